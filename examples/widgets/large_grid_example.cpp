@@ -0,0 +1,47 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+/** Benchmark for the constrain and layout passes with a large number of widgets.
+ *
+ * The window contains a scrollable grid of 3364 labels, each label consists of a
+ * label-, icon- and text-widget; for a total of more than 10,000 widgets.
+ *
+ * Toggling the checkbox in the top-left corner changes a single widget. The number of
+ * widgets visited during the constrain and layout passes is reported by the
+ * "widget_constrain" and "widget_layout" counters in the statistics log, the duration of
+ * the passes by the "window_constrain" and "window_layout" traces.
+ */
+
+#include "ttauri/GUI/gui_system.hpp"
+#include "ttauri/widgets/checkbox_widget.hpp"
+#include "ttauri/widgets/label_widget.hpp"
+#include "ttauri/widgets/grid_widget.hpp"
+#include "ttauri/widgets/scroll_widget.hpp"
+#include "ttauri/crt.hpp"
+
+using namespace tt;
+
+int tt_main(int argc, char *argv[])
+{
+    constexpr size_t nr_columns = 58;
+    constexpr size_t nr_rows = 58;
+
+    auto &window = gui_system::global().make_window(l10n("Large grid example"));
+
+    observable<int> value = 0;
+    auto &cb = window.content().make_widget<checkbox_widget>("A1", value, 1, 0);
+    cb.on_label = l10n("on");
+    cb.off_label = l10n("off");
+
+    auto &scroll = window.content().make_widget<scroll_widget<>>("A2");
+    auto &grid = scroll.make_widget<grid_widget>();
+
+    for (size_t row_nr = 0; row_nr != nr_rows; ++row_nr) {
+        for (size_t column_nr = 0; column_nr != nr_columns; ++column_nr) {
+            grid.make_widget<label_widget>(column_nr, row_nr, l10n("cell"));
+        }
+    }
+
+    return gui_system::global().loop();
+}
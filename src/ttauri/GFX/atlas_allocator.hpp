@@ -0,0 +1,247 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "skyline_packer.hpp"
+#include "../geometry/extent.hpp"
+#include "../geometry/point.hpp"
+#include "../assert.hpp"
+#include "../cast.hpp"
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <cmath>
+#include <cstdint>
+
+namespace tt {
+
+/** Allocator for the rectangles of an atlas consisting of multiple images.
+ *
+ * Rectangles are packed into each image, called a page, by a `skyline_packer`.
+ * New pages are added up to a maximum. When all pages are full, the least
+ * recently used page is evicted: all its rectangles are forgotten and the page is
+ * repacked from scratch. Rectangles that are still in use are allocated again when
+ * they are looked up, which compacts the atlas to the working set.
+ *
+ * A page that was used during one of the last `frames_in_flight` frames is never
+ * evicted, since vertices referencing that page may still be drawn. The user of the
+ * allocator calls `next_frame()` after the vertices of a frame have been submitted.
+ *
+ * The allocator only keeps track of positions; the user owns the images and
+ * must create a new image when `nr_pages()` grows.
+ *
+ * @tparam Key The type of key to identify a rectangle, for example `font_glyph_ids`.
+ */
+template<typename Key>
+class atlas_allocator {
+public:
+    using key_type = Key;
+
+    struct item_type {
+        /** The position of the bottom-left corner of the rectangle, z is the page index.
+         */
+        point3 position;
+        extent2 size;
+    };
+
+    /** Create an allocator.
+     *
+     * @param page_width The width of each page in pixels.
+     * @param page_height The height of each page in pixels.
+     * @param maximum_nr_pages The maximum number of pages.
+     * @param frames_in_flight The number of frames, including the current frame, during
+     *                         which a page is not evicted after it was last used.
+     */
+    atlas_allocator(int page_width, int page_height, int maximum_nr_pages, int frames_in_flight = 1) noexcept :
+        _page_width(page_width),
+        _page_height(page_height),
+        _maximum_nr_pages(maximum_nr_pages),
+        _frames_in_flight(narrow_cast<uint64_t>(frames_in_flight))
+    {
+        tt_axiom(maximum_nr_pages > 0);
+        tt_axiom(frames_in_flight > 0);
+    }
+
+    atlas_allocator(atlas_allocator const &) = delete;
+    atlas_allocator(atlas_allocator &&) = delete;
+    atlas_allocator &operator=(atlas_allocator const &) = delete;
+    atlas_allocator &operator=(atlas_allocator &&) = delete;
+
+    /** The number of pages that are in use.
+     */
+    [[nodiscard]] size_t nr_pages() const noexcept
+    {
+        return _pages.size();
+    }
+
+    /** The number of rectangles in the atlas.
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _items.size();
+    }
+
+    /** The number of times a page was evicted.
+     */
+    [[nodiscard]] size_t eviction_count() const noexcept
+    {
+        return _eviction_count;
+    }
+
+    /** The fraction of the pages that is covered by rectangles.
+     */
+    [[nodiscard]] float occupancy() const noexcept
+    {
+        if (_pages.empty()) {
+            return 0.0f;
+        }
+
+        auto used_area = size_t{0};
+        for (ttlet &page : _pages) {
+            used_area += page.packer.used_area();
+        }
+        return static_cast<float>(used_area) /
+            (static_cast<float>(_pages.size()) * static_cast<float>(_page_width) * static_cast<float>(_page_height));
+    }
+
+    /** Check if a rectangle of the given size fits on an empty page.
+     */
+    [[nodiscard]] bool fits_on_page(extent2 size) const noexcept
+    {
+        ttlet width = std::ceil(size.width());
+        ttlet height = std::ceil(size.height());
+        return width > 0.0f and height > 0.0f and width <= static_cast<float>(_page_width) and
+            height <= static_cast<float>(_page_height);
+    }
+
+    /** Find a rectangle.
+     * The page of the rectangle is marked as used during the current frame.
+     *
+     * @param key The key of the rectangle.
+     * @return The rectangle, or empty if it is not in the atlas.
+     */
+    [[nodiscard]] std::optional<item_type> find(key_type const &key) noexcept
+    {
+        ttlet i = _items.find(key);
+        if (i == _items.cend()) {
+            return {};
+        }
+
+        _pages[page_index(i->second)].last_used = _frame;
+        return i->second;
+    }
+
+    /** Allocate a rectangle.
+     * The key must not already be in the atlas. This may add a new page, or evict the
+     * least recently used page and the rectangles on it.
+     *
+     * @param key The key of the rectangle.
+     * @param size The size of the rectangle, rounded up to whole pixels.
+     * @return The rectangle, or empty if all pages are in use by the frames in flight
+     *         or when the rectangle does not fit on a page, see `fits_on_page()`.
+     */
+    [[nodiscard]] std::optional<item_type> allocate(key_type const &key, extent2 size) noexcept
+    {
+        tt_axiom(not _items.contains(key));
+
+        if (not fits_on_page(size)) {
+            return {};
+        }
+
+        ttlet width = narrow_cast<int>(std::ceil(size.width()));
+        ttlet height = narrow_cast<int>(std::ceil(size.height()));
+
+        for (auto i = size_t{0}; i != _pages.size(); ++i) {
+            if (ttlet position = _pages[i].packer.allocate(width, height)) {
+                return add_item(key, i, *position, size);
+            }
+        }
+
+        if (std::ssize(_pages) < _maximum_nr_pages) {
+            _pages.emplace_back(_page_width, _page_height);
+            ttlet i = _pages.size() - 1;
+            ttlet position = _pages[i].packer.allocate(width, height);
+            tt_axiom(position);
+            return add_item(key, i, *position, size);
+        }
+
+        if (ttlet i = least_recently_used_page()) {
+            evict(*i);
+            ttlet position = _pages[*i].packer.allocate(width, height);
+            tt_axiom(position);
+            return add_item(key, *i, *position, size);
+        }
+
+        return {};
+    }
+
+    /** Mark the end of a frame.
+     * Pages that were last used `frames_in_flight` frames ago may be evicted.
+     */
+    void next_frame() noexcept
+    {
+        ++_frame;
+    }
+
+private:
+    struct page_type {
+        skyline_packer packer;
+
+        /** The frame in which a rectangle on this page was last allocated or found.
+         */
+        uint64_t last_used;
+
+        page_type(int width, int height) noexcept : packer(width, height), last_used(0) {}
+    };
+
+    int _page_width;
+    int _page_height;
+    int _maximum_nr_pages;
+    uint64_t _frames_in_flight;
+    uint64_t _frame = 0;
+    size_t _eviction_count = 0;
+
+    std::vector<page_type> _pages;
+    std::unordered_map<key_type, item_type> _items;
+
+    [[nodiscard]] static size_t page_index(item_type const &item) noexcept
+    {
+        return narrow_cast<size_t>(item.position.z());
+    }
+
+    [[nodiscard]] item_type add_item(key_type const &key, size_t page, point2 position, extent2 size) noexcept
+    {
+        _pages[page].last_used = _frame;
+
+        ttlet item = item_type{point3{position.x(), position.y(), narrow_cast<float>(page)}, size};
+        _items.emplace(key, item);
+        return item;
+    }
+
+    /** Find the least recently used page that was not used by one of the frames in flight.
+     */
+    [[nodiscard]] std::optional<size_t> least_recently_used_page() const noexcept
+    {
+        auto r = std::optional<size_t>{};
+        for (auto i = size_t{0}; i != _pages.size(); ++i) {
+            ttlet last_used = _pages[i].last_used;
+            if (last_used + _frames_in_flight <= _frame and (not r or last_used < _pages[*r].last_used)) {
+                r = i;
+            }
+        }
+        return r;
+    }
+
+    void evict(size_t page) noexcept
+    {
+        std::erase_if(_items, [page](ttlet &item) {
+            return page_index(item.second) == page;
+        });
+        _pages[page].packer.clear();
+        ++_eviction_count;
+    }
+};
+
+} // namespace tt
@@ -0,0 +1,135 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/GFX/atlas_allocator.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace std;
+using namespace tt;
+
+TEST(atlas_allocator, find)
+{
+    auto allocator = atlas_allocator<int>{64, 64, 2};
+
+    ASSERT_FALSE(allocator.find(1));
+
+    ttlet a = allocator.allocate(1, extent2{10.5f, 20.0f});
+    ASSERT_TRUE(a);
+    ASSERT_EQ(a->position, point3(0.0f, 0.0f, 0.0f));
+    ASSERT_EQ(a->size, extent2(10.5f, 20.0f));
+
+    ttlet b = allocator.find(1);
+    ASSERT_TRUE(b);
+    ASSERT_EQ(b->position, a->position);
+    ASSERT_EQ(allocator.size(), 1);
+    ASSERT_EQ(allocator.nr_pages(), 1);
+}
+
+TEST(atlas_allocator, add_page)
+{
+    auto allocator = atlas_allocator<int>{64, 64, 2};
+
+    ASSERT_TRUE(allocator.allocate(1, extent2{64.0f, 64.0f}));
+    ttlet b = allocator.allocate(2, extent2{32.0f, 32.0f});
+    ASSERT_TRUE(b);
+    ASSERT_EQ(b->position, point3(0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(allocator.nr_pages(), 2);
+    ASSERT_EQ(allocator.eviction_count(), 0);
+}
+
+TEST(atlas_allocator, evict_least_recently_used)
+{
+    auto allocator = atlas_allocator<int>{64, 64, 2};
+
+    // Frame 0: fill both pages.
+    ASSERT_TRUE(allocator.allocate(1, extent2{64.0f, 64.0f}));
+    ASSERT_TRUE(allocator.allocate(2, extent2{64.0f, 64.0f}));
+    allocator.next_frame();
+
+    // Frame 1: only glyph 2 is used, so page 0 becomes the least recently used.
+    ASSERT_TRUE(allocator.find(2));
+    allocator.next_frame();
+
+    ttlet c = allocator.allocate(3, extent2{16.0f, 16.0f});
+    ASSERT_TRUE(c);
+    ASSERT_EQ(c->position, point3(0.0f, 0.0f, 0.0f));
+    ASSERT_EQ(allocator.eviction_count(), 1);
+    ASSERT_FALSE(allocator.find(1));
+    ASSERT_TRUE(allocator.find(2));
+    ASSERT_TRUE(allocator.find(3));
+}
+
+TEST(atlas_allocator, no_eviction_during_frame)
+{
+    auto allocator = atlas_allocator<int>{64, 64, 1};
+
+    ASSERT_TRUE(allocator.allocate(1, extent2{64.0f, 64.0f}));
+
+    // The only page is used during this frame, its glyphs may still be drawn.
+    ASSERT_FALSE(allocator.allocate(2, extent2{1.0f, 1.0f}));
+    ASSERT_TRUE(allocator.find(1));
+
+    allocator.next_frame();
+    ASSERT_TRUE(allocator.allocate(2, extent2{1.0f, 1.0f}));
+    ASSERT_FALSE(allocator.find(1));
+}
+
+TEST(atlas_allocator, no_eviction_during_frames_in_flight)
+{
+    auto allocator = atlas_allocator<int>{64, 64, 1, 3};
+
+    ASSERT_TRUE(allocator.allocate(1, extent2{64.0f, 64.0f}));
+
+    // The page may still be drawn by the two frames that follow.
+    allocator.next_frame();
+    ASSERT_FALSE(allocator.allocate(2, extent2{1.0f, 1.0f}));
+    allocator.next_frame();
+    ASSERT_FALSE(allocator.allocate(2, extent2{1.0f, 1.0f}));
+    ASSERT_EQ(allocator.eviction_count(), 0);
+
+    allocator.next_frame();
+    ASSERT_TRUE(allocator.allocate(2, extent2{1.0f, 1.0f}));
+    ASSERT_FALSE(allocator.find(1));
+    ASSERT_EQ(allocator.eviction_count(), 1);
+}
+
+TEST(atlas_allocator, too_large)
+{
+    auto allocator = atlas_allocator<int>{64, 64, 1};
+    ASSERT_TRUE(allocator.fits_on_page(extent2{64.0f, 63.5f}));
+    ASSERT_FALSE(allocator.fits_on_page(extent2{64.5f, 1.0f}));
+    ASSERT_FALSE(allocator.allocate(1, extent2{64.5f, 1.0f}));
+    ASSERT_EQ(allocator.nr_pages(), 0);
+}
+
+/** Cycle through many more glyphs than fit in the atlas, like an application
+ * that keeps changing fonts and sizes. The atlas must never overflow and the
+ * working set of each frame must remain available.
+ */
+TEST(atlas_allocator, working_set)
+{
+    auto allocator = atlas_allocator<int>{256, 256, 4};
+
+    auto engine = std::mt19937{42};
+    auto size_distribution = std::uniform_real_distribution<float>{10.0f, 45.0f};
+
+    for (auto frame = 0; frame != 100; ++frame) {
+        // Each frame uses 50 glyphs, half of which are shared with the previous frame.
+        for (auto i = 0; i != 50; ++i) {
+            ttlet key = frame * 25 + i;
+            if (not allocator.find(key)) {
+                ASSERT_TRUE(allocator.allocate(key, extent2{size_distribution(engine), size_distribution(engine)}));
+            }
+        }
+
+        for (auto i = 0; i != 50; ++i) {
+            ASSERT_TRUE(allocator.find(frame * 25 + i));
+        }
+        allocator.next_frame();
+    }
+
+    ASSERT_EQ(allocator.nr_pages(), 4);
+    ASSERT_GT(allocator.eviction_count(), 0);
+}
@@ -3,18 +3,15 @@
 // (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include "draw_context.hpp"
-#include "pipeline_flat_device_shared.hpp"
 #include "pipeline_box_device_shared.hpp"
-#include "pipeline_image_device_shared.hpp"
-#include "pipeline_SDF_device_shared.hpp"
 #include "pipeline_image_image.hpp"
-#include "gfx_device_vulkan.hpp"
+#include "gfx_device.hpp"
 #include "../text/shaped_text.hpp"
 
 namespace tt {
 
 draw_context::draw_context(
-    gfx_device_vulkan &device,
+    gfx_device &device,
     size_t frame_buffer_index,
     extent2 surface_size,
     aarectangle scissor_rectangle,
@@ -202,21 +199,14 @@ void draw_context::draw_text(shaped_text const &text, std::optional<color> text_
 {
     tt_axiom(_sdf_vertices != nullptr);
 
-    if (text_color) {
-        narrow_cast<gfx_device_vulkan &>(device()).SDFPipeline->place_vertices(
-            *_sdf_vertices, aarectangle{_transform * _clipping_rectangle}, _transform * transform, text, *text_color);
-    } else {
-        narrow_cast<gfx_device_vulkan &>(device()).SDFPipeline->place_vertices(
-            *_sdf_vertices, aarectangle{_transform * _clipping_rectangle}, _transform * transform, text);
-    }
+    _device.place_vertices(*_sdf_vertices, aarectangle{_transform * _clipping_rectangle}, _transform * transform, text, text_color);
 }
 
 void draw_context::draw_glyph(font_glyph_ids const &glyph, rectangle box, color text_color) const noexcept
 {
     tt_axiom(_sdf_vertices != nullptr);
 
-    narrow_cast<gfx_device_vulkan &>(device()).SDFPipeline->place_vertices(
-        *_sdf_vertices, aarectangle{_transform * _clipping_rectangle}, _transform * box, glyph, text_color);
+    _device.place_vertices(*_sdf_vertices, aarectangle{_transform * _clipping_rectangle}, _transform * box, glyph, text_color);
 }
 
 }
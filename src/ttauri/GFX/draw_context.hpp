@@ -17,7 +17,6 @@
 
 namespace tt {
 class gfx_device;
-class gfx_device_vulkan;
 class shaped_text;
 class font_glyph_ids;
 namespace pipeline_image {
@@ -35,7 +34,7 @@ public:
     ~draw_context() = default;
 
     draw_context(
-        gfx_device_vulkan &device,
+        gfx_device &device,
         size_t frame_buffer_index,
         extent2 surface_size,
         aarectangle scissor_rectangle,
@@ -179,7 +178,7 @@ public:
     }
 
 private:
-    gfx_device_vulkan &_device;
+    gfx_device &_device;
 
     vspan<pipeline_flat::vertex> *_flat_vertices;
     vspan<pipeline_box::vertex> *_box_vertices;
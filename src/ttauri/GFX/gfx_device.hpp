@@ -10,12 +10,26 @@
 #include "../cast.hpp"
 #include "../bigint.hpp"
 #include "../unfair_recursive_mutex.hpp"
+#include "../vspan.hpp"
+#include "../geometry/axis_aligned_rectangle.hpp"
+#include "../geometry/rectangle.hpp"
+#include "../geometry/matrix.hpp"
+#include "../color/color.hpp"
 #include <unordered_set>
 #include <mutex>
 #include <tuple>
+#include <optional>
 
 namespace tt {
 class gfx_system;
+class shaped_text;
+class font_glyph_ids;
+namespace pipeline_SDF {
+struct vertex;
+}
+namespace pipeline_image {
+struct image;
+}
 
 /*! A gfx_device that handles a set of windows.
  */
@@ -46,6 +60,47 @@ public:
      * \returns -1 When not viable, 0 when not presentable, positive values for increasing score.
      */
     virtual int score(gfx_surface const &surface) const = 0;
+
+    /** Place vertices for the glyphs of a shaped text.
+     * The glyphs are added to the SDF-atlas of this device when needed.
+     *
+     * @param vertices The list of vertices to add to.
+     * @param clipping_rectangle The clipping rectangle in window coordinates.
+     * @param transform The transformation from text coordinates to window coordinates.
+     * @param text The shaped text to draw.
+     * @param text_color Override the color of the text, when empty use the text style's color.
+     */
+    virtual void place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        matrix3 transform,
+        shaped_text const &text,
+        std::optional<color> text_color) noexcept = 0;
+
+    /** Place vertices for a single glyph.
+     * The glyph is added to the SDF-atlas of this device when needed.
+     *
+     * @param vertices The list of vertices to add to.
+     * @param clipping_rectangle The clipping rectangle in window coordinates.
+     * @param box The rectangle of the glyph in window coordinates; including the draw border.
+     * @param glyph The font-id, composed-glyphs to render.
+     * @param text_color The color of the glyph.
+     */
+    virtual void place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        rectangle box,
+        font_glyph_ids const &glyph,
+        color text_color) noexcept = 0;
+
+    /** Make an image that can be drawn using `draw_context::draw_image()`.
+     * The image is allocated in the texture atlas of this device.
+     *
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     * @return The image, or an image without a parent when this device can not draw images.
+     */
+    [[nodiscard]] virtual pipeline_image::image make_image(size_t width, size_t height) noexcept = 0;
 };
 
 }
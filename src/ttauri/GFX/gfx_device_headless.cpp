@@ -0,0 +1,172 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "gfx_device_headless.hpp"
+#include "gfx_surface_headless.hpp"
+#include "pipeline_image_image.hpp"
+#include "../text/shaped_text.hpp"
+#include "../graphic_path.hpp"
+#include "../logger.hpp"
+#include "../geometry/scale.hpp"
+#include "../geometry/translate.hpp"
+#include <utility>
+
+namespace tt {
+
+gfx_device_headless::gfx_device_headless(gfx_system &system) noexcept : gfx_device(system)
+{
+    deviceName = "<headless>";
+
+    // There needs to be at least one atlas image, same as the Vulkan SDF pipeline.
+    add_atlas_image();
+}
+
+gfx_device_headless::~gfx_device_headless() {}
+
+int gfx_device_headless::score(gfx_surface const &surface) const
+{
+    if (dynamic_cast<gfx_surface_headless const *>(&surface) == nullptr) {
+        return -1;
+    }
+    return 1;
+}
+
+void gfx_device_headless::add_atlas_image() noexcept
+{
+    auto image = pixel_map<sdf_r8>{atlas_image_width, atlas_image_height};
+
+    // Same clear value as the Vulkan atlas textures: fully outside of any glyph.
+    for (ssize_t y = 0; y != image.height(); ++y) {
+        auto row = image[y];
+        for (ssize_t x = 0; x != image.width(); ++x) {
+            row[x] = -sdf_r8::max_distance;
+        }
+    }
+
+    _atlas_images.push_back(std::move(image));
+}
+
+[[nodiscard]] std::optional<pipeline_SDF::atlas_rect>
+gfx_device_headless::allocate_rect(font_glyph_ids const &glyph, extent2 draw_extent) noexcept
+{
+    if (not _atlas_allocator.fits_on_page(draw_extent)) {
+        if (not std::exchange(_atlas_glyph_too_large_logged, true)) {
+            tt_log_error(
+                "gfx_device_headless glyph of {}x{} pixels is larger than an atlas image, the glyph is not drawn.",
+                draw_extent.width(),
+                draw_extent.height());
+        }
+        return {};
+    }
+
+    ttlet item = _atlas_allocator.allocate(glyph, draw_extent);
+    if (not item) {
+        if (not std::exchange(_atlas_full_logged, true)) {
+            tt_log_error("gfx_device_headless atlas is full, all atlas images are used in this frame; glyphs are not drawn.");
+        }
+        return {};
+    }
+
+    while (_atlas_allocator.nr_pages() > _atlas_images.size()) {
+        add_atlas_image();
+    }
+
+    return pipeline_SDF::atlas_rect{item->position, item->size};
+}
+
+/** Render a glyph directly into the atlas.
+ * This uses the same scaling and border as `pipeline_SDF::device_shared::addGlyphToAtlas()`,
+ * but there is no staging texture since the atlas lives in CPU memory.
+ */
+[[nodiscard]] std::optional<pipeline_SDF::atlas_rect>
+gfx_device_headless::add_glyph_to_atlas(font_glyph_ids const &glyph) noexcept
+{
+    using pipeline_SDF::device_shared;
+
+    ttlet[glyph_path, glyph_bounding_box] = glyph.getPathAndBoundingBox();
+
+    ttlet draw_scale = scale2{device_shared::drawfontSize, device_shared::drawfontSize};
+    ttlet scaled_bounding_box = draw_scale * glyph_bounding_box;
+
+    ttlet draw_offset = point2{device_shared::drawBorder, device_shared::drawBorder} - get<0>(scaled_bounding_box);
+    ttlet draw_extent = scaled_bounding_box.size() + 2.0f * device_shared::drawBorder;
+    ttlet draw_translate = translate2{draw_offset};
+
+    ttlet draw_path = (draw_translate * draw_scale) * glyph_path;
+
+    ttlet lock = std::scoped_lock(gfx_system_mutex);
+    ttlet atlas_rect = allocate_rect(glyph, draw_extent);
+    if (not atlas_rect) {
+        return {};
+    }
+
+    auto &atlas_image = _atlas_images.at(narrow_cast<size_t>(atlas_rect->atlas_position.z()));
+    auto pixmap = atlas_image.submap(aarectangle{point2{atlas_rect->atlas_position}, atlas_rect->size});
+    fill(pixmap, draw_path);
+    return atlas_rect;
+}
+
+[[nodiscard]] std::optional<pipeline_SDF::atlas_rect>
+gfx_device_headless::get_glyph_from_atlas(font_glyph_ids const &glyph) noexcept
+{
+    if (ttlet item = _atlas_allocator.find(glyph)) {
+        return pipeline_SDF::atlas_rect{item->position, item->size};
+    } else {
+        return add_glyph_to_atlas(glyph);
+    }
+}
+
+void gfx_device_headless::place_vertices(
+    vspan<pipeline_SDF::vertex> &vertices,
+    aarectangle clipping_rectangle,
+    rectangle box,
+    font_glyph_ids const &glyph,
+    color text_color) noexcept
+{
+    ttlet atlas_rect = get_glyph_from_atlas(glyph);
+
+    if (!atlas_rect or !overlaps(clipping_rectangle, aarectangle{box})) {
+        return;
+    }
+
+    vertices.emplace_back(get<0>(box), clipping_rectangle, get<0>(atlas_rect->texture_coordinates), text_color);
+    vertices.emplace_back(get<1>(box), clipping_rectangle, get<1>(atlas_rect->texture_coordinates), text_color);
+    vertices.emplace_back(get<2>(box), clipping_rectangle, get<2>(atlas_rect->texture_coordinates), text_color);
+    vertices.emplace_back(get<3>(box), clipping_rectangle, get<3>(atlas_rect->texture_coordinates), text_color);
+}
+
+void gfx_device_headless::_place_vertices(
+    vspan<pipeline_SDF::vertex> &vertices,
+    aarectangle clipping_rectangle,
+    matrix3 transform,
+    attributed_glyph const &attr_glyph,
+    color text_color) noexcept
+{
+    if (!is_visible(attr_glyph.general_category)) {
+        return;
+    }
+
+    ttlet bounding_box = transform * attr_glyph.boundingBox(pipeline_SDF::device_shared::scaledDrawBorder);
+    place_vertices(vertices, clipping_rectangle, bounding_box, attr_glyph.glyphs, text_color);
+}
+
+void gfx_device_headless::place_vertices(
+    vspan<pipeline_SDF::vertex> &vertices,
+    aarectangle clipping_rectangle,
+    matrix3 transform,
+    shaped_text const &text,
+    std::optional<color> text_color) noexcept
+{
+    for (ttlet &attr_glyph : text) {
+        _place_vertices(vertices, clipping_rectangle, transform, attr_glyph, text_color ? *text_color : attr_glyph.style.color);
+    }
+}
+
+[[nodiscard]] pipeline_image::image
+gfx_device_headless::make_image([[maybe_unused]] size_t width, [[maybe_unused]] size_t height) noexcept
+{
+    return pipeline_image::image{};
+}
+
+} // namespace tt
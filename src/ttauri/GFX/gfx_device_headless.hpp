@@ -0,0 +1,108 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "gfx_device.hpp"
+#include "atlas_allocator.hpp"
+#include "pipeline_SDF_atlas_rect.hpp"
+#include "pipeline_SDF_device_shared.hpp"
+#include "pipeline_SDF_vertex.hpp"
+#include "../text/font_glyph_ids.hpp"
+#include "../rapid/sdf_r8.hpp"
+#include "../pixel_map.hpp"
+#include <optional>
+#include <vector>
+
+namespace tt {
+struct attributed_glyph;
+
+/** A graphics device that does not require a GPU.
+ *
+ * The headless device is used together with `gfx_surface_headless` to run
+ * the complete widget pipeline: constrain, layout and draw, on machines without
+ * a GPU. The device owns a CPU-side SDF glyph atlas with the same layout as the
+ * atlas of the Vulkan SDF pipeline, so that the texture coordinates of the
+ * SDF vertices can be sampled by the software rasterizer.
+ */
+class gfx_device_headless final : public gfx_device {
+public:
+    static constexpr int atlas_image_width = pipeline_SDF::device_shared::atlasImageWidth;
+    static constexpr int atlas_image_height = pipeline_SDF::device_shared::atlasImageHeight;
+    static constexpr int atlas_maximum_nr_images = pipeline_SDF::device_shared::atlasMaximumNrImages;
+
+    gfx_device_headless(gfx_system &system) noexcept;
+    ~gfx_device_headless();
+
+    gfx_device_headless(const gfx_device_headless &) = delete;
+    gfx_device_headless &operator=(const gfx_device_headless &) = delete;
+    gfx_device_headless(gfx_device_headless &&) = delete;
+    gfx_device_headless &operator=(gfx_device_headless &&) = delete;
+
+    /** The headless device can only render on headless surfaces.
+     */
+    int score(gfx_surface const &surface) const override;
+
+    void place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        matrix3 transform,
+        shaped_text const &text,
+        std::optional<color> text_color) noexcept override;
+
+    void place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        rectangle box,
+        font_glyph_ids const &glyph,
+        color text_color) noexcept override;
+
+    /** The headless device has no texture atlas for images.
+     * @return An image without a parent, which is not drawn.
+     */
+    [[nodiscard]] pipeline_image::image make_image(size_t width, size_t height) noexcept override;
+
+    /** The images of the SDF glyph atlas.
+     * Each image is indexed by the z-coordinate of the texture coordinate of a SDF vertex.
+     */
+    [[nodiscard]] std::vector<pixel_map<sdf_r8>> const &atlas_images() const noexcept
+    {
+        return _atlas_images;
+    }
+
+    /** The number of glyphs that are in the atlas.
+     */
+    [[nodiscard]] size_t atlas_glyph_count() const noexcept
+    {
+        return _atlas_allocator.size();
+    }
+
+    /** End the frame of the glyph atlas.
+     * Glyphs that are not used in the next frame may be evicted from the atlas.
+     */
+    void next_frame() noexcept
+    {
+        _atlas_allocator.next_frame();
+    }
+
+private:
+    atlas_allocator<font_glyph_ids> _atlas_allocator = {atlas_image_width, atlas_image_height, atlas_maximum_nr_images};
+    std::vector<pixel_map<sdf_r8>> _atlas_images;
+    bool _atlas_glyph_too_large_logged = false;
+    bool _atlas_full_logged = false;
+
+    void add_atlas_image() noexcept;
+    [[nodiscard]] std::optional<pipeline_SDF::atlas_rect> allocate_rect(font_glyph_ids const &glyph, extent2 draw_extent) noexcept;
+    [[nodiscard]] std::optional<pipeline_SDF::atlas_rect> add_glyph_to_atlas(font_glyph_ids const &glyph) noexcept;
+    [[nodiscard]] std::optional<pipeline_SDF::atlas_rect> get_glyph_from_atlas(font_glyph_ids const &glyph) noexcept;
+
+    void _place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        matrix3 transform,
+        attributed_glyph const &attr_glyph,
+        color text_color) noexcept;
+};
+
+} // namespace tt
@@ -438,6 +438,35 @@ int gfx_device_vulkan::score(gfx_surface const &surface) const
     return total_score;
 }
 
+void gfx_device_vulkan::place_vertices(
+    vspan<pipeline_SDF::vertex> &vertices,
+    aarectangle clipping_rectangle,
+    matrix3 transform,
+    shaped_text const &text,
+    std::optional<color> text_color) noexcept
+{
+    if (text_color) {
+        SDFPipeline->place_vertices(vertices, clipping_rectangle, transform, text, *text_color);
+    } else {
+        SDFPipeline->place_vertices(vertices, clipping_rectangle, transform, text);
+    }
+}
+
+void gfx_device_vulkan::place_vertices(
+    vspan<pipeline_SDF::vertex> &vertices,
+    aarectangle clipping_rectangle,
+    rectangle box,
+    font_glyph_ids const &glyph,
+    color text_color) noexcept
+{
+    SDFPipeline->place_vertices(vertices, clipping_rectangle, box, glyph, text_color);
+}
+
+[[nodiscard]] pipeline_image::image gfx_device_vulkan::make_image(size_t width, size_t height) noexcept
+{
+    return imagePipeline->makeImage(width, height);
+}
+
 std::vector<vk::DeviceQueueCreateInfo> gfx_device_vulkan::make_device_queue_create_infos() const noexcept
 {
     ttlet default_queue_priority = std::array{1.0f};
@@ -106,6 +106,22 @@ public:
 
     int score(gfx_surface const &surface) const override;
 
+    void place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        matrix3 transform,
+        shaped_text const &text,
+        std::optional<color> text_color) noexcept override;
+
+    void place_vertices(
+        vspan<pipeline_SDF::vertex> &vertices,
+        aarectangle clipping_rectangle,
+        rectangle box,
+        font_glyph_ids const &glyph,
+        color text_color) noexcept override;
+
+    [[nodiscard]] pipeline_image::image make_image(size_t width, size_t height) noexcept override;
+
     /*! Find the minimum number of queue families to instantiate for a window.
      * This will give priority for having the Graphics and Present in the same
      * queue family.
@@ -0,0 +1,114 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "gfx_surface_headless.hpp"
+#include "gfx_device_headless.hpp"
+#include "../trace.hpp"
+#include "../cast.hpp"
+
+namespace tt {
+
+gfx_surface_headless::gfx_surface_headless(gfx_system &system, extent2 size, bool rasterize) noexcept :
+    gfx_surface(system), _rasterize(rasterize), _requested_size(size)
+{
+    // The headless surface does not need to wait for a swapchain.
+    subpixel_orientation = subpixel_orientation::Unknown;
+}
+
+gfx_surface_headless::~gfx_surface_headless() {}
+
+void gfx_surface_headless::set_device(gfx_device *device) noexcept
+{
+    tt_axiom(gfx_system_mutex.recurse_lock_count());
+
+    super::set_device(device);
+    if (device) {
+        tt_assert(dynamic_cast<gfx_device_headless *>(device) != nullptr);
+        state = gfx_surface_state::ready_to_render;
+    }
+}
+
+gfx_device_headless &gfx_surface_headless::headless_device() const noexcept
+{
+    tt_axiom(gfx_system_mutex.recurse_lock_count());
+    tt_axiom(_device != nullptr);
+    return narrow_cast<gfx_device_headless &>(*_device);
+}
+
+[[nodiscard]] extent2 gfx_surface_headless::update(extent2 minimum_size, extent2 maximum_size) noexcept
+{
+    ttlet lock = std::scoped_lock(gfx_system_mutex);
+
+    teardown();
+
+    ttlet new_size = ceil(clamp(_requested_size, minimum_size, maximum_size));
+    if (new_size != size or (_rasterize and not _rasterizer.image)) {
+        size = new_size;
+        if (_rasterize) {
+            _rasterizer = software_rasterizer{narrow_cast<ssize_t>(size.width()), narrow_cast<ssize_t>(size.height())};
+        }
+    }
+
+    if (_device != nullptr and state == gfx_surface_state::no_device) {
+        state = gfx_surface_state::ready_to_render;
+    }
+    return size;
+}
+
+[[nodiscard]] std::optional<draw_context> gfx_surface_headless::render_start(aarectangle redraw_rectangle)
+{
+    ttlet lock = std::scoped_lock(gfx_system_mutex);
+
+    if (state != gfx_surface_state::ready_to_render || !redraw_rectangle) {
+        return {};
+    }
+
+    ttlet scissor_rectangle = ceil(intersect(redraw_rectangle, aarectangle{size}));
+
+    return draw_context{
+        *_device,
+        _frame_count % 2,
+        size,
+        scissor_rectangle,
+        _flat_vertices.span,
+        _box_vertices.span,
+        _image_vertices.span,
+        _sdf_vertices.span};
+}
+
+void gfx_surface_headless::render_finish(draw_context const &context, color background_color)
+{
+    ttlet lock = std::scoped_lock(gfx_system_mutex);
+
+    if (_rasterize) {
+        auto t = trace<"software_rasterizer">{};
+
+        ttlet scissor_rectangle = context.scissor_rectangle();
+
+        // Only clear the part of the image that is redrawn, the same as the scissor of the Vulkan render pass.
+        _rasterizer.clear(scissor_rectangle, background_color);
+
+        _rasterizer.draw(scissor_rectangle, _flat_vertices.span);
+        _rasterizer.draw(scissor_rectangle, _box_vertices.span);
+        // Images can only be uploaded on a Vulkan device, the image vertices are not rasterized.
+        _rasterizer.draw(scissor_rectangle, _sdf_vertices.span, headless_device().atlas_images(), subpixel_orientation);
+    }
+
+    headless_device().next_frame();
+    ++_frame_count;
+}
+
+void gfx_surface_headless::teardown()
+{
+    tt_axiom(gfx_system_mutex.recurse_lock_count());
+
+    if (state == gfx_surface_state::device_lost) {
+        state = gfx_surface_state::no_device;
+
+    } else if (state == gfx_surface_state::window_lost) {
+        state = gfx_surface_state::no_window;
+    }
+}
+
+} // namespace tt
@@ -0,0 +1,145 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "gfx_surface.hpp"
+#include "software_rasterizer.hpp"
+#include "pipeline_flat_vertex.hpp"
+#include "pipeline_box_vertex.hpp"
+#include "pipeline_image_vertex.hpp"
+#include "pipeline_SDF_vertex.hpp"
+#include <memory>
+
+namespace tt {
+class gfx_device_headless;
+
+/** A surface that renders without a window or GPU.
+ *
+ * The headless surface collects the vertex streams of the flat, box, image and SDF
+ * pipelines in CPU memory. When rasterizing is enabled the vertices are drawn by
+ * the `software_rasterizer` into `image()` at `render_finish()`.
+ *
+ * The size of the surface is set by the user, and is clamped by `update()`
+ * to the minimum and maximum size of the window's widgets.
+ */
+class gfx_surface_headless final : public gfx_surface {
+public:
+    using super = gfx_surface;
+
+    /** The number of vertices in each vertex stream.
+     * The same as the Vulkan pipelines, which are limited by the 16 bit vertex index.
+     */
+    static constexpr ssize_t maximum_number_of_vertices = 1 << (sizeof(uint16_t) * CHAR_BIT);
+
+    /** Create a headless surface.
+     *
+     * @param system The graphics system.
+     * @param size The requested size of the surface in pixels.
+     * @param rasterize When true the vertices are drawn by the software rasterizer.
+     */
+    gfx_surface_headless(gfx_system &system, extent2 size, bool rasterize = false) noexcept;
+    ~gfx_surface_headless();
+
+    gfx_surface_headless(const gfx_surface_headless &) = delete;
+    gfx_surface_headless &operator=(const gfx_surface_headless &) = delete;
+    gfx_surface_headless(gfx_surface_headless &&) = delete;
+    gfx_surface_headless &operator=(gfx_surface_headless &&) = delete;
+
+    void set_device(gfx_device *device) noexcept override;
+
+    gfx_device_headless &headless_device() const noexcept;
+
+    [[nodiscard]] extent2 update(extent2 minimum_size, extent2 maximum_size) noexcept override;
+
+    [[nodiscard]] std::optional<draw_context> render_start(aarectangle redraw_rectangle) override;
+    void render_finish(draw_context const &context, color background_color) override;
+
+    /** Change the requested size of the surface.
+     * The new size is used on the next call to `update()`.
+     */
+    void set_requested_size(extent2 requested_size) noexcept
+    {
+        ttlet lock = std::scoped_lock(gfx_system_mutex);
+        _requested_size = requested_size;
+    }
+
+    /** The rendered image.
+     * The image is only updated when rasterizing is enabled. Row zero is the bottom of the window,
+     * the colors are linear-sRGB with pre-multiplied alpha.
+     */
+    [[nodiscard]] pixel_map<sfloat_rgba16> const &image() const noexcept
+    {
+        return _rasterizer.image;
+    }
+
+    [[nodiscard]] vspan<pipeline_flat::vertex> const &flat_vertices() const noexcept
+    {
+        return _flat_vertices.span;
+    }
+
+    [[nodiscard]] vspan<pipeline_box::vertex> const &box_vertices() const noexcept
+    {
+        return _box_vertices.span;
+    }
+
+    [[nodiscard]] vspan<pipeline_image::vertex> const &image_vertices() const noexcept
+    {
+        return _image_vertices.span;
+    }
+
+    [[nodiscard]] vspan<pipeline_SDF::vertex> const &sdf_vertices() const noexcept
+    {
+        return _sdf_vertices.span;
+    }
+
+    /** The number of frames that where rendered on this surface.
+     */
+    [[nodiscard]] size_t frame_count() const noexcept
+    {
+        return _frame_count;
+    }
+
+protected:
+    void teardown() override;
+
+private:
+    /** Storage for a vertex stream.
+     * Like the mapped memory of a Vulkan vertex buffer, this memory is not initialized;
+     * vertices are constructed in place by the vspan.
+     */
+    template<typename T>
+    struct vertex_buffer {
+        std::allocator<T> allocator;
+        T *data;
+        vspan<T> span;
+
+        vertex_buffer() noexcept :
+            allocator(), data(allocator.allocate(maximum_number_of_vertices)), span(data, maximum_number_of_vertices)
+        {
+        }
+
+        ~vertex_buffer()
+        {
+            span.clear();
+            allocator.deallocate(data, maximum_number_of_vertices);
+        }
+
+        vertex_buffer(vertex_buffer const &) = delete;
+        vertex_buffer &operator=(vertex_buffer const &) = delete;
+    };
+
+    bool _rasterize;
+    extent2 _requested_size;
+    size_t _frame_count = 0;
+
+    vertex_buffer<pipeline_flat::vertex> _flat_vertices;
+    vertex_buffer<pipeline_box::vertex> _box_vertices;
+    vertex_buffer<pipeline_image::vertex> _image_vertices;
+    vertex_buffer<pipeline_SDF::vertex> _sdf_vertices;
+
+    software_rasterizer _rasterizer;
+};
+
+} // namespace tt
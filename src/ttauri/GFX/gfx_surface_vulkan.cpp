@@ -326,7 +326,7 @@ std::optional<draw_context> gfx_surface_vulkan::render_start(aarectangle redraw_
     // Update the widgets before the pipelines need their vertices.
     // We unset modified before, so that modification requests are captured.
     return draw_context{
-        *narrow_cast<gfx_device_vulkan *>(_device),
+        *_device,
         narrow_cast<size_t>(frame_buffer_index),
         size,
         scissor_rectangle,
@@ -0,0 +1,38 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "gfx_system_headless.hpp"
+#include "gfx_device_headless.hpp"
+#include "gfx_surface_headless.hpp"
+
+namespace tt {
+
+gfx_system_headless::gfx_system_headless() noexcept : gfx_system() {}
+
+gfx_system_headless::~gfx_system_headless() {}
+
+void gfx_system_headless::init() noexcept
+{
+    ttlet lock = std::scoped_lock(gfx_system_mutex);
+
+    super::init();
+    devices.push_back(std::make_shared<gfx_device_headless>(*this));
+}
+
+[[nodiscard]] std::unique_ptr<gfx_surface>
+gfx_system_headless::make_surface([[maybe_unused]] os_handle instance, [[maybe_unused]] void *os_window) const noexcept
+{
+    return make_surface(extent2{640.0f, 480.0f}, false);
+}
+
+[[nodiscard]] std::unique_ptr<gfx_surface> gfx_system_headless::make_surface(extent2 size, bool rasterize) const noexcept
+{
+    ttlet lock = std::scoped_lock(gfx_system_mutex);
+
+    auto surface = std::make_unique<gfx_surface_headless>(*const_cast<gfx_system_headless *>(this), size, rasterize);
+    surface->init();
+    return surface;
+}
+
+} // namespace tt
@@ -0,0 +1,46 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "gfx_system.hpp"
+#include "../geometry/extent.hpp"
+
+namespace tt {
+
+/** Graphics system without a GPU.
+ *
+ * The headless graphics system has a single `gfx_device_headless`, and
+ * makes `gfx_surface_headless` surfaces. It is used for rendering widgets
+ * in tests and benchmarks on machines without a display or Vulkan driver.
+ */
+class gfx_system_headless final : public gfx_system {
+public:
+    using super = gfx_system;
+
+    gfx_system_headless() noexcept;
+    ~gfx_system_headless();
+
+    gfx_system_headless(const gfx_system_headless &) = delete;
+    gfx_system_headless &operator=(const gfx_system_headless &) = delete;
+    gfx_system_headless(gfx_system_headless &&) = delete;
+    gfx_system_headless &operator=(gfx_system_headless &&) = delete;
+
+    void init() noexcept override;
+
+    /** Make a headless surface.
+     * The operating system handles are ignored, the surface has a default size
+     * which may be changed with `gfx_surface_headless::set_requested_size()`.
+     */
+    [[nodiscard]] std::unique_ptr<gfx_surface> make_surface(os_handle instance, void *os_window) const noexcept override;
+
+    /** Make a headless surface.
+     *
+     * @param size The requested size of the surface in pixels.
+     * @param rasterize When true the surface is drawn into an image by the software rasterizer.
+     */
+    [[nodiscard]] std::unique_ptr<gfx_surface> make_surface(extent2 size, bool rasterize) const noexcept;
+};
+
+} // namespace tt
@@ -14,6 +14,7 @@
 #include "../geometry/scale.hpp"
 #include "../geometry/translate.hpp"
 #include <array>
+#include <utility>
 
 namespace tt::pipeline_SDF {
 
@@ -35,36 +36,37 @@ void device_shared::destroy(gfx_device_vulkan *vulkanDevice)
     teardownAtlas(vulkanDevice);
 }
 
-[[nodiscard]] atlas_rect device_shared::allocateRect(extent2 drawExtent) noexcept
+[[nodiscard]] std::optional<atlas_rect> device_shared::allocateRect(font_glyph_ids const &glyph, extent2 drawExtent) noexcept
 {
-    auto imageWidth = narrow_cast<int>(std::ceil(drawExtent.width()));
-    auto imageHeight = narrow_cast<int>(std::ceil(drawExtent.height()));
-
-    if (atlas_allocation_position.y() + imageHeight > atlasImageHeight) {
-        atlas_allocation_position.x() = 0;
-        atlas_allocation_position.y() = 0;
-        atlas_allocation_position.z() = atlas_allocation_position.z() + 1;
-
-        if (atlas_allocation_position.z() >= atlasMaximumNrImages) {
-            tt_log_fatal("pipeline_SDF atlas overflow, too many glyphs in use.");
+    if (not atlasAllocator.fits_on_page(drawExtent)) {
+        if (not std::exchange(atlasGlyphTooLargeLogged, true)) {
+            tt_log_error(
+                "pipeline_SDF glyph of {}x{} pixels is larger than an atlas image, the glyph is not drawn.",
+                drawExtent.width(),
+                drawExtent.height());
         }
+        return {};
+    }
 
-        if (atlas_allocation_position.z() >= size(atlasTextures)) {
-            addAtlasImage();
+    ttlet eviction_count = atlasAllocator.eviction_count();
+    ttlet item = atlasAllocator.allocate(glyph, drawExtent);
+    if (not item) {
+        if (not std::exchange(atlasFullLogged, true)) {
+            tt_log_error("pipeline_SDF atlas is full, all atlas images are used by the frames in flight; glyphs are not drawn.");
         }
+        return {};
     }
 
-    if (atlas_allocation_position.x() + imageWidth > atlasImageWidth) {
-        atlas_allocation_position.x() = 0;
-        atlas_allocation_position.y() = atlas_allocation_position.y() + atlasAllocationMaxHeight;
+    if (atlasAllocator.eviction_count() != eviction_count) {
+        // A frame of another window may still be sampling the evicted image.
+        device.waitIdle();
     }
 
-    auto r = atlas_rect{atlas_allocation_position, drawExtent};
-
-    atlas_allocation_position.x() = atlas_allocation_position.x() + imageWidth;
-    atlasAllocationMaxHeight = std::max(atlasAllocationMaxHeight, imageHeight);
+    while (atlasAllocator.nr_pages() > size(atlasTextures)) {
+        addAtlasImage();
+    }
 
-    return r;
+    return atlas_rect{item->position, item->size};
 }
 
 void device_shared::uploadStagingPixmapToAtlas(atlas_rect location)
@@ -124,7 +126,7 @@ void device_shared::prepareAtlasForRendering()
  *  |                     |
  *  O---------------------+
  */
-atlas_rect device_shared::addGlyphToAtlas(font_glyph_ids glyph) noexcept
+std::optional<atlas_rect> device_shared::addGlyphToAtlas(font_glyph_ids glyph) noexcept
 {
     ttlet[glyphPath, glyphBoundingBox] = glyph.getPathAndBoundingBox();
 
@@ -145,25 +147,27 @@ atlas_rect device_shared::addGlyphToAtlas(font_glyph_ids glyph) noexcept
 
     // Draw glyphs into staging buffer of the atlas and upload it to the correct position in the atlas.
     ttlet lock = std::scoped_lock(gfx_system_mutex);
+    ttlet atlas_rect = allocateRect(glyph, drawExtent);
+    if (not atlas_rect) {
+        return {};
+    }
+
     prepareStagingPixmapForDrawing();
-    auto atlas_rect = allocateRect(drawExtent);
-    auto pixmap = stagingTexture.pixel_map.submap(aarectangle{atlas_rect.size});
+    auto pixmap = stagingTexture.pixel_map.submap(aarectangle{atlas_rect->size});
     fill(pixmap, drawPath);
-    uploadStagingPixmapToAtlas(atlas_rect);
+    uploadStagingPixmapToAtlas(*atlas_rect);
 
     return atlas_rect;
 }
 
-std::pair<atlas_rect, bool> device_shared::getGlyphFromAtlas(font_glyph_ids glyph) noexcept
+std::pair<std::optional<atlas_rect>, bool> device_shared::getGlyphFromAtlas(font_glyph_ids glyph) noexcept
 {
-    ttlet i = glyphs_in_atlas.find(glyph);
-    if (i != glyphs_in_atlas.cend()) {
-        return {i->second, false};
+    if (ttlet item = atlasAllocator.find(glyph)) {
+        return {atlas_rect{item->position, item->size}, false};
 
     } else {
-        ttlet aarectangle = addGlyphToAtlas(glyph);
-        glyphs_in_atlas.emplace(glyph, aarectangle);
-        return {aarectangle, true};
+        ttlet atlas_rect = addGlyphToAtlas(glyph);
+        return {atlas_rect, atlas_rect.has_value()};
     }
 }
 
@@ -188,15 +192,15 @@ bool device_shared::_place_vertices(
     ttlet p3 = get<3>(box);
 
     // If none of the vertices is inside the clipping rectangle then don't add the
-    // quad to the vertex list.
-    if (!overlaps(clipping_rectangle, aarectangle{box})) {
+    // quad to the vertex list. Also skip glyphs that did not fit in the atlas.
+    if (!atlas_rect or !overlaps(clipping_rectangle, aarectangle{box})) {
         return glyph_was_added;
     }
 
-    vertices.emplace_back(p0, clipping_rectangle, get<0>(atlas_rect.texture_coordinates), color);
-    vertices.emplace_back(p1, clipping_rectangle, get<1>(atlas_rect.texture_coordinates), color);
-    vertices.emplace_back(p2, clipping_rectangle, get<2>(atlas_rect.texture_coordinates), color);
-    vertices.emplace_back(p3, clipping_rectangle, get<3>(atlas_rect.texture_coordinates), color);
+    vertices.emplace_back(p0, clipping_rectangle, get<0>(atlas_rect->texture_coordinates), color);
+    vertices.emplace_back(p1, clipping_rectangle, get<1>(atlas_rect->texture_coordinates), color);
+    vertices.emplace_back(p2, clipping_rectangle, get<2>(atlas_rect->texture_coordinates), color);
+    vertices.emplace_back(p3, clipping_rectangle, get<3>(atlas_rect->texture_coordinates), color);
     return glyph_was_added;
 }
 
@@ -281,6 +285,7 @@ void device_shared::place_vertices(
 void device_shared::drawInCommandBuffer(vk::CommandBuffer &commandBuffer)
 {
     commandBuffer.bindIndexBuffer(device.quadIndexBuffer, 0, vk::IndexType::eUint16);
+    atlasAllocator.next_frame();
 }
 
 void device_shared::buildShaders()
@@ -7,6 +7,7 @@
 #include "pipeline_SDF_texture_map.hpp"
 #include "pipeline_SDF_atlas_rect.hpp"
 #include "pipeline_SDF_specialization_constants.hpp"
+#include "atlas_allocator.hpp"
 #include "../text/font_glyph_ids.hpp"
 #include "../required.hpp"
 #include "../logger.hpp"
@@ -15,7 +16,7 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.hpp>
 #include <mutex>
-#include <unordered_map>
+#include <optional>
 
 namespace tt {
 class gfx_device_vulkan;
@@ -42,6 +43,11 @@ struct device_shared final {
     static_assert(atlasImageWidth == atlasImageHeight, "needed for fwidth(textureCoord)");
 
     static constexpr int atlasMaximumNrImages = 16; // 16 * 512 characters, of 64x64 pixels.
+
+    // The number of frames after which an atlas image that is no longer drawn may be evicted.
+    // The frame counter advances for every window that is drawn, so with multiple windows this
+    // does not bound the frames on the GPU; the device is waited on before an evicted image is reused.
+    static constexpr int atlasFramesInFlight = 3;
     static constexpr int stagingImageWidth = 128; // maximum size of character that can be uploaded is 128x128
     static constexpr int stagingImageHeight = 128;
 
@@ -60,7 +66,13 @@ struct device_shared final {
     vk::SpecializationInfo fragmentShaderSpecializationInfo;
     std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
 
-    std::unordered_map<font_glyph_ids, atlas_rect> glyphs_in_atlas;
+    atlas_allocator<font_glyph_ids> atlasAllocator = {
+        atlasImageWidth,
+        atlasImageHeight,
+        atlasMaximumNrImages,
+        atlasFramesInFlight};
+    bool atlasGlyphTooLargeLogged = false;
+    bool atlasFullLogged = false;
     texture_map stagingTexture;
     std::vector<texture_map> atlasTextures;
 
@@ -68,10 +80,6 @@ struct device_shared final {
     vk::Sampler atlasSampler;
     vk::DescriptorImageInfo atlasSamplerDescriptorImageInfo;
 
-    point3 atlas_allocation_position = {};
-    /// During allocation on a row, we keep track of the tallest glyph.
-    int atlasAllocationMaxHeight = 0;
-
     device_shared(gfx_device_vulkan const &device);
     ~device_shared();
 
@@ -87,10 +95,18 @@ struct device_shared final {
     void destroy(gfx_device_vulkan *vulkanDevice);
 
     /** Allocate an glyph in the atlas.
-     * This may allocate an atlas texture, up to atlasMaximumNrImages.
+     * This may allocate an atlas texture, up to atlasMaximumNrImages. When all atlas textures
+     * are full, the least recently used texture is evicted and reused after the device is idle.
+     *
+     * @return The location in the atlas, or empty when the glyph is larger than an atlas texture
+     *         or when all atlas textures are in use by the frames in flight.
      */
-    [[nodiscard]] atlas_rect allocateRect(extent2 drawExtent) noexcept;
+    [[nodiscard]] std::optional<atlas_rect> allocateRect(font_glyph_ids const &glyph, extent2 drawExtent) noexcept;
 
+    /** Draw the glyphs in the command buffer.
+     * This ends the frame of the atlas allocator, glyphs that are not used in the next
+     * frame may be evicted from the atlas.
+     */
     void drawInCommandBuffer(vk::CommandBuffer &commandBuffer);
 
     /** Once drawing in the staging pixmap is completed, you can upload it to the atlas.
@@ -204,12 +220,12 @@ private:
         attributed_glyph const &attr_glyph,
         color color) noexcept;
 
-    atlas_rect addGlyphToAtlas(font_glyph_ids glyph) noexcept;
+    std::optional<atlas_rect> addGlyphToAtlas(font_glyph_ids glyph) noexcept;
 
     /**
-     * @return The Atlas rectangle and true if a new glyph was added to the atlas.
+     * @return The Atlas rectangle, empty if the glyph does not fit in the atlas, and true if a new glyph was added to the atlas.
      */
-    std::pair<atlas_rect, bool> getGlyphFromAtlas(font_glyph_ids glyph) noexcept;
+    std::pair<std::optional<atlas_rect>, bool> getGlyphFromAtlas(font_glyph_ids glyph) noexcept;
 };
 
 } // namespace tt::pipeline_SDF
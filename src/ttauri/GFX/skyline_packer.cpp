@@ -0,0 +1,124 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "skyline_packer.hpp"
+#include "../assert.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace tt {
+
+skyline_packer::skyline_packer(int width, int height) noexcept : _width(width), _height(height), _used_area(0), _skyline()
+{
+    tt_axiom(width > 0 and height > 0);
+    clear();
+}
+
+void skyline_packer::clear() noexcept
+{
+    _used_area = 0;
+    _skyline.clear();
+    _skyline.push_back({0, 0, _width});
+}
+
+[[nodiscard]] std::optional<int> skyline_packer::fit(size_t index, int width, int height) const noexcept
+{
+    if (_skyline[index].x + width > _width) {
+        return {};
+    }
+
+    auto y = 0;
+    auto width_left = width;
+    for (auto i = index; width_left > 0; ++i) {
+        tt_axiom(i < _skyline.size());
+        y = std::max(y, _skyline[i].y);
+        if (y + height > _height) {
+            return {};
+        }
+        width_left -= _skyline[i].width;
+    }
+    return y;
+}
+
+[[nodiscard]] size_t skyline_packer::waste(size_t index, int width, int y) const noexcept
+{
+    auto r = size_t{0};
+    auto width_left = width;
+    for (auto i = index; width_left > 0; ++i) {
+        ttlet covered_width = std::min(width_left, _skyline[i].width);
+        r += static_cast<size_t>(covered_width) * static_cast<size_t>(y - _skyline[i].y);
+        width_left -= covered_width;
+    }
+    return r;
+}
+
+void skyline_packer::insert(size_t index, int width, int height, int y) noexcept
+{
+    ttlet x = _skyline[index].x;
+    ttlet right = x + width;
+
+    _skyline.insert(_skyline.begin() + index, segment_type{x, y + height, width});
+
+    // Shrink or remove the segments that are now below the new segment.
+    auto i = index + 1;
+    while (i < _skyline.size() and _skyline[i].x < right) {
+        auto &segment = _skyline[i];
+        ttlet shrink = right - segment.x;
+        if (shrink >= segment.width) {
+            _skyline.erase(_skyline.begin() + i);
+        } else {
+            segment.x += shrink;
+            segment.width -= shrink;
+            break;
+        }
+    }
+
+    // Merge neighboring segments at the same height.
+    for (auto j = index == 0 ? 1 : index; j < _skyline.size() and j <= index + 1;) {
+        if (_skyline[j - 1].y == _skyline[j].y) {
+            _skyline[j - 1].width += _skyline[j].width;
+            _skyline.erase(_skyline.begin() + j);
+        } else {
+            ++j;
+        }
+    }
+}
+
+[[nodiscard]] std::optional<point2> skyline_packer::allocate(int width, int height) noexcept
+{
+    tt_axiom(width > 0 and height > 0);
+
+    auto best_index = _skyline.size();
+    auto best_y = 0;
+    auto best_top = std::numeric_limits<int>::max();
+    auto best_waste = std::numeric_limits<size_t>::max();
+
+    for (auto i = size_t{0}; i != _skyline.size(); ++i) {
+        if (ttlet y = fit(i, width, height)) {
+            ttlet top = *y + height;
+            if (top > best_top) {
+                continue;
+            }
+
+            ttlet w = waste(i, width, *y);
+            if (top < best_top or w < best_waste) {
+                best_index = i;
+                best_y = *y;
+                best_top = top;
+                best_waste = w;
+            }
+        }
+    }
+
+    if (best_index == _skyline.size()) {
+        return {};
+    }
+
+    ttlet position = point2{static_cast<float>(_skyline[best_index].x), static_cast<float>(best_y)};
+    insert(best_index, width, height, best_y);
+    _used_area += static_cast<size_t>(width) * static_cast<size_t>(height);
+    return position;
+}
+
+} // namespace tt
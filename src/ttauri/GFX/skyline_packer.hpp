@@ -0,0 +1,101 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "../geometry/point.hpp"
+#include <vector>
+#include <optional>
+#include <cstddef>
+
+namespace tt {
+
+/** A skyline bin-packer for a single image.
+ *
+ * The packer keeps track of the top edge of the allocated rectangles as a list
+ * of horizontal segments; the skyline. A new rectangle is placed on top of the
+ * skyline at the position where its top edge ends up the lowest, ties are broken
+ * by the least amount of area that becomes unusable below the rectangle.
+ *
+ * Unlike a row allocator the height difference between neighboring rectangles
+ * is not lost, which makes a big difference for glyphs of mixed sizes.
+ * Individual rectangles can not be freed, only the whole image can be cleared.
+ */
+class skyline_packer {
+public:
+    skyline_packer(int width, int height) noexcept;
+
+    skyline_packer(skyline_packer const &) noexcept = default;
+    skyline_packer(skyline_packer &&) noexcept = default;
+    skyline_packer &operator=(skyline_packer const &) noexcept = default;
+    skyline_packer &operator=(skyline_packer &&) noexcept = default;
+
+    [[nodiscard]] int width() const noexcept
+    {
+        return _width;
+    }
+
+    [[nodiscard]] int height() const noexcept
+    {
+        return _height;
+    }
+
+    /** The total area of the allocated rectangles.
+     */
+    [[nodiscard]] size_t used_area() const noexcept
+    {
+        return _used_area;
+    }
+
+    /** The fraction of the image that is covered by allocated rectangles.
+     */
+    [[nodiscard]] float occupancy() const noexcept
+    {
+        return static_cast<float>(_used_area) / (static_cast<float>(_width) * static_cast<float>(_height));
+    }
+
+    /** Allocate a rectangle.
+     *
+     * @param width The width of the rectangle in pixels, larger than zero.
+     * @param height The height of the rectangle in pixels, larger than zero.
+     * @return The position of the bottom-left corner of the rectangle, or empty when the rectangle does not fit.
+     */
+    [[nodiscard]] std::optional<point2> allocate(int width, int height) noexcept;
+
+    /** Free all the rectangles.
+     */
+    void clear() noexcept;
+
+private:
+    struct segment_type {
+        int x;
+        int y;
+        int width;
+    };
+
+    int _width;
+    int _height;
+    size_t _used_area;
+
+    /** Segments ordered from left to right, covering the full width of the image.
+     */
+    std::vector<segment_type> _skyline;
+
+    /** Find the bottom of a rectangle placed with its left edge at the start of a segment.
+     *
+     * @param index The index of the segment.
+     * @param width The width of the rectangle.
+     * @param height The height of the rectangle.
+     * @return The y-coordinate of the bottom of the rectangle, or empty if it does not fit.
+     */
+    [[nodiscard]] std::optional<int> fit(size_t index, int width, int height) const noexcept;
+
+    /** The area below a rectangle that can no longer be allocated.
+     */
+    [[nodiscard]] size_t waste(size_t index, int width, int y) const noexcept;
+
+    void insert(size_t index, int width, int height, int y) noexcept;
+};
+
+} // namespace tt
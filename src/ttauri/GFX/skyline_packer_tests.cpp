@@ -0,0 +1,114 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/GFX/skyline_packer.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace tt;
+
+namespace {
+
+struct packed_rectangle {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+[[nodiscard]] bool overlaps(packed_rectangle const &lhs, packed_rectangle const &rhs) noexcept
+{
+    return lhs.x < rhs.x + rhs.width and rhs.x < lhs.x + lhs.width and lhs.y < rhs.y + rhs.height and
+        rhs.y < lhs.y + lhs.height;
+}
+
+} // namespace
+
+TEST(skyline_packer, allocate_bottom_left)
+{
+    auto packer = skyline_packer{100, 100};
+
+    ttlet a = packer.allocate(30, 20);
+    ASSERT_TRUE(a);
+    ASSERT_EQ(*a, point2(0.0f, 0.0f));
+
+    ttlet b = packer.allocate(30, 10);
+    ASSERT_TRUE(b);
+    ASSERT_EQ(*b, point2(30.0f, 0.0f));
+
+    // Does not fit next to the others, is placed on top of the lowest rectangle.
+    ttlet c = packer.allocate(50, 10);
+    ASSERT_TRUE(c);
+    ASSERT_EQ(*c, point2(30.0f, 10.0f));
+
+    ASSERT_EQ(packer.used_area(), 30 * 20 + 30 * 10 + 50 * 10);
+}
+
+TEST(skyline_packer, full)
+{
+    auto packer = skyline_packer{64, 64};
+
+    for (auto i = 0; i != 16; ++i) {
+        ASSERT_TRUE(packer.allocate(16, 16));
+    }
+    ASSERT_FLOAT_EQ(packer.occupancy(), 1.0f);
+    ASSERT_FALSE(packer.allocate(1, 1));
+
+    packer.clear();
+    ASSERT_EQ(packer.used_area(), 0);
+    ttlet a = packer.allocate(64, 64);
+    ASSERT_TRUE(a);
+    ASSERT_EQ(*a, point2(0.0f, 0.0f));
+}
+
+TEST(skyline_packer, too_large)
+{
+    auto packer = skyline_packer{64, 64};
+    ASSERT_FALSE(packer.allocate(65, 1));
+    ASSERT_FALSE(packer.allocate(1, 65));
+    ASSERT_TRUE(packer.allocate(64, 64));
+}
+
+/** Packing efficiency with glyph sized rectangles.
+ * The glyphs of a SDF atlas at 28 pixels/em including the draw border are between
+ * about 10 and 45 pixels in size. The previous row allocator reached about 70% occupancy
+ * on this distribution.
+ */
+TEST(skyline_packer, efficiency)
+{
+    auto packer = skyline_packer{1024, 1024};
+
+    auto engine = std::mt19937{42};
+    auto width_distribution = std::uniform_int_distribution<int>{10, 40};
+    auto height_distribution = std::uniform_int_distribution<int>{20, 45};
+
+    auto rectangles = std::vector<packed_rectangle>{};
+    auto nr_failures = 0;
+    while (nr_failures < 100) {
+        ttlet width = width_distribution(engine);
+        ttlet height = height_distribution(engine);
+
+        if (ttlet position = packer.allocate(width, height)) {
+            rectangles.push_back({static_cast<int>(position->x()), static_cast<int>(position->y()), width, height});
+        } else {
+            ++nr_failures;
+        }
+    }
+
+    for (auto i = 0_uz; i != rectangles.size(); ++i) {
+        ttlet &a = rectangles[i];
+        ASSERT_GE(a.x, 0);
+        ASSERT_GE(a.y, 0);
+        ASSERT_LE(a.x + a.width, 1024);
+        ASSERT_LE(a.y + a.height, 1024);
+
+        for (auto j = i + 1; j != rectangles.size(); ++j) {
+            ASSERT_FALSE(overlaps(a, rectangles[j]));
+        }
+    }
+
+    ASSERT_GT(packer.occupancy(), 0.85f);
+}
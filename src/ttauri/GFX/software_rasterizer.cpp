@@ -0,0 +1,517 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "software_rasterizer.hpp"
+#include "../cast.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace tt {
+namespace detail {
+
+/** A triangle in window coordinates, used to calculate barycentric weights of fragments.
+ */
+struct software_triangle {
+    f32x4 p0;
+    f32x4 p1;
+    f32x4 p2;
+    float rcp_area;
+
+    software_triangle(f32x4 p0, f32x4 p1, f32x4 p2) noexcept :
+        p0(p0), p1(p1), p2(p2), rcp_area(1.0f / cross_2D(p1 - p0, p2 - p0))
+    {
+    }
+
+    [[nodiscard]] bool is_degenerate() const noexcept
+    {
+        return !std::isfinite(rcp_area);
+    }
+
+    /** Calculate the barycentric weights of a point.
+     * @return The weight of p0, p1 and p2 in x, y and z.
+     */
+    [[nodiscard]] f32x4 weights(f32x4 p) const noexcept
+    {
+        return f32x4{cross_2D(p2 - p1, p - p1), cross_2D(p0 - p2, p - p2), cross_2D(p1 - p0, p - p0), 0.0f} * rcp_area;
+    }
+
+    /** The change of the barycentric weights when moving one pixel to the right.
+     */
+    [[nodiscard]] f32x4 dx_weights() const noexcept
+    {
+        return f32x4{p1.y() - p2.y(), p2.y() - p0.y(), p0.y() - p1.y(), 0.0f} * rcp_area;
+    }
+
+    /** Check if the fragment on an edge belongs to this triangle.
+     * The top-left rule makes sure that a fragment exactly on the shared edge of
+     * the two triangles of a quad is drawn only once.
+     */
+    [[nodiscard]] bool owns_edge(f32x4 a, f32x4 b) const noexcept
+    {
+        auto d = b - a;
+        if (rcp_area < 0.0f) {
+            d = -d;
+        }
+        return d.y() > 0.0f || (d.y() == 0.0f && d.x() < 0.0f);
+    }
+
+    [[nodiscard]] bool contains(f32x4 w) const noexcept
+    {
+        return (w.x() > 0.0f || (w.x() == 0.0f && owns_edge(p1, p2))) &&
+            (w.y() > 0.0f || (w.y() == 0.0f && owns_edge(p2, p0))) &&
+            (w.z() > 0.0f || (w.z() == 0.0f && owns_edge(p0, p1)));
+    }
+
+    [[nodiscard]] aarectangle bounding_rectangle() const noexcept
+    {
+        ttlet lo = min(min(p0, p1), p2);
+        ttlet hi = max(max(p0, p1), p2);
+        return aarectangle{point2{lo.x(), lo.y()}, point2{hi.x(), hi.y()}};
+    }
+};
+
+/** Call a function for each fragment of a triangle.
+ *
+ * @param image_rectangle The rectangle of the image clipped by the scissor rectangle.
+ * @param triangle The triangle to rasterize.
+ * @param func The function to call for each fragment: `func(x, y, weights)`.
+ */
+template<typename Func>
+void for_each_fragment(aarectangle image_rectangle, software_triangle const &triangle, Func const &func) noexcept
+{
+    if (triangle.is_degenerate()) {
+        return;
+    }
+
+    ttlet r = intersect(image_rectangle, triangle.bounding_rectangle());
+    if (!r) {
+        return;
+    }
+
+    ttlet x_begin = narrow_cast<ssize_t>(std::floor(r.left()));
+    ttlet x_end = narrow_cast<ssize_t>(std::ceil(r.right()));
+    ttlet y_begin = narrow_cast<ssize_t>(std::floor(r.bottom()));
+    ttlet y_end = narrow_cast<ssize_t>(std::ceil(r.top()));
+
+    for (ssize_t y = y_begin; y != y_end; ++y) {
+        for (ssize_t x = x_begin; x != x_end; ++x) {
+            ttlet frag_coord = f32x4{narrow_cast<float>(x) + 0.5f, narrow_cast<float>(y) + 0.5f, 0.0f, 1.0f};
+            ttlet w = triangle.weights(frag_coord);
+            if (triangle.contains(w)) {
+                func(x, y, frag_coord, w);
+            }
+        }
+    }
+}
+
+template<typename T>
+[[nodiscard]] T interpolate(f32x4 w, T const &a, T const &b, T const &c) noexcept
+{
+    return a * w.x() + b * w.y() + c * w.z();
+}
+
+/** Check if a fragment is inside the clipping rectangle of a vertex.
+ * @param clipping_rectangle left-bottom in (x, y), right-top in (z, w).
+ */
+[[nodiscard]] bool is_clipped(f32x4 clipping_rectangle, f32x4 frag_coord) noexcept
+{
+    return ge(frag_coord.xyxy(), clipping_rectangle) != 0b0011;
+}
+
+/** Depth test a fragment.
+ * Like the Vulkan pipelines the fragment passes when its elevation is greater or
+ * equal to the elevation in the depth buffer, the depth buffer is updated on pass.
+ */
+[[nodiscard]] bool depth_test(pixel_map<float> &depth, ssize_t x, ssize_t y, float z) noexcept
+{
+    auto &d = depth[y][x];
+    if (z >= d) {
+        d = z;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/** Blend a pre-multiplied-alpha color over a pixel.
+ */
+void blend(sfloat_rgba16 &pixel, f32x4 over) noexcept
+{
+    ttlet under = static_cast<f32x4>(pixel);
+    pixel = over + under * (1.0f - over.w());
+}
+
+constexpr float Kr = 0.2126f;
+constexpr float Kg = 0.7152f;
+constexpr float Kb = 0.0722f;
+constexpr float Ku = Kb / Kg;
+constexpr float Kv = Kr / Kg;
+
+/** Convert linear-rgb to tluv, see utils.glsl.
+ */
+[[nodiscard]] f32x4 rgb_to_tluv(f32x4 rgb) noexcept
+{
+    ttlet Y = Kr * rgb.x() + Kg * rgb.y() + Kb * rgb.z();
+    return f32x4{std::sqrt(std::max(Y, 0.0f)), rgb.z() - Y, rgb.x() - Y, rgb.w()};
+}
+
+[[nodiscard]] float tYUV_to_R(f32x4 yuv) noexcept
+{
+    return yuv.z() + yuv.x();
+}
+
+[[nodiscard]] float tYUV_to_G(f32x4 yuv) noexcept
+{
+    return yuv.x() - yuv.y() * Ku - yuv.z() * Kv;
+}
+
+[[nodiscard]] float tYUV_to_B(f32x4 yuv) noexcept
+{
+    return yuv.y() + yuv.x();
+}
+
+[[nodiscard]] f32x4 tluv_to_tYUV(f32x4 luv) noexcept
+{
+    return f32x4{luv.x() * luv.x(), luv.y(), luv.z(), luv.w()};
+}
+
+/** Convert a subpixel-triplet of tluv values to a single opaque linear-rgb value, see utils.glsl.
+ */
+[[nodiscard]] f32x4 tluv_to_rgb(f32x4 sub_R, f32x4 sub_G, f32x4 sub_B) noexcept
+{
+    return f32x4{tYUV_to_R(tluv_to_tYUV(sub_R)), tYUV_to_G(tluv_to_tYUV(sub_G)), tYUV_to_B(tluv_to_tYUV(sub_B)), 1.0f};
+}
+
+[[nodiscard]] f32x4 tluv_to_rgb(f32x4 luv) noexcept
+{
+    return tluv_to_rgb(luv, luv, luv);
+}
+
+[[nodiscard]] f32x4 mix(f32x4 a, f32x4 b, float t) noexcept
+{
+    return a + (b - a) * t;
+}
+
+/** Sample the SDF atlas with bi-linear interpolation and clamp-to-edge addressing.
+ * @return The normalized distance, between -1.0 and 1.0, like a R8Snorm texture.
+ */
+[[nodiscard]] float sample(pixel_map<sdf_r8> const &image, float u, float v) noexcept
+{
+    ttlet tx = u * narrow_cast<float>(image.width()) - 0.5f;
+    ttlet ty = v * narrow_cast<float>(image.height()) - 0.5f;
+    ttlet x0f = std::floor(tx);
+    ttlet y0f = std::floor(ty);
+    ttlet fx = tx - x0f;
+    ttlet fy = ty - y0f;
+
+    ttlet x0 = std::clamp(narrow_cast<ssize_t>(x0f), ssize_t{0}, image.width() - 1);
+    ttlet x1 = std::clamp(narrow_cast<ssize_t>(x0f) + 1, ssize_t{0}, image.width() - 1);
+    ttlet y0 = std::clamp(narrow_cast<ssize_t>(y0f), ssize_t{0}, image.height() - 1);
+    ttlet y1 = std::clamp(narrow_cast<ssize_t>(y0f) + 1, ssize_t{0}, image.height() - 1);
+
+    ttlet row0 = image[y0];
+    ttlet row1 = image[y1];
+    ttlet s00 = static_cast<float>(row0[x0]);
+    ttlet s01 = static_cast<float>(row0[x1]);
+    ttlet s10 = static_cast<float>(row1[x0]);
+    ttlet s11 = static_cast<float>(row1[x1]);
+
+    ttlet s0 = s00 + (s01 - s00) * fx;
+    ttlet s1 = s10 + (s11 - s10) * fx;
+    return (s0 + (s1 - s0) * fy) * sdf_r8::one_over_max_distance;
+}
+
+/** Get the red and blue subpixel offsets, see pipeline_SDF.frag.
+ * @return The red subpixel offset in (x,y), the blue subpixel offset in (z,w)
+ */
+[[nodiscard]] f32x4 get_red_blue_subpixel_offset(subpixel_orientation orientation, f32x4 texture_stride) noexcept
+{
+    constexpr float third = 1.0f / 3.0f;
+
+    switch (orientation) {
+    case subpixel_orientation::BlueRight: return texture_stride.xyxy() * f32x4{-third, -third, third, third};
+    case subpixel_orientation::BlueLeft: return texture_stride.xyxy() * f32x4{third, third, -third, -third};
+    case subpixel_orientation::BlueTop: return texture_stride.zwzw() * f32x4{-third, -third, third, third};
+    case subpixel_orientation::BlueBottom: return texture_stride.zwzw() * f32x4{third, third, -third, -third};
+    default: return f32x4{};
+    }
+}
+
+/** Calculate the distance of a fragment to the edge of a box, see pipeline_box.frag.
+ *
+ * @param corner_coordinates The interpolated distance from the left, bottom, right and top edges.
+ * @param corner_radii The radius of the left-bottom, right-bottom, left-top and right-top corners.
+ * @param corner_shapes The shape of each corner: 0 = square, 1 = rounded, 2 = cut.
+ */
+[[nodiscard]] float box_distance(f32x4 corner_coordinates, f32x4 corner_radii, std::array<int, 4> corner_shapes) noexcept
+{
+    ttlet distance_x = std::min(corner_coordinates.x(), corner_coordinates.z());
+    ttlet distance_y = std::min(corner_coordinates.y(), corner_coordinates.w());
+
+    auto corner_distance = [&](float radius, int shape) {
+        switch (shape) {
+        case 1: {
+            ttlet x = radius - distance_x;
+            ttlet y = radius - distance_y;
+            return radius - std::sqrt(x * x + y * y);
+        }
+        case 2: return distance_x + distance_y - radius;
+        default: return std::min(distance_x, distance_y);
+        }
+    };
+
+    auto inside = [](float a, float b, float radius) {
+        return a < radius && b < radius;
+    };
+
+    if (inside(corner_coordinates.x(), corner_coordinates.y(), corner_radii.x())) {
+        return corner_distance(corner_radii.x(), corner_shapes[0]);
+    } else if (inside(corner_coordinates.z(), corner_coordinates.y(), corner_radii.y())) {
+        return corner_distance(corner_radii.y(), corner_shapes[1]);
+    } else if (inside(corner_coordinates.x(), corner_coordinates.w(), corner_radii.z())) {
+        return corner_distance(corner_radii.z(), corner_shapes[2]);
+    } else if (inside(corner_coordinates.z(), corner_coordinates.w(), corner_radii.w())) {
+        return corner_distance(corner_radii.w(), corner_shapes[3]);
+    } else {
+        return std::min(distance_x, distance_y);
+    }
+}
+
+[[nodiscard]] int box_corner_shape(float radius_and_shape) noexcept
+{
+    return radius_and_shape > 0.1f ? 1 : radius_and_shape < -0.1f ? 2 : 0;
+}
+
+} // namespace detail
+
+software_rasterizer::software_rasterizer(ssize_t width, ssize_t height) noexcept : image(width, height), depth(width, height)
+{
+    clear(aarectangle{image.extent()}, color::transparent());
+}
+
+void software_rasterizer::clear(aarectangle clear_rectangle, color background_color) noexcept
+{
+    ttlet image_rectangle = intersect(clear_rectangle, aarectangle{image.extent()});
+    if (!image_rectangle) {
+        return;
+    }
+
+    ttlet background_pixel = sfloat_rgba16{background_color};
+    auto image_submap = image.submap(image_rectangle);
+    auto depth_submap = depth.submap(image_rectangle);
+    for (ssize_t y = 0; y != image_submap.height(); ++y) {
+        auto image_row = image_submap[y];
+        auto depth_row = depth_submap[y];
+        for (ssize_t x = 0; x != image_submap.width(); ++x) {
+            image_row[x] = background_pixel;
+            depth_row[x] = -std::numeric_limits<float>::infinity();
+        }
+    }
+}
+
+void software_rasterizer::draw(aarectangle scissor_rectangle, vspan<pipeline_flat::vertex> const &vertices) noexcept
+{
+    ttlet image_rectangle = intersect(scissor_rectangle, aarectangle{image.extent()});
+
+    for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+        ttlet &v0 = vertices[i + 0];
+        ttlet &v1 = vertices[i + 1];
+        ttlet &v2 = vertices[i + 2];
+        ttlet &v3 = vertices[i + 3];
+
+        // All vertices of a quad share the flat attributes.
+        ttlet clipping_rectangle = static_cast<f32x4>(v0.clipping_rectangle);
+        auto fill_color = static_cast<f32x4>(v0.color);
+        fill_color = fill_color.xyz1() * fill_color.wwww();
+
+        auto shade = [&](detail::software_triangle const &triangle, f32x4 z) {
+            detail::for_each_fragment(image_rectangle, triangle, [&](ssize_t x, ssize_t y, f32x4 frag_coord, f32x4 w) {
+                if (detail::is_clipped(clipping_rectangle, frag_coord)) {
+                    return;
+                }
+                if (!detail::depth_test(depth, x, y, dot<0b0111>(w, z))) {
+                    return;
+                }
+                detail::blend(image[y][x], fill_color);
+            });
+        };
+
+        ttlet p0 = static_cast<f32x4>(v0.position);
+        ttlet p1 = static_cast<f32x4>(v1.position);
+        ttlet p2 = static_cast<f32x4>(v2.position);
+        ttlet p3 = static_cast<f32x4>(v3.position);
+        shade(detail::software_triangle{p0, p1, p2}, f32x4{p0.z(), p1.z(), p2.z(), 0.0f});
+        shade(detail::software_triangle{p2, p1, p3}, f32x4{p2.z(), p1.z(), p3.z(), 0.0f});
+    }
+}
+
+void software_rasterizer::draw(aarectangle scissor_rectangle, vspan<pipeline_box::vertex> const &vertices) noexcept
+{
+    ttlet image_rectangle = intersect(scissor_rectangle, aarectangle{image.extent()});
+
+    for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+        ttlet &v0 = vertices[i + 0];
+        ttlet &v1 = vertices[i + 1];
+        ttlet &v2 = vertices[i + 2];
+        ttlet &v3 = vertices[i + 3];
+
+        // Calculate the flat attributes the same way as pipeline_box.vert.
+        ttlet border_start = 1.0f;
+        ttlet border_middle = border_start + v0.line_width * 0.5f;
+        ttlet border_end = border_start + v0.line_width;
+
+        ttlet clipping_rectangle = static_cast<f32x4>(v0.clipping_rectangle);
+        auto fill_color = static_cast<f32x4>(v0.fill_color);
+        fill_color = fill_color.xyz1() * fill_color.wwww();
+        auto line_color = static_cast<f32x4>(v0.line_color);
+        line_color = line_color.xyz1() * line_color.wwww();
+
+        ttlet corner_radii_and_shapes = static_cast<f32x4>(v0.corner_shapes);
+        ttlet corner_shapes = std::array<int, 4>{
+            detail::box_corner_shape(corner_radii_and_shapes.x()),
+            detail::box_corner_shape(corner_radii_and_shapes.y()),
+            detail::box_corner_shape(corner_radii_and_shapes.z()),
+            detail::box_corner_shape(corner_radii_and_shapes.w())};
+        ttlet corner_radii = abs(corner_radii_and_shapes) + border_middle;
+
+        auto shade = [&](detail::software_triangle const &triangle,
+                         f32x4 z,
+                         pipeline_box::vertex const &a,
+                         pipeline_box::vertex const &b,
+                         pipeline_box::vertex const &c) {
+            ttlet ca = static_cast<f32x4>(a.corner_coordinate);
+            ttlet cb = static_cast<f32x4>(b.corner_coordinate);
+            ttlet cc = static_cast<f32x4>(c.corner_coordinate);
+
+            detail::for_each_fragment(image_rectangle, triangle, [&](ssize_t x, ssize_t y, f32x4 frag_coord, f32x4 w) {
+                if (detail::is_clipped(clipping_rectangle, frag_coord)) {
+                    return;
+                }
+
+                ttlet corner_coordinates = detail::interpolate(w, ca, cb, cc);
+                ttlet distance = detail::box_distance(corner_coordinates, corner_radii, corner_shapes);
+
+                ttlet background = std::clamp(distance - border_end + 0.5f, 0.0f, 1.0f);
+                if (background == 1.0f && fill_color.w() == 0.0f) {
+                    return;
+                }
+
+                if (!detail::depth_test(depth, x, y, dot<0b0111>(w, z))) {
+                    return;
+                }
+
+                ttlet border = std::clamp(distance - border_start + 0.5f, 0.0f, 1.0f);
+                detail::blend(image[y][x], fill_color * background + line_color * border * (1.0f - background));
+            });
+        };
+
+        ttlet p0 = static_cast<f32x4>(v0.position);
+        ttlet p1 = static_cast<f32x4>(v1.position);
+        ttlet p2 = static_cast<f32x4>(v2.position);
+        ttlet p3 = static_cast<f32x4>(v3.position);
+        shade(detail::software_triangle{p0, p1, p2}, f32x4{p0.z(), p1.z(), p2.z(), 0.0f}, v0, v1, v2);
+        shade(detail::software_triangle{p2, p1, p3}, f32x4{p2.z(), p1.z(), p3.z(), 0.0f}, v2, v1, v3);
+    }
+}
+
+void software_rasterizer::draw(
+    aarectangle scissor_rectangle,
+    vspan<pipeline_SDF::vertex> const &vertices,
+    std::vector<pixel_map<sdf_r8>> const &atlas,
+    tt::subpixel_orientation subpixel_orientation) noexcept
+{
+    ttlet image_rectangle = intersect(scissor_rectangle, aarectangle{image.extent()});
+
+    for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+        ttlet &v0 = vertices[i + 0];
+        ttlet &v1 = vertices[i + 1];
+        ttlet &v2 = vertices[i + 2];
+        ttlet &v3 = vertices[i + 3];
+
+        ttlet clipping_rectangle = static_cast<f32x4>(v0.clippingRectangle);
+        ttlet color_luv = detail::rgb_to_tluv(static_cast<f32x4>(v0.color));
+
+        ttlet atlas_index = narrow_cast<size_t>(static_cast<f32x4>(v0.textureCoord).z());
+        if (atlas_index >= atlas.size()) {
+            continue;
+        }
+        ttlet &atlas_image = atlas[atlas_index];
+        ttlet atlas_width = narrow_cast<float>(atlas_image.width());
+
+        auto shade = [&](detail::software_triangle const &triangle,
+                         f32x4 z,
+                         pipeline_SDF::vertex const &a,
+                         pipeline_SDF::vertex const &b,
+                         pipeline_SDF::vertex const &c) {
+            ttlet ta = static_cast<f32x4>(a.textureCoord);
+            ttlet tb = static_cast<f32x4>(b.textureCoord);
+            ttlet tc = static_cast<f32x4>(c.textureCoord);
+
+            // The texture stride is constant over a triangle; calculated the same as dFdxCoarse().
+            ttlet horizontal_texture_stride = detail::interpolate(triangle.dx_weights(), ta, tb, tc);
+            ttlet texture_stride = f32x4{
+                horizontal_texture_stride.x(),
+                horizontal_texture_stride.y(),
+                -horizontal_texture_stride.y(),
+                horizontal_texture_stride.x()};
+
+            ttlet pixel_distance = hypot<0b0011>(texture_stride);
+            ttlet distance_multiplier = sdf_r8::max_distance / (pixel_distance * atlas_width);
+
+            detail::for_each_fragment(image_rectangle, triangle, [&](ssize_t x, ssize_t y, f32x4 frag_coord, f32x4 w) {
+                if (detail::is_clipped(clipping_rectangle, frag_coord)) {
+                    return;
+                }
+
+                ttlet texture_coord = detail::interpolate(w, ta, tb, tc);
+                ttlet g_radius = detail::sample(atlas_image, texture_coord.x(), texture_coord.y()) * distance_multiplier;
+
+                if (g_radius < -0.5f) {
+                    return;
+                }
+
+                if (!detail::depth_test(depth, x, y, dot<0b0111>(w, z))) {
+                    return;
+                }
+
+                auto &pixel = image[y][x];
+                if (color_luv.w() == 1.0f && g_radius >= 0.5f) {
+                    pixel = detail::tluv_to_rgb(color_luv);
+                    return;
+                }
+
+                ttlet background_luv = detail::rgb_to_tluv(static_cast<f32x4>(pixel));
+
+                if (subpixel_orientation == subpixel_orientation::Unknown) {
+                    ttlet coverage = std::clamp(g_radius + 0.5f, 0.0f, 1.0f) * color_luv.w();
+                    pixel = detail::tluv_to_rgb(detail::mix(background_luv, color_luv, coverage));
+
+                } else {
+                    ttlet rb_coords =
+                        texture_coord.xyxy() + detail::get_red_blue_subpixel_offset(subpixel_orientation, texture_stride);
+                    ttlet r_radius = detail::sample(atlas_image, rb_coords.x(), rb_coords.y()) * distance_multiplier;
+                    ttlet b_radius = detail::sample(atlas_image, rb_coords.z(), rb_coords.w()) * distance_multiplier;
+
+                    ttlet r_coverage = std::clamp(r_radius + 0.5f, 0.0f, 1.0f) * color_luv.w();
+                    ttlet g_coverage = std::clamp(g_radius + 0.5f, 0.0f, 1.0f) * color_luv.w();
+                    ttlet b_coverage = std::clamp(b_radius + 0.5f, 0.0f, 1.0f) * color_luv.w();
+
+                    pixel = detail::tluv_to_rgb(
+                        detail::mix(background_luv, color_luv, r_coverage),
+                        detail::mix(background_luv, color_luv, g_coverage),
+                        detail::mix(background_luv, color_luv, b_coverage));
+                }
+            });
+        };
+
+        ttlet p0 = static_cast<f32x4>(v0.position);
+        ttlet p1 = static_cast<f32x4>(v1.position);
+        ttlet p2 = static_cast<f32x4>(v2.position);
+        ttlet p3 = static_cast<f32x4>(v3.position);
+        shade(detail::software_triangle{p0, p1, p2}, f32x4{p0.z(), p1.z(), p2.z(), 0.0f}, v0, v1, v2);
+        shade(detail::software_triangle{p2, p1, p3}, f32x4{p2.z(), p1.z(), p3.z(), 0.0f}, v2, v1, v3);
+    }
+}
+
+} // namespace tt
@@ -0,0 +1,89 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "pipeline_flat_vertex.hpp"
+#include "pipeline_box_vertex.hpp"
+#include "pipeline_SDF_vertex.hpp"
+#include "subpixel_orientation.hpp"
+#include "../rapid/sfloat_rgba16.hpp"
+#include "../rapid/sdf_r8.hpp"
+#include "../pixel_map.hpp"
+#include "../vspan.hpp"
+#include <vector>
+
+namespace tt {
+
+/** A CPU implementation of the flat, box and SDF shaders.
+ *
+ * The software rasterizer draws the quads of the vertex streams that are
+ * produced by `draw_context` into a `pixel_map<sfloat_rgba16>`. It follows the
+ * math of the `pipeline_flat`, `pipeline_box` and `pipeline_SDF` shaders, so
+ * that widgets can be rendered, benchmarked and compared pixel-by-pixel
+ * without a GPU.
+ *
+ * Coordinates are in window pixels with the origin at the bottom-left corner,
+ * row zero of the image and depth-buffer is the bottom row of the window.
+ *
+ * Like the Vulkan pipelines, each quad consists of the triangles (0, 1, 2) and (2, 1, 3),
+ * fragments are depth-tested using greater-or-equal elevation, and colors are composited
+ * using pre-multiplied alpha blending.
+ */
+class software_rasterizer {
+public:
+    /** The linear-sRGB image with pre-multiplied alpha.
+     */
+    pixel_map<sfloat_rgba16> image;
+
+    /** The elevation of the fragment that was last written to each pixel.
+     */
+    pixel_map<float> depth;
+
+    software_rasterizer() noexcept = default;
+    software_rasterizer(software_rasterizer const &) = delete;
+    software_rasterizer(software_rasterizer &&) noexcept = default;
+    software_rasterizer &operator=(software_rasterizer const &) = delete;
+    software_rasterizer &operator=(software_rasterizer &&) noexcept = default;
+
+    /** Create a rasterizer for an image of the given size.
+     */
+    software_rasterizer(ssize_t width, ssize_t height) noexcept;
+
+    /** Clear part of the image and depth-buffer.
+     *
+     * @param clear_rectangle The part of the image to clear, usually the scissor rectangle.
+     * @param background_color The color to fill the image with.
+     */
+    void clear(aarectangle clear_rectangle, color background_color) noexcept;
+
+    /** Rasterize quads using the flat shader.
+     *
+     * @param scissor_rectangle The part of the image that may be modified.
+     * @param vertices The vertices, four for each quad.
+     */
+    void draw(aarectangle scissor_rectangle, vspan<pipeline_flat::vertex> const &vertices) noexcept;
+
+    /** Rasterize quads using the box shader.
+     *
+     * @param scissor_rectangle The part of the image that may be modified.
+     * @param vertices The vertices, four for each quad.
+     */
+    void draw(aarectangle scissor_rectangle, vspan<pipeline_box::vertex> const &vertices) noexcept;
+
+    /** Rasterize quads using the SDF shader.
+     *
+     * @param scissor_rectangle The part of the image that may be modified.
+     * @param vertices The vertices, four for each quad.
+     * @param atlas The images of the SDF atlas, indexed by the z-coordinate of the texture coordinates.
+     * @param subpixel_orientation The subpixel orientation to use for anti-aliasing.
+     */
+    void draw(
+        aarectangle scissor_rectangle,
+        vspan<pipeline_SDF::vertex> const &vertices,
+        std::vector<pixel_map<sdf_r8>> const &atlas,
+        tt::subpixel_orientation subpixel_orientation) noexcept;
+};
+
+} // namespace tt
@@ -0,0 +1,281 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/GFX/software_rasterizer.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tt;
+
+namespace {
+
+/** Uninitialized memory for a few vertices, like a mapped Vulkan vertex buffer.
+ */
+template<typename Vertex = pipeline_flat::vertex>
+struct vertex_buffer {
+    static constexpr ssize_t size = 16;
+
+    std::allocator<Vertex> allocator;
+    Vertex *data = allocator.allocate(size);
+    vspan<Vertex> span = vspan<Vertex>{data, size};
+
+    ~vertex_buffer()
+    {
+        span.clear();
+        allocator.deallocate(data, size);
+    }
+};
+
+/** Add a flat quad with the corners in the same order as `pipeline_flat::device_shared::place_vertices()`.
+ */
+void add_quad(vspan<pipeline_flat::vertex> &vertices, aarectangle clipping_rectangle, aarectangle box, float z, color fill_color)
+{
+    vertices.emplace_back(clipping_rectangle, point3{box.left(), box.bottom(), z}, fill_color);
+    vertices.emplace_back(clipping_rectangle, point3{box.right(), box.bottom(), z}, fill_color);
+    vertices.emplace_back(clipping_rectangle, point3{box.left(), box.top(), z}, fill_color);
+    vertices.emplace_back(clipping_rectangle, point3{box.right(), box.top(), z}, fill_color);
+}
+
+/** Add a box quad the same way as `pipeline_box::device_shared::place_vertices()`.
+ */
+void add_box(
+    vspan<pipeline_box::vertex> &vertices,
+    aarectangle clipping_rectangle,
+    aarectangle box,
+    color fill_color,
+    color line_color,
+    float line_width,
+    corner_shapes corner_shapes)
+{
+    ttlet outer_box = expand(box, line_width * 0.5f + 1.0f);
+    ttlet outer_extent = static_cast<f32x4>(outer_box.size());
+
+    vertices.emplace_back(
+        clipping_rectangle, point3{get<0>(outer_box)}, outer_extent._00xy(), fill_color, line_color, line_width, corner_shapes);
+    vertices.emplace_back(
+        clipping_rectangle, point3{get<1>(outer_box)}, outer_extent.x00y(), fill_color, line_color, line_width, corner_shapes);
+    vertices.emplace_back(
+        clipping_rectangle, point3{get<2>(outer_box)}, outer_extent._0yx0(), fill_color, line_color, line_width, corner_shapes);
+    vertices.emplace_back(
+        clipping_rectangle, point3{get<3>(outer_box)}, outer_extent.xy00(), fill_color, line_color, line_width, corner_shapes);
+}
+
+/** Add a SDF quad that maps the whole of the first atlas image onto a box.
+ */
+void add_glyph(vspan<pipeline_SDF::vertex> &vertices, aarectangle clipping_rectangle, aarectangle box, color text_color)
+{
+    vertices.emplace_back(point3{get<0>(box)}, clipping_rectangle, point3{0.0f, 0.0f, 0.0f}, text_color);
+    vertices.emplace_back(point3{get<1>(box)}, clipping_rectangle, point3{1.0f, 0.0f, 0.0f}, text_color);
+    vertices.emplace_back(point3{get<2>(box)}, clipping_rectangle, point3{0.0f, 1.0f, 0.0f}, text_color);
+    vertices.emplace_back(point3{get<3>(box)}, clipping_rectangle, point3{1.0f, 1.0f, 0.0f}, text_color);
+}
+
+/** A signed distance field of a disc, positive inside the disc.
+ */
+[[nodiscard]] pixel_map<sdf_r8> make_disc_sdf(ssize_t size, float radius)
+{
+    auto r = pixel_map<sdf_r8>{size, size};
+    ttlet center = narrow_cast<float>(size) * 0.5f;
+    for (ssize_t y = 0; y != size; ++y) {
+        for (ssize_t x = 0; x != size; ++x) {
+            ttlet dx = narrow_cast<float>(x) + 0.5f - center;
+            ttlet dy = narrow_cast<float>(y) + 0.5f - center;
+            r[y][x] = radius - std::sqrt(dx * dx + dy * dy);
+        }
+    }
+    return r;
+}
+
+[[nodiscard]] f32x4 pixel(software_rasterizer const &r, ssize_t x, ssize_t y)
+{
+    return static_cast<f32x4>(r.image[y][x]);
+}
+
+/** Convert the image into text, one string per row with the top row first.
+ * Each pixel is converted to a character by the function `to_char(f32x4 pixel)`.
+ */
+template<typename ToChar>
+[[nodiscard]] std::vector<std::string> to_text(software_rasterizer const &r, ToChar const &to_char)
+{
+    auto text = std::vector<std::string>{};
+    for (auto y = r.image.height() - 1; y >= 0; --y) {
+        auto &line = text.emplace_back();
+        for (ssize_t x = 0; x != r.image.width(); ++x) {
+            line += to_char(pixel(r, x, y));
+        }
+    }
+    return text;
+}
+
+/** Full coverage is '#', no coverage is ' ' and partial coverage is '+'.
+ */
+[[nodiscard]] char coverage_to_char(float coverage)
+{
+    return coverage < 0.01f ? ' ' : coverage > 0.99f ? '#' : '+';
+}
+
+} // namespace
+
+TEST(software_rasterizer, flat_quad)
+{
+    auto buffer = vertex_buffer{};
+    auto &vertices = buffer.span;
+
+    auto r = software_rasterizer{8, 8};
+    ttlet everything = aarectangle{0.0f, 0.0f, 8.0f, 8.0f};
+
+    add_quad(vertices, everything, aarectangle{2.0f, 2.0f, 4.0f, 4.0f}, 0.0f, color{1.0f, 0.0f, 0.0f, 1.0f});
+    r.draw(everything, vertices);
+
+    // Pixels are covered when their center is inside the quad.
+    ASSERT_EQ(pixel(r, 2, 2), (f32x4{1.0f, 0.0f, 0.0f, 1.0f}));
+    ASSERT_EQ(pixel(r, 5, 5), (f32x4{1.0f, 0.0f, 0.0f, 1.0f}));
+    ASSERT_EQ(pixel(r, 1, 2), (f32x4{0.0f, 0.0f, 0.0f, 0.0f}));
+    ASSERT_EQ(pixel(r, 6, 5), (f32x4{0.0f, 0.0f, 0.0f, 0.0f}));
+    ASSERT_EQ(pixel(r, 2, 6), (f32x4{0.0f, 0.0f, 0.0f, 0.0f}));
+}
+
+TEST(software_rasterizer, flat_quad_depth)
+{
+    auto buffer = vertex_buffer{};
+    auto &vertices = buffer.span;
+
+    auto r = software_rasterizer{8, 8};
+    ttlet everything = aarectangle{0.0f, 0.0f, 8.0f, 8.0f};
+
+    // The green quad is drawn first, but is higher so it must stay on top of the blue quad.
+    add_quad(vertices, everything, aarectangle{0.0f, 0.0f, 4.0f, 4.0f}, 1.0f, color{0.0f, 1.0f, 0.0f, 1.0f});
+    add_quad(vertices, everything, aarectangle{2.0f, 2.0f, 4.0f, 4.0f}, 0.0f, color{0.0f, 0.0f, 1.0f, 1.0f});
+    r.draw(everything, vertices);
+
+    ASSERT_EQ(pixel(r, 1, 1), (f32x4{0.0f, 1.0f, 0.0f, 1.0f}));
+    ASSERT_EQ(pixel(r, 3, 3), (f32x4{0.0f, 1.0f, 0.0f, 1.0f}));
+    ASSERT_EQ(pixel(r, 5, 5), (f32x4{0.0f, 0.0f, 1.0f, 1.0f}));
+}
+
+TEST(software_rasterizer, scissor_and_clipping)
+{
+    auto buffer = vertex_buffer{};
+    auto &vertices = buffer.span;
+
+    auto r = software_rasterizer{8, 8};
+    ttlet everything = aarectangle{0.0f, 0.0f, 8.0f, 8.0f};
+
+    // The clipping rectangle of the vertex and the scissor rectangle both limit the quad.
+    add_quad(vertices, aarectangle{0.0f, 0.0f, 8.0f, 4.0f}, everything, 0.0f, color{1.0f, 1.0f, 1.0f, 1.0f});
+    r.draw(aarectangle{0.0f, 0.0f, 4.0f, 8.0f}, vertices);
+
+    ASSERT_EQ(pixel(r, 1, 1), (f32x4{1.0f, 1.0f, 1.0f, 1.0f}));
+    ASSERT_EQ(pixel(r, 5, 1), (f32x4{0.0f, 0.0f, 0.0f, 0.0f}));
+    ASSERT_EQ(pixel(r, 1, 5), (f32x4{0.0f, 0.0f, 0.0f, 0.0f}));
+
+    r.clear(aarectangle{0.0f, 0.0f, 2.0f, 2.0f}, color{0.0f, 0.0f, 0.0f, 1.0f});
+    ASSERT_EQ(pixel(r, 1, 1), (f32x4{0.0f, 0.0f, 0.0f, 1.0f}));
+    ASSERT_EQ(pixel(r, 3, 3), (f32x4{1.0f, 1.0f, 1.0f, 1.0f}));
+}
+
+TEST(software_rasterizer, box_reference_image)
+{
+    auto buffer = vertex_buffer<pipeline_box::vertex>{};
+    auto &vertices = buffer.span;
+
+    auto r = software_rasterizer{16, 16};
+    ttlet everything = aarectangle{0.0f, 0.0f, 16.0f, 16.0f};
+
+    // A green box with a red border centered on pixel boundaries; the left-bottom corner is square,
+    // the right-bottom corner is cut and the top corners are rounded.
+    add_box(
+        vertices,
+        everything,
+        aarectangle{3.5f, 3.5f, 9.0f, 9.0f},
+        color{0.0f, 1.0f, 0.0f, 1.0f},
+        color{1.0f, 0.0f, 0.0f, 1.0f},
+        1.0f,
+        corner_shapes{0.0f, -3.0f, 3.0f, 3.0f});
+    r.draw(everything, vertices);
+
+    // 'R' is the border, 'G' is the fill, '+' is anti-aliased and ' ' is transparent.
+    ttlet text = to_text(r, [](f32x4 p) {
+        if (p.w() < 0.01f) {
+            return ' ';
+        } else if (p.w() < 0.99f or (p.x() > 0.01f and p.y() > 0.01f)) {
+            return '+';
+        } else {
+            return p.x() > 0.99f ? 'R' : 'G';
+        }
+    });
+
+    ttlet expected = std::vector<std::string>{
+        "                ",
+        "                ",
+        "                ",
+        "    ++RRRR++    ",
+        "   +++GGGG+++   ",
+        "   ++GGGGGG++   ",
+        "   RGGGGGGGGR   ",
+        "   RGGGGGGGGR   ",
+        "   RGGGGGGGGR   ",
+        "   RGGGGGGGGR   ",
+        "   RGGGGGGGR    ",
+        "   RGGGGGGR     ",
+        "   RRRRRRR      ",
+        "                ",
+        "                ",
+        "                "};
+    ASSERT_EQ(text, expected);
+}
+
+TEST(software_rasterizer, sdf_reference_image)
+{
+    auto buffer = vertex_buffer<pipeline_SDF::vertex>{};
+    auto &vertices = buffer.span;
+
+    auto r = software_rasterizer{16, 16};
+    ttlet everything = aarectangle{0.0f, 0.0f, 16.0f, 16.0f};
+    r.clear(everything, color{0.0f, 0.0f, 0.0f, 1.0f});
+
+    // A glyph of a disc with a radius of 5 pixels, drawn at the same scale as the atlas.
+    auto atlas = std::vector<pixel_map<sdf_r8>>{};
+    atlas.push_back(make_disc_sdf(16, 5.0f));
+    add_glyph(vertices, everything, everything, color{1.0f, 1.0f, 1.0f, 1.0f});
+    r.draw(everything, vertices, atlas, subpixel_orientation::Unknown);
+
+    ttlet text = to_text(r, [](f32x4 p) {
+        return coverage_to_char(p.y());
+    });
+
+    ttlet expected = std::vector<std::string>{
+        "                ",
+        "                ",
+        "                ",
+        "     ++++++     ",
+        "    +######+    ",
+        "   +########+   ",
+        "   +########+   ",
+        "   +########+   ",
+        "   +########+   ",
+        "   +########+   ",
+        "   +########+   ",
+        "    +######+    ",
+        "     ++++++     ",
+        "                ",
+        "                ",
+        "                "};
+    ASSERT_EQ(text, expected);
+
+    // With sub-pixel anti-aliasing the red sub-pixel is on the left; on the left edge of the disc it is
+    // further outside than the blue sub-pixel, on the right edge it is further inside.
+    r.clear(everything, color{0.0f, 0.0f, 0.0f, 1.0f});
+    r.draw(everything, vertices, atlas, subpixel_orientation::BlueRight);
+
+    ttlet left = pixel(r, 3, 8);
+    ttlet right = pixel(r, 12, 8);
+    ASSERT_LT(left.x(), left.z());
+    ASSERT_GT(right.x(), right.z());
+    ASSERT_EQ(pixel(r, 8, 8), (f32x4{1.0f, 1.0f, 1.0f, 1.0f}));
+}
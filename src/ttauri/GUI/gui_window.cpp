@@ -123,7 +123,13 @@ void gui_window::render(hires_utc_clock::time_point displayTimePoint)
     ttlet need_reconstrain = _request_setting_change.exchange(false);
 
     // Update the size constraints of the window_widget and it children.
-    ttlet constraints_have_changed = widget->constrain(displayTimePoint, need_reconstrain);
+    // Only the widgets on the path to widgets that requested to be re-constrained are visited,
+    // the "widget_constrain" counter counts the number of visited widgets.
+    auto constraints_have_changed = false;
+    {
+        ttlet t = trace<"window_constrain">();
+        constraints_have_changed = widget->constrain(displayTimePoint, need_reconstrain);
+    }
 
     // Check if the window size matches the preferred size of the window_widget.
     // If not ask the operating system to change the size of the window, which is
@@ -158,7 +164,12 @@ void gui_window::render(hires_utc_clock::time_point displayTimePoint)
     ttlet need_layout = requestLayout.exchange(false, std::memory_order::relaxed) || constraints_have_changed;
 
     // Make sure the widget's layout is updated before draw, but after window resize.
-    widget->layout(displayTimePoint, need_layout);
+    // Only the widgets on the path to widgets that requested a new layout are visited,
+    // the "widget_layout" counter counts the number of visited widgets.
+    {
+        ttlet t = trace<"window_layout">();
+        widget->layout(displayTimePoint, need_layout);
+    }
 
     if (auto optional_draw_context = surface->render_start(_request_redraw_rectangle)) {
         auto draw_context = *optional_draw_context;
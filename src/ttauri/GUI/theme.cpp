@@ -57,10 +57,11 @@ theme::theme(URL const &url)
 [[nodiscard]] std::string theme::parse_string(datum const &data, char const *object_name)
 {
     // Extract name
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing '{}'", object_name);
     }
-    ttlet object = data[object_name];
+    ttlet object = data[key];
     if (!object.is_string()) {
         throw parse_error("'{}' attribute must be a string, got {}.", object_name, object.type_name());
     }
@@ -69,11 +70,12 @@ theme::theme(URL const &url)
 
 [[nodiscard]] float theme::parse_float(datum const &data, char const *object_name)
 {
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing '{}'", object_name);
     }
 
-    ttlet object = data[object_name];
+    ttlet object = data[key];
     if (!object.is_numeric()) {
         throw parse_error("'{}' attribute must be a number, got {}.", object_name, object.type_name());
     }
@@ -83,11 +85,12 @@ theme::theme(URL const &url)
 
 [[nodiscard]] bool theme::parse_bool(datum const &data, char const *object_name)
 {
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing '{}'", object_name);
     }
 
-    ttlet object = data[object_name];
+    ttlet object = data[key];
     if (!object.is_bool()) {
         throw parse_error("'{}' attribute must be a boolean, got {}.", object_name, object.type_name());
     }
@@ -130,11 +133,12 @@ theme::theme(URL const &url)
 
 [[nodiscard]] tt::color theme::parse_color(datum const &data, char const *object_name)
 {
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing color '{}'", object_name);
     }
 
-    ttlet color_object = data[object_name];
+    ttlet color_object = data[key];
 
     try {
         return parse_color_value(color_object);
@@ -151,11 +155,12 @@ theme::theme(URL const &url)
 [[nodiscard]] std::vector<color> theme::parse_color_list(datum const &data, char const *object_name)
 {
     // Extract name
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing color list '{}'", object_name);
     }
 
-    ttlet color_list_object = data[object_name];
+    ttlet color_list_object = data[key];
     if (color_list_object.is_vector() and std::size(color_list_object) > 0 and color_list_object[0].is_vector()) {
         auto r = std::vector<tt::color>{};
         ssize_t i = 0;
@@ -170,7 +175,7 @@ theme::theme(URL const &url)
 
     } else {
         try {
-            return {parse_color_value(data[object_name])};
+            return {parse_color_value(color_list_object)};
         } catch (parse_error const &e) {
             throw parse_error("Could not parse color '{}'\n{}", object_name, e.what());
         }
@@ -179,11 +184,12 @@ theme::theme(URL const &url)
 
 [[nodiscard]] font_weight theme::parse_font_weight(datum const &data, char const *object_name)
 {
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing '{}'", object_name);
     }
 
-    ttlet object = data[object_name];
+    ttlet object = data[key];
     if (object.is_numeric()) {
         return font_weight_from_int(static_cast<int>(object));
     } else if (object.is_string()) {
@@ -223,11 +229,12 @@ theme::theme(URL const &url)
 [[nodiscard]] text_style theme::parse_text_style(datum const &data, char const *object_name)
 {
     // Extract name
-    if (!data.contains(object_name)) {
+    ttlet key = datum::intern(object_name);
+    if (!data.contains(key)) {
         throw parse_error("Missing text-style '{}'", object_name);
     }
 
-    ttlet textStyleObject = data[object_name];
+    ttlet textStyleObject = data[key];
     try {
         return parse_text_style_value(textStyleObject);
     } catch (parse_error const &e) {
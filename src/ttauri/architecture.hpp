@@ -160,6 +160,7 @@ constexpr bool x86_64_v4 = false;
 #define tt_force_inline __forceinline
 #define tt_no_inline __declspec(noinline)
 #define tt_restrict __restrict
+#define tt_target(...)
 #define clang_suppress(a)
 #define msvc_pragma(a) _Pragma(a)
 
@@ -170,6 +171,7 @@ constexpr bool x86_64_v4 = false;
 #define tt_force_inline inline __attribute__((always_inline))
 #define tt_no_inline __attribute__((noinline))
 #define tt_restrict __restrict__
+#define tt_target(...) __attribute__((target(__VA_ARGS__)))
 #define clang_suppress(a) _Pragma(tt_stringify(clang diagnostic ignored a))
 #define msvc_pragma(a)
 
@@ -180,6 +182,7 @@ constexpr bool x86_64_v4 = false;
 #define tt_force_inline inline __attribute__((always_inline))
 #define tt_no_inline __attribute__((noinline))
 #define tt_restrict __restrict__
+#define tt_target(...) __attribute__((target(__VA_ARGS__)))
 #define clang_suppress(a)
 #define msvc_pragma(a)
 
@@ -190,6 +193,7 @@ constexpr bool x86_64_v4 = false;
 #define tt_force_inline inline
 #define tt_no_inline
 #define tt_restrict
+#define tt_target(...)
 #define clang_suppress(a)
 #define msvc_pragma(a)
 
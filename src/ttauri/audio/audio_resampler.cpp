@@ -0,0 +1,282 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "audio_resampler.hpp"
+#include "../architecture.hpp"
+#include "../cast.hpp"
+#include "../memory.hpp"
+#include "../rapid/numeric_array.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <type_traits>
+
+namespace tt {
+
+/** The number of phases in the coefficient table; a power of two.
+ */
+constexpr size_t audio_resampler_num_phases = 256;
+
+/** The number of fraction bits of the position that select the phase.
+ */
+constexpr int audio_resampler_phase_bits = 8;
+static_assert((1_uz << audio_resampler_phase_bits) == audio_resampler_num_phases);
+
+/** The stop-band attenuation in dB, this determines the Kaiser window.
+ */
+constexpr double audio_resampler_attenuation = 96.0;
+
+/** The number of fraction bits in the fixed point position and step.
+ */
+constexpr int audio_resampler_fraction_bits = 32;
+
+/** The widest vector type supported by the CPU the library is compiled for.
+ */
+using audio_resampler_vector = std::conditional_t<x86_64_v2_5, f32x8, f32x4>;
+
+/** Modified Bessel function of the first kind, order zero.
+ */
+[[nodiscard]] static double bessel_i0(double x) noexcept
+{
+    ttlet x_2_sq = (x * 0.5) * (x * 0.5);
+
+    auto r = 1.0;
+    auto term = 1.0;
+    for (auto k = 1; term > r * 1e-17; ++k) {
+        term *= x_2_sq / (static_cast<double>(k) * static_cast<double>(k));
+        r += term;
+    }
+    return r;
+}
+
+[[nodiscard]] static double sinc(double x) noexcept
+{
+    if (x == 0.0) {
+        return 1.0;
+    } else {
+        ttlet pi_x = std::numbers::pi * x;
+        return std::sin(pi_x) / pi_x;
+    }
+}
+
+/** Calculate a windowed-sinc filter coefficient.
+ *
+ * @param x The distance in input samples from the center of the filter.
+ * @param half_width Half the width of the filter in input samples.
+ * @param cutoff The cutoff frequency relative to the input Nyquist frequency.
+ * @param beta The beta parameter of the Kaiser window.
+ */
+[[nodiscard]] static double windowed_sinc(double x, double half_width, double cutoff, double beta) noexcept
+{
+    ttlet t = x / half_width;
+    ttlet window = bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - t * t))) / bessel_i0(beta);
+    return cutoff * sinc(cutoff * x) * window;
+}
+
+/** Apply two adjacent phases of the filter and interpolate between the results.
+ *
+ * @param samples The first sample of the filter window.
+ * @param coefficients The coefficients of the phase, followed by the coefficients of the next phase.
+ * @param num_taps The number of coefficients in a phase, a multiple of twice the vector size.
+ * @param fraction The fractional position between the two phases.
+ */
+template<typename V>
+[[nodiscard]] static float
+convolve(float const *samples, float const *coefficients, size_t num_taps, float fraction) noexcept
+{
+    constexpr auto vector_size = sizeof(V) / sizeof(float);
+    ttlet next_coefficients = coefficients + num_taps;
+
+    // Two sets of accumulators, so that the additions of consecutive iterations do not depend on each other.
+    auto acc0 = V{};
+    auto acc1 = V{};
+    auto acc2 = V{};
+    auto acc3 = V{};
+    for (auto i = 0_uz; i != num_taps; i += vector_size * 2) {
+        ttlet x0 = V::load(samples + i);
+        ttlet x1 = V::load(samples + i + vector_size);
+        acc0 += x0 * V::load(coefficients + i);
+        acc1 += x0 * V::load(next_coefficients + i);
+        acc2 += x1 * V::load(coefficients + i + vector_size);
+        acc3 += x1 * V::load(next_coefficients + i + vector_size);
+    }
+    acc0 += acc2;
+    acc1 += acc3;
+
+    acc0 += (acc1 - acc0) * fraction;
+
+    auto r = 0.0f;
+    for (auto i = 0_uz; i != vector_size; ++i) {
+        r += acc0[i];
+    }
+    return r;
+}
+
+audio_resampler::audio_resampler(
+    size_t num_channels,
+    int input_sample_rate,
+    int output_sample_rate,
+    size_t num_taps) noexcept :
+    _num_channels(num_channels),
+    _num_taps(num_taps),
+    _input_sample_rate(input_sample_rate),
+    _output_sample_rate(output_sample_rate)
+{
+    tt_axiom(num_channels > 0);
+    tt_axiom(num_taps >= 16 and num_taps % 16 == 0);
+    tt_axiom(input_sample_rate > 0 and output_sample_rate > 0);
+
+    set_ratio(static_cast<double>(output_sample_rate) / static_cast<double>(input_sample_rate));
+
+    // Over-allocate so that the coefficients can be aligned to a cache-line.
+    constexpr auto alignment = hardware_destructive_interference_size / sizeof(float);
+    _coefficient_storage.resize((audio_resampler_num_phases + 1) * _num_taps + alignment);
+    _coefficients = ceil(_coefficient_storage.data(), hardware_destructive_interference_size);
+
+    // The stop-band starts at the Nyquist frequency of the lowest sample rate, expressed
+    // relative to the input Nyquist frequency; the transition width follows from the
+    // length of the filter and the attenuation.
+    ttlet attenuation = audio_resampler_attenuation;
+    ttlet beta = 0.1102 * (attenuation - 8.7);
+    ttlet transition = 2.0 * (attenuation - 7.95) / (14.36 * static_cast<double>(_num_taps));
+    ttlet cutoff = std::min(1.0, ratio()) - transition * 0.5;
+    ttlet half_width = static_cast<double>(_num_taps) * 0.5;
+
+    for (auto phase = 0_uz; phase != audio_resampler_num_phases + 1; ++phase) {
+        ttlet row = _coefficients + phase * _num_taps;
+        ttlet fraction = static_cast<double>(phase) / static_cast<double>(audio_resampler_num_phases);
+
+        // The output is at `half_width - 1 + fraction` samples from the start of the window.
+        auto sum = 0.0;
+        for (auto i = 0_uz; i != _num_taps; ++i) {
+            ttlet x = half_width - 1.0 + fraction - static_cast<double>(i);
+            ttlet coefficient = windowed_sinc(x, half_width, cutoff, beta);
+            row[i] = static_cast<float>(coefficient);
+            sum += coefficient;
+        }
+
+        // Normalize each phase to unity gain at DC, so that the gain does not depend on the phase.
+        for (auto i = 0_uz; i != _num_taps; ++i) {
+            row[i] = static_cast<float>(row[i] / sum);
+        }
+    }
+
+    _history.resize(_num_channels * _num_taps);
+    _scratch.resize(_num_taps * 2);
+    reset();
+}
+
+[[nodiscard]] double audio_resampler::ratio() const noexcept
+{
+    return std::ldexp(1.0, audio_resampler_fraction_bits) / static_cast<double>(_step);
+}
+
+void audio_resampler::set_ratio(double ratio) noexcept
+{
+    tt_axiom(ratio > 0.0);
+    _step = static_cast<int64_t>(std::llround(std::ldexp(1.0 / ratio, audio_resampler_fraction_bits)));
+}
+
+void audio_resampler::reset() noexcept
+{
+    std::fill(_history.begin(), _history.end(), 0.0f);
+
+    // Start the window so that the first output sample is centered on the first input sample.
+    _position = -static_cast<int64_t>(_num_taps / 2 - 1) << audio_resampler_fraction_bits;
+}
+
+[[nodiscard]] size_t audio_resampler::num_output_samples(size_t num_input_samples) const noexcept
+{
+    // The window of the last output sample must end on the last input sample.
+    ttlet end = (static_cast<int64_t>(num_input_samples) - static_cast<int64_t>(_num_taps) + 1)
+        << audio_resampler_fraction_bits;
+
+    if (_position >= end) {
+        return 0;
+    } else {
+        return narrow_cast<size_t>((end - _position - 1) / _step + 1);
+    }
+}
+
+void audio_resampler::process_channel(
+    float const *input,
+    size_t num_input_samples,
+    float *output,
+    size_t num_output_samples,
+    float *history) noexcept
+{
+    ttlet num_history = _num_taps - 1;
+    ttlet num_head = std::min(num_input_samples, num_history);
+    ttlet scratch = _scratch.data();
+
+    // Windows that start before the input read from the history followed by the start of the input.
+    std::copy_n(history, num_history, scratch);
+    std::copy_n(input, num_head, scratch + num_history);
+
+    constexpr auto fraction_mask = (int64_t{1} << audio_resampler_fraction_bits) - 1;
+    constexpr auto interpolation_bits = audio_resampler_fraction_bits - audio_resampler_phase_bits;
+    constexpr auto interpolation_mask = (int64_t{1} << interpolation_bits) - 1;
+    constexpr auto interpolation_scale = 1.0f / static_cast<float>(int64_t{1} << interpolation_bits);
+
+    auto position = _position;
+    for (auto i = 0_uz; i != num_output_samples; ++i, position += _step) {
+        ttlet index = position >> audio_resampler_fraction_bits;
+        ttlet phase = narrow_cast<size_t>((position & fraction_mask) >> interpolation_bits);
+        ttlet fraction = static_cast<float>(position & interpolation_mask) * interpolation_scale;
+
+        ttlet samples = index < 0 ? scratch + (index + static_cast<int64_t>(num_history)) : input + index;
+        output[i] = convolve<audio_resampler_vector>(samples, _coefficients + phase * _num_taps, _num_taps, fraction);
+    }
+
+    // Keep the last samples for the windows that straddle the next input.
+    if (num_input_samples >= num_history) {
+        std::copy_n(input + (num_input_samples - num_history), num_history, history);
+    } else {
+        std::copy_n(scratch + num_input_samples, num_history, history);
+    }
+}
+
+size_t audio_resampler::process(float const *const *input, size_t num_input_samples, float *const *output) noexcept
+{
+    tt_axiom(input != nullptr and output != nullptr);
+
+    ttlet num_output = num_output_samples(num_input_samples);
+    for (auto i = 0_uz; i != _num_channels; ++i) {
+        process_channel(input[i], num_input_samples, output[i], num_output, _history.data() + i * _num_taps);
+    }
+
+    _position += static_cast<int64_t>(num_output) * _step;
+    _position -= static_cast<int64_t>(num_input_samples) << audio_resampler_fraction_bits;
+    _output_sample_count += static_cast<int64_t>(num_output);
+    return num_output;
+}
+
+void audio_resampler::process(audio_block const &input, audio_block &output) noexcept
+{
+    tt_axiom(input.num_channels == _num_channels);
+    tt_axiom(output.num_channels == _num_channels);
+
+    // The time of the first output sample relative to the first input sample.
+    ttlet offset = std::ldexp(static_cast<double>(_position), -audio_resampler_fraction_bits) +
+        static_cast<double>(_num_taps / 2 - 1);
+
+    output.sample_rate = _output_sample_rate;
+    output.sample_count = _output_sample_count;
+    ttlet offset_in_seconds = std::chrono::duration<double>(offset / static_cast<double>(_input_sample_rate));
+    output.time_stamp = input.time_stamp + std::chrono::duration_cast<hires_utc_clock::duration>(offset_in_seconds);
+    output.state = input.state;
+
+    if (input.state == audio_block_state::corrupt) {
+        // The samples of a corrupt block must not be read; restart the filter after the block.
+        ttlet num_output = num_output_samples(input.num_samples);
+        reset();
+        _output_sample_count += static_cast<int64_t>(num_output);
+        output.num_samples = num_output;
+    } else {
+        output.num_samples = process(input.samples, input.num_samples, output.samples);
+    }
+}
+
+} // namespace tt
@@ -0,0 +1,156 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "audio_block.hpp"
+#include "../required.hpp"
+#include "../assert.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace tt {
+
+/** A sample-rate converter for streams of audio blocks.
+ *
+ * This is a polyphase windowed-sinc resampler, used to combine audio devices that
+ * run on different word-clocks. The low-pass filter is a Kaiser windowed sinc with
+ * about 96 dB stop-band attenuation, its stop-band starts at the lowest of the input
+ * and output Nyquist frequencies.
+ *
+ * The filter is stored as a table of 256 phases, the coefficients for the fractional
+ * position between two phases are linearly interpolated. This means that the ratio
+ * may be changed between calls to `process()`, to compensate for the drift between
+ * the word-clocks of the devices.
+ *
+ * The filter is applied per channel directly on the non-interleaved sample buffers of
+ * the input; only the filter windows that straddle the previous block are copied to
+ * a small scratch buffer.
+ *
+ * The output is aligned with the input, output sample `i` is at the same time as input
+ * sample `i / ratio()`. To do so the resampler holds back `num_taps() / 2` input samples.
+ */
+class audio_resampler {
+public:
+    audio_resampler(audio_resampler const &) = delete;
+    audio_resampler(audio_resampler &&) = delete;
+    audio_resampler &operator=(audio_resampler const &) = delete;
+    audio_resampler &operator=(audio_resampler &&) = delete;
+
+    /** Create a resampler.
+     *
+     * @param num_channels The number of channels.
+     * @param input_sample_rate The nominal sample rate of the input.
+     * @param output_sample_rate The nominal sample rate of the output.
+     * @param num_taps The length of the filter, a multiple of 16. A longer filter has
+     *                 a smaller transition band and costs more CPU time.
+     */
+    audio_resampler(size_t num_channels, int input_sample_rate, int output_sample_rate, size_t num_taps = 128) noexcept;
+
+    [[nodiscard]] size_t num_channels() const noexcept
+    {
+        return _num_channels;
+    }
+
+    [[nodiscard]] size_t num_taps() const noexcept
+    {
+        return _num_taps;
+    }
+
+    [[nodiscard]] int input_sample_rate() const noexcept
+    {
+        return _input_sample_rate;
+    }
+
+    [[nodiscard]] int output_sample_rate() const noexcept
+    {
+        return _output_sample_rate;
+    }
+
+    /** The current ratio between the output and input sample rate.
+     */
+    [[nodiscard]] double ratio() const noexcept;
+
+    /** Change the ratio between the output and input sample rate.
+     *
+     * The filter is designed for the nominal sample rates passed to the constructor,
+     * the ratio should only be changed by a small amount to compensate for drift.
+     *
+     * @param ratio The new ratio of output samples per input sample.
+     */
+    void set_ratio(double ratio) noexcept;
+
+    /** Clear the samples held back from previous blocks.
+     */
+    void reset() noexcept;
+
+    /** The number of output samples that `process()` produces for the next input.
+     *
+     * @param num_input_samples The number of samples in each channel of the next input.
+     */
+    [[nodiscard]] size_t num_output_samples(size_t num_input_samples) const noexcept;
+
+    /** Resample a block of non-interleaved samples.
+     *
+     * @param input A pointer to an array of pointers to the samples of each channel.
+     * @param num_input_samples The number of samples of each channel of the input.
+     * @param output A pointer to an array of pointers to the output buffer of each channel.
+     *               Each buffer must have room for `num_output_samples(num_input_samples)` samples.
+     * @return The number of samples written to each channel of the output.
+     */
+    size_t process(float const *const *input, size_t num_input_samples, float *const *output) noexcept;
+
+    /** Resample an audio block.
+     *
+     * The output's `num_samples`, `sample_rate`, `sample_count`, `time_stamp` and `state`
+     * are set from the input. The samples of a corrupt block are not read, the resampler
+     * is reset instead.
+     *
+     * @param input An audio block with the same number of channels as the resampler.
+     * @param [out]output An audio block with the same number of channels as the resampler,
+     *                    and buffers with room for `num_output_samples(input.num_samples)` samples.
+     */
+    void process(audio_block const &input, audio_block &output) noexcept;
+
+private:
+    size_t _num_channels;
+    size_t _num_taps;
+    int _input_sample_rate;
+    int _output_sample_rate;
+
+    /** The number of input samples per output sample, in 32.32 fixed point.
+     */
+    int64_t _step;
+
+    /** The position of the first sample of the filter window of the next output sample,
+     * in 32.32 fixed point, relative to the first sample of the next input.
+     */
+    int64_t _position;
+
+    /** The number of samples that have been written to the output.
+     */
+    int64_t _output_sample_count = 0;
+
+    /** The filter coefficients, `num_phases + 1` rows of `num_taps` coefficients.
+     */
+    std::vector<float> _coefficient_storage;
+    float *_coefficients;
+
+    /** The last `num_taps - 1` input samples of each channel, with a stride of `num_taps`.
+     */
+    std::vector<float> _history;
+
+    /** The history of a channel followed by the first samples of the input.
+     */
+    std::vector<float> _scratch;
+
+    void process_channel(
+        float const *input,
+        size_t num_input_samples,
+        float *output,
+        size_t num_output_samples,
+        float *history) noexcept;
+};
+
+} // namespace tt
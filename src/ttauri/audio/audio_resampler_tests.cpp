@@ -0,0 +1,220 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "audio_resampler.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <vector>
+
+using namespace tt;
+
+/** Generate a sine wave.
+ */
+[[nodiscard]] static std::vector<float> make_tone(double frequency, int sample_rate, size_t num_samples)
+{
+    auto r = std::vector<float>(num_samples);
+    ttlet omega = 2.0 * std::numbers::pi * frequency / static_cast<double>(sample_rate);
+    for (auto i = 0_uz; i != num_samples; ++i) {
+        r[i] = static_cast<float>(0.5 * std::sin(omega * static_cast<double>(i)));
+    }
+    return r;
+}
+
+/** Resample a single channel in blocks.
+ */
+[[nodiscard]] static std::vector<float>
+resample(audio_resampler &resampler, std::vector<float> const &input, size_t block_size)
+{
+    auto r = std::vector<float>{};
+    auto output = std::vector<float>{};
+    for (auto offset = 0_uz; offset < input.size(); offset += block_size) {
+        ttlet num_input = std::min(block_size, input.size() - offset);
+        output.resize(resampler.num_output_samples(num_input));
+
+        float const *input_ptr = input.data() + offset;
+        float *output_ptr = output.data();
+        ttlet num_output = resampler.process(&input_ptr, num_input, &output_ptr);
+        EXPECT_EQ(num_output, output.size());
+
+        r.insert(r.end(), output.begin(), output.end());
+    }
+    return r;
+}
+
+/** Measure the amplitude of a frequency in the signal using a Hann window.
+ * The first and last 10% of the signal are skipped, to stay away from the edges of the filter.
+ */
+[[nodiscard]] static double measure_amplitude(std::vector<float> const &signal, double frequency, int sample_rate)
+{
+    ttlet begin = signal.size() / 10;
+    ttlet end = signal.size() - signal.size() / 10;
+    ttlet size = static_cast<double>(end - begin);
+    ttlet omega = 2.0 * std::numbers::pi * frequency / static_cast<double>(sample_rate);
+
+    auto sum = std::complex<double>{};
+    auto window_sum = 0.0;
+    for (auto i = begin; i != end; ++i) {
+        ttlet window = 0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(i - begin) / size);
+        sum += window * static_cast<double>(signal[i]) * std::polar(1.0, -omega * static_cast<double>(i));
+        window_sum += window;
+    }
+    return 2.0 * std::abs(sum) / window_sum;
+}
+
+/** The level of the signal in dB relative to the amplitude of the test tone.
+ */
+[[nodiscard]] static double measure_rms_db(std::vector<float> const &signal)
+{
+    ttlet begin = signal.size() / 10;
+    ttlet end = signal.size() - signal.size() / 10;
+
+    auto sum = 0.0;
+    for (auto i = begin; i != end; ++i) {
+        sum += static_cast<double>(signal[i]) * static_cast<double>(signal[i]);
+    }
+    ttlet amplitude = std::sqrt(2.0 * sum / static_cast<double>(end - begin));
+    return 20.0 * std::log10(amplitude / 0.5);
+}
+
+[[nodiscard]] static double to_db(double amplitude)
+{
+    return 20.0 * std::log10(amplitude / 0.5);
+}
+
+TEST(audio_resampler, num_output_samples)
+{
+    auto resampler = audio_resampler(1, 48000, 44100);
+    ASSERT_NEAR(resampler.ratio(), 44100.0 / 48000.0, 1e-9);
+
+    // Odd block sizes, with blocks smaller than the filter.
+    auto num_input = 0_uz;
+    auto num_output = 0_uz;
+    for (auto block_size : {1_uz, 7_uz, 100_uz, 480_uz, 4096_uz, 3_uz, 127_uz}) {
+        ttlet input = std::vector<float>(block_size, 0.0f);
+        num_input += input.size();
+        num_output += resample(resampler, input, block_size).size();
+    }
+
+    // The resampler holds back half the filter.
+    ttlet expected = (static_cast<double>(num_input) - static_cast<double>(resampler.num_taps() / 2)) * resampler.ratio();
+    ASSERT_NEAR(static_cast<double>(num_output), expected, 1.0);
+}
+
+TEST(audio_resampler, block_size_independent)
+{
+    ttlet input = make_tone(1000.0, 48000, 10000);
+
+    auto resampler1 = audio_resampler(1, 48000, 44100);
+    ttlet expected = resample(resampler1, input, input.size());
+
+    // The blocks are smaller than the filter, so that windows straddle multiple blocks.
+    for (auto block_size : {1_uz, 5_uz, 64_uz, 127_uz, 128_uz, 1000_uz}) {
+        auto resampler2 = audio_resampler(1, 48000, 44100);
+        ttlet result = resample(resampler2, input, block_size);
+        ASSERT_EQ(result, expected) << "block_size=" << block_size;
+    }
+}
+
+TEST(audio_resampler, passband_ripple)
+{
+    for (ttlet[input_rate, output_rate] : {std::pair{48000, 44100}, std::pair{44100, 48000}, std::pair{44100, 96000}}) {
+        for (auto frequency : {20.0, 100.0, 1000.0, 5000.0, 10000.0, 15000.0, 18000.0, 19000.0, 19500.0}) {
+            auto resampler = audio_resampler(1, input_rate, output_rate);
+            ttlet output = resample(resampler, make_tone(frequency, input_rate, 20000), 512);
+
+            ttlet gain = to_db(measure_amplitude(output, frequency, output_rate));
+            ASSERT_NEAR(gain, 0.0, 0.01) << input_rate << "->" << output_rate << " frequency=" << frequency;
+        }
+    }
+}
+
+TEST(audio_resampler, aliasing)
+{
+    // Frequencies above the output Nyquist frequency must not alias into the output.
+    for (auto frequency : {22200.0, 22700.0, 23500.0, 23900.0}) {
+        auto resampler = audio_resampler(1, 48000, 44100);
+        ttlet output = resample(resampler, make_tone(frequency, 48000, 20000), 512);
+
+        ASSERT_LT(measure_rms_db(output), -90.0) << "frequency=" << frequency;
+    }
+}
+
+TEST(audio_resampler, imaging)
+{
+    // When up-sampling the image of a tone, mirrored around the input Nyquist frequency, must be removed.
+    for (auto frequency : {17000.0, 19000.0, 21000.0}) {
+        auto resampler = audio_resampler(1, 44100, 48000);
+        ttlet output = resample(resampler, make_tone(frequency, 44100, 20000), 512);
+
+        ttlet image_frequency = 44100.0 - frequency;
+        ASSERT_LT(to_db(measure_amplitude(output, image_frequency, 48000)), -90.0) << "frequency=" << frequency;
+    }
+}
+
+TEST(audio_resampler, drift_compensation)
+{
+    ttlet input = make_tone(1000.0, 48000, 48000);
+
+    // Speed up and slow down the output slightly, like a control loop following a word-clock.
+    auto resampler = audio_resampler(1, 48000, 48000);
+    auto output = std::vector<float>{};
+    for (auto offset = 0_uz; offset != input.size(); offset += 480) {
+        resampler.set_ratio(1.0 + 0.001 * std::sin(static_cast<double>(offset) * 0.001));
+
+        auto block = std::vector<float>(input.begin() + offset, input.begin() + offset + 480);
+        ttlet result = resample(resampler, block, block.size());
+        output.insert(output.end(), result.begin(), result.end());
+    }
+
+    // The ratio changes are too small to change the amplitude of the tone.
+    auto peak = 0.0f;
+    for (auto i = 1000_uz; i != output.size(); ++i) {
+        peak = std::max(peak, std::abs(output[i]));
+    }
+    ASSERT_NEAR(peak, 0.5f, 0.001f);
+    ASSERT_NEAR(static_cast<double>(output.size()), 48000.0, 100.0);
+}
+
+TEST(audio_resampler, audio_block)
+{
+    auto resampler = audio_resampler(2, 48000, 96000);
+
+    auto left = std::vector<float>(480, 0.25f);
+    auto right = std::vector<float>(480, -0.25f);
+    auto input_samples = std::array<float *, 2>{left.data(), right.data()};
+    auto input = audio_block{};
+    input.samples = input_samples.data();
+    input.num_samples = 480;
+    input.num_channels = 2;
+    input.sample_rate = 48000;
+    input.state = audio_block_state::normal;
+
+    auto out_left = std::vector<float>(resampler.num_output_samples(480));
+    auto out_right = std::vector<float>(resampler.num_output_samples(480));
+    auto output_samples = std::array<float *, 2>{out_left.data(), out_right.data()};
+    auto output = audio_block{};
+    output.samples = output_samples.data();
+    output.num_channels = 2;
+
+    resampler.process(input, output);
+    ASSERT_EQ(output.num_samples, out_left.size());
+    ASSERT_EQ(output.sample_rate, 96000);
+    ASSERT_EQ(output.sample_count, 0);
+    ASSERT_EQ(output.state, audio_block_state::normal);
+
+    // DC passes unmodified once the filter is filled, and the channels are processed independently.
+    ASSERT_NEAR(out_left.back(), 0.25f, 1e-5f);
+    ASSERT_NEAR(out_right.back(), -0.25f, 1e-5f);
+
+    // The samples of a corrupt block are not read.
+    input.state = audio_block_state::corrupt;
+    ttlet num_output = resampler.num_output_samples(480);
+    resampler.process(input, output);
+    ASSERT_EQ(output.state, audio_block_state::corrupt);
+    ASSERT_EQ(output.num_samples, num_output);
+    ASSERT_EQ(output.sample_count, static_cast<int64_t>(out_left.size()));
+}
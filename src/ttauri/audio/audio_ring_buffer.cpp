@@ -0,0 +1,103 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "audio_ring_buffer.hpp"
+#include "../counters.hpp"
+#include "../memory.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace tt {
+
+/** The minimum number of samples of a channel, so that each channel starts on a new cache-line.
+ */
+constexpr size_t audio_ring_buffer_min_capacity = hardware_destructive_interference_size / sizeof(float);
+
+audio_ring_buffer::audio_ring_buffer(size_t num_channels, size_t capacity) noexcept :
+    _num_channels(num_channels), _capacity(std::bit_ceil(std::max(capacity, audio_ring_buffer_min_capacity)))
+{
+    tt_axiom(num_channels > 0);
+
+    // Over-allocate so that the first channel can be aligned to a cache-line.
+    _storage.resize(_num_channels * _capacity + audio_ring_buffer_min_capacity);
+    _samples = ceil(_storage.data(), hardware_destructive_interference_size);
+
+    // Register the counters here, so that they are not added to the map from a real-time thread.
+    register_counter<"audio_overrun">();
+    register_counter<"audio_underrun">();
+}
+
+size_t audio_ring_buffer::write(float const *const *samples, size_t num_samples) noexcept
+{
+    tt_axiom(samples != nullptr);
+
+    // Only the producer modifies _head.
+    ttlet head = _head.load(std::memory_order::relaxed);
+
+    // Only reload _tail from the consumer's cache-line when the cached value shows the buffer as full.
+    if (head - _tail_cache + num_samples > _capacity) {
+        _tail_cache = _tail.load(std::memory_order::acquire);
+    }
+
+    ttlet num_free = _capacity - narrow_cast<size_t>(head - _tail_cache);
+    if (num_samples > num_free) [[unlikely]] {
+        _num_overruns.fetch_add(1, std::memory_order::relaxed);
+        increment_counter<"audio_overrun">();
+        num_samples = num_free;
+    }
+
+    ttlet offset = narrow_cast<size_t>(head & (_capacity - 1));
+    ttlet first_size = std::min(num_samples, _capacity - offset);
+    ttlet second_size = num_samples - first_size;
+    for (auto i = 0_uz; i != _num_channels; ++i) {
+        ttlet src = samples[i];
+        ttlet dst = channel(i);
+        std::memcpy(dst + offset, src, first_size * sizeof(float));
+        std::memcpy(dst, src + first_size, second_size * sizeof(float));
+    }
+
+    // Release the samples to the consumer.
+    _head.store(head + num_samples, std::memory_order::release);
+    return num_samples;
+}
+
+size_t audio_ring_buffer::read(float *const *samples, size_t num_samples) noexcept
+{
+    tt_axiom(samples != nullptr);
+
+    // Only the consumer modifies _tail.
+    ttlet tail = _tail.load(std::memory_order::relaxed);
+
+    // Only reload _head from the producer's cache-line when the cached value shows the buffer as empty.
+    if (_head_cache - tail < num_samples) {
+        _head_cache = _head.load(std::memory_order::acquire);
+    }
+
+    ttlet num_available = narrow_cast<size_t>(_head_cache - tail);
+    auto num_silent = 0_uz;
+    if (num_samples > num_available) [[unlikely]] {
+        _num_underruns.fetch_add(1, std::memory_order::relaxed);
+        increment_counter<"audio_underrun">();
+        num_silent = num_samples - num_available;
+        num_samples = num_available;
+    }
+
+    ttlet offset = narrow_cast<size_t>(tail & (_capacity - 1));
+    ttlet first_size = std::min(num_samples, _capacity - offset);
+    ttlet second_size = num_samples - first_size;
+    for (auto i = 0_uz; i != _num_channels; ++i) {
+        ttlet src = channel(i);
+        ttlet dst = samples[i];
+        std::memcpy(dst, src + offset, first_size * sizeof(float));
+        std::memcpy(dst + first_size, src, second_size * sizeof(float));
+        std::fill_n(dst + num_samples, num_silent, 0.0f);
+    }
+
+    // Release the space to the producer.
+    _tail.store(tail + num_samples, std::memory_order::release);
+    return num_samples;
+}
+
+} // namespace tt
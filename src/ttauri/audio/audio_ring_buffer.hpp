@@ -0,0 +1,159 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "audio_block.hpp"
+#include "../required.hpp"
+#include "../architecture.hpp"
+#include "../cast.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace tt {
+
+/** A wait-free single-producer/single-consumer ring buffer for multi-channel audio.
+ *
+ * This ring buffer is used to pass audio between a real-time audio callback and
+ * a non-real-time thread, for metering, recording or the GUI. Either side may be
+ * the real-time thread; `write()` and `read()` never allocate, lock or wait.
+ *
+ * The samples of each channel are stored non-interleaved like in `audio_block`, so
+ * that a bulk write or read is a copy of at most two contiguous ranges per channel.
+ * The write and read positions are on separate cache-lines, and each side keeps a
+ * private copy of the position of the other side, which is only reloaded when the
+ * buffer appears to be full or empty.
+ *
+ * Samples that do not fit in the buffer are dropped and counted as an overrun,
+ * samples that are not available are read as silence and counted as an underrun.
+ * Both are also counted by the global counters "audio_overrun" and "audio_underrun".
+ */
+class audio_ring_buffer {
+public:
+    audio_ring_buffer(audio_ring_buffer const &) = delete;
+    audio_ring_buffer(audio_ring_buffer &&) = delete;
+    audio_ring_buffer &operator=(audio_ring_buffer const &) = delete;
+    audio_ring_buffer &operator=(audio_ring_buffer &&) = delete;
+
+    /** Create an audio ring buffer.
+     *
+     * @param num_channels The number of channels.
+     * @param capacity The minimum number of samples of each channel that can be buffered,
+     *                 this is rounded up to a power of two.
+     */
+    audio_ring_buffer(size_t num_channels, size_t capacity) noexcept;
+
+    /** The number of channels.
+     */
+    [[nodiscard]] size_t num_channels() const noexcept
+    {
+        return _num_channels;
+    }
+
+    /** The number of samples of each channel that can be buffered.
+     */
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    /** The number of samples of each channel that are available for reading.
+     * This function may only be called from the producer or the consumer thread.
+     * For the consumer this may show less samples then there really are,
+     * for the producer this may show more.
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        // Load _tail before _head; since _tail never passes _head the difference can not be negative.
+        // _head and _tail are 64 bit counters, they will never wrap around.
+        ttlet tail = _tail.load(std::memory_order::acquire);
+        ttlet head = _head.load(std::memory_order::acquire);
+        return std::min(narrow_cast<size_t>(head - tail), _capacity);
+    }
+
+    /** Write samples into the ring buffer.
+     * This function may only be called from the producer thread.
+     *
+     * @param samples A pointer to an array of pointers to the samples of each channel.
+     * @param num_samples The number of samples of each channel to write.
+     * @return The number of samples written, less than `num_samples` on an overrun.
+     */
+    size_t write(float const *const *samples, size_t num_samples) noexcept;
+
+    /** Write the samples of an audio block into the ring buffer.
+     * This function may only be called from the producer thread.
+     *
+     * @param block An audio block with the same number of channels as the ring buffer.
+     * @return The number of samples written, less than `block.num_samples` on an overrun.
+     */
+    size_t write(audio_block const &block) noexcept
+    {
+        tt_axiom(block.num_channels == _num_channels);
+        return write(block.samples, block.num_samples);
+    }
+
+    /** Read samples from the ring buffer.
+     * This function may only be called from the consumer thread.
+     *
+     * @param samples A pointer to an array of pointers to the samples of each channel.
+     * @param num_samples The number of samples of each channel to read.
+     * @return The number of samples read, on an underrun the rest of the samples are set to zero.
+     */
+    size_t read(float *const *samples, size_t num_samples) noexcept;
+
+    /** Read samples from the ring buffer into an audio block.
+     * This function may only be called from the consumer thread.
+     *
+     * @param block An audio block with the same number of channels as the ring buffer,
+     *              `block.num_samples` are read.
+     * @return The number of samples read, on an underrun the rest of the samples are set to zero.
+     */
+    size_t read(audio_block &block) noexcept
+    {
+        tt_axiom(block.num_channels == _num_channels);
+        return read(block.samples, block.num_samples);
+    }
+
+    /** The number of writes that did not fit in the ring buffer.
+     */
+    [[nodiscard]] int64_t num_overruns() const noexcept
+    {
+        return _num_overruns.load(std::memory_order::relaxed);
+    }
+
+    /** The number of reads for which not enough samples where available.
+     */
+    [[nodiscard]] int64_t num_underruns() const noexcept
+    {
+        return _num_underruns.load(std::memory_order::relaxed);
+    }
+
+private:
+    std::vector<float> _storage;
+    float *_samples;
+    size_t _num_channels;
+    size_t _capacity;
+
+    /** The number of samples written, modified by the producer.
+     */
+    alignas(hardware_destructive_interference_size) std::atomic<uint64_t> _head = 0;
+    uint64_t _tail_cache = 0;
+    std::atomic<int64_t> _num_overruns = 0;
+
+    /** The number of samples read, modified by the consumer.
+     */
+    alignas(hardware_destructive_interference_size) std::atomic<uint64_t> _tail = 0;
+    uint64_t _head_cache = 0;
+    std::atomic<int64_t> _num_underruns = 0;
+
+    [[nodiscard]] float *channel(size_t channel_nr) const noexcept
+    {
+        tt_axiom(channel_nr < _num_channels);
+        return _samples + channel_nr * _capacity;
+    }
+};
+
+} // namespace tt
@@ -0,0 +1,245 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "audio_ring_buffer.hpp"
+#include "../counters.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace tt;
+
+/** Non-interleaved sample buffers for a number of channels.
+ */
+struct test_buffers {
+    std::vector<std::vector<float>> channels;
+    std::vector<float *> pointers;
+
+    test_buffers(size_t num_channels, size_t num_samples) : channels(num_channels, std::vector<float>(num_samples))
+    {
+        for (auto &channel : channels) {
+            pointers.push_back(channel.data());
+        }
+    }
+
+    /** Fill each channel with a sequence, the channel number is added as a fraction.
+     */
+    void fill(float first)
+    {
+        for (auto i = 0_uz; i != channels.size(); ++i) {
+            auto value = first;
+            for (auto &sample : channels[i]) {
+                sample = value + static_cast<float>(i) * 0.25f;
+                value += 1.0f;
+            }
+        }
+    }
+
+    [[nodiscard]] audio_block block() noexcept
+    {
+        auto r = audio_block{};
+        r.samples = pointers.data();
+        r.num_samples = channels.front().size();
+        r.num_channels = channels.size();
+        r.state = audio_block_state::normal;
+        return r;
+    }
+};
+
+TEST(audio_ring_buffer, capacity)
+{
+    auto buffer = audio_ring_buffer(2, 100);
+    ASSERT_EQ(buffer.num_channels(), 2);
+    ASSERT_EQ(buffer.capacity(), 128);
+    ASSERT_EQ(buffer.size(), 0);
+
+    auto small_buffer = audio_ring_buffer(1, 1);
+    ASSERT_GE(small_buffer.capacity(), 16);
+}
+
+TEST(audio_ring_buffer, wrap_around)
+{
+    auto buffer = audio_ring_buffer(3, 64);
+    auto in = test_buffers(3, 40);
+    auto out = test_buffers(3, 40);
+
+    // Each write after the first wraps around the end of the buffer at a different position.
+    auto first = 0.0f;
+    for (auto i = 0; i != 10; ++i) {
+        in.fill(first);
+        ASSERT_EQ(buffer.write(in.block()), 40);
+        ASSERT_EQ(buffer.size(), 40);
+
+        auto out_block = out.block();
+        ASSERT_EQ(buffer.read(out_block), 40);
+        ASSERT_EQ(buffer.size(), 0);
+        ASSERT_EQ(out.channels, in.channels);
+        first += 40.0f;
+    }
+
+    ASSERT_EQ(buffer.num_overruns(), 0);
+    ASSERT_EQ(buffer.num_underruns(), 0);
+}
+
+TEST(audio_ring_buffer, overrun)
+{
+    auto buffer = audio_ring_buffer(2, 64);
+    auto in = test_buffers(2, 48);
+    ttlet counter_before = read_counter<"audio_overrun">();
+
+    in.fill(0.0f);
+    ASSERT_EQ(buffer.write(in.block()), 48);
+    in.fill(48.0f);
+    ASSERT_EQ(buffer.write(in.block()), 16);
+    ASSERT_EQ(buffer.size(), 64);
+    ASSERT_EQ(buffer.num_overruns(), 1);
+    ASSERT_EQ(read_counter<"audio_overrun">(), counter_before + 1);
+
+    // The samples that did fit are a contiguous sequence.
+    auto out = test_buffers(2, 64);
+    auto out_block = out.block();
+    ASSERT_EQ(buffer.read(out_block), 64);
+    for (auto i = 0_uz; i != 64; ++i) {
+        ASSERT_EQ(out.channels[0][i], static_cast<float>(i));
+        ASSERT_EQ(out.channels[1][i], static_cast<float>(i) + 0.25f);
+    }
+}
+
+TEST(audio_ring_buffer, underrun)
+{
+    auto buffer = audio_ring_buffer(2, 64);
+    auto in = test_buffers(2, 10);
+    auto out = test_buffers(2, 16);
+    ttlet counter_before = read_counter<"audio_underrun">();
+
+    in.fill(1.0f);
+    ASSERT_EQ(buffer.write(in.block()), 10);
+
+    out.fill(-1.0f);
+    auto out_block = out.block();
+    ASSERT_EQ(buffer.read(out_block), 10);
+    ASSERT_EQ(buffer.num_underruns(), 1);
+    ASSERT_EQ(read_counter<"audio_underrun">(), counter_before + 1);
+
+    // The samples that were not available are silent.
+    for (auto i = 0_uz; i != 16; ++i) {
+        ASSERT_EQ(out.channels[0][i], i < 10 ? static_cast<float>(i + 1) : 0.0f);
+        ASSERT_EQ(out.channels[1][i], i < 10 ? static_cast<float>(i + 1) + 0.25f : 0.0f);
+    }
+}
+
+/** Elevate the current thread to a real-time priority, when the process is allowed to.
+ */
+static void try_set_realtime_priority() noexcept
+{
+#if defined(__linux__)
+    auto param = sched_param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    // Without CAP_SYS_NICE or an rtprio limit this fails, the test will then run at normal priority.
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+TEST(audio_ring_buffer, realtime_producer)
+{
+    using namespace std::chrono_literals;
+
+    constexpr auto num_channels = 2_uz;
+    constexpr auto block_size = 64_uz;
+    constexpr auto num_blocks = 2000_uz;
+
+    auto buffer = audio_ring_buffer(num_channels, 1024);
+    auto done = std::atomic<bool>{false};
+
+    // The producer simulates an audio callback, which writes a block every 20 microseconds.
+    // Samples that are dropped on an overrun are skipped in the sequence.
+    auto producer = std::thread([&] {
+        try_set_realtime_priority();
+
+        auto in = test_buffers(num_channels, block_size);
+        auto first = 0.0f;
+        auto deadline = std::chrono::steady_clock::now();
+        for (auto i = 0_uz; i != num_blocks; ++i) {
+            in.fill(first);
+            first += static_cast<float>(buffer.write(in.block()));
+
+            deadline += 20us;
+            std::this_thread::sleep_until(deadline);
+        }
+        done.store(true, std::memory_order::release);
+    });
+
+    // The consumer reads in chunks of a size that is unrelated to the block size of the producer.
+    // A fatal assertion here would return while the producer is still joinable, so failures
+    // are reported with EXPECT and end the loop; the producer is joined before asserting.
+    auto out = test_buffers(num_channels, 100);
+    auto expected = 0.0f;
+    auto chunk_sizes = std::array<size_t, 4>{7, 100, 33, 64};
+    auto chunk_index = 0_uz;
+    auto failed = false;
+    while (not failed) {
+        ttlet producer_done = done.load(std::memory_order::acquire);
+
+        ttlet chunk_size = std::min(chunk_sizes[chunk_index++ % chunk_sizes.size()], buffer.size());
+        auto data = std::array<float *, num_channels>{out.pointers[0], out.pointers[1]};
+        ttlet num_read = buffer.read(data.data(), chunk_size);
+        EXPECT_EQ(num_read, chunk_size);
+        failed |= num_read != chunk_size;
+
+        for (auto i = 0_uz; i != num_read and not failed; ++i) {
+            EXPECT_EQ(out.channels[0][i], expected);
+            EXPECT_EQ(out.channels[1][i], expected + 0.25f);
+            failed |= out.channels[0][i] != expected or out.channels[1][i] != expected + 0.25f;
+            expected += 1.0f;
+        }
+
+        if (producer_done and buffer.size() == 0) {
+            break;
+        } else if (num_read == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    ASSERT_FALSE(failed);
+    ASSERT_GT(expected, 0.0f);
+
+    // Above the consumer never reads more than size(), so there must not have been an underrun.
+    ASSERT_EQ(buffer.num_underruns(), 0);
+
+    // Now read unconditionally, as an audio callback would, from the drained buffer.
+    ttlet counter_before = read_counter<"audio_underrun">();
+    for (auto i = 0_uz; i != 3; ++i) {
+        out.fill(-1.0f);
+        auto data = std::array<float *, num_channels>{out.pointers[0], out.pointers[1]};
+        ASSERT_EQ(buffer.read(data.data(), 100), 0);
+        for (auto j = 0_uz; j != 100; ++j) {
+            ASSERT_EQ(out.channels[0][j], 0.0f);
+            ASSERT_EQ(out.channels[1][j], 0.0f);
+        }
+        ASSERT_EQ(buffer.num_underruns(), narrow_cast<int64_t>(i + 1));
+    }
+
+    // A read of more samples than were written returns the written samples followed by silence.
+    auto in = test_buffers(num_channels, 10);
+    in.fill(expected);
+    ASSERT_EQ(buffer.write(in.block()), 10);
+    out.fill(-1.0f);
+    auto data = std::array<float *, num_channels>{out.pointers[0], out.pointers[1]};
+    ASSERT_EQ(buffer.read(data.data(), 100), 10);
+    for (auto j = 0_uz; j != 100; ++j) {
+        ASSERT_EQ(out.channels[0][j], j < 10 ? expected + static_cast<float>(j) : 0.0f);
+        ASSERT_EQ(out.channels[1][j], j < 10 ? expected + static_cast<float>(j) + 0.25f : 0.0f);
+    }
+    ASSERT_EQ(buffer.num_underruns(), 4);
+    ASSERT_EQ(read_counter<"audio_underrun">(), counter_before + 4);
+    ASSERT_EQ(buffer.size(), 0);
+}
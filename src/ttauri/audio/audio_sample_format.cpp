@@ -3,6 +3,7 @@
 // (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include "audio_sample_format.hpp"
+#include <algorithm>
 
 namespace tt {
 
@@ -33,7 +34,7 @@ namespace tt {
 {
     tt_axiom(is_valid());
 
-    auto r = narrow_cast<int>(std::bit_floor((((16u - num_bytes) / stride) & 3) + 1));
+    auto r = narrow_cast<int>(std::bit_floor(std::min((16u - num_bytes) / stride, 3u) + 1));
     tt_axiom(r == 1 || r == 2 || r == 4);
     return r;
 }
@@ -52,6 +53,10 @@ namespace tt {
 {
     tt_axiom(is_valid());
 
+    if (num_samples == 0) {
+        return 0;
+    }
+
     ttlet src_buffer_size = (num_samples - 1) * stride + num_bytes;
     if (src_buffer_size < 16) {
         return 0;
@@ -126,12 +131,60 @@ namespace tt {
     tt_axiom(is_valid());
     ttlet num_samples = num_samples_per_chunk();
 
-    // The bytes are shifted right.
-    ttlet byte_shift = (4 - num_samples) * 4;
+    // The bytes are shifted right by the samples in a single chunk.
+    ttlet byte_shift = num_samples * 4;
 
     return i8x16::byte_srl_shuffle_indices(byte_shift);
 }
 
+[[nodiscard]] i8x16 audio_sample_format::deinterleave_shuffle_indices() const noexcept
+{
+    tt_axiom(is_valid());
+
+    // Indices set to -1 result in a zero after a byte shuffle.
+    auto r = i8x16::broadcast(-1);
+    for (int channel_nr = 0; channel_nr != 4; ++channel_nr) {
+        ttlet sample_src_offset = channel_nr * num_bytes;
+        ttlet sample_dst_offset = channel_nr * 4;
+
+        // Bytes are ordered least to most significant.
+        for (int byte_nr = 0; byte_nr != num_bytes; ++byte_nr) {
+            ttlet src_offset = sample_src_offset + (endian == std::endian::little ? byte_nr : num_bytes - byte_nr - 1);
+
+            // Offset the bytes so they become aligned to the left.
+            ttlet dst_offset = sample_dst_offset + byte_nr + (4 - num_bytes);
+
+            r[dst_offset] = narrow_cast<int8_t>(src_offset);
+        }
+    }
+
+    return r;
+}
+
+[[nodiscard]] i8x16 audio_sample_format::interleave_shuffle_indices() const noexcept
+{
+    tt_axiom(is_valid());
+
+    // Indices set to -1 result in a zero after a byte shuffle.
+    auto r = i8x16::broadcast(-1);
+    for (int channel_nr = 0; channel_nr != 4; ++channel_nr) {
+        ttlet sample_dst_offset = channel_nr * num_bytes;
+        ttlet sample_src_offset = channel_nr * 4;
+
+        // Bytes are ordered least to most significant.
+        for (int byte_nr = 0; byte_nr != num_bytes; ++byte_nr) {
+            ttlet dst_offset = sample_dst_offset + (endian == std::endian::little ? byte_nr : num_bytes - byte_nr - 1);
+
+            // Take the bytes that are aligned to the left.
+            ttlet src_offset = sample_src_offset + byte_nr + (4 - num_bytes);
+
+            r[dst_offset] = narrow_cast<int8_t>(src_offset);
+        }
+    }
+
+    return r;
+}
+
 [[nodiscard]] bool audio_sample_format::is_valid() const noexcept
 {
     return (num_bytes >= 1 && num_bytes <= 4) && (num_bits + num_guard_bits <= num_bytes * 8) &&
@@ -100,6 +100,16 @@ struct audio_sample_format {
      */
     [[nodiscard]] i8x16 concat_shuffle_indices() const noexcept;
 
+    /** Return a shuffle indices for loading a frame of 4 consecutive channels into 32 bit integers.
+     * The packed samples of the channels are located in the first `num_bytes * 4` bytes.
+     */
+    [[nodiscard]] i8x16 deinterleave_shuffle_indices() const noexcept;
+
+    /** Return a shuffle indices for storing 32 bit samples of 4 consecutive channels into a frame.
+     * The packed samples of the channels are located in the first `num_bytes * 4` bytes.
+     */
+    [[nodiscard]] i8x16 interleave_shuffle_indices() const noexcept;
+
     /** Is the audio sample format valid.
      */
     [[nodiscard]] bool is_valid() const noexcept;
@@ -8,6 +8,11 @@
 #include "../memory.hpp"
 #include "../endian.hpp"
 #include "../rapid/numeric_array.hpp"
+#if defined(TT_X86_64_V2_5)
+#include "../rapid/f32x8_x64v25.hpp"
+#include "../cpu_id.hpp"
+#endif
+#include <array>
 #include <bit>
 #include <cstdint>
 #include <tuple>
@@ -85,10 +90,168 @@ static void store_sample(
     return r;
 }
 
-audio_sample_packer::audio_sample_packer(audio_sample_format format) noexcept : _dither(format.num_bits), _format(format)
+/** Convert float samples to integer samples aligned to the left.
+ * Float samples are returned unmodified, integer samples are returned as the bits of a f32x4.
+ */
+template<bool IsFloat>
+[[nodiscard]] static f32x4 pack_samples(f32x4 samples, f32x4 multiplier, dither &dither) noexcept
+{
+    if constexpr (IsFloat) {
+        return samples;
+
+    } else {
+        samples += dither.next();
+        samples = min(samples, f32x4::broadcast(1));
+        samples = max(samples, f32x4::broadcast(-1));
+        samples *= multiplier;
+        return bit_cast<f32x4>(static_cast<i32x4>(samples));
+    }
+}
+
+/** Store 4 samples of 4 consecutive channels as 4 frames.
+ *
+ * @param channels The 4 samples of each channel, as returned by `pack_samples()`.
+ * @param dst The location of the first channel in the first frame.
+ */
+template<int NumBytes>
+static void store_frames(
+    std::array<f32x4, 4> const &channels,
+    std::byte *dst,
+    i8x16 interleave_shuffle_indices,
+    int stride) noexcept
+{
+    ttlet frames = transpose(channels[0], channels[1], channels[2], channels[3]);
+    for (ttlet &frame : frames) {
+        shuffle(bit_cast<i8x16>(frame), interleave_shuffle_indices).store<NumBytes * 4>(dst);
+        dst += stride;
+    }
+}
+
+/** Pack 4 samples at a time of groups of 4 channels.
+ */
+template<int NumBytes, bool IsFloat>
+static void pack_frames_x4(
+    float const *const *src,
+    std::byte *dst,
+    size_t num_channels,
+    size_t first,
+    size_t last,
+    int stride,
+    i8x16 interleave_shuffle_indices,
+    f32x4 multiplier,
+    dither &dither) noexcept
+{
+    tt_axiom(num_channels % 4 == 0);
+    tt_axiom((last - first) % 4 == 0);
+
+    for (auto i = first; i != last; i += 4) {
+        auto frame_dst = dst + i * stride;
+        for (auto c = 0_uz; c != num_channels; c += 4) {
+            auto channels = std::array<f32x4, 4>{};
+            for (auto j = 0_uz; j != 4; ++j) {
+                channels[j] = pack_samples<IsFloat>(f32x4::load(src[c + j] + i), multiplier, dither);
+            }
+            store_frames<NumBytes>(channels, frame_dst, interleave_shuffle_indices, stride);
+            frame_dst += NumBytes * 4;
+        }
+    }
+}
+
+#if defined(TT_X86_64_V2_5)
+/** Pack 8 samples at a time of groups of 4 channels.
+ * The low lane of each register holds the first 4 samples, the high lane the next 4 samples;
+ * the lanes are transposed independently so that both byte shuffles use the same indices.
+ */
+template<int NumBytes, bool IsFloat>
+tt_target("avx2") static void pack_frames_x8_avx2(
+    float const *const *src,
+    std::byte *dst,
+    size_t num_channels,
+    size_t first,
+    size_t last,
+    int stride,
+    i8x16 interleave_shuffle_indices,
+    f32x4 multiplier,
+    dither &dither) noexcept
+{
+    tt_axiom(num_channels % 4 == 0);
+    tt_axiom((last - first) % 8 == 0);
+
+    ttlet shuffle_indices = _mm256_broadcastsi128_si256(interleave_shuffle_indices.reg());
+    ttlet multiplier_ = _mm256_set1_ps(get<0>(multiplier));
+    ttlet one = _mm256_set1_ps(1.0f);
+    ttlet min_one = _mm256_set1_ps(-1.0f);
+
+    for (auto i = first; i != last; i += 8) {
+        auto frame_dst = dst + i * stride;
+        for (auto c = 0_uz; c != num_channels; c += 4) {
+            __m256 channels[4];
+            for (auto j = 0_uz; j != 4; ++j) {
+                auto samples = _mm256_loadu_ps(src[c + j] + i);
+                if constexpr (not IsFloat) {
+                    ttlet dither_lo = dither.next();
+                    ttlet dither_hi = dither.next();
+                    samples = _mm256_add_ps(samples, _mm256_set_m128(dither_hi.reg(), dither_lo.reg()));
+                    samples = _mm256_min_ps(samples, one);
+                    samples = _mm256_max_ps(samples, min_one);
+                    samples = _mm256_mul_ps(samples, multiplier_);
+                    samples = _mm256_castsi256_ps(_mm256_cvtps_epi32(samples));
+                }
+                channels[j] = samples;
+            }
+
+            f32x8_x64v25_transpose_lanes(channels[0], channels[1], channels[2], channels[3]);
+
+            auto p = frame_dst;
+            for (ttlet frame : channels) {
+                ttlet packed = _mm256_shuffle_epi8(_mm256_castps_si256(frame), shuffle_indices);
+                i8x16{_mm256_castsi256_si128(packed)}.store<NumBytes * 4>(p);
+                i8x16{_mm256_extracti128_si256(packed, 1)}.store<NumBytes * 4>(p + 4 * stride);
+                p += stride;
+            }
+            frame_dst += NumBytes * 4;
+        }
+    }
+}
+#endif
+
+/** Pack the samples of groups of 4 channels, as much as possible 8 samples at a time.
+ *
+ * @return The number of samples that have been packed for each channel.
+ */
+template<int NumBytes, bool IsFloat>
+[[nodiscard]] static size_t pack_frames(
+    float const *const *src,
+    std::byte *dst,
+    size_t num_channels,
+    size_t num_samples,
+    int stride,
+    i8x16 interleave_shuffle_indices,
+    f32x4 multiplier,
+    dither &dither,
+    bool has_avx2) noexcept
+{
+    auto first = 0_uz;
+#if defined(TT_X86_64_V2_5)
+    if (has_avx2) {
+        first = num_samples / 8 * 8;
+        pack_frames_x8_avx2<NumBytes, IsFloat>(
+            src, dst, num_channels, 0, first, stride, interleave_shuffle_indices, multiplier, dither);
+    }
+#endif
+
+    ttlet last = num_samples / 4 * 4;
+    pack_frames_x4<NumBytes, IsFloat>(
+        src, dst, num_channels, first, last, stride, interleave_shuffle_indices, multiplier, dither);
+    return last;
+}
+
+audio_sample_packer::audio_sample_packer(audio_sample_format format, [[maybe_unused]] bool enable_avx2) noexcept :
+    _dither(format.num_bits), _format(format)
 {
     _store_shuffle_indices = format.store_shuffle_indices();
     _concat_shuffle_indices = format.concat_shuffle_indices();
+    _interleave_shuffle_indices = format.interleave_shuffle_indices();
 
     _multiplier = f32x4::broadcast(format.pack_multiplier());
 
@@ -98,6 +261,12 @@ audio_sample_packer::audio_sample_packer(audio_sample_format format) noexcept :
     _direction = format.endian == std::endian::little ? 1 : -1;
     _start_byte = format.endian == std::endian::little ? 0 : format.num_bytes - 1;
     _align_shift = 32 - format.num_bytes * 8;
+
+#if defined(TT_X86_64_V2_5)
+    _has_avx2 = enable_avx2 and cpu_has_avx2() and cpu_has_os_avx();
+#else
+    _has_avx2 = false;
+#endif
 }
 
 void audio_sample_packer::operator()(float const *tt_restrict src, std::byte *tt_restrict dst, size_t num_samples) const noexcept
@@ -162,4 +331,63 @@ void audio_sample_packer::operator()(float const *tt_restrict src, std::byte *tt
     }
 }
 
+void audio_sample_packer::operator()(
+    float const *const *tt_restrict src,
+    std::byte *tt_restrict dst,
+    size_t num_channels,
+    size_t num_samples) const noexcept
+{
+    tt_axiom(src != nullptr);
+    tt_axiom(dst != nullptr);
+    tt_axiom(_format.is_valid());
+    tt_axiom(num_channels * _format.num_bytes <= narrow_cast<size_t>(_format.stride));
+
+    ttlet num_fast_channels = num_channels / 4 * 4;
+    auto num_fast_samples = 0_uz;
+
+    if (num_fast_channels != 0) {
+        ttlet stride = _format.stride;
+        ttlet indices = _interleave_shuffle_indices;
+        ttlet multiplier = _multiplier;
+        ttlet has_avx2 = _has_avx2;
+        auto dither = _dither;
+
+        if (_format.is_float) {
+            tt_axiom(_format.num_bytes == 4);
+            num_fast_samples = pack_frames<4, true>(
+                src, dst, num_fast_channels, num_samples, stride, indices, multiplier, dither, has_avx2);
+        } else {
+            switch (_format.num_bytes) {
+            case 1:
+                num_fast_samples = pack_frames<1, false>(
+                    src, dst, num_fast_channels, num_samples, stride, indices, multiplier, dither, has_avx2);
+                break;
+            case 2:
+                num_fast_samples = pack_frames<2, false>(
+                    src, dst, num_fast_channels, num_samples, stride, indices, multiplier, dither, has_avx2);
+                break;
+            case 3:
+                num_fast_samples = pack_frames<3, false>(
+                    src, dst, num_fast_channels, num_samples, stride, indices, multiplier, dither, has_avx2);
+                break;
+            case 4:
+                num_fast_samples = pack_frames<4, false>(
+                    src, dst, num_fast_channels, num_samples, stride, indices, multiplier, dither, has_avx2);
+                break;
+            default: tt_no_default();
+            }
+        }
+
+        _dither = dither;
+    }
+
+    // The remaining samples and channels are packed one channel at a time.
+    for (auto c = 0_uz; c != num_channels; ++c) {
+        ttlet first = c < num_fast_channels ? num_fast_samples : 0_uz;
+        if (first != num_samples) {
+            (*this)(src[c] + first, dst + first * _format.stride + c * _format.num_bytes, num_samples - first);
+        }
+    }
+}
+
 } // namespace tt
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "audio_sample_format.hpp"
+#include "audio_block.hpp"
 #include "../required.hpp"
 #include "../architecture.hpp"
 #include "../rapid/numeric_array.hpp"
@@ -22,8 +23,10 @@ public:
      * interleaved channels.
      *
      * @param format The sample format.
+     * @param enable_avx2 Use AVX2 when the CPU supports it. When false the SSE code path
+     *                    is always used, which allows both paths to be tested on one CPU.
      */
-    audio_sample_packer(audio_sample_format format) noexcept;
+    audio_sample_packer(audio_sample_format format, bool enable_avx2 = true) noexcept;
 
     /** Unpack samples.
      *
@@ -33,9 +36,36 @@ public:
      */
     void operator()(float const *tt_restrict src, std::byte *tt_restrict dst, size_t num_samples) const noexcept;
 
+    /** Pack the samples of multiple channels into interleaved frames.
+     *
+     * The channels are handled in groups of 4, each group of samples is transposed
+     * in registers so that every frame is written with a single store. On CPUs with
+     * AVX2, 8 samples of each channel are handled at a time.
+     *
+     * @param src A pointer to an array of pointers to the floating point samples of each channel.
+     * @param dst A pointer to a byte array to store the packed frames into. The sample
+     *            of the n-th channel is stored at `n * format.num_bytes` inside a frame,
+     *            `format.stride` is the size of a frame.
+     * @param num_channels Number of channels.
+     * @param num_samples Number of samples for each channel.
+     */
+    void operator()(float const *const *tt_restrict src, std::byte *tt_restrict dst, size_t num_channels, size_t num_samples)
+        const noexcept;
+
+    /** Pack all the channels of an audio block into interleaved frames.
+     *
+     * @param src An audio block.
+     * @param dst A pointer to a byte array to store the packed frames into.
+     */
+    void operator()(audio_block const &src, std::byte *tt_restrict dst) const noexcept
+    {
+        (*this)(src.samples, dst, src.num_channels, src.num_samples);
+    }
+
 private:
     i8x16 _store_shuffle_indices;
     i8x16 _concat_shuffle_indices;
+    i8x16 _interleave_shuffle_indices;
     f32x4 _multiplier;
     mutable dither _dither;
     audio_sample_format _format;
@@ -44,6 +74,7 @@ private:
     int _direction;
     int _start_byte;
     int _align_shift;
+    bool _has_avx2;
 };
 
 } // namespace tt
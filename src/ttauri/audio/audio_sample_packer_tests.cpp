@@ -8,6 +8,8 @@
 #include <iostream>
 #include <string>
 #include <array>
+#include <vector>
+#include <cmath>
 
 using namespace tt;
 
@@ -1139,3 +1141,142 @@ TEST(audio_sample_packer, pack_float32be_mono)
         ASSERT_EQ(packed[i], static_cast<std::byte>(i));
     }
 }
+
+/** Decode a packed sample of any format.
+ */
+[[nodiscard]] static float decode_sample(std::byte const *p, audio_sample_format const &format)
+{
+    uint32_t u = 0;
+    for (int i = 0; i != format.num_bytes; ++i) {
+        ttlet byte_nr = format.endian == std::endian::little ? format.num_bytes - i - 1 : i;
+        u = (u << 8) | static_cast<uint32_t>(p[byte_nr]);
+    }
+    u <<= 32 - format.num_bytes * 8;
+
+    if (format.is_float) {
+        return std::bit_cast<float>(u);
+    } else {
+        return static_cast<float>(static_cast<int32_t>(u)) / format.pack_multiplier();
+    }
+}
+
+/** Pack an increasing number of channels and samples into interleaved frames.
+ * Each frame has room for one more channel, which must not be modified.
+ */
+static void test_pack_interleaved(audio_sample_format format, float max_diff)
+{
+    constexpr size_t max_num_channels = 11;
+    constexpr size_t max_num_samples = 37;
+    format.stride = (max_num_channels + 1) * format.num_bytes;
+    ttlet stride = static_cast<size_t>(format.stride);
+    ttlet num_bytes = static_cast<size_t>(format.num_bytes);
+
+    auto samples = std::vector<std::vector<float>>{};
+    auto channels = std::vector<float const *>{};
+    for (auto c = 0_uz; c != max_num_channels; ++c) {
+        auto &channel = samples.emplace_back(max_num_samples);
+        for (auto i = 0_uz; i != max_num_samples; ++i) {
+            channel[i] = 0.9f * std::sin(static_cast<float>(c) * 0.7f + static_cast<float>(i) * 0.3f);
+        }
+        channel[c % max_num_samples] = c % 2 == 0 ? 1.0f : -1.0f;
+        channels.push_back(channel.data());
+    }
+
+    // Test both the AVX2 and the SSE code path, the first is only used when the CPU supports it.
+    for (ttlet enable_avx2 : {true, false}) {
+        ttlet packer = audio_sample_packer{format, enable_avx2};
+        for (auto num_channels = 1_uz; num_channels <= max_num_channels; ++num_channels) {
+            for (auto num_samples = 0_uz; num_samples <= max_num_samples; ++num_samples) {
+                auto packed = std::vector<std::byte>(max_num_samples * stride, std::byte{0xa5});
+                packer(channels.data(), packed.data(), num_channels, num_samples);
+
+                for (auto i = 0_uz; i != packed.size(); ++i) {
+                    ttlet sample_nr = i / stride;
+                    ttlet channel_nr = (i % stride) / num_bytes;
+                    if (sample_nr >= num_samples or channel_nr >= num_channels) {
+                        ASSERT_EQ(packed[i], std::byte{0xa5});
+                    } else if (i % num_bytes == 0) {
+                        ASSERT_NEAR(samples[channel_nr][sample_nr], decode_sample(&packed[i], format), max_diff);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(audio_sample_packer, pack_int16le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 2;
+    format.num_guard_bits = 0;
+    format.num_bits = 15;
+    format.is_float = false;
+    format.endian = std::endian::little;
+    test_pack_interleaved(format, int16_max_diff);
+}
+
+TEST(audio_sample_packer, pack_int16be_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 2;
+    format.num_guard_bits = 0;
+    format.num_bits = 15;
+    format.is_float = false;
+    format.endian = std::endian::big;
+    test_pack_interleaved(format, int16_max_diff);
+}
+
+TEST(audio_sample_packer, pack_int24le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 3;
+    format.num_guard_bits = 0;
+    format.num_bits = 23;
+    format.is_float = false;
+    format.endian = std::endian::little;
+    test_pack_interleaved(format, int24_max_diff);
+}
+
+TEST(audio_sample_packer, pack_int20be_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 3;
+    format.num_guard_bits = 0;
+    format.num_bits = 19;
+    format.is_float = false;
+    format.endian = std::endian::big;
+    test_pack_interleaved(format, int20_max_diff);
+}
+
+TEST(audio_sample_packer, pack_fix8_24le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 4;
+    format.num_guard_bits = 8;
+    format.num_bits = 23;
+    format.is_float = false;
+    format.endian = std::endian::little;
+    test_pack_interleaved(format, fix8_24_max_diff);
+}
+
+TEST(audio_sample_packer, pack_float32le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 4;
+    format.num_guard_bits = 0;
+    format.num_bits = 23;
+    format.is_float = true;
+    format.endian = std::endian::little;
+    test_pack_interleaved(format, float32_max_diff);
+}
+
+TEST(audio_sample_packer, pack_float32be_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 4;
+    format.num_guard_bits = 0;
+    format.num_bits = 23;
+    format.is_float = true;
+    format.endian = std::endian::big;
+    test_pack_interleaved(format, float32_max_diff);
+}
@@ -8,6 +8,11 @@
 #include "../memory.hpp"
 #include "../endian.hpp"
 #include "../rapid/numeric_array.hpp"
+#if defined(TT_X86_64_V2_5)
+#include "../rapid/f32x8_x64v25.hpp"
+#include "../cpu_id.hpp"
+#endif
+#include <array>
 #include <bit>
 #include <cstdint>
 #include <tuple>
@@ -85,10 +90,149 @@ static void store_samples(float *&dst, f32x4 samples) noexcept
     dst += 4;
 }
 
-audio_sample_unpacker::audio_sample_unpacker(audio_sample_format format) noexcept : _format(format)
+/** Convert integer samples aligned to the left to float samples.
+ * Float samples are returned unmodified, integer samples are passed as the bits of a f32x4.
+ */
+template<bool IsFloat>
+[[nodiscard]] static f32x4 unpack_samples(f32x4 samples, f32x4 multiplier) noexcept
+{
+    if constexpr (IsFloat) {
+        return samples;
+    } else {
+        return static_cast<f32x4>(bit_cast<i32x4>(samples)) * multiplier;
+    }
+}
+
+/** Load 4 frames of 4 consecutive channels as 4 samples of each channel.
+ *
+ * @param src The location of the first channel in the first frame.
+ * @return The 4 samples of each channel, to be passed to `unpack_samples()`.
+ */
+template<int NumBytes>
+[[nodiscard]] static std::array<f32x4, 4>
+load_frames(std::byte const *src, i8x16 deinterleave_shuffle_indices, int stride) noexcept
+{
+    auto frames = std::array<f32x4, 4>{};
+    for (auto &frame : frames) {
+        frame = bit_cast<f32x4>(shuffle(i8x16::load<NumBytes * 4>(src), deinterleave_shuffle_indices));
+        src += stride;
+    }
+    return transpose(frames[0], frames[1], frames[2], frames[3]);
+}
+
+/** Unpack 4 samples at a time of groups of 4 channels.
+ */
+template<int NumBytes, bool IsFloat>
+static void unpack_frames_x4(
+    std::byte const *src,
+    float *const *dst,
+    size_t num_channels,
+    size_t first,
+    size_t last,
+    int stride,
+    i8x16 deinterleave_shuffle_indices,
+    f32x4 multiplier) noexcept
+{
+    tt_axiom(num_channels % 4 == 0);
+    tt_axiom((last - first) % 4 == 0);
+
+    for (auto i = first; i != last; i += 4) {
+        auto frame_src = src + i * stride;
+        for (auto c = 0_uz; c != num_channels; c += 4) {
+            ttlet channels = load_frames<NumBytes>(frame_src, deinterleave_shuffle_indices, stride);
+            for (auto j = 0_uz; j != 4; ++j) {
+                unpack_samples<IsFloat>(channels[j], multiplier).store(reinterpret_cast<std::byte *>(dst[c + j] + i));
+            }
+            frame_src += NumBytes * 4;
+        }
+    }
+}
+
+#if defined(TT_X86_64_V2_5)
+/** Unpack 8 samples at a time of groups of 4 channels.
+ * The low lane of each register is loaded with one of the first 4 frames, the high lane
+ * with one of the next 4 frames; after transposing the lanes each register holds 8 samples of a channel.
+ */
+template<int NumBytes, bool IsFloat>
+tt_target("avx2") static void unpack_frames_x8_avx2(
+    std::byte const *src,
+    float *const *dst,
+    size_t num_channels,
+    size_t first,
+    size_t last,
+    int stride,
+    i8x16 deinterleave_shuffle_indices,
+    f32x4 multiplier) noexcept
+{
+    tt_axiom(num_channels % 4 == 0);
+    tt_axiom((last - first) % 8 == 0);
+
+    ttlet shuffle_indices = _mm256_broadcastsi128_si256(deinterleave_shuffle_indices.reg());
+    ttlet multiplier_ = _mm256_set1_ps(get<0>(multiplier));
+
+    for (auto i = first; i != last; i += 8) {
+        auto frame_src = src + i * stride;
+        for (auto c = 0_uz; c != num_channels; c += 4) {
+            __m256 channels[4];
+
+            auto p = frame_src;
+            for (auto &frame : channels) {
+                ttlet lo = i8x16::load<NumBytes * 4>(p);
+                ttlet hi = i8x16::load<NumBytes * 4>(p + 4 * stride);
+                frame = _mm256_castsi256_ps(_mm256_shuffle_epi8(_mm256_set_m128i(hi.reg(), lo.reg()), shuffle_indices));
+                p += stride;
+            }
+
+            f32x8_x64v25_transpose_lanes(channels[0], channels[1], channels[2], channels[3]);
+
+            for (auto j = 0_uz; j != 4; ++j) {
+                auto samples = channels[j];
+                if constexpr (not IsFloat) {
+                    samples = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(samples)), multiplier_);
+                }
+                _mm256_storeu_ps(dst[c + j] + i, samples);
+            }
+            frame_src += NumBytes * 4;
+        }
+    }
+}
+#endif
+
+/** Unpack the samples of groups of 4 channels, as much as possible 8 samples at a time.
+ *
+ * @return The number of samples that have been unpacked for each channel.
+ */
+template<int NumBytes, bool IsFloat>
+[[nodiscard]] static size_t unpack_frames(
+    std::byte const *src,
+    float *const *dst,
+    size_t num_channels,
+    size_t num_samples,
+    int stride,
+    i8x16 deinterleave_shuffle_indices,
+    f32x4 multiplier,
+    bool has_avx2) noexcept
+{
+    auto first = 0_uz;
+#if defined(TT_X86_64_V2_5)
+    if (has_avx2) {
+        first = num_samples / 8 * 8;
+        unpack_frames_x8_avx2<NumBytes, IsFloat>(
+            src, dst, num_channels, 0, first, stride, deinterleave_shuffle_indices, multiplier);
+    }
+#endif
+
+    ttlet last = num_samples / 4 * 4;
+    unpack_frames_x4<NumBytes, IsFloat>(src, dst, num_channels, first, last, stride, deinterleave_shuffle_indices, multiplier);
+    return last;
+}
+
+audio_sample_unpacker::audio_sample_unpacker(audio_sample_format format, [[maybe_unused]] bool enable_avx2) noexcept :
+    _format(format)
 {
     _load_shuffle_indices = format.load_shuffle_indices();
     _concat_shuffle_indices = format.concat_shuffle_indices();
+    _deinterleave_shuffle_indices = format.deinterleave_shuffle_indices();
 
     _multiplier = f32x4::broadcast(format.unpack_multiplier());
     _num_chunks_per_quad = format.num_chunks_per_quad();
@@ -97,9 +241,13 @@ audio_sample_unpacker::audio_sample_unpacker(audio_sample_format format) noexcep
     _direction = format.endian == std::endian::little ? -1 : 1;
     _start_byte = format.endian == std::endian::little ? format.num_bytes - 1 : 0;
     _align_shift = 32 - format.num_bytes * 8;
-}
-
 
+#if defined(TT_X86_64_V2_5)
+    _has_avx2 = enable_avx2 and cpu_has_avx2() and cpu_has_os_avx();
+#else
+    _has_avx2 = false;
+#endif
+}
 
 void audio_sample_unpacker::operator()(std::byte const *tt_restrict src, float *tt_restrict dst, size_t num_samples)
     const noexcept
@@ -142,4 +290,60 @@ void audio_sample_unpacker::operator()(std::byte const *tt_restrict src, float *
     }
 }
 
+void audio_sample_unpacker::operator()(
+    std::byte const *tt_restrict src,
+    float *const *tt_restrict dst,
+    size_t num_channels,
+    size_t num_samples) const noexcept
+{
+    tt_axiom(src != nullptr);
+    tt_axiom(dst != nullptr);
+    tt_axiom(_format.is_valid());
+    tt_axiom(num_channels * _format.num_bytes <= narrow_cast<size_t>(_format.stride));
+
+    ttlet num_fast_channels = num_channels / 4 * 4;
+    auto num_fast_samples = 0_uz;
+
+    if (num_fast_channels != 0) {
+        ttlet stride = _format.stride;
+        ttlet indices = _deinterleave_shuffle_indices;
+        ttlet multiplier = _multiplier;
+        ttlet has_avx2 = _has_avx2;
+
+        if (_format.is_float) {
+            tt_axiom(_format.num_bytes == 4);
+            num_fast_samples =
+                unpack_frames<4, true>(src, dst, num_fast_channels, num_samples, stride, indices, multiplier, has_avx2);
+        } else {
+            switch (_format.num_bytes) {
+            case 1:
+                num_fast_samples =
+                    unpack_frames<1, false>(src, dst, num_fast_channels, num_samples, stride, indices, multiplier, has_avx2);
+                break;
+            case 2:
+                num_fast_samples =
+                    unpack_frames<2, false>(src, dst, num_fast_channels, num_samples, stride, indices, multiplier, has_avx2);
+                break;
+            case 3:
+                num_fast_samples =
+                    unpack_frames<3, false>(src, dst, num_fast_channels, num_samples, stride, indices, multiplier, has_avx2);
+                break;
+            case 4:
+                num_fast_samples =
+                    unpack_frames<4, false>(src, dst, num_fast_channels, num_samples, stride, indices, multiplier, has_avx2);
+                break;
+            default: tt_no_default();
+            }
+        }
+    }
+
+    // The remaining samples and channels are unpacked one channel at a time.
+    for (auto c = 0_uz; c != num_channels; ++c) {
+        ttlet first = c < num_fast_channels ? num_fast_samples : 0_uz;
+        if (first != num_samples) {
+            (*this)(src + first * _format.stride + c * _format.num_bytes, dst[c] + first, num_samples - first);
+        }
+    }
+}
+
 } // namespace tt
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "audio_sample_format.hpp"
+#include "audio_block.hpp"
 #include "../required.hpp"
 #include "../architecture.hpp"
 #include "../rapid/numeric_array.hpp"
@@ -21,8 +22,10 @@ public:
      * interleaved channels.
      *
      * @param format The sample format.
+     * @param enable_avx2 Use AVX2 when the CPU supports it. When false the SSE code path
+     *                    is always used, which allows both paths to be tested on one CPU.
      */
-    audio_sample_unpacker(audio_sample_format format) noexcept;
+    audio_sample_unpacker(audio_sample_format format, bool enable_avx2 = true) noexcept;
 
     /** Unpack samples.
      *
@@ -32,16 +35,44 @@ public:
      */
     void operator()(std::byte const *tt_restrict src, float *tt_restrict dst, size_t num_samples) const noexcept;
 
+    /** Unpack the samples of interleaved frames into multiple channels.
+     *
+     * The channels are handled in groups of 4, each frame is loaded with a single load
+     * and the samples are transposed in registers. On CPUs with AVX2, 8 samples of each
+     * channel are handled at a time.
+     *
+     * @param src A pointer to a byte array containing the frames. The sample of the n-th
+     *            channel is located at `n * format.num_bytes` inside a frame,
+     *            `format.stride` is the size of a frame.
+     * @param dst A pointer to an array of pointers to the floating point samples of each channel.
+     * @param num_channels Number of channels.
+     * @param num_samples Number of samples for each channel.
+     */
+    void operator()(std::byte const *tt_restrict src, float *const *tt_restrict dst, size_t num_channels, size_t num_samples)
+        const noexcept;
+
+    /** Unpack interleaved frames into all the channels of an audio block.
+     *
+     * @param src A pointer to a byte array containing the frames.
+     * @param dst An audio block, with `num_samples` and `num_channels` set.
+     */
+    void operator()(std::byte const *tt_restrict src, audio_block &dst) const noexcept
+    {
+        (*this)(src, dst.samples, dst.num_channels, dst.num_samples);
+    }
+
 private:
     f32x4 _multiplier;
     i8x16 _load_shuffle_indices;
     i8x16 _concat_shuffle_indices;
+    i8x16 _deinterleave_shuffle_indices;
     int _num_chunks_per_quad;
     int _chunk_stride;
     audio_sample_format _format;
     int _direction;
     int _start_byte;
     int _align_shift;
+    bool _has_avx2;
 
     [[nodiscard]] size_t calculate_num_fast_samples(size_t num_samples) const noexcept;
 };
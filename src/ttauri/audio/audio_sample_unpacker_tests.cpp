@@ -8,6 +8,7 @@
 #include <iostream>
 #include <string>
 #include <array>
+#include <vector>
 
 using namespace tt;
 
@@ -724,3 +725,123 @@ TEST(audio_sample_unpacker, unpack_float32be_mono)
     ASSERT_NEAR(flat_samples[6], float32_to_float(packed[24], packed[25], packed[26], packed[27]), float32_max_diff);
     ASSERT_NEAR(flat_samples[7], float32_to_float(packed[28], packed[29], packed[30], packed[31]), float32_max_diff);
 }
+
+/** Unpack an increasing number of channels and samples from interleaved frames.
+ * The result must be identical to unpacking one channel at a time.
+ */
+static void test_unpack_interleaved(audio_sample_format format)
+{
+    constexpr size_t max_num_channels = 11;
+    constexpr size_t max_num_samples = 37;
+    constexpr float sentinel = -2.0f;
+    format.stride = (max_num_channels + 1) * format.num_bytes;
+    ttlet stride = static_cast<size_t>(format.stride);
+    ttlet num_bytes = static_cast<size_t>(format.num_bytes);
+
+    auto packed = std::vector<std::byte>(max_num_samples * stride);
+    for (auto i = 0_uz; i != packed.size(); ++i) {
+        packed[i] = static_cast<std::byte>(i * 113 + 7);
+    }
+
+    // Test both the AVX2 and the SSE code path, the first is only used when the CPU supports it.
+    for (ttlet enable_avx2 : {true, false}) {
+        ttlet unpacker = audio_sample_unpacker{format, enable_avx2};
+        for (auto num_channels = 1_uz; num_channels <= max_num_channels; ++num_channels) {
+            for (auto num_samples = 0_uz; num_samples <= max_num_samples; ++num_samples) {
+                auto samples = std::vector<std::vector<float>>{};
+                auto channels = std::vector<float *>{};
+                for (auto c = 0_uz; c != num_channels; ++c) {
+                    channels.push_back(samples.emplace_back(max_num_samples, sentinel).data());
+                }
+                unpacker(packed.data(), channels.data(), num_channels, num_samples);
+
+                for (auto c = 0_uz; c != num_channels; ++c) {
+                    auto expected = std::vector<float>(max_num_samples, sentinel);
+                    unpacker(packed.data() + c * num_bytes, expected.data(), num_samples);
+
+                    for (auto i = 0_uz; i != max_num_samples; ++i) {
+                        // Compare the bits, the random bytes may be unpacked as NaN floats.
+                        ASSERT_EQ(std::bit_cast<uint32_t>(samples[c][i]), std::bit_cast<uint32_t>(expected[i]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(audio_sample_unpacker, unpack_int16le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 2;
+    format.num_guard_bits = 0;
+    format.num_bits = 15;
+    format.is_float = false;
+    format.endian = std::endian::little;
+    test_unpack_interleaved(format);
+}
+
+TEST(audio_sample_unpacker, unpack_int16be_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 2;
+    format.num_guard_bits = 0;
+    format.num_bits = 15;
+    format.is_float = false;
+    format.endian = std::endian::big;
+    test_unpack_interleaved(format);
+}
+
+TEST(audio_sample_unpacker, unpack_int24le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 3;
+    format.num_guard_bits = 0;
+    format.num_bits = 23;
+    format.is_float = false;
+    format.endian = std::endian::little;
+    test_unpack_interleaved(format);
+}
+
+TEST(audio_sample_unpacker, unpack_int20be_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 3;
+    format.num_guard_bits = 0;
+    format.num_bits = 19;
+    format.is_float = false;
+    format.endian = std::endian::big;
+    test_unpack_interleaved(format);
+}
+
+TEST(audio_sample_unpacker, unpack_fix8_24le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 4;
+    format.num_guard_bits = 8;
+    format.num_bits = 23;
+    format.is_float = false;
+    format.endian = std::endian::little;
+    test_unpack_interleaved(format);
+}
+
+TEST(audio_sample_unpacker, unpack_float32le_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 4;
+    format.num_guard_bits = 0;
+    format.num_bits = 23;
+    format.is_float = true;
+    format.endian = std::endian::little;
+    test_unpack_interleaved(format);
+}
+
+TEST(audio_sample_unpacker, unpack_float32be_interleaved)
+{
+    auto format = audio_sample_format{};
+    format.num_bytes = 4;
+    format.num_guard_bits = 0;
+    format.num_bits = 23;
+    format.is_float = true;
+    format.endian = std::endian::big;
+    test_unpack_interleaved(format);
+}
@@ -6,7 +6,11 @@
 #include "bezier_point.hpp"
 #include "pixel_map.inl"
 #include "memory.hpp"
+#include "cast.hpp"
+#include "rapid/numeric_array.hpp"
 #include <optional>
+#include <span>
+#include <cmath>
 
 namespace tt {
 
@@ -186,6 +190,44 @@ static std::optional<std::vector<std::pair<float,float>>> getFillSpansAtY(std::v
     return r;
 }
 
+/** Get the crossings of a horizontal scan-line with the curves, for filling with the nonzero winding rule.
+ *
+ * @param v The curves of all the contours.
+ * @param y The y-coordinate of the scan-line.
+ * @return The x-coordinates of the crossings sorted from left to right, with the direction in which
+ *         the curve crosses: +1 upward, -1 downward, and 0 where the curve touches the scan-line.
+ *         Empty when the scan-line passes through an anchor point, where a crossing may be counted twice.
+ */
+static std::optional<std::vector<std::pair<float, int>>> getWindingCrossingsAtY(std::vector<bezier_curve> const &v, float y) noexcept
+{
+    auto r = std::vector<std::pair<float, int>>{};
+    r.reserve(v.size());
+
+    for (ttlet &curve : v) {
+        if (y == curve.P1.y() || y == curve.P2.y()) {
+            return {};
+        }
+
+        auto ts = results<float, 3>{};
+        switch (curve.type) {
+        case bezier_curve::Type::Linear: ts = bezierFindT(curve.P1.y(), curve.P2.y(), y); break;
+        case bezier_curve::Type::Quadratic: ts = bezierFindT(curve.P1.y(), curve.C1.y(), curve.P2.y(), y); break;
+        case bezier_curve::Type::Cubic: ts = bezierFindT(curve.P1.y(), curve.C1.y(), curve.C2.y(), curve.P2.y(), y); break;
+        default: tt_no_default();
+        }
+
+        for (ttlet t : ts) {
+            if (t > 0.0f && t < 1.0f) {
+                ttlet dy = curve.tangentAt(t).y();
+                r.emplace_back(curve.pointAt(t).x(), dy > 0.0f ? 1 : dy < 0.0f ? -1 : 0);
+            }
+        }
+    }
+
+    std::sort(r.begin(), r.end());
+    return r;
+}
+
 static void fillPartialPixels(pixel_row<uint8_t> row, ssize_t const i, float const startX, float const endX) noexcept
 {
     ttlet pixelCoverage =
@@ -405,7 +447,25 @@ static void bad_pixels_horizontally(pixel_map<sdf_r8> &image) noexcept
 }
 
 
-void fill(pixel_map<sdf_r8> &image, std::vector<bezier_curve> const &curves) noexcept
+static void repair_sdf(pixel_map<sdf_r8> &image) noexcept
+{
+    bad_pixels_horizontally(image);
+    bad_pixels_edges(image);
+
+    std::vector<std::pair<int,int>> bad_pixel_list;
+    for (int i = 0; i < 10; i++) {
+        bad_pixel_list = bad_pixels_homogenious(image);
+        if (std::ssize(bad_pixel_list) == 0) {
+            break;
+        }
+
+        for (ttlet &[x, y]: bad_pixel_list) {
+            image[y][x].repair();
+        }
+    }
+}
+
+void fill_reference(pixel_map<sdf_r8> &image, std::vector<bezier_curve> const &curves) noexcept
 {
     for (int row_nr = 0; row_nr != image.height(); ++row_nr) {
         auto row = image.at(row_nr);
@@ -416,20 +476,244 @@ void fill(pixel_map<sdf_r8> &image, std::vector<bezier_curve> const &curves) noe
         }
     }
 
-    bad_pixels_horizontally(image);
-    bad_pixels_edges(image);
+    repair_sdf(image);
+}
 
-    std::vector<std::pair<int,int>> bad_pixel_list;
-    for (int i = 0; i < 10; i++) {
-        bad_pixel_list = bad_pixels_homogenious(image);
-        if (std::ssize(bad_pixel_list) == 0) {
+namespace {
+
+/** A grid of cells over an image, each cell lists the curves that may be within
+ * `sdf_r8::max_distance` of a pixel in that cell.
+ *
+ * The lists are stored back-to-back in a single vector, and the curves in each
+ * list are in the same order as the original list of curves.
+ */
+class sdf_curve_grid {
+public:
+    static constexpr ssize_t cell_size = 8;
+
+    sdf_curve_grid(ssize_t width, ssize_t height, std::vector<bezier_curve> const &curves) noexcept :
+        _nr_columns((width + cell_size - 1) / cell_size), _nr_rows((height + cell_size - 1) / cell_size)
+    {
+        _offsets.resize(narrow_cast<size_t>(_nr_columns * _nr_rows + 1), 0);
+
+        for (ttlet &curve : curves) {
+            for_each_cell(curve, [this](size_t cell) {
+                ++_offsets[cell + 1];
+            });
+        }
+
+        for (auto i = 1_uz; i != _offsets.size(); ++i) {
+            _offsets[i] += _offsets[i - 1];
+        }
+
+        _curve_indices.resize(_offsets.back());
+        auto fill_offsets = _offsets;
+        for (auto i = 0_uz; i != curves.size(); ++i) {
+            for_each_cell(curves[i], [this, &fill_offsets, i](size_t cell) {
+                _curve_indices[fill_offsets[cell]++] = narrow_cast<uint32_t>(i);
+            });
+        }
+    }
+
+    /** The indices of the curves near the cell which contains the pixel.
+     */
+    [[nodiscard]] std::span<uint32_t const> at(ssize_t column_nr, ssize_t row_nr) const noexcept
+    {
+        ttlet cell = narrow_cast<size_t>((row_nr / cell_size) * _nr_columns + column_nr / cell_size);
+        return {_curve_indices.data() + _offsets[cell], _offsets[cell + 1] - _offsets[cell]};
+    }
+
+private:
+    ssize_t _nr_columns;
+    ssize_t _nr_rows;
+    std::vector<size_t> _offsets;
+    std::vector<uint32_t> _curve_indices;
+
+    /** Call a function for each cell that contains a pixel within `sdf_r8::max_distance` of the curve.
+     * The control points of a curve form a hull around the curve.
+     */
+    template<typename Function>
+    void for_each_cell(bezier_curve const &curve, Function const &function) const noexcept
+    {
+        auto min_x = std::min(curve.P1.x(), curve.P2.x());
+        auto max_x = std::max(curve.P1.x(), curve.P2.x());
+        auto min_y = std::min(curve.P1.y(), curve.P2.y());
+        auto max_y = std::max(curve.P1.y(), curve.P2.y());
+        if (curve.type == bezier_curve::Type::Quadratic or curve.type == bezier_curve::Type::Cubic) {
+            min_x = std::min(min_x, curve.C1.x());
+            max_x = std::max(max_x, curve.C1.x());
+            min_y = std::min(min_y, curve.C1.y());
+            max_y = std::max(max_y, curve.C1.y());
+        }
+        if (curve.type == bezier_curve::Type::Cubic) {
+            min_x = std::min(min_x, curve.C2.x());
+            max_x = std::max(max_x, curve.C2.x());
+            min_y = std::min(min_y, curve.C2.y());
+            max_y = std::max(max_y, curve.C2.y());
+        }
+
+        ttlet first_column = std::max(ssize_t{0}, cell_index(min_x - sdf_r8::max_distance));
+        ttlet last_column = std::min(_nr_columns - 1, cell_index(max_x + sdf_r8::max_distance));
+        ttlet first_row = std::max(ssize_t{0}, cell_index(min_y - sdf_r8::max_distance));
+        ttlet last_row = std::min(_nr_rows - 1, cell_index(max_y + sdf_r8::max_distance));
+
+        for (auto row_nr = first_row; row_nr <= last_row; ++row_nr) {
+            for (auto column_nr = first_column; column_nr <= last_column; ++column_nr) {
+                function(narrow_cast<size_t>(row_nr * _nr_columns + column_nr));
+            }
+        }
+    }
+
+    [[nodiscard]] static ssize_t cell_index(float coordinate) noexcept
+    {
+        // Clamp first, so that huge coordinates do not overflow the integer.
+        ttlet clamped = std::clamp(coordinate, -1.0f, 1e6f);
+        return static_cast<ssize_t>(std::floor(clamped / static_cast<float>(cell_size)));
+    }
+};
+
+/** Calculate the signed distance between a group of pixels on a row and a linear curve.
+ * This uses the same math as `bezier_curve::sdf_distance()`.
+ *
+ * @param curve A linear curve.
+ * @param x The x-coordinates of the pixels.
+ * @param y The y-coordinate of the row.
+ * @param[out] distance The signed distances.
+ * @return false if the curve has zero length.
+ */
+template<size_t N>
+[[nodiscard]] bool sdf_distance_linear(bezier_curve const &curve, numeric_array<float, N> x, float y, numeric_array<float, N> &distance) noexcept
+{
+    using simd = numeric_array<float, N>;
+
+    ttlet dx = curve.P2.x() - curve.P1.x();
+    ttlet dy = curve.P2.y() - curve.P1.y();
+    ttlet t_below = dx * dx + dy * dy;
+    if (t_below == 0.0f) {
+        [[unlikely]] return false;
+    }
+
+    ttlet t_above = (x - curve.P1.x()) * dx + (y - curve.P1.y()) * dy;
+    ttlet t = clamp(t_above / simd::broadcast(t_below), simd::broadcast(0.0f), simd::broadcast(1.0f));
+
+    ttlet normal_x = x - (t * dx + curve.P1.x());
+    ttlet normal_y = y - (t * dy + curve.P1.y());
+    distance = sqrt(normal_x * normal_x + normal_y * normal_y);
+
+    // Same as `cross(tangent, normal) < 0.0 ? distance : -distance`.
+    ttlet cross = normal_y * dx - normal_x * dy;
+    ttlet inside_mask = lt(cross, simd::broadcast(0.0f));
+    for (auto i = 0_uz; i != N; ++i) {
+        if (not static_cast<bool>(inside_mask & (1U << i))) {
+            distance[i] = -distance[i];
+        }
+    }
+    return true;
+}
+
+/** Check if a pixel is inside of the glyph, using the nonzero winding rule on the crossings of a scan-line.
+ *
+ * @param crossings The crossings of the scan-line, from `getWindingCrossingsAtY()`.
+ * @param x The x-coordinate of the pixel, which is not on a curve.
+ */
+[[nodiscard]] bool is_inside(std::vector<std::pair<float, int>> const &crossings, float x) noexcept
+{
+    auto winding = 0;
+    for (ttlet &crossing : crossings) {
+        if (x < crossing.first) {
             break;
         }
+        winding += crossing.second;
+    }
+    return winding != 0;
+}
 
-        for (ttlet &[x, y]: bad_pixel_list) {
-            image[y][x].repair();
+/** Generate a row of the signed distance field, N pixels at a time.
+ */
+template<size_t N>
+void generate_sdf_r8_row(
+    pixel_row<sdf_r8> row,
+    ssize_t row_nr,
+    std::vector<bezier_curve> const &curves,
+    sdf_curve_grid const &grid,
+    std::optional<std::vector<std::pair<float, int>>> const &crossings) noexcept
+{
+    using simd = numeric_array<float, N>;
+    static_assert(sdf_curve_grid::cell_size % N == 0, "A group of pixels must be inside a single cell of the grid.");
+
+    auto lane_offsets = simd::broadcast(0.0f);
+    for (auto i = 0_uz; i != N; ++i) {
+        lane_offsets[i] = static_cast<float>(i);
+    }
+
+    ttlet y = static_cast<float>(row_nr);
+    for (ssize_t column_nr = 0; column_nr < row.width(); column_nr += N) {
+        ttlet nr_pixels = std::min(static_cast<ssize_t>(N), row.width() - column_nr);
+        ttlet x = lane_offsets + static_cast<float>(column_nr);
+
+        auto min_distance = simd::broadcast(std::numeric_limits<float>::max());
+        for (ttlet curve_index : grid.at(column_nr, row_nr)) {
+            ttlet &curve = curves[curve_index];
+
+            auto distance = simd::broadcast(0.0f);
+            if (curve.type == bezier_curve::Type::Linear) {
+                if (not sdf_distance_linear(curve, x, y, distance)) {
+                    continue;
+                }
+            } else {
+                for (auto i = 0_uz; i != N; ++i) {
+                    distance[i] = curve.sdf_distance(point2{x[i], y});
+                }
+            }
+
+            // Keep the first of equally close curves, same as the reference implementation.
+            ttlet closer_mask = lt(abs(distance), abs(min_distance));
+            for (auto i = 0_uz; i != N; ++i) {
+                if (static_cast<bool>(closer_mask & (1U << i))) {
+                    min_distance[i] = distance[i];
+                }
+            }
+        }
+
+        for (ssize_t i = 0; i != nr_pixels; ++i) {
+            ttlet distance = min_distance[narrow_cast<size_t>(i)];
+            if (std::abs(distance) < sdf_r8::max_distance) {
+                row[column_nr + i] = distance;
+            } else if (crossings) {
+                // No curve is close enough to this pixel, the distance saturates.
+                row[column_nr + i] = is_inside(*crossings, x[narrow_cast<size_t>(i)]) ? sdf_r8::max_distance : -sdf_r8::max_distance;
+            } else {
+                // The scan-line is numerically unstable, take the sign from the closest of all curves.
+                row[column_nr + i] = generate_sdf_r8_pixel(point2{x[narrow_cast<size_t>(i)], y}, curves);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void fill(pixel_map<sdf_r8> &image, std::vector<bezier_curve> const &curves) noexcept
+{
+    ttlet grid = sdf_curve_grid{image.width(), image.height(), curves};
+
+    for (ssize_t row_nr = 0; row_nr != image.height(); ++row_nr) {
+        ttlet y = static_cast<float>(row_nr);
+
+        // If the scanline passes through an anchor point, try again slightly offset;
+        // otherwise the pixels far from the curves are signed the same way as the reference.
+        auto crossings = getWindingCrossingsAtY(curves, y);
+        if (not crossings) {
+            crossings = getWindingCrossingsAtY(curves, y + 0.01f);
+        }
+
+        if constexpr (x86_64_v2_5) {
+            generate_sdf_r8_row<8>(image.at(row_nr), row_nr, curves, grid, crossings);
+        } else {
+            generate_sdf_r8_row<4>(image.at(row_nr), row_nr, curves, grid, crossings);
         }
     }
+
+    repair_sdf(image);
 }
 
 }
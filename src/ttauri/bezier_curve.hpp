@@ -354,9 +354,27 @@ makeContourFromPoints(std::vector<bezier_point>::const_iterator first, std::vect
 void fill(pixel_map<uint8_t> &image, std::vector<bezier_curve> const &curves) noexcept;
 
 /** Fill a signed distance field image from the given contour.
+ *
+ * Only the curves within `sdf_r8::max_distance` of a pixel are evaluated, using a grid of
+ * curve-lists; pixels further away are saturated and get their sign from a scanline fill
+ * with the nonzero winding rule, so that overlapping contours are filled.
+ * The distances to linear curves are calculated for a group of pixels at once using SIMD.
+ *
+ * The result is the same as `fill_reference()`, except far from the curves in a region where
+ * the closest curve belongs to an overlapping contour: the reference takes the sign from that
+ * curve and leaves a hole.
+ *
  * @param image An signed-distance-field which show distance toward the closest curve
  * @param curves All curves of path, in no particular order.
  */
 void fill(pixel_map<sdf_r8> &image, std::vector<bezier_curve> const &curves) noexcept;
 
+/** Fill a signed distance field image from the given contour.
+ * The reference implementation, which calculates the distance to every curve for every pixel.
+ *
+ * @param image An signed-distance-field which show distance toward the closest curve
+ * @param curves All curves of path, in no particular order.
+ */
+void fill_reference(pixel_map<sdf_r8> &image, std::vector<bezier_curve> const &curves) noexcept;
+
 } // namespace tt
@@ -7,6 +7,9 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <numbers>
+#include <cmath>
 
 using namespace std;
 using namespace tt;
@@ -17,3 +20,113 @@ TEST(bezier_cruve, solve_x_by_y) {
     ASSERT_RESULTS(bezier_curve(point2(2.0f,2.0f), point2(1.5f,2.0f), point2(1.0f,2.0f)).solveXByY(1.5f), tt::results3());
     ASSERT_RESULTS(bezier_curve(point2(1.0f,2.0f), point2(1.0f,1.5f), point2(1.0f,1.0f)).solveXByY(1.5f), tt::results3(1.0f));
 }
+
+namespace {
+
+[[nodiscard]] std::vector<bezier_curve> make_polygon(std::vector<point2> const &points)
+{
+    auto r = std::vector<bezier_curve>{};
+    for (size_t i = 0; i != points.size(); ++i) {
+        r.emplace_back(points[i], points[(i + 1) % points.size()]);
+    }
+    return r;
+}
+
+/** A clockwise circle made out of quadratic curves.
+ */
+[[nodiscard]] std::vector<bezier_curve> make_circle(point2 center, float radius, int nr_segments)
+{
+    ttlet step = -2.0f * std::numbers::pi_v<float> / nr_segments;
+    ttlet control_radius = radius / std::cos(step * 0.5f);
+
+    auto r = std::vector<bezier_curve>{};
+    for (int i = 0; i != nr_segments; ++i) {
+        ttlet a1 = step * i;
+        ttlet a2 = step * (i + 1);
+        ttlet ac = (a1 + a2) * 0.5f;
+        r.emplace_back(
+            center + vector2{std::cos(a1), std::sin(a1)} * radius,
+            center + vector2{std::cos(ac), std::sin(ac)} * control_radius,
+            center + vector2{std::cos(a2), std::sin(a2)} * radius);
+    }
+    return r;
+}
+
+void assert_sdf_equal(std::vector<bezier_curve> const &curves, ssize_t width, ssize_t height)
+{
+    auto expected = pixel_map<sdf_r8>{width, height};
+    auto result = pixel_map<sdf_r8>{width, height};
+    fill_reference(expected, curves);
+    fill(result, curves);
+
+    for (ssize_t y = 0; y != height; ++y) {
+        for (ssize_t x = 0; x != width; ++x) {
+            // Allow for a single step of the 8-bit signed distance field due to rounding of the SIMD calculation.
+            ASSERT_NEAR(static_cast<float>(result[y][x]), static_cast<float>(expected[y][x]), 0.03f) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+} // namespace
+
+TEST(bezier_curve, fill_sdf_empty)
+{
+    assert_sdf_equal({}, 13, 11);
+}
+
+TEST(bezier_curve, fill_sdf_square_with_hole)
+{
+    auto curves = make_polygon({point2{10.0f, 10.0f}, point2{10.0f, 50.0f}, point2{50.0f, 50.0f}, point2{50.0f, 10.0f}});
+    auto hole = make_polygon({point2{20.0f, 20.0f}, point2{40.0f, 20.0f}, point2{40.0f, 40.0f}, point2{20.0f, 40.0f}});
+    curves.insert(curves.end(), hole.begin(), hole.end());
+
+    // A width which is not a multiple of the SIMD width or grid cell.
+    assert_sdf_equal(curves, 61, 64);
+
+    auto image = pixel_map<sdf_r8>{61, 64};
+    fill(image, curves);
+    ASSERT_EQ(static_cast<float>(image[15][15]), sdf_r8::max_distance);
+    ASSERT_EQ(static_cast<float>(image[30][30]), -sdf_r8::max_distance);
+    ASSERT_EQ(static_cast<float>(image[2][2]), -sdf_r8::max_distance);
+}
+
+TEST(bezier_curve, fill_sdf_circle)
+{
+    assert_sdf_equal(make_circle(point2{32.5f, 30.25f}, 24.0f, 8), 64, 64);
+    assert_sdf_equal(make_circle(point2{20.0f, 20.0f}, 3.5f, 6), 40, 40);
+}
+
+TEST(bezier_curve, fill_sdf_overlapping)
+{
+    // Two overlapping squares with the same orientation, the overlap is far from the outer curves.
+    auto curves = make_polygon({point2{8.0f, 8.0f}, point2{8.0f, 30.0f}, point2{30.0f, 30.0f}, point2{30.0f, 8.0f}});
+    auto other = make_polygon({point2{12.0f, 12.0f}, point2{12.0f, 34.0f}, point2{34.0f, 34.0f}, point2{34.0f, 12.0f}});
+    curves.insert(curves.end(), other.begin(), other.end());
+
+    assert_sdf_equal(curves, 43, 40);
+
+    // With the even-odd rule the overlap would be a hole.
+    auto image = pixel_map<sdf_r8>{43, 40};
+    fill(image, curves);
+    ASSERT_EQ(static_cast<float>(image[21][21]), sdf_r8::max_distance);
+    ASSERT_EQ(static_cast<float>(image[2][2]), -sdf_r8::max_distance);
+}
+
+TEST(bezier_curve, fill_sdf_self_intersecting)
+{
+    // A pentagram drawn as a single contour, the pentagon in the middle has a winding number of two.
+    // The points of the star are narrow enough that all their pixels are near a curve.
+    auto points = std::vector<point2>{};
+    for (int i = 0; i != 5; ++i) {
+        ttlet angle = std::numbers::pi_v<float> * (0.5f - 0.8f * i);
+        points.push_back(point2{20.0f, 20.0f} + vector2{std::cos(angle), std::sin(angle)} * 15.5f);
+    }
+    ttlet curves = make_polygon(points);
+
+    assert_sdf_equal(curves, 40, 40);
+
+    auto image = pixel_map<sdf_r8>{40, 40};
+    fill(image, curves);
+    ASSERT_EQ(static_cast<float>(image[20][20]), sdf_r8::max_distance);
+    ASSERT_EQ(static_cast<float>(image[2][2]), -sdf_r8::max_distance);
+}
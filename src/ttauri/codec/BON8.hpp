@@ -327,8 +327,8 @@ public:
      * @tparam T Type of the values.
      * @param items A vector of values.
      */
-    template<typename T>
-    void add(std::vector<T> const &items) {
+    template<typename T, typename Allocator>
+    void add(std::vector<T, Allocator> const &items) {
         open_string = false;
         if (std::ssize(items) == 0) {
             output += static_cast<std::byte>(BON8_code_array_empty);
@@ -658,10 +658,12 @@ void BON8_encoder::add(datum const &value) {
 
 /** Decode BON8 message from buffer.
  * @param buffer A buffer to a BON8 encoded message.
+ * @param allocation How to allocate the strings, vectors and maps of the decoded message.
  * @return The decoded message.
  */
-[[nodiscard]] datum decode_BON8(std::span<const std::byte> buffer)
+[[nodiscard]] datum decode_BON8(std::span<const std::byte> buffer, datum_allocation allocation = datum_allocation::heap)
 {
+    ttlet arena_scope = datum_arena_scope{allocation};
     auto *ptr = buffer.data();
     auto *last = ptr + buffer.size();
     return detail::decode_BON8(ptr, last);
@@ -669,10 +671,12 @@ void BON8_encoder::add(datum const &value) {
 
 /** Decode BON8 message from buffer.
  * @param buffer A buffer to a BON8 encoded message.
+ * @param allocation How to allocate the strings, vectors and maps of the decoded message.
  * @return The decoded message.
  */
-[[nodiscard]] datum decode_BON8(bstring const &buffer)
+[[nodiscard]] datum decode_BON8(bstring const &buffer, datum_allocation allocation = datum_allocation::heap)
 {
+    ttlet arena_scope = datum_arena_scope{allocation};
     auto *ptr = buffer.data();
     auto *last = ptr + buffer.size();
     return detail::decode_BON8(ptr, last);
@@ -680,10 +684,12 @@ void BON8_encoder::add(datum const &value) {
 
 /** Decode BON8 message from buffer.
  * @param buffer A buffer to a BON8 encoded message.
+ * @param allocation How to allocate the strings, vectors and maps of the decoded message.
  * @return The decoded message.
  */
-[[nodiscard]] datum decode_BON8(bstring_view buffer)
+[[nodiscard]] datum decode_BON8(bstring_view buffer, datum_allocation allocation = datum_allocation::heap)
 {
+    ttlet arena_scope = datum_arena_scope{allocation};
     auto *ptr = buffer.data();
     auto *last = ptr + buffer.size();
     return detail::decode_BON8(ptr, last);
@@ -3,14 +3,33 @@
 // (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include "JSON.hpp"
+#include <string>
+#include <unordered_map>
 
 namespace tt {
 
 struct parse_context_t {
     std::string_view::const_iterator text_begin;
 
+    /** The keys of the objects in the document.
+     * The same keys are repeated throughout a document, so each key is stored once and shared.
+     * Keys are not interned, since they come from untrusted input and interned strings are never freed.
+     */
+    std::unordered_map<std::string, datum> keys;
 };
 
+/** Get the shared key of an object in the document.
+ */
+[[nodiscard]] static datum const &make_key(parse_context_t &context, std::string &&name)
+{
+    auto i = context.keys.find(name);
+    if (i == context.keys.end()) {
+        auto key = datum{name};
+        i = context.keys.emplace(std::move(name), std::move(key)).first;
+    }
+    return i->second;
+}
+
 [[nodiscard]] static parse_result<datum> parseValue(parse_context_t &context, token_iterator token);
 
 [[nodiscard]] static parse_result<datum> parseArray(parse_context_t &context, token_iterator token)
@@ -88,7 +107,7 @@ struct parse_context_t {
             }
 
             if (auto result = parseValue(context, token)) {
-                object[name] = *result;
+                object[make_key(context, std::move(name))] = *result;
                 token = result.next_token;
 
             } else {
@@ -148,10 +167,11 @@ struct parse_context_t {
     }
 }
 
-[[nodiscard]] datum parse_JSON(std::string_view text)
+[[nodiscard]] datum parse_JSON(std::string_view text, datum_allocation allocation)
 {
     token_vector tokens = parseTokens(text);
 
+    ttlet arena_scope = datum_arena_scope{allocation};
     datum root;
 
     tt_axiom(tokens.back() == tokenizer_name_t::End);
@@ -175,9 +195,9 @@ struct parse_context_t {
     return root;
 }
 
-[[nodiscard]] datum parse_JSON(URL const &url)
+[[nodiscard]] datum parse_JSON(URL const &url, datum_allocation allocation)
 {
-    return parse_JSON(url.loadView()->string_view());
+    return parse_JSON(url.loadView()->string_view(), allocation);
 }
 
 static void format_JSON_impl(datum const &value, std::string &result, tt::indent indent={})
@@ -21,15 +21,17 @@ namespace tt {
 
 /** Parse a JSON string.
  * @param text The text to parse.
+ * @param allocation How to allocate the strings, vectors and maps of the parsed object.
  * @return A datum representing the parsed object.
  */
-[[nodiscard]] datum parse_JSON(std::string_view text);
+[[nodiscard]] datum parse_JSON(std::string_view text, datum_allocation allocation = datum_allocation::heap);
 
 /** Parse a JSON string.
  * @param file URL pointing to the file to parse.
+ * @param allocation How to allocate the strings, vectors and maps of the parsed object.
  * @return A datum representing the parsed object.
  */
-[[nodiscard]] datum parse_JSON(tt::URL const &file);
+[[nodiscard]] datum parse_JSON(tt::URL const &file, datum_allocation allocation = datum_allocation::heap);
 
 /** Dump an datum object into a JSON string.
  * @param root datum-object to serialize
@@ -6,6 +6,8 @@
 #include "ttauri/required.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <string>
+#include <format>
 
 using namespace std;
 using namespace tt;
@@ -92,4 +94,26 @@ TEST(JSON, ParseTwoItemObject) {
     expected["foo"]["baz"] = 43;
     ASSERT_EQ(parse_JSON("{\"foo\": {\"bar\": 42, \"baz\": 43}}"), expected);
     ASSERT_EQ(parse_JSON("{\"foo\": {\"bar\": 42, \"baz\": 43,}}"), expected);
-}
\ No newline at end of file
+}
+TEST(JSON, ParseArena) {
+    auto text = std::string{"{\"items\": ["};
+    for (auto i = 0; i != 1000; ++i) {
+        text += std::format("{{\"index\": {}, \"name\": \"item number {}\", \"tags\": [\"first tag\", \"second tag\"]}},", i, i);
+    }
+    text += "]}";
+
+    ttlet expected = parse_JSON(text);
+
+    auto result = datum{};
+    {
+        ttlet arena_scope = datum_arena_scope{};
+        result = parse_JSON(text);
+
+        // Each item allocates a map, a vector and three long strings, with the nodes of the map.
+        ASSERT_GT(arena_scope.arena()->allocation_count(), 5000);
+    }
+
+    // The document keeps the arena alive after the scope has ended.
+    ASSERT_EQ(result, expected);
+    ASSERT_EQ(parse_JSON(text, datum_allocation::arena), expected);
+}
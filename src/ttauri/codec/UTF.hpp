@@ -5,12 +5,19 @@
 #pragma once
 
 #include "../required.hpp"
+#include "../architecture.hpp"
 #include "../endian.hpp"
 #include "../CP1252.hpp"
 #include <type_traits>
 #include <iterator>
 #include <bit>
 
+#if defined(TT_X86_64_V3)
+#include <immintrin.h>
+#elif defined(TT_X86_64_V1)
+#include <emmintrin.h>
+#endif
+
 namespace tt {
 
 /** Convert a UTF-16 encoded code-point to a UTF-32 encoded code-point
@@ -91,7 +98,7 @@ template<typename Iterator>
         cp |= static_cast<char32_t>(*(it++) & 0x3f);
         cp <<= 6;
         cp |= static_cast<char32_t>(*(it++) & 0x3f);
-        tt_axiom(cp >= 0x100000 && cp <= 0x10ffff, "UTF-8 Overlong encoding");
+        tt_axiom(cp >= 0x10000 && cp <= 0x10ffff, "UTF-8 Overlong encoding");
         return cp;
     }
 }
@@ -153,13 +160,14 @@ constexpr bool utf8_to_utf32(Iterator &it, Iterator last, char32_t &code_point)
         }
 
         code_point <<= 6;
-        code_point = *(it++) & 0x3f;
+        code_point |= *(it++) & 0x3f;
     }
 
     if ((code_point >= 0xd800 && code_point <= 0xdfff) || // Surrogate pair
         (continuation_count == 1 && code_point < 0x0080) || // Overlong
         (continuation_count == 2 && code_point < 0x0800) || // Overlong
-        (continuation_count == 3 && code_point < 0x10000) // Overlong
+        (continuation_count == 3 && code_point < 0x10000) || // Overlong
+        code_point > 0x10ffff // Beyond the 17 planes
     ) {
         // Surrogate pair
         code_point = CP1252_to_UTF32(static_cast<char>(first_cu));
@@ -170,10 +178,26 @@ constexpr bool utf8_to_utf32(Iterator &it, Iterator last, char32_t &code_point)
     return true;
 }
 
+namespace detail {
+
+/** The type of the code-units written through a back-insert-iterator or a pointer.
+ */
+template<typename OutputIterator>
+struct utf_output_value {
+    using type = typename OutputIterator::container_type::value_type;
+};
+
+template<typename T>
+struct utf_output_value<T *> {
+    using type = T;
+};
+
+} // namespace detail
+
 /** Convert a UTF-32 encoded code point to a UTF-16 encoded code point.
  * It is undefined behavior when the code-point is outside the Unicode range or if it is a surrogate-code.
  *
- * @tparam Iterator A LegacyOutputIterator
+ * @tparam BackInsertIterator A back-insert-iterator, or a pointer into a buffer that is large enough.
  * @param code_point The code point to encode.
  * @param [in,out] it An iterator pointing to where the UTF-16 code units should be inserted.
  *                    After the call the iterator points beyond the code point.
@@ -181,7 +205,7 @@ constexpr bool utf8_to_utf32(Iterator &it, Iterator last, char32_t &code_point)
 template<typename BackInsertIterator>
 constexpr void utf32_to_utf16(char32_t code_point, BackInsertIterator &it) noexcept
 {
-    using value_type = typename BackInsertIterator::container_type::value_type;
+    using value_type = typename detail::utf_output_value<BackInsertIterator>::type;
     static_assert(sizeof(value_type) == 2, "Iterator must point to a two byte character type");
 
     if (code_point <= 0xffff) {
@@ -200,7 +224,7 @@ constexpr void utf32_to_utf16(char32_t code_point, BackInsertIterator &it) noexc
 /** Convert a UTF-32 encoded code point to a UTF-8 encoded code point.
  * It is undefined behavior when the code-point is outside the Unicode range or if it is a surrogate-code.
  *
- * @tparam Iterator A LegacyOutputIterator
+ * @tparam BackInsertIterator A back-insert-iterator, or a pointer into a buffer that is large enough.
  * @param code_point The code point to encode.
  * @param [in,out] it An iterator pointing to where the UTF-8 code units should be inserted.
  *                    After the call the iterator points beyond the code point.
@@ -208,7 +232,7 @@ constexpr void utf32_to_utf16(char32_t code_point, BackInsertIterator &it) noexc
 template<typename BackInsertIterator>
 constexpr void utf32_to_utf8(char32_t code_point, BackInsertIterator &it) noexcept
 {
-    using value_type = typename BackInsertIterator::container_type::value_type;
+    using value_type = typename detail::utf_output_value<BackInsertIterator>::type;
     static_assert(sizeof(value_type) == 1, "UTF-8 values must be stored in a 1 byte character type");
 
     if (code_point <= 0x7f) {
@@ -233,6 +257,303 @@ constexpr void utf32_to_utf8(char32_t code_point, BackInsertIterator &it) noexce
     }
 }
 
+namespace detail {
+
+#if defined(TT_X86_64_V1)
+/** Store 16 ASCII characters as UTF-8, UTF-16 or UTF-32 code-units.
+ */
+template<typename CharT>
+void store_ascii(CharT *dst, __m128i chunk) noexcept
+{
+    if constexpr (sizeof(CharT) == 1) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), chunk);
+
+    } else {
+        ttlet zero = _mm_setzero_si128();
+        ttlet lo = _mm_unpacklo_epi8(chunk, zero);
+        ttlet hi = _mm_unpackhi_epi8(chunk, zero);
+        if constexpr (sizeof(CharT) == 2) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8), hi);
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+}
+#endif
+
+#if defined(TT_X86_64_V3)
+/** Store 32 ASCII characters as UTF-8, UTF-16 or UTF-32 code-units.
+ */
+template<typename CharT>
+void store_ascii(CharT *dst, __m256i chunk) noexcept
+{
+    if constexpr (sizeof(CharT) == 1) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), chunk);
+
+    } else {
+        ttlet lo = _mm256_castsi256_si128(chunk);
+        ttlet hi = _mm256_extracti128_si256(chunk, 1);
+        if constexpr (sizeof(CharT) == 2) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_cvtepu8_epi16(lo));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 16), _mm256_cvtepu8_epi16(hi));
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_cvtepu8_epi32(lo));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 16), _mm256_cvtepu8_epi32(hi));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+        }
+    }
+}
+#endif
+
+/** Skip over a run of ASCII UTF-8 code-units, a block at a time.
+ *
+ * @param first The first code-unit.
+ * @param last One beyond the last code-unit.
+ * @return The first non-ASCII code-unit, or a code-unit in the last partial block.
+ */
+[[nodiscard]] inline char8_t const *utf8_skip_ascii(char8_t const *first, char8_t const *last) noexcept
+{
+#if defined(TT_X86_64_V3)
+    while (last - first >= 32) {
+        ttlet mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(first))));
+        if (mask != 0) {
+            return first + std::countr_zero(mask);
+        }
+        first += 32;
+    }
+#endif
+#if defined(TT_X86_64_V1)
+    while (last - first >= 16) {
+        ttlet mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(first))));
+        if (mask != 0) {
+            return first + std::countr_zero(mask);
+        }
+        first += 16;
+    }
+#endif
+    return first;
+}
+
+/** Convert a run of ASCII UTF-8 code-units, a block at a time.
+ *
+ * A full block is written to `dst`, but the pointers are only advanced over the ASCII code-units;
+ * the caller must make sure that `dst` has room for as many code-units as are left in `src`.
+ *
+ * @param [in,out] src The first code-unit, after the call the first non-ASCII code-unit
+ *                     or a code-unit in the last partial block.
+ * @param last One beyond the last code-unit.
+ * @param [in,out] dst Where to write the converted code-units to.
+ */
+template<typename CharT>
+void utf8_ascii_run(char8_t const *&src, char8_t const *last, CharT *&dst) noexcept
+{
+#if defined(TT_X86_64_V3)
+    while (last - src >= 32) {
+        ttlet chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src));
+        ttlet mask = static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+        store_ascii(dst, chunk);
+
+        ttlet n = mask == 0 ? 32 : std::countr_zero(mask);
+        src += n;
+        dst += n;
+        if (mask != 0) {
+            return;
+        }
+    }
+#endif
+#if defined(TT_X86_64_V1)
+    while (last - src >= 16) {
+        ttlet chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+        ttlet mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+        store_ascii(dst, chunk);
+
+        ttlet n = mask == 0 ? 16 : std::countr_zero(mask);
+        src += n;
+        dst += n;
+        if (mask != 0) {
+            return;
+        }
+    }
+#endif
+}
+
+/** Convert a run of ASCII UTF-16 code-units to UTF-8, a block at a time.
+ *
+ * @see utf8_ascii_run()
+ */
+template<typename CharT>
+void utf16_ascii_run(char16_t const *&src, char16_t const *last, CharT *&dst) noexcept
+{
+    static_assert(sizeof(CharT) == 1);
+
+#if defined(TT_X86_64_V1)
+    ttlet zero = _mm_setzero_si128();
+    ttlet non_ascii = _mm_set1_epi16(static_cast<short>(0xff80));
+    while (last - src >= 8) {
+        ttlet chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+        ttlet is_ascii = _mm_cmpeq_epi16(_mm_and_si128(chunk, non_ascii), zero);
+        ttlet mask = static_cast<uint32_t>(_mm_movemask_epi8(is_ascii)) ^ 0xffff;
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(chunk, chunk));
+
+        ttlet n = mask == 0 ? 8 : std::countr_zero(mask) / 2;
+        src += n;
+        dst += n;
+        if (mask != 0) {
+            return;
+        }
+    }
+#endif
+}
+
+/** Convert a run of ASCII UTF-32 code-units to UTF-8, a block at a time.
+ *
+ * @see utf8_ascii_run()
+ */
+template<typename CharT>
+void utf32_ascii_run(char32_t const *&src, char32_t const *last, CharT *&dst) noexcept
+{
+    static_assert(sizeof(CharT) == 1);
+
+#if defined(TT_X86_64_V1)
+    ttlet zero = _mm_setzero_si128();
+    ttlet non_ascii = _mm_set1_epi32(static_cast<int>(0xffff'ff80));
+    while (last - src >= 8) {
+        ttlet lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+        ttlet hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + 4));
+        ttlet is_ascii_lo = _mm_cmpeq_epi32(_mm_and_si128(lo, non_ascii), zero);
+        ttlet is_ascii_hi = _mm_cmpeq_epi32(_mm_and_si128(hi, non_ascii), zero);
+        ttlet mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi32(is_ascii_lo, is_ascii_hi))) ^ 0xffff;
+        ttlet words = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(words, words));
+
+        ttlet n = mask == 0 ? 8 : std::countr_zero(mask) / 2;
+        src += n;
+        dst += n;
+        if (mask != 0) {
+            return;
+        }
+    }
+#endif
+}
+
+/** Convert a run of UTF-16 code-units without surrogates to UTF-32, a block at a time.
+ *
+ * @see utf8_ascii_run()
+ */
+inline void utf16_bmp_run(char16_t const *&src, char16_t const *last, char32_t *&dst) noexcept
+{
+#if defined(TT_X86_64_V1)
+    ttlet zero = _mm_setzero_si128();
+    ttlet surrogate_mask = _mm_set1_epi16(static_cast<short>(0xf800));
+    ttlet surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+    while (last - src >= 8) {
+        ttlet chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+        ttlet is_surrogate = _mm_cmpeq_epi16(_mm_and_si128(chunk, surrogate_mask), surrogate);
+        ttlet mask = static_cast<uint32_t>(_mm_movemask_epi8(is_surrogate));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(chunk, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4), _mm_unpackhi_epi16(chunk, zero));
+
+        ttlet n = mask == 0 ? 8 : std::countr_zero(mask) / 2;
+        src += n;
+        dst += n;
+        if (mask != 0) {
+            return;
+        }
+    }
+#endif
+}
+
+/** Convert a run of UTF-32 code-units in the basic multilingual plane to UTF-16, a block at a time.
+ *
+ * @see utf8_ascii_run()
+ */
+inline void utf32_bmp_run(char32_t const *&src, char32_t const *last, char16_t *&dst) noexcept
+{
+#if defined(TT_X86_64_V1)
+    ttlet zero = _mm_setzero_si128();
+    ttlet plane_mask = _mm_set1_epi32(static_cast<int>(0xffff'0000));
+    ttlet surrogate_mask = _mm_set1_epi32(0xf800);
+    ttlet surrogate = _mm_set1_epi32(0xd800);
+    ttlet bias32 = _mm_set1_epi32(0x8000);
+    ttlet bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    while (last - src >= 8) {
+        ttlet lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+        ttlet hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + 4));
+        ttlet is_bmp_lo = _mm_andnot_si128(
+            _mm_cmpeq_epi32(_mm_and_si128(lo, surrogate_mask), surrogate), _mm_cmpeq_epi32(_mm_and_si128(lo, plane_mask), zero));
+        ttlet is_bmp_hi = _mm_andnot_si128(
+            _mm_cmpeq_epi32(_mm_and_si128(hi, surrogate_mask), surrogate), _mm_cmpeq_epi32(_mm_and_si128(hi, plane_mask), zero));
+        ttlet mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi32(is_bmp_lo, is_bmp_hi))) ^ 0xffff;
+
+        // Bias the code-units so that the signed saturation of the pack does not clamp them.
+        ttlet words = _mm_packs_epi32(_mm_sub_epi32(lo, bias32), _mm_sub_epi32(hi, bias32));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_xor_si128(words, bias16));
+
+        ttlet n = mask == 0 ? 8 : std::countr_zero(mask) / 2;
+        src += n;
+        dst += n;
+        if (mask != 0) {
+            return;
+        }
+    }
+#endif
+}
+
+/** Convert a UTF-8 string to UTF-8, UTF-16 or UTF-32.
+ *
+ * Runs of ASCII are converted a block at a time, other code-points are decoded with
+ * `utf8_to_utf32(it, last, code_point)`, so that invalid code-units are replaced
+ * with their CP-1252 interpretation in a single pass.
+ *
+ * @param rhs A UTF-8 encoded string, which may be invalid.
+ * @return A valid string.
+ */
+template<typename StringT>
+[[nodiscard]] StringT utf8_to_utf(std::u8string_view rhs) noexcept
+{
+    using value_type = typename StringT::value_type;
+
+    // A code-unit re-encoded from CP-1252 to UTF-8 takes up to three code-units,
+    // otherwise UTF-16 and UTF-32 never need more code-units than UTF-8.
+    constexpr size_t max_expansion = sizeof(value_type) == 1 ? 3 : 1;
+
+    auto r = StringT(rhs.size() * max_expansion, value_type{});
+    auto dst = r.data();
+    auto src = rhs.data();
+    ttlet last = src + rhs.size();
+    while (src != last) {
+        utf8_ascii_run(src, last, dst);
+        if (src == last) {
+            break;
+        }
+
+        auto code_point = char32_t{};
+        utf8_to_utf32(src, last, code_point);
+        if constexpr (sizeof(value_type) == 1) {
+            utf32_to_utf8(code_point, dst);
+        } else if constexpr (sizeof(value_type) == 2) {
+            utf32_to_utf16(code_point, dst);
+        } else {
+            *(dst++) = static_cast<value_type>(code_point);
+        }
+    }
+
+    r.resize(dst - r.data());
+    return r;
+}
+
+[[nodiscard]] inline std::u8string_view as_u8string_view(std::string_view rhs) noexcept
+{
+    return {reinterpret_cast<char8_t const *>(rhs.data()), rhs.size()};
+}
+
+} // namespace detail
+
 /** Sanitize a UTF-32 string so it contains only valid encoded Unicode code points.
  *
  * This function will replace invalid code units with the unicode-replacement-character 0xfffd.
@@ -381,37 +702,16 @@ template<typename Container>
 {
     auto r = std::move(rhs);
 
-    ttlet first = begin(rhs);
-    ttlet last = end(rhs);
-
     auto code_point = char32_t{};
-    auto valid = true;
-    auto old_it = first;
-    for (auto it = first; valid && it != last;) {
-        old_it = it;
-        valid &= utf8_to_utf32(it, last, code_point);
-    }
-
-    if (valid) {
-        return r;
-    }
-
-    // Copy the valid UTF-8 code units and prepare for
-    // re-encoding the rest of the string.
-    auto tmp = std::u8string{begin(r), old_it};
-    tmp.reserve(size(r));
-
-    // Add the last decoded code point.
-    auto tmp_i = std::back_inserter(tmp);
-    utf32_to_utf8(code_point, tmp_i);
-
-    // Re-encode the rest of the string.
-    for (auto it = old_it + 1; it != last;) {
-        utf8_to_utf32(it, last, code_point);
-        utf32_to_utf8(code_point, tmp_i);
+    char8_t const *const last = r.data() + r.size();
+    for (char8_t const *it = r.data(); it != last;) {
+        it = detail::utf8_skip_ascii(it, last);
+        if (it != last && !utf8_to_utf32(it, last, code_point)) {
+            // The valid prefix is copied as-is by the conversion.
+            return detail::utf8_to_utf<std::u8string>(r);
+        }
     }
 
-    std::swap(r, tmp);
     return r;
 }
 
@@ -420,27 +720,46 @@ namespace detail {
 template<typename StringT>
 [[nodiscard]] inline StringT to_u8string(std::u16string_view const &rhs) noexcept
 {
-    auto r = StringT{};
-    r.reserve(rhs.size());
-    auto r_it = std::back_inserter(r);
+    using value_type = typename StringT::value_type;
+
+    // Each UTF-16 code-unit is encoded in at most three UTF-8 code-units.
+    auto r = StringT(rhs.size() * 3, value_type{});
+    auto dst = r.data();
+    auto src = rhs.data();
+    ttlet last = src + rhs.size();
+    while (src != last) {
+        utf16_ascii_run(src, last, dst);
+        if (src == last) {
+            break;
+        }
 
-    for (auto it = std::begin(rhs); it != std::end(rhs);) {
-        ttlet c32 = utf16_to_utf32(it);
-        utf32_to_utf8(c32, r_it);
+        ttlet c32 = utf16_to_utf32(src);
+        utf32_to_utf8(c32, dst);
     }
+
+    r.resize(dst - r.data());
     return r;
 }
 
 template<typename StringT>
 [[nodiscard]] inline StringT to_u8string(std::u32string_view const &rhs) noexcept
 {
-    auto r = StringT{};
-    r.reserve(rhs.size());
-    auto r_it = std::back_inserter(r);
+    using value_type = typename StringT::value_type;
+
+    auto r = StringT(rhs.size() * 4, value_type{});
+    auto dst = r.data();
+    auto src = rhs.data();
+    ttlet last = src + rhs.size();
+    while (src != last) {
+        utf32_ascii_run(src, last, dst);
+        if (src == last) {
+            break;
+        }
 
-    for (auto c32 : rhs) {
-        utf32_to_utf8(c32, r_it);
+        utf32_to_utf8(*(src++), dst);
     }
+
+    r.resize(dst - r.data());
     return r;
 }
 
@@ -521,15 +840,7 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::u16string to_u16string(std::u8string_view const &rhs) noexcept
 {
-    auto r = std::u16string{};
-    r.reserve(rhs.size());
-    auto r_it = std::back_inserter(r);
-
-    for (auto it = std::begin(rhs); it != std::end(rhs);) {
-        ttlet c32 = utf8_to_utf32(it);
-        utf32_to_utf16(c32, r_it);
-    }
-    return r;
+    return detail::utf8_to_utf<std::u16string>(rhs);
 }
 
 /** UTF-32 string to UTF-16 string conversion.
@@ -540,13 +851,20 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::u16string to_u16string(std::u32string_view const &rhs) noexcept
 {
-    auto r = std::u16string{};
-    r.reserve(rhs.size());
-    auto r_it = std::back_inserter(r);
+    auto r = std::u16string(rhs.size() * 2, char16_t{});
+    auto dst = r.data();
+    auto src = rhs.data();
+    ttlet last = src + rhs.size();
+    while (src != last) {
+        detail::utf32_bmp_run(src, last, dst);
+        if (src == last) {
+            break;
+        }
 
-    for (auto c32 : rhs) {
-        utf32_to_utf16(c32, r_it);
+        utf32_to_utf16(*(src++), dst);
     }
+
+    r.resize(dst - r.data());
     return r;
 }
 
@@ -558,13 +876,7 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::u32string to_u32string(std::u8string_view const &rhs) noexcept
 {
-    auto r = std::u32string{};
-    r.reserve(rhs.size());
-
-    for (auto it = std::begin(rhs); it != std::end(rhs);) {
-        r += utf8_to_utf32(it);
-    }
-    return r;
+    return detail::utf8_to_utf<std::u32string>(rhs);
 }
 
 /** UTF-16 string to UTF-32 string conversion.
@@ -575,12 +887,20 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::u32string to_u32string(std::u16string_view const &rhs) noexcept
 {
-    auto r = std::u32string{};
-    r.reserve(rhs.size());
+    auto r = std::u32string(rhs.size(), char32_t{});
+    auto dst = r.data();
+    auto src = rhs.data();
+    ttlet last = src + rhs.size();
+    while (src != last) {
+        detail::utf16_bmp_run(src, last, dst);
+        if (src == last) {
+            break;
+        }
 
-    for (auto it = std::begin(rhs); it != std::end(rhs);) {
-        r += utf16_to_utf32(it);
+        *(dst++) = utf16_to_utf32(src);
     }
+
+    r.resize(dst - r.data());
     return r;
 }
 
@@ -603,7 +923,7 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::u16string to_u16string(std::string_view const &rhs) noexcept
 {
-    return to_u16string(sanitize_u8string(std::u8string{reinterpret_cast<char8_t const *>(rhs.data()), rhs.size()}));
+    return detail::utf8_to_utf<std::u16string>(detail::as_u8string_view(rhs));
 }
 
 /** Convert a string to a UTF-32 encoded string.
@@ -614,7 +934,7 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::u32string to_u32string(std::string_view const &rhs) noexcept
 {
-    return to_u32string(sanitize_u8string(std::u8string{reinterpret_cast<char8_t const *>(rhs.data()), rhs.size()}));
+    return detail::utf8_to_utf<std::u32string>(detail::as_u8string_view(rhs));
 }
 
 /** Convert a wide-string to a UTF-8 encoded string.
@@ -696,8 +1016,7 @@ template<typename StringT>
  */
 [[nodiscard]] inline std::wstring to_wstring(std::string_view const &rhs) noexcept
 {
-    auto s8 = sanitize_u8string(std::u8string{reinterpret_cast<char8_t const *>(rhs.data()), rhs.size()});
-    return to_wstring(s8);
+    return to_wstring(detail::as_u8string_view(rhs));
 }
 
 /** Convert a UTF-16 encoded string to a wide-string.
@@ -0,0 +1,123 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/codec/UTF.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+using namespace std;
+using namespace tt;
+
+/** Decode a UTF-8 string one code-point at a time.
+ */
+static u32string reference_u8_to_u32(u8string_view rhs)
+{
+    auto r = u32string{};
+    auto code_point = char32_t{};
+    for (auto it = rhs.begin(); it != rhs.end();) {
+        utf8_to_utf32(it, rhs.end(), code_point);
+        r += code_point;
+    }
+    return r;
+}
+
+static u16string reference_u32_to_u16(u32string_view rhs)
+{
+    auto r = u16string{};
+    auto r_it = back_inserter(r);
+    for (ttlet c : rhs) {
+        utf32_to_utf16(c, r_it);
+    }
+    return r;
+}
+
+static u8string reference_u32_to_u8(u32string_view rhs)
+{
+    auto r = u8string{};
+    auto r_it = back_inserter(r);
+    for (ttlet c : rhs) {
+        utf32_to_utf8(c, r_it);
+    }
+    return r;
+}
+
+/** A random code-point, mostly ASCII so that the block conversions are interrupted often.
+ */
+static char32_t random_code_point(std::mt19937 &rng)
+{
+    switch (rng() % 8) {
+    case 0: return static_cast<char32_t>(0x80 + rng() % 0x780);
+    case 1: return static_cast<char32_t>(0x800 + rng() % 0xd000);
+    case 2: return static_cast<char32_t>(0xe000 + rng() % 0x2000);
+    case 3: return static_cast<char32_t>(0x10000 + rng() % 0x100000);
+    default: return static_cast<char32_t>(rng() % 0x80);
+    }
+}
+
+TEST(UTF, sanitize_u8string)
+{
+    // Invalid code-units are interpreted as CP-1252.
+    ASSERT_EQ(to_u32string(std::string_view{"a\x80z"}), U"a\u20acz");
+    // Overlong encoding.
+    ASSERT_EQ(to_u32string(std::string_view{"\xc0\xaf"}), U"\u00c0\u00af");
+    // Truncated code-point.
+    ASSERT_EQ(to_u32string(std::string_view{"\xe2\x82"}), U"\u00e2\u201a");
+    // Beyond the 17 planes.
+    ASSERT_EQ(to_u32string(std::string_view{"\xf4\x90\x80\x80"}), U"\u00f4\ufffd\u20ac\u20ac");
+    // Encoded surrogate.
+    ASSERT_EQ(to_u32string(std::string_view{"\xed\xa0\x80"}), U"\u00ed\u00a0\u20ac");
+
+    ASSERT_EQ(to_u8string(std::string_view{"abc\xe2\x82\xac"}), u8"abc\u20ac");
+    ASSERT_EQ(to_u8string(std::string_view{"0123456789abcdef\x80"}), u8"0123456789abcdef\u20ac");
+}
+
+TEST(UTF, fuzz_utf8)
+{
+    auto rng = std::mt19937{42};
+
+    for (auto i = 0; i != 2000; ++i) {
+        auto s = u8string{};
+        ttlet length = rng() % 100;
+        for (auto j = 0_uz; j != length; ++j) {
+            if (rng() % 16 == 0) {
+                // A random byte, which is often invalid UTF-8.
+                s += static_cast<char8_t>(rng());
+            } else {
+                ttlet c32 = random_code_point(rng);
+                auto s_it = back_inserter(s);
+                utf32_to_utf8(c32, s_it);
+            }
+        }
+        ttlet sv = std::string_view{reinterpret_cast<char const *>(s.data()), s.size()};
+
+        ttlet expected = reference_u8_to_u32(s);
+        ASSERT_EQ(to_u32string(sv), expected);
+        ASSERT_EQ(to_u16string(sv), reference_u32_to_u16(expected));
+        ASSERT_EQ(to_u8string(sv), reference_u32_to_u8(expected));
+    }
+}
+
+TEST(UTF, fuzz_utf16_utf32)
+{
+    auto rng = std::mt19937{42};
+
+    for (auto i = 0; i != 2000; ++i) {
+        auto s32 = u32string{};
+        ttlet length = rng() % 100;
+        for (auto j = 0_uz; j != length; ++j) {
+            s32 += random_code_point(rng);
+        }
+
+        ttlet s16 = reference_u32_to_u16(s32);
+        ttlet s8 = reference_u32_to_u8(s32);
+
+        ASSERT_EQ(to_u16string(s32), s16);
+        ASSERT_EQ(to_u16string(s8), s16);
+        ASSERT_EQ(to_u32string(s16), s32);
+        ASSERT_EQ(to_u32string(s8), s32);
+        ASSERT_EQ(to_u8string(s16), s8);
+        ASSERT_EQ(to_u8string(s32), s8);
+    }
+}
@@ -36,17 +36,23 @@ struct counter_functor {
     // Make sure non of the counters are false sharing cache-lines.
     alignas(hardware_destructive_interference_size) inline static std::atomic<int64_t> counter = 0;
 
+    /** Set when the counter has been added to the counter map.
+     */
+    inline static std::atomic<bool> registered = false;
+
     tt_no_inline void add_to_map() const noexcept
     {
-        counter_map.insert(Tag, counter_map_value_type{&counter, 0});
-        statistics_start();
+        if (not registered.exchange(true, std::memory_order::acq_rel)) {
+            counter_map.insert(Tag, counter_map_value_type{&counter, 0});
+            statistics_start();
+        }
     }
 
     int64_t increment() const noexcept
     {
         ttlet value = counter.fetch_add(1, std::memory_order::relaxed);
 
-        if (value == 0) {
+        if (value == 0 and not registered.load(std::memory_order::relaxed)) {
             [[unlikely]] add_to_map();
         }
 
@@ -67,6 +73,19 @@ inline int64_t increment_counter() noexcept
     return counter_functor<Tag>{}.increment();
 }
 
+/** Add a counter to the counter map before it is incremented.
+ *
+ * The first increment of an unregistered counter adds it to the map and may start the
+ * statistics subsystem, which may allocate and take a lock. Counters that are incremented
+ * from a real-time thread should be registered ahead of time, after which incrementing
+ * the counter is a single atomic add.
+ */
+template<basic_fixed_string Tag>
+inline void register_counter() noexcept
+{
+    counter_functor<Tag>{}.add_to_map();
+}
+
 template<basic_fixed_string Tag>
 [[nodiscard]] inline int64_t read_counter() noexcept
 {
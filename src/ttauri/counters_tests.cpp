@@ -30,3 +30,15 @@ TEST(Counters, RunTimeRead) {
     ASSERT_EQ(read_counter("foo_b").first, 1);
     ASSERT_EQ(read_counter("bar_b").first, 2);
 }
+
+TEST(Counters, Registered) {
+    register_counter<"foo_c">();
+    ASSERT_TRUE(counter_functor<"foo_c">::registered.load());
+    ASSERT_EQ(read_counter("foo_c").first, 0);
+
+    // The first increment of a registered counter does not add it to the map again.
+    increment_counter<"foo_c">();
+    ASSERT_EQ(read_counter("foo_c"), (std::pair<int64_t, int64_t>{1, 1}));
+    increment_counter<"foo_c">();
+    ASSERT_EQ(read_counter("foo_c"), (std::pair<int64_t, int64_t>{2, 1}));
+}
@@ -8,6 +8,9 @@
 #include "URL.hpp"
 #include "decimal.hpp"
 #include "memory.hpp"
+#include "datum_arena.hpp"
+#include "flat_unordered_map.hpp"
+#include "unfair_mutex.hpp"
 #include "type_traits.hpp"
 #include "exception.hpp"
 #include "math.hpp"
@@ -18,6 +21,8 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <cstring>
 #include <cstdint>
 #include <variant>
@@ -352,36 +357,199 @@ private:
         return static_cast<int64_t>(u64 << 16) >> 16;
     }
 
-    /** Extract a pointer for an existing object from datum's storage.
+    /** A large object together with its reference count.
+     * Large objects are shared between copies of a datum and are only copied
+     * when a datum is modified while the object is shared, see `get_mutable_pointer()`.
+     */
+    template<typename O>
+    struct shared_object {
+        std::atomic<uint64_t> count;
+
+        /** The arena the object was allocated from, or nullptr when allocated on the heap.
+         */
+        datum_arena *arena;
+
+        O value;
+
+        template<typename... Args>
+        shared_object(datum_arena *arena, Args &&...args) noexcept :
+            count(1), arena(arena), value(std::forward<Args>(args)...)
+        {
+        }
+    };
+
+    /** Allocate a large object from the current arena or the heap.
+     *
+     * @param args The arguments passed to the constructor of the object.
+     * @return A pointer to the new object with a reference count of one.
+     */
+    template<typename O, typename... Args>
+    static shared_object<O> *new_shared_object(Args &&...args) noexcept
+    {
+        if (auto *const arena = datum_arena::current()) {
+            [[unlikely]] arena->retain();
+            auto *const p = arena->allocate(sizeof(shared_object<O>), alignof(shared_object<O>));
+            return new (p) shared_object<O>(arena, std::forward<Args>(args)...);
+        } else {
+            return new shared_object<O>(nullptr, std::forward<Args>(args)...);
+        }
+    }
+
+    /** Allocate a large object and encode the pointer into a uint64_t.
+     *
+     * @param mask A mask signifying the type of the pointer.
+     * @param args The arguments passed to the constructor of the object.
+     * @return Encoded pointer.
+     */
+    template<typename O, typename... Args>
+    static uint64_t make_object(uint64_t mask, Args &&...args) noexcept
+    {
+        return make_pointer(mask, new_shared_object<O>(std::forward<Args>(args)...));
+    }
+
+    /** Extract a pointer to the shared object from datum's storage.
      * Canonical pointers on x86 and ARM are at most 48 bit and are sign extended to 64 bit.
      * Since the pointer is stored as a 48 bit integer, this function will launder it.
      */
     template<typename O>
+    shared_object<O> *get_shared_pointer() const noexcept
+    {
+        return std::launder(reinterpret_cast<shared_object<O> *>(get_signed_integer()));
+    }
+
+    /** Extract a pointer for an existing object from datum's storage.
+     * The object may be shared with other datums, so it must not be modified through this pointer.
+     */
+    template<typename O>
     O *get_pointer() const
     {
-        return std::launder(reinterpret_cast<O *>(get_signed_integer()));
+        return &get_shared_pointer<O>()->value;
+    }
+
+    /** Extract a pointer for an existing object that may be modified.
+     * If the object is shared with other datums, then this datum will first
+     * be detached by making its own copy of the object.
+     *
+     * References into the object obtained before a datum is copied are shared by
+     * both datums. Modifications through such a reference are visible in both.
+     */
+    template<typename O>
+    O *get_mutable_pointer() noexcept
+    {
+        auto *p = get_shared_pointer<O>();
+        if (p->count.load(std::memory_order::acquire) != 1) [[unlikely]] {
+            auto *const q = new_shared_object<O>(p->value);
+            release<O>();
+            u64 = make_pointer(u64 & ~pointer_mask, q);
+            p = q;
+        }
+        return &p->value;
+    }
+
+    /** Increment the reference count of the object.
+     */
+    template<typename O>
+    void retain() const noexcept
+    {
+        get_shared_pointer<O>()->count.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    /** Decrement the reference count of the object and delete it when it was the last reference.
+     */
+    template<typename O>
+    void release() noexcept
+    {
+        auto *const p = get_shared_pointer<O>();
+        if (p->count.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            if (auto *const arena = p->arena) {
+                // The memory is returned when the arena is destroyed.
+                [[unlikely]] std::destroy_at(p);
+                arena->release();
+            } else {
+                delete p;
+            }
+        }
+    }
+
+    /** The reference count of objects that are never destroyed.
+     * The reference count of an interned string starts at this value, so that it never reaches zero.
+     */
+    static constexpr uint64_t immortal_count = uint64_t{1} << 62;
+
+    template<typename O>
+    [[nodiscard]] static bool is_immortal(shared_object<O> const *p) noexcept
+    {
+        return p->count.load(std::memory_order::relaxed) >= immortal_count / 2;
+    }
+
+    /** Find or create the interned string object.
+     *
+     * @param str The text of the string.
+     * @return The immortal string object, with a reference for the caller.
+     */
+    [[nodiscard]] static shared_object<std::string> *intern_object(std::string_view str) noexcept
+    {
+        static auto mutex = unfair_mutex{};
+        // The keys point to the strings owned by the immortal objects.
+        static auto table = std::unordered_map<std::string_view, shared_object<std::string> *>{};
+
+        ttlet lock = std::scoped_lock(mutex);
+        auto i = table.find(str);
+        if (i == table.end()) {
+            // Interned strings are shared between documents, they are never allocated from an arena.
+            auto *const p = new shared_object<std::string>(nullptr, str);
+            p->count.store(immortal_count, std::memory_order::relaxed);
+            i = table.emplace(std::string_view{p->value}, p).first;
+        }
+
+        i->second->count.fetch_add(1, std::memory_order::relaxed);
+        return i->second;
+    }
+
+    /** Compare two strings without copying them.
+     * Short strings are always stored inside the datum and long strings always in an object,
+     * so both must be of the same physical type to be equal.
+     *
+     * @param other The other datum, which must hold a string.
+     */
+    [[nodiscard]] bool equal_string(datum_impl const &other) const noexcept
+    {
+        if (u64 == other.u64) {
+            // The same short string, or the same object.
+            return true;
+        } else if (type_id() != other.type_id() or not is_phy_string_ptr()) {
+            return false;
+        }
+
+        ttlet *lhs = get_shared_pointer<std::string>();
+        ttlet *rhs = other.get_shared_pointer<std::string>();
+        if (is_immortal(lhs) and is_immortal(rhs)) {
+            // Different interned strings.
+            return false;
+        }
+        return lhs->value == rhs->value;
     }
 
-    /** Delete the object that the datum is pointing to.
+    /** Release the object that the datum is pointing to.
      * This function should only be called on a datum that holds a pointer.
      */
     void delete_pointer() noexcept
     {
         if constexpr (HasLargeObjects) {
             switch (type_id()) {
-            case phy_integer_ptr_id: delete get_pointer<int64_t>(); break;
-            case phy_string_ptr_id: delete get_pointer<std::string>(); break;
-            case phy_url_ptr_id: delete get_pointer<URL>(); break;
-            case phy_vector_ptr_id: delete get_pointer<datum_impl::vector>(); break;
-            case phy_map_ptr_id: delete get_pointer<datum_impl::map>(); break;
-            case phy_decimal_ptr_id: delete get_pointer<decimal>(); break;
-            case phy_bytes_ptr_id: delete get_pointer<bstring>(); break;
+            case phy_integer_ptr_id: release<int64_t>(); break;
+            case phy_string_ptr_id: release<std::string>(); break;
+            case phy_url_ptr_id: release<URL>(); break;
+            case phy_vector_ptr_id: release<datum_impl::vector>(); break;
+            case phy_map_ptr_id: release<datum_impl::map>(); break;
+            case phy_decimal_ptr_id: release<decimal>(); break;
+            case phy_bytes_ptr_id: release<bstring>(); break;
             default: tt_no_default();
             }
         }
     }
 
-    /** Copy the object pointed to by the other datum into this datum.
+    /** Share the object pointed to by the other datum with this datum.
      * Other datum must point to an object. This datum must not point to an object.
      *
      * @param other The other datum which holds a pointer to an object.
@@ -390,49 +558,27 @@ private:
     {
         if constexpr (HasLargeObjects) {
             switch (other.type_id()) {
-            case phy_integer_ptr_id: {
-                auto *const p = new int64_t(*other.get_pointer<int64_t>());
-                u64 = make_pointer(integer_ptr_mask, p);
-            } break;
-
-            case phy_string_ptr_id: {
-                auto *const p = new std::string(*other.get_pointer<std::string>());
-                u64 = make_pointer(string_ptr_mask, p);
-            } break;
-
-            case phy_url_ptr_id: {
-                auto *const p = new URL(*other.get_pointer<URL>());
-                u64 = make_pointer(url_ptr_mask, p);
-            } break;
-
-            case phy_vector_ptr_id: {
-                auto *const p = new datum_impl::vector(*other.get_pointer<datum_impl::vector>());
-                u64 = make_pointer(vector_ptr_mask, p);
-            } break;
-
-            case phy_map_ptr_id: {
-                auto *const p = new datum_impl::map(*other.get_pointer<datum_impl::map>());
-                u64 = make_pointer(map_ptr_mask, p);
-            } break;
-
-            case phy_decimal_ptr_id: {
-                auto *const p = new decimal(*other.get_pointer<decimal>());
-                u64 = make_pointer(decimal_ptr_mask, p);
-            } break;
-
-            case phy_bytes_ptr_id: {
-                auto *const p = new bstring(*other.get_pointer<bstring>());
-                u64 = make_pointer(bytes_ptr_mask, p);
-            } break;
-
+            case phy_integer_ptr_id: other.retain<int64_t>(); break;
+            case phy_string_ptr_id: other.retain<std::string>(); break;
+            case phy_url_ptr_id: other.retain<URL>(); break;
+            case phy_vector_ptr_id: other.retain<datum_impl::vector>(); break;
+            case phy_map_ptr_id: other.retain<datum_impl::map>(); break;
+            case phy_decimal_ptr_id: other.retain<decimal>(); break;
+            case phy_bytes_ptr_id: other.retain<bstring>(); break;
             default: tt_no_default();
             }
+            u64 = other.u64;
         }
     }
 
 public:
-    using vector = std::vector<datum_impl>;
-    using map = std::unordered_map<datum_impl, datum_impl>;
+    using vector = std::vector<datum_impl, datum_allocator<datum_impl>>;
+    using map = flat_unordered_map<
+        datum_impl,
+        datum_impl,
+        std::hash<datum_impl>,
+        std::equal_to<datum_impl>,
+        datum_allocator<std::pair<datum_impl, datum_impl>>>;
     struct undefined {
     };
     struct null {
@@ -466,18 +612,10 @@ public:
     datum_impl &operator=(datum_impl const &other) noexcept
     {
         tt_return_on_self_assignment(other);
-        if (is_phy_pointer()) {
-            [[unlikely]] delete_pointer();
-        }
-
-        if (other.is_phy_pointer()) {
-            [[unlikely]] copy_pointer(other);
-
-        } else {
-            // We do a memcpy, because we don't know the type in the union.
-            std::memcpy(this, &other, sizeof(*this));
-        }
-        return *this;
+        // Share the object of other before releasing our own object,
+        // since other may be owned by our own object.
+        auto tmp = other;
+        return *this = std::move(tmp);
     }
 
     datum_impl(datum_impl &&other) noexcept : u64(undefined_mask)
@@ -491,9 +629,18 @@ public:
     datum_impl &operator=(datum_impl &&other) noexcept
     {
         tt_return_on_self_assignment(other);
-        // We do a memcpy, because we don't know the type in the union.
-        std::memcpy(this, &other, sizeof(*this));
+        // Take the value of other before releasing our own object,
+        // since other may be owned by our own object.
+        uint64_t tmp;
+        std::memcpy(&tmp, &other, sizeof(tmp));
         other.u64 = undefined_mask;
+
+        if (is_phy_pointer()) {
+            [[unlikely]] delete_pointer();
+        }
+
+        // We do a memcpy, because we don't know the type in the union.
+        std::memcpy(this, &tmp, sizeof(*this));
         return *this;
     }
 
@@ -517,8 +664,7 @@ public:
         if (m < minimum_mantissa || m > maximum_mantissa) {
             [[unlikely]] if constexpr (HasLargeObjects)
             {
-                auto *const p = new decimal(value);
-                u64 = make_pointer(decimal_ptr_mask, p);
+                u64 = make_object<decimal>(decimal_ptr_mask, value);
             }
             else
             {
@@ -545,8 +691,7 @@ public:
         if (value > maximum_int) {
             [[unlikely]] if constexpr (HasLargeObjects)
             {
-                auto *const p = new uint64_t(value);
-                u64 = make_pointer(integer_ptr_mask, p);
+                u64 = make_object<int64_t>(integer_ptr_mask, static_cast<int64_t>(value));
             }
             else
             {
@@ -565,8 +710,7 @@ public:
             [[unlikely]]
             {
                 if constexpr (HasLargeObjects) {
-                    auto *const p = new int64_t(value);
-                    u64 = make_pointer(integer_ptr_mask, p);
+                    u64 = make_object<int64_t>(integer_ptr_mask, value);
                 } else {
                     throw std::overflow_error(std::format(
                         "Constructing integer {} to datum, outside {} and {}", value, minimum_int, maximum_int));
@@ -585,8 +729,7 @@ public:
     {
         if (u64 == 0) {
             if constexpr (HasLargeObjects) {
-                auto *const p = new std::string(value);
-                u64 = make_pointer(string_ptr_mask, p);
+                u64 = make_object<std::string>(string_ptr_mask, value);
             } else {
                 throw std::overflow_error(std::format("Constructing string {} to datum, larger than 6 characters", value));
             }
@@ -596,46 +739,62 @@ public:
     datum_impl(std::string const &value) noexcept : datum_impl(std::string_view(value)) {}
     datum_impl(char const *value) noexcept : datum_impl(std::string_view(value)) {}
 
+    /** Create a datum holding an interned string.
+     * Interned strings with the same text share a single object which is never destroyed,
+     * so that they are compared by pointer. Use this for strings that are used often as
+     * a key, like the names of members; short strings are always stored inside the datum.
+     *
+     * Interned strings are never freed, so only intern strings from a bounded set, such as
+     * compile-time keys or the names in a program, never strings from untrusted input.
+     *
+     * @param str The text of the string.
+     * @return A datum holding the string.
+     */
+    template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
+    [[nodiscard]] static datum_impl intern(std::string_view str) noexcept
+    {
+        auto r = datum_impl{};
+        r.u64 = make_string(str);
+        if (r.u64 == 0) {
+            r.u64 = make_pointer(string_ptr_mask, intern_object(str));
+        }
+        return r;
+    }
+
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
     datum_impl(URL const &value) noexcept
     {
-        auto *const p = new URL(value);
-        u64 = make_pointer(url_ptr_mask, p);
+        u64 = make_object<URL>(url_ptr_mask, value);
     }
 
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
     datum_impl(URL &&value) noexcept
     {
-        auto *const p = new URL(std::move(value));
-        u64 = make_pointer(url_ptr_mask, p);
+        u64 = make_object<URL>(url_ptr_mask, std::move(value));
     }
 
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
     datum_impl(datum_impl::vector const &value) noexcept
     {
-        auto *const p = new datum_impl::vector(value);
-        u64 = make_pointer(vector_ptr_mask, p);
+        u64 = make_object<datum_impl::vector>(vector_ptr_mask, value);
     }
 
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
     datum_impl(datum_impl::vector &&value) noexcept
     {
-        auto *const p = new datum_impl::vector(std::move(value));
-        u64 = make_pointer(vector_ptr_mask, p);
+        u64 = make_object<datum_impl::vector>(vector_ptr_mask, std::move(value));
     }
 
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
     datum_impl(datum_impl::map const &value) noexcept
     {
-        auto *const p = new datum_impl::map(value);
-        u64 = make_pointer(map_ptr_mask, p);
+        u64 = make_object<datum_impl::map>(map_ptr_mask, value);
     }
 
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
     datum_impl(datum_impl::map &&value) noexcept
     {
-        auto *const p = new datum_impl::map(std::move(value));
-        u64 = make_pointer(map_ptr_mask, p);
+        u64 = make_object<datum_impl::map>(map_ptr_mask, std::move(value));
     }
 
     datum_impl &operator=(datum_impl::undefined rhs) noexcept
@@ -702,8 +861,7 @@ public:
         if (m < minimum_mantissa || m > maximum_mantissa) {
             [[unlikely]] if constexpr (HasLargeObjects)
             {
-                auto *const p = new decimal(rhs);
-                u64 = make_pointer(decimal_ptr_mask, p);
+                u64 = make_object<decimal>(decimal_ptr_mask, rhs);
             }
             else
             {
@@ -741,8 +899,7 @@ public:
         if (rhs > maximum_int) {
             [[unlikely]] if constexpr (HasLargeObjects)
             {
-                auto *const p = new uint64_t(rhs);
-                u64 = make_pointer(integer_ptr_mask, p);
+                u64 = make_object<int64_t>(integer_ptr_mask, static_cast<int64_t>(rhs));
             }
             else
             {
@@ -778,8 +935,7 @@ public:
         if (rhs < minimum_int || rhs > maximum_int) {
             [[unlikely]] if constexpr (HasLargeObjects)
             {
-                auto *const p = new int64_t(rhs);
-                u64 = make_pointer(integer_ptr_mask, p);
+                u64 = make_object<int64_t>(integer_ptr_mask, rhs);
             }
             else
             {
@@ -833,8 +989,7 @@ public:
         u64 = make_string(rhs);
         if (u64 == 0) {
             if constexpr (HasLargeObjects) {
-                auto *const p = new std::string(rhs);
-                u64 = make_pointer(string_ptr_mask, p);
+                u64 = make_object<std::string>(string_ptr_mask, rhs);
             } else {
                 throw std::overflow_error(std::format("Assigning string {} to datum, larger than 6 characters", rhs));
             }
@@ -861,8 +1016,7 @@ public:
             [[unlikely]] delete_pointer();
         }
 
-        auto *const p = new URL(rhs);
-        u64 = make_pointer(url_ptr_mask, p);
+        u64 = make_object<URL>(url_ptr_mask, rhs);
         return *this;
     }
 
@@ -873,8 +1027,7 @@ public:
             [[unlikely]] delete_pointer();
         }
 
-        auto *const p = new URL(std::move(rhs));
-        u64 = make_pointer(url_ptr_mask, p);
+        u64 = make_object<URL>(url_ptr_mask, std::move(rhs));
         return *this;
     }
 
@@ -885,8 +1038,7 @@ public:
             [[unlikely]] delete_pointer();
         }
 
-        auto *const p = new datum_impl::vector(rhs);
-        u64 = make_pointer(vector_ptr_mask, p);
+        u64 = make_object<datum_impl::vector>(vector_ptr_mask, rhs);
 
         return *this;
     }
@@ -898,8 +1050,7 @@ public:
             [[unlikely]] delete_pointer();
         }
 
-        auto *const p = new datum_impl::vector(std::move(rhs));
-        u64 = make_pointer(vector_ptr_mask, p);
+        u64 = make_object<datum_impl::vector>(vector_ptr_mask, std::move(rhs));
 
         return *this;
     }
@@ -911,8 +1062,7 @@ public:
             [[unlikely]] delete_pointer();
         }
 
-        auto *const p = new datum_impl::map(rhs);
-        u64 = make_pointer(map_ptr_mask, p);
+        u64 = make_object<datum_impl::map>(map_ptr_mask, rhs);
 
         return *this;
     }
@@ -924,8 +1074,7 @@ public:
             [[unlikely]] delete_pointer();
         }
 
-        auto *const p = new datum_impl::map(std::move(rhs));
-        u64 = make_pointer(map_ptr_mask, p);
+        u64 = make_object<datum_impl::map>(map_ptr_mask, std::move(rhs));
 
         return *this;
     }
@@ -999,7 +1148,7 @@ public:
         if (is_phy_integer()) {
             return get_signed_integer();
         } else if (is_phy_integer_ptr()) {
-            return *get_pointer<signed long long>();
+            return *get_pointer<int64_t>();
         } else if (is_phy_float()) {
             return static_cast<signed long long>(f64);
         } else if (is_phy_small()) {
@@ -1315,6 +1464,8 @@ public:
      * When this datum holds undefined it is treated as if datum holds an empty map.
      * When this datum holds a vector, the index must be datum holding an integer.
      *
+     * The returned reference is invalidated when an item is added to the map or vector.
+     *
      * @param rhs An index into the map or vector.
      */
     template<bool P = HasLargeObjects, std::enable_if_t<P, int> = 0>
@@ -1322,18 +1473,17 @@ public:
     {
         if (is_undefined()) {
             // When accessing a name on an undefined it means we need replace it with an empty map.
-            auto *p = new datum_impl::map();
-            u64 = map_ptr_mask | (reinterpret_cast<uint64_t>(p) & pointer_mask);
+            u64 = make_object<datum_impl::map>(map_ptr_mask);
         }
 
         if (is_map()) {
-            auto &m = *get_pointer<datum_impl::map>();
+            auto &m = *get_mutable_pointer<datum_impl::map>();
             auto [i, did_insert] = m.try_emplace(rhs);
             return i->second;
 
         } else if (is_vector() && rhs.is_integer()) {
             auto index = static_cast<int64_t>(rhs);
-            auto &v = *get_pointer<datum_impl::vector>();
+            auto &v = *get_mutable_pointer<datum_impl::vector>();
 
             if (index < 0) {
                 index = std::ssize(v) + index;
@@ -1430,12 +1580,11 @@ public:
     {
         if (is_undefined()) {
             // When appending on undefined it means we need replace it with an empty vector.
-            auto *p = new datum_impl::vector();
-            u64 = vector_ptr_mask | (reinterpret_cast<uint64_t>(p) & pointer_mask);
+            u64 = make_object<datum_impl::vector>(vector_ptr_mask);
         }
 
         if (is_vector()) {
-            auto *v = get_pointer<datum_impl::vector>();
+            auto *v = get_mutable_pointer<datum_impl::vector>();
             v->emplace_back();
             return v->back();
 
@@ -1449,12 +1598,11 @@ public:
     {
         if (is_undefined()) {
             // When appending on undefined it means we need replace it with an empty vector.
-            auto *p = new datum_impl::vector();
-            u64 = vector_ptr_mask | (reinterpret_cast<uint64_t>(p) & pointer_mask);
+            u64 = make_object<datum_impl::vector>(vector_ptr_mask);
         }
 
         if (is_vector()) {
-            auto *v = get_pointer<datum_impl::vector>();
+            auto *v = get_mutable_pointer<datum_impl::vector>();
             v->emplace_back(std::forward<Args>(args)...);
 
         } else {
@@ -1467,12 +1615,11 @@ public:
     {
         if (is_undefined()) {
             // When appending on undefined it means we need replace it with an empty vector.
-            auto *p = new datum_impl::vector();
-            u64 = vector_ptr_mask | (reinterpret_cast<uint64_t>(p) & pointer_mask);
+            u64 = make_object<datum_impl::vector>(vector_ptr_mask);
         }
 
         if (is_vector()) {
-            auto *v = get_pointer<datum_impl::vector>();
+            auto *v = get_mutable_pointer<datum_impl::vector>();
             v->push_back(std::forward<Arg>(arg));
 
         } else {
@@ -1483,7 +1630,7 @@ public:
     void pop_back()
     {
         if (is_vector()) {
-            auto *v = get_pointer<datum_impl::vector>();
+            auto *v = get_mutable_pointer<datum_impl::vector>();
             v->pop_back();
 
         } else {
@@ -1542,7 +1689,7 @@ public:
     datum_impl &front()
     {
         if (is_vector()) {
-            auto *v = get_pointer<datum_impl::vector>();
+            auto *v = get_mutable_pointer<datum_impl::vector>();
             return v->front();
 
         } else {
@@ -1564,7 +1711,7 @@ public:
     datum_impl &back()
     {
         if (is_vector()) {
-            auto *v = get_pointer<datum_impl::vector>();
+            auto *v = get_mutable_pointer<datum_impl::vector>();
             return v->back();
 
         } else {
@@ -2015,7 +2162,7 @@ public:
         case datum_impl::phy_string_id:
         case datum_impl::phy_string_ptr_id:
             return (
-                (rhs.is_string() && static_cast<std::string>(lhs) == static_cast<std::string>(rhs)) ||
+                (rhs.is_string() && lhs.equal_string(rhs)) ||
                 (rhs.is_url() && static_cast<URL>(lhs) == static_cast<URL>(rhs)));
         case datum_impl::phy_url_ptr_id:
             return (rhs.is_url() || rhs.is_string()) && static_cast<URL>(lhs) == static_cast<URL>(rhs);
@@ -2448,7 +2595,7 @@ public:
         if (lhs.is_map() && rhs.is_map()) {
             result = lhs;
 
-            auto result_map = result.get_pointer<datum_impl::map>();
+            auto result_map = result.get_mutable_pointer<datum_impl::map>();
             for (auto rhs_i = rhs.map_begin(); rhs_i != rhs.map_end(); rhs_i++) {
                 auto result_i = result_map->find(rhs_i->first);
                 if (result_i == result_map->end()) {
@@ -2461,7 +2608,7 @@ public:
         } else if (lhs.is_vector() && rhs.is_vector()) {
             result = lhs;
 
-            auto result_vector = result.get_pointer<datum_impl::vector>();
+            auto result_vector = result.get_mutable_pointer<datum_impl::vector>();
             for (auto rhs_i = rhs.vector_begin(); rhs_i != rhs.vector_end(); rhs_i++) {
                 result_vector->push_back(*rhs_i);
             }
@@ -0,0 +1,19 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "datum_arena.hpp"
+#include <algorithm>
+
+namespace tt {
+
+void datum_arena::add_block(size_t size) noexcept
+{
+    _block_size = std::max({size, minimum_block_size, _block_size * 2});
+    // Not using std::make_unique, since the memory does not need to be zero initialized.
+    _blocks.push_back(std::unique_ptr<std::byte[]>(new std::byte[_block_size]));
+    _capacity += _block_size;
+    _offset = 0;
+}
+
+} // namespace tt
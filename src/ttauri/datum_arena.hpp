@@ -0,0 +1,289 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "required.hpp"
+#include "assert.hpp"
+#include "unfair_mutex.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <type_traits>
+#include <cstddef>
+
+namespace tt {
+
+/** How the large objects of a datum are allocated.
+ */
+enum class datum_allocation {
+    /** Each large object is allocated separately on the heap.
+     */
+    heap,
+
+    /** Large objects are allocated from a monotonic arena that is owned by the document.
+     */
+    arena
+};
+
+/** A monotonic arena for the large objects of datums.
+ *
+ * Memory is handed out sequentially from large blocks and is only returned to the
+ * system when the arena is destroyed, which makes building and tearing down a
+ * document with thousands of strings, vectors and maps cheap.
+ *
+ * The arena is reference counted. Every large object and every vector or map allocated
+ * from the arena holds a reference, so that the arena is destroyed together with the last
+ * datum of the document. Memory freed by a datum is not reused, therefor an arena is
+ * meant for documents that are built once, not for long running modifications.
+ *
+ * Datums allocate from the arena of the `datum_arena_scope` that is active on the current thread.
+ */
+class datum_arena {
+public:
+    datum_arena(datum_arena const &) = delete;
+    datum_arena(datum_arena &&) = delete;
+    datum_arena &operator=(datum_arena const &) = delete;
+    datum_arena &operator=(datum_arena &&) = delete;
+
+    /** The arena of the active `datum_arena_scope` on this thread.
+     *
+     * @return The current arena, or nullptr when large objects are allocated on the heap.
+     */
+    [[nodiscard]] static datum_arena *current() noexcept
+    {
+        return _current;
+    }
+
+    /** Allocate memory from the arena.
+     *
+     * @param size The number of bytes to allocate.
+     * @param alignment The alignment of the memory, at most `__STDCPP_DEFAULT_NEW_ALIGNMENT__`.
+     * @return A pointer to the allocated memory.
+     */
+    [[nodiscard]] void *allocate(size_t size, size_t alignment) noexcept
+    {
+        tt_axiom(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        ttlet lock = std::scoped_lock(_mutex);
+        ++_allocation_count;
+
+        auto offset = (_offset + alignment - 1) & ~(alignment - 1);
+        if (offset + size > _block_size) {
+            [[unlikely]] add_block(size);
+            offset = 0;
+        }
+
+        _offset = offset + size;
+        return _blocks.back().get() + offset;
+    }
+
+    void retain() noexcept
+    {
+        _reference_count.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    void release() noexcept
+    {
+        if (_reference_count.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    /** The number of allocations done from this arena.
+     */
+    [[nodiscard]] size_t allocation_count() const noexcept
+    {
+        ttlet lock = std::scoped_lock(_mutex);
+        return _allocation_count;
+    }
+
+    /** The number of blocks allocated from the heap.
+     */
+    [[nodiscard]] size_t nr_blocks() const noexcept
+    {
+        ttlet lock = std::scoped_lock(_mutex);
+        return _blocks.size();
+    }
+
+    /** The total size in bytes of the blocks allocated from the heap.
+     */
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        ttlet lock = std::scoped_lock(_mutex);
+        return _capacity;
+    }
+
+private:
+    static constexpr size_t minimum_block_size = 64 * 1024;
+
+    inline static thread_local datum_arena *_current = nullptr;
+
+    mutable unfair_mutex _mutex;
+    std::atomic<size_t> _reference_count = 1;
+    std::vector<std::unique_ptr<std::byte[]>> _blocks;
+    size_t _block_size = 0;
+    size_t _offset = 0;
+    size_t _allocation_count = 0;
+    size_t _capacity = 0;
+
+    datum_arena() noexcept = default;
+    ~datum_arena() = default;
+
+    /** Add a block of at least the given size.
+     * Blocks grow geometrically so that large documents need only a few blocks.
+     */
+    void add_block(size_t size) noexcept;
+
+    friend class datum_arena_scope;
+};
+
+/** Allocate the large objects of datums from an arena.
+ *
+ * While the scope is alive, all large objects of datums created on the current thread
+ * are allocated from a new arena. Scopes may be nested and must be destroyed in
+ * reverse order of construction on the thread that created them.
+ *
+ * The datums created inside the scope may outlive the scope; they keep the arena alive.
+ */
+class datum_arena_scope {
+public:
+    datum_arena_scope(datum_arena_scope const &) = delete;
+    datum_arena_scope(datum_arena_scope &&) = delete;
+    datum_arena_scope &operator=(datum_arena_scope const &) = delete;
+    datum_arena_scope &operator=(datum_arena_scope &&) = delete;
+
+    /** Start a scope.
+     *
+     * @param allocation When `datum_allocation::heap` the scope does nothing.
+     */
+    explicit datum_arena_scope(datum_allocation allocation = datum_allocation::arena) noexcept :
+        _previous(datum_arena::_current), _arena(nullptr)
+    {
+        if (allocation == datum_allocation::arena) {
+            _arena = new datum_arena();
+            datum_arena::_current = _arena;
+        }
+    }
+
+    ~datum_arena_scope()
+    {
+        if (_arena != nullptr) {
+            tt_axiom(datum_arena::_current == _arena);
+            datum_arena::_current = _previous;
+            _arena->release();
+        }
+    }
+
+    /** The arena of this scope, or nullptr when allocating on the heap.
+     */
+    [[nodiscard]] datum_arena const *arena() const noexcept
+    {
+        return _arena;
+    }
+
+private:
+    datum_arena *_previous;
+    datum_arena *_arena;
+};
+
+/** The allocator for the vectors and maps of a datum.
+ *
+ * A default constructed allocator allocates from the current arena, or from the heap
+ * when no `datum_arena_scope` is active. Copying a container selects the current
+ * arena again, so copies of a document made after parsing are allocated on the heap.
+ */
+template<typename T>
+class datum_allocator {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = datum_allocator<U>;
+    };
+
+    datum_allocator() noexcept : _arena(datum_arena::current())
+    {
+        if (_arena != nullptr) {
+            _arena->retain();
+        }
+    }
+
+    ~datum_allocator()
+    {
+        if (_arena != nullptr) {
+            _arena->release();
+        }
+    }
+
+    datum_allocator(datum_allocator const &other) noexcept : _arena(other._arena)
+    {
+        if (_arena != nullptr) {
+            _arena->retain();
+        }
+    }
+
+    template<typename U>
+    datum_allocator(datum_allocator<U> const &other) noexcept : _arena(other._arena)
+    {
+        if (_arena != nullptr) {
+            _arena->retain();
+        }
+    }
+
+    datum_allocator &operator=(datum_allocator const &other) noexcept
+    {
+        tt_return_on_self_assignment(other);
+        if (other._arena != nullptr) {
+            other._arena->retain();
+        }
+        if (_arena != nullptr) {
+            _arena->release();
+        }
+        _arena = other._arena;
+        return *this;
+    }
+
+    [[nodiscard]] datum_allocator select_on_container_copy_construction() const noexcept
+    {
+        return {};
+    }
+
+    [[nodiscard]] value_type *allocate(size_type n) const
+    {
+        if (_arena != nullptr) {
+            return static_cast<value_type *>(_arena->allocate(n * sizeof(value_type), alignof(value_type)));
+        } else {
+            return std::allocator<value_type>{}.allocate(n);
+        }
+    }
+
+    void deallocate(value_type *p, size_type n) const noexcept
+    {
+        if (_arena == nullptr) {
+            std::allocator<value_type>{}.deallocate(p, n);
+        }
+    }
+
+    template<typename U>
+    [[nodiscard]] friend bool operator==(datum_allocator const &lhs, datum_allocator<U> const &rhs) noexcept
+    {
+        return lhs._arena == rhs._arena;
+    }
+
+private:
+    datum_arena *_arena;
+
+    template<typename U>
+    friend class datum_allocator;
+};
+
+} // namespace tt
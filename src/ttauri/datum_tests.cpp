@@ -143,3 +143,99 @@ TEST(Datum, ArrayOperations) {
     ASSERT_EQ(v[-2], 14);
     ASSERT_EQ(v[-1], 15);
 }
+
+TEST(Datum, CopyOnWriteVector) {
+    auto a = datum{datum::vector{11, 12, 13}};
+    auto b = a;
+
+    // Copies share the same vector until modified.
+    ASSERT_EQ(&*a.vector_begin(), &*b.vector_begin());
+
+    b.push_back(14);
+    ASSERT_NE(&*a.vector_begin(), &*b.vector_begin());
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(b.size(), 4);
+
+    b[0] = 42;
+    ASSERT_EQ(a[0], 11);
+    ASSERT_EQ(b[0], 42);
+
+    // A vector that is not shared is modified in place.
+    ttlet *first = &*b.vector_begin();
+    b[1] = 43;
+    ASSERT_EQ(first, &*b.vector_begin());
+}
+
+TEST(Datum, CopyOnWriteMap) {
+    auto a = datum{datum::map{}};
+    a["foo"] = 1;
+    a["bar"] = datum{datum::vector{1, 2, 3}};
+
+    auto b = a;
+    b["foo"] = 2;
+    b["bar"].push_back(4);
+    b["baz"] = 3;
+
+    ASSERT_EQ(a["foo"], 1);
+    ASSERT_EQ(a["bar"].size(), 3);
+    ASSERT_FALSE(a.contains("baz"));
+    ASSERT_EQ(b["foo"], 2);
+    ASSERT_EQ(b["bar"].size(), 4);
+    ASSERT_EQ(b["baz"], 3);
+}
+
+TEST(Datum, CopyOnWriteAssignFromChild) {
+    auto a = datum{datum::map{}};
+    a["child"] = datum{datum::vector{1, 2, 3}};
+
+    // The child is owned by a itself.
+    a = a["child"];
+    ASSERT_TRUE(a.is_vector());
+    ASSERT_EQ(a.size(), 3);
+
+    a = std::move(a[1]);
+    ASSERT_EQ(a, 2);
+}
+
+TEST(Datum, ArenaAllocation) {
+    auto a = datum{};
+    {
+        ttlet arena_scope = datum_arena_scope{};
+        a = datum{datum::vector{}};
+        for (auto i = 0; i != 100; ++i) {
+            a.push_back(datum{datum::map{}});
+            a.back()["a long key"] = "a long string value";
+        }
+        ASSERT_GT(arena_scope.arena()->allocation_count(), 200);
+    }
+
+    // Copies made after the scope has ended are allocated on the heap.
+    auto b = a;
+    b[0]["a long key"] = "modified";
+
+    ASSERT_EQ(a.size(), 100);
+    ASSERT_EQ(a[0]["a long key"], "a long string value");
+    ASSERT_EQ(b[0]["a long key"], "modified");
+    ASSERT_EQ(a[99]["a long key"], "a long string value");
+}
+
+TEST(Datum, Intern) {
+    ttlet a = datum::intern("a long key");
+    ttlet b = datum::intern(std::string{"a long "} + "key");
+    ttlet c = datum::intern("another long key");
+
+    ASSERT_TRUE(a.is_string());
+    ASSERT_EQ(a, b);
+    ASSERT_NE(a, c);
+
+    // Interned strings compare equal to strings that are not interned.
+    ASSERT_EQ(a, datum{"a long key"});
+    ASSERT_EQ(datum{"a long key"}, b);
+    ASSERT_EQ(datum::intern("foo"), datum{"foo"});
+
+    auto m = datum{datum::map{}};
+    m[datum{"a long key"}] = 42;
+    ASSERT_EQ(m[a], 42);
+    ASSERT_TRUE(m.contains(b));
+    ASSERT_FALSE(m.contains(c));
+}
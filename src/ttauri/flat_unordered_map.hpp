@@ -0,0 +1,417 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "required.hpp"
+#include "assert.hpp"
+#include "cast.hpp"
+#include <vector>
+#include <utility>
+#include <memory>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <bit>
+#include <type_traits>
+#include <cstdint>
+
+namespace tt {
+
+/** An unordered map with its items stored contiguously.
+ *
+ * The items are stored in a vector in order of insertion. Small maps, like the objects
+ * of a typical JSON configuration, are searched linearly which is faster than hashing
+ * the key and does not need an allocation per item. When the map grows above
+ * `linear_search_threshold` items, an open-addressing index into the vector is maintained.
+ *
+ * Unlike `std::unordered_map`, inserting an item may invalidate references and iterators
+ * to other items. Erasing an item moves the last item into its place.
+ *
+ * @tparam Key The type of the key.
+ * @tparam T The type of the mapped value.
+ * @tparam Hash The hash function for the key.
+ * @tparam KeyEqual The equality function for the key.
+ * @tparam Allocator The allocator of the items.
+ */
+template<
+    typename Key,
+    typename T,
+    typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key>,
+    typename Allocator = std::allocator<std::pair<Key, T>>>
+class flat_unordered_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+
+private:
+    using items_type = std::vector<value_type, allocator_type>;
+
+public:
+    using iterator = typename items_type::iterator;
+    using const_iterator = typename items_type::const_iterator;
+
+    /** The maximum number of items that are searched linearly.
+     */
+    static constexpr size_t linear_search_threshold = 8;
+
+    flat_unordered_map() noexcept = default;
+    flat_unordered_map(flat_unordered_map const &) = default;
+    flat_unordered_map(flat_unordered_map &&) noexcept = default;
+    flat_unordered_map &operator=(flat_unordered_map const &) = default;
+    flat_unordered_map &operator=(flat_unordered_map &&) noexcept = default;
+
+    flat_unordered_map(std::initializer_list<value_type> init) : flat_unordered_map()
+    {
+        for (ttlet &item : init) {
+            insert(item);
+        }
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _items.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _items.empty();
+    }
+
+    [[nodiscard]] iterator begin() noexcept
+    {
+        return _items.begin();
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return _items.begin();
+    }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept
+    {
+        return _items.cbegin();
+    }
+
+    [[nodiscard]] iterator end() noexcept
+    {
+        return _items.end();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return _items.end();
+    }
+
+    [[nodiscard]] const_iterator cend() const noexcept
+    {
+        return _items.cend();
+    }
+
+    void clear() noexcept
+    {
+        _items.clear();
+        _index.clear();
+    }
+
+    void reserve(size_t new_capacity)
+    {
+        _items.reserve(new_capacity);
+    }
+
+    [[nodiscard]] iterator find(key_type const &key) noexcept
+    {
+        return begin() + find_index(key, hash_of(key));
+    }
+
+    [[nodiscard]] const_iterator find(key_type const &key) const noexcept
+    {
+        return begin() + find_index(key, hash_of(key));
+    }
+
+    [[nodiscard]] bool contains(key_type const &key) const noexcept
+    {
+        return find_index(key, hash_of(key)) != size();
+    }
+
+    [[nodiscard]] size_t count(key_type const &key) const noexcept
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /** Insert an item if the key is not yet in the map.
+     *
+     * @param key The key of the item.
+     * @param args The arguments to construct the mapped value with.
+     * @return An iterator to the item with the key, and true if the item was inserted.
+     */
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        if constexpr (not std::is_same_v<std::remove_cvref_t<K>, key_type>) {
+            // Convert the key once, instead of on each comparison.
+            return try_emplace(key_type(std::forward<K>(key)), std::forward<Args>(args)...);
+
+        } else {
+            ttlet hash = hash_of(key);
+            ttlet i = find_index(key, hash);
+            if (i != size()) {
+                return {begin() + i, false};
+            }
+
+            _items.emplace_back(
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            add_to_index(hash);
+            return {begin() + i, true};
+        }
+    }
+
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K &&key, Args &&...args)
+    {
+        return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(value_type const &item)
+    {
+        return try_emplace(item.first, item.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&item)
+    {
+        return try_emplace(std::move(item.first), std::move(item.second));
+    }
+
+    mapped_type &operator[](key_type const &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    mapped_type &operator[](key_type &&key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    [[nodiscard]] mapped_type &at(key_type const &key)
+    {
+        ttlet i = find(key);
+        if (i == end()) {
+            throw std::out_of_range("flat_unordered_map::at()");
+        }
+        return i->second;
+    }
+
+    [[nodiscard]] mapped_type const &at(key_type const &key) const
+    {
+        ttlet i = find(key);
+        if (i == end()) {
+            throw std::out_of_range("flat_unordered_map::at()");
+        }
+        return i->second;
+    }
+
+    /** Erase an item.
+     * The last item is moved in place of the erased item. When the map has an index,
+     * only the slots of the erased and the moved item are updated; the slots following
+     * the erased slot are shifted back, so that no tombstones are needed.
+     *
+     * @param key The key of the item to erase.
+     * @return The number of items erased.
+     */
+    size_t erase(key_type const &key)
+    {
+        ttlet hash = hash_of(key);
+        ttlet i = find_index(key, hash);
+        if (i == size()) {
+            return 0;
+        }
+
+        ttlet last = size() - 1;
+        if (not _index.empty()) {
+            if (last <= linear_search_threshold) {
+                // The map becomes small enough to be searched linearly.
+                _index.clear();
+            } else {
+                erase_slot(find_slot(i, hash));
+                if (i != last) {
+                    _index[find_slot(last, hasher{}(_items[last].first))].index = narrow_cast<uint32_t>(i + 1);
+                }
+            }
+        }
+
+        if (i != last) {
+            _items[i] = std::move(_items[last]);
+        }
+        _items.pop_back();
+        return 1;
+    }
+
+    [[nodiscard]] friend bool operator==(flat_unordered_map const &lhs, flat_unordered_map const &rhs) noexcept
+    {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+
+        for (ttlet &item : lhs) {
+            ttlet i = rhs.find(item.first);
+            if (i == rhs.end() or not(i->second == item.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /** A slot in the index.
+     */
+    struct slot_type {
+        /** The index of the item plus one, or zero when the slot is empty.
+         */
+        uint32_t index;
+
+        /** The lower bits of the hash of the key, to skip most key comparisons.
+         */
+        uint32_t hash;
+    };
+
+    using index_type = std::vector<slot_type, typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>>;
+
+    items_type _items;
+
+    /** Open addressing hash table with linear probing, empty when the map is small.
+     * The number of slots is a power of two and at least twice the number of items.
+     */
+    index_type _index;
+
+    /** The hash of a key, only calculated when the map has an index.
+     */
+    [[nodiscard]] size_t hash_of(key_type const &key) const noexcept
+    {
+        return _index.empty() ? 0 : hasher{}(key);
+    }
+
+    /** Find the index of an item.
+     *
+     * @param key The key to search for.
+     * @param hash The hash of the key when the map has an index.
+     * @return The index of the item, or `size()` when not found.
+     */
+    [[nodiscard]] size_t find_index(key_type const &key, size_t hash) const noexcept
+    {
+        if (_index.empty()) {
+            for (auto i = 0_uz; i != _items.size(); ++i) {
+                if (key_equal{}(_items[i].first, key)) {
+                    return i;
+                }
+            }
+            return _items.size();
+        }
+
+        ttlet mask = _index.size() - 1;
+        ttlet hash32 = static_cast<uint32_t>(hash);
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            ttlet slot = _index[i];
+            if (slot.index == 0) {
+                return _items.size();
+            } else if (slot.hash == hash32 and key_equal{}(_items[slot.index - 1].first, key)) {
+                return slot.index - 1;
+            }
+        }
+    }
+
+    /** Find the slot of an item in the index.
+     *
+     * @param index The index of the item.
+     * @param hash The hash of the key of the item.
+     * @return The position of the slot in the index.
+     */
+    [[nodiscard]] size_t find_slot(size_t index, size_t hash) const noexcept
+    {
+        tt_axiom(not _index.empty());
+
+        ttlet mask = _index.size() - 1;
+        auto i = hash & mask;
+        while (_index[i].index != index + 1) {
+            tt_axiom(_index[i].index != 0);
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    /** Empty a slot of the index.
+     * The slots that follow in the same probe sequence are shifted back, so that every
+     * item remains reachable from the slot of its hash without tombstones.
+     *
+     * @param i The position of the slot to empty.
+     */
+    void erase_slot(size_t i) noexcept
+    {
+        ttlet mask = _index.size() - 1;
+        for (auto j = (i + 1) & mask; _index[j].index != 0; j = (j + 1) & mask) {
+            // The index has less than 2^32 slots, so the lower bits of the hash give the home slot.
+            ttlet home = static_cast<size_t>(_index[j].hash) & mask;
+
+            // Move the slot back when the empty slot is between its home slot and the slot itself.
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                _index[i] = _index[j];
+                i = j;
+            }
+        }
+        _index[i] = slot_type{0, 0};
+    }
+
+    void insert_slot(size_t hash, size_t index) noexcept
+    {
+        ttlet mask = _index.size() - 1;
+        auto i = hash & mask;
+        while (_index[i].index != 0) {
+            i = (i + 1) & mask;
+        }
+        _index[i] = slot_type{narrow_cast<uint32_t>(index + 1), static_cast<uint32_t>(hash)};
+    }
+
+    /** Add the last item to the index.
+     *
+     * @param hash The hash of the key of the last item when the map has an index.
+     */
+    void add_to_index(size_t hash)
+    {
+        if (_index.empty()) {
+            if (_items.size() > linear_search_threshold) {
+                rebuild_index();
+            }
+        } else if (_items.size() * 2 > _index.size()) {
+            rebuild_index();
+        } else {
+            insert_slot(hash, _items.size() - 1);
+        }
+    }
+
+    void rebuild_index()
+    {
+        if (_items.size() <= linear_search_threshold) {
+            _index.clear();
+            return;
+        }
+
+        _index.assign(std::bit_ceil(_items.size() * 4), slot_type{0, 0});
+        tt_axiom(_index.size() <= 0x1'0000'0000);
+        for (auto i = 0_uz; i != _items.size(); ++i) {
+            insert_slot(hasher{}(_items[i].first), i);
+        }
+    }
+};
+
+} // namespace tt
@@ -0,0 +1,139 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/flat_unordered_map.hpp"
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+using namespace tt;
+
+TEST(flat_unordered_map, insert_and_find)
+{
+    auto m = flat_unordered_map<std::string, int>{};
+    ASSERT_TRUE(m.empty());
+
+    ASSERT_TRUE(m.try_emplace("foo", 1).second);
+    ASSERT_TRUE(m.try_emplace("bar", 2).second);
+    ASSERT_FALSE(m.try_emplace("foo", 3).second);
+    m["baz"] = 4;
+
+    ASSERT_EQ(m.size(), 3);
+    ASSERT_EQ(m.at("foo"), 1);
+    ASSERT_EQ(m.at("bar"), 2);
+    ASSERT_EQ(m.at("baz"), 4);
+    ASSERT_FALSE(m.contains("qux"));
+    ASSERT_THROW((void)m.at("qux"), std::out_of_range);
+
+    // Items are iterated in order of insertion.
+    auto i = m.begin();
+    ASSERT_EQ(i++->first, "foo");
+    ASSERT_EQ(i++->first, "bar");
+    ASSERT_EQ(i++->first, "baz");
+    ASSERT_EQ(i, m.end());
+}
+
+TEST(flat_unordered_map, erase)
+{
+    auto m = flat_unordered_map<int, int>{{1, 10}, {2, 20}, {3, 30}};
+
+    ASSERT_EQ(m.erase(2), 1);
+    ASSERT_EQ(m.erase(2), 0);
+    ASSERT_EQ(m.size(), 2);
+    ASSERT_EQ(m.at(1), 10);
+    ASSERT_EQ(m.at(3), 30);
+}
+
+/** A poor hash function, so that long probe sequences wrap around the end of the index.
+ */
+struct colliding_hash {
+    [[nodiscard]] size_t operator()(int key) const noexcept
+    {
+        return key % 3 == 0 ? 0xffff'ffff : static_cast<size_t>(key % 5);
+    }
+};
+
+TEST(flat_unordered_map, erase_colliding)
+{
+    auto engine = std::mt19937{42};
+
+    auto m = flat_unordered_map<int, int, colliding_hash>{};
+    auto expected = std::unordered_map<int, int>{};
+    for (auto key = 0; key != 100; ++key) {
+        m[key] = key * 10;
+        expected[key] = key * 10;
+    }
+
+    // Erase the keys in random order, every other key must remain reachable after each erase.
+    auto keys = std::vector<int>{};
+    for (auto key = 0; key != 100; ++key) {
+        keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), engine);
+
+    for (ttlet key : keys) {
+        ASSERT_EQ(m.erase(key), 1);
+        ASSERT_EQ(m.erase(key), 0);
+        expected.erase(key);
+        ASSERT_EQ(m.size(), expected.size());
+        for (ttlet &[k, value] : expected) {
+            ASSERT_EQ(m.at(k), value);
+        }
+    }
+    ASSERT_TRUE(m.empty());
+}
+
+TEST(flat_unordered_map, equality)
+{
+    ttlet a = flat_unordered_map<int, int>{{1, 10}, {2, 20}};
+    ttlet b = flat_unordered_map<int, int>{{2, 20}, {1, 10}};
+    ttlet c = flat_unordered_map<int, int>{{2, 20}, {1, 11}};
+    ASSERT_EQ(a, b);
+    ASSERT_NE(a, c);
+}
+
+/** Compare against std::unordered_map while the map grows and shrinks around the
+ * threshold between linear search and the index.
+ */
+TEST(flat_unordered_map, random)
+{
+    auto engine = std::mt19937{42};
+
+    for (auto round = 0; round != 50; ++round) {
+        auto key_distribution = std::uniform_int_distribution<int>{0, round < 25 ? 12 : 300};
+
+        auto m = flat_unordered_map<std::string, int>{};
+        auto expected = std::unordered_map<std::string, int>{};
+
+        for (auto i = 0; i != 1000; ++i) {
+            ttlet key = std::to_string(key_distribution(engine));
+            switch (engine() % 4) {
+            case 0:
+                m[key] += i;
+                expected[key] += i;
+                break;
+            case 1: ASSERT_EQ(m.erase(key), expected.erase(key)); break;
+            case 2: {
+                ttlet r = m.try_emplace(key, i);
+                ttlet e = expected.try_emplace(key, i);
+                ASSERT_EQ(r.second, e.second);
+                ASSERT_EQ(r.first->second, e.first->second);
+            } break;
+            default: ASSERT_EQ(m.contains(key), expected.contains(key));
+            }
+            ASSERT_EQ(m.size(), expected.size());
+        }
+
+        for (ttlet &[key, value] : expected) {
+            ASSERT_EQ(m.at(key), value);
+        }
+
+        ttlet copy = m;
+        ASSERT_EQ(copy, m);
+    }
+}
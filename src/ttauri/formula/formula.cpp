@@ -11,6 +11,7 @@
 #include "formula_bit_or_node.hpp"
 #include "formula_bit_xor_node.hpp"
 #include "formula_call_node.hpp"
+#include "formula_compiled_node.hpp"
 #include "formula_decrement_node.hpp"
 #include "formula_div_node.hpp"
 #include "formula_eq_node.hpp"
@@ -391,6 +392,26 @@ std::unique_ptr<formula_node> parse_formula(formula_parse_context& context)
     return parse_formula_1(context, parse_primary_formula(context), 0);
 }
 
+std::unique_ptr<formula_node> compile_formula(std::unique_ptr<formula_node> node)
+{
+    if (dynamic_cast<formula_compiled_node *>(node.get()) != nullptr) {
+        return node;
+    }
+
+    auto program = formula_program{};
+    try {
+        program = formula_compiler::compile(*node);
+    } catch (operation_error const &) {
+        // The formula is too large for the operands of the instructions.
+        return node;
+    }
+
+    if (program.size() == 1 and program[0].opcode == formula_opcode::evaluate) {
+        return node;
+    }
+    return std::make_unique<formula_compiled_node>(std::move(node), std::move(program));
+}
+
 std::string_view::const_iterator find_end_of_formula(
     std::string_view::const_iterator first,
     std::string_view::const_iterator last,
@@ -38,6 +38,16 @@ inline std::unique_ptr<formula_node> parse_formula(std::string_view text) {
     return parse_formula(text.cbegin(), text.cend());
 }
 
+/** Compile a post-processed formula to bytecode.
+ * Names are resolved to slots, literal subtrees are folded into constants and
+ * nodes without bytecode are evaluated by the tree-walker, which remains the reference.
+ *
+ * @param node The formula after post processing.
+ * @return The formula evaluated by the bytecode virtual machine, or the original
+ *         formula when none of its nodes could be compiled.
+ */
+std::unique_ptr<formula_node> compile_formula(std::unique_ptr<formula_node> node);
+
 
 /** Find the end of an formula.
     * This function will track nested brackets and strings, until the terminating_character is found.
@@ -0,0 +1,87 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "formula_node.hpp"
+#include "formula_program.hpp"
+#include "formula_compiler.hpp"
+
+namespace tt {
+
+/** A formula which is evaluated by the bytecode virtual machine.
+ * All other operations, such as assignment and calls, are forwarded to the original formula.
+ */
+struct formula_compiled_node final : formula_node {
+    std::unique_ptr<formula_node> node;
+    formula_program program;
+
+    formula_compiled_node(std::unique_ptr<formula_node> node, formula_program program) :
+        formula_node(node->location), node(std::move(node)), program(std::move(program))
+    {
+    }
+
+    void post_process(formula_post_process_context &context) override
+    {
+        node->post_process(context);
+        program = formula_compiler::compile(*node);
+    }
+
+    void resolve_function_pointer(formula_post_process_context &context) override
+    {
+        node->resolve_function_pointer(context);
+    }
+
+    void compile(formula_compiler &compiler, size_t dst) const override
+    {
+        node->compile(compiler, dst);
+    }
+
+    datum evaluate(formula_evaluation_context &context) const override
+    {
+        return program.evaluate(context);
+    }
+
+    datum &evaluate_lvalue(formula_evaluation_context &context) const override
+    {
+        return node->evaluate_lvalue(context);
+    }
+
+    bool has_evaluate_xvalue() const override
+    {
+        return node->has_evaluate_xvalue();
+    }
+
+    datum const &evaluate_xvalue(formula_evaluation_context const &context) const override
+    {
+        return node->evaluate_xvalue(context);
+    }
+
+    datum &assign(formula_evaluation_context &context, datum const &rhs) const override
+    {
+        return node->assign(context, rhs);
+    }
+
+    datum call(formula_evaluation_context &context, datum::vector const &arguments) const override
+    {
+        return node->call(context, arguments);
+    }
+
+    std::string get_name() const override
+    {
+        return node->get_name();
+    }
+
+    std::vector<std::string> get_name_and_argument_names() const override
+    {
+        return node->get_name_and_argument_names();
+    }
+
+    std::string string() const noexcept override
+    {
+        return node->string();
+    }
+};
+
+} // namespace tt
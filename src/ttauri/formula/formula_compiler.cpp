@@ -0,0 +1,258 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "formula_compiler.hpp"
+#include "formula_node.hpp"
+#include "../exception.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace tt {
+
+[[nodiscard]] static uint16_t to_operand(size_t value)
+{
+    if (value > std::numeric_limits<uint16_t>::max()) {
+        throw operation_error("Formula is too large to compile.");
+    }
+    return static_cast<uint16_t>(value);
+}
+
+/** Integer division by zero is not an error that can be caught, it must not be folded.
+ */
+[[nodiscard]] static bool is_division_by_zero(formula_opcode opcode, datum const &rhs) noexcept
+{
+    return (opcode == formula_opcode::div or opcode == formula_opcode::mod) and rhs.is_integer() and rhs == 0;
+}
+
+[[nodiscard]] formula_program formula_compiler::compile(formula_node const &node)
+{
+    auto compiler = formula_compiler{};
+    ttlet dst = compiler.allocate_register();
+    node.compile(compiler, dst);
+    compiler.release_register();
+    return std::move(compiler._program);
+}
+
+[[nodiscard]] size_t formula_compiler::allocate_register()
+{
+    ttlet r = _nr_registers_in_use++;
+    _program._nr_registers = std::max(_program._nr_registers, _nr_registers_in_use);
+    return r;
+}
+
+size_t formula_compiler::emit(formula_node const &source, formula_opcode opcode, size_t dst, size_t lhs, size_t rhs)
+{
+    ttlet index = _program._code.size();
+    _program._code.push_back({opcode, to_operand(dst), to_operand(lhs), to_operand(rhs)});
+    _program._sources.push_back(&source);
+    return index;
+}
+
+void formula_compiler::patch_jump(size_t index)
+{
+    _program._code[index].rhs = to_operand(_program._code.size());
+}
+
+[[nodiscard]] datum const *formula_compiler::constant_since(size_t first) const noexcept
+{
+    if (_program._code.size() == first + 1 and _program._code[first].opcode == formula_opcode::load_constant) {
+        return &_program._constants[_program._code[first].lhs];
+    } else {
+        return nullptr;
+    }
+}
+
+void formula_compiler::truncate(size_t nr_instructions, size_t nr_constants) noexcept
+{
+    _program._code.resize(nr_instructions);
+    _program._sources.resize(nr_instructions);
+    _program._constants.resize(nr_constants);
+}
+
+void formula_compiler::emit_evaluate(formula_node const &source, size_t dst)
+{
+    emit(source, formula_opcode::evaluate, dst, 0, 0);
+}
+
+void formula_compiler::emit_constant(formula_node const &source, datum const &value, size_t dst)
+{
+    ttlet index = _program._constants.size();
+    _program._constants.push_back(value);
+    emit(source, formula_opcode::load_constant, dst, index, 0);
+}
+
+void formula_compiler::emit_name(formula_node const &source, std::string const &name, formula_variable_slot const &slot, size_t dst)
+{
+    auto [i, inserted] = _name_slots.try_emplace(name, _program._names.size());
+    if (inserted) {
+        _program._names.push_back(name);
+        _program._slots.push_back(slot);
+    }
+    emit(source, formula_opcode::load_name, dst, i->second, 0);
+}
+
+void formula_compiler::compile_unary(formula_opcode opcode, formula_node const &source, formula_node const &rhs, size_t dst)
+{
+    tt_axiom(is_unary(opcode));
+
+    ttlet first = _program._code.size();
+    ttlet first_constant = _program._constants.size();
+
+    rhs.compile(*this, dst);
+
+    if (ttlet rhs_constant = constant_since(first)) {
+        try {
+            auto value = formula_program::apply(opcode, *rhs_constant);
+            truncate(first, first_constant);
+            emit_constant(source, value, dst);
+            return;
+        } catch (...) {
+            // Leave the error to be reported when the formula is evaluated.
+        }
+    }
+
+    emit(source, opcode, dst, dst, 0);
+}
+
+void formula_compiler::compile_binary(
+    formula_opcode opcode,
+    formula_node const &source,
+    formula_node const &lhs,
+    formula_node const &rhs,
+    size_t dst)
+{
+    tt_axiom(is_binary(opcode));
+
+    ttlet first = _program._code.size();
+    ttlet first_constant = _program._constants.size();
+
+    lhs.compile(*this, dst);
+    ttlet lhs_is_constant = constant_since(first) != nullptr;
+
+    ttlet rhs_first = _program._code.size();
+    ttlet tmp = allocate_register();
+    rhs.compile(*this, tmp);
+    release_register();
+
+    if (lhs_is_constant) {
+        if (ttlet rhs_constant = constant_since(rhs_first); rhs_constant != nullptr and not is_division_by_zero(opcode, *rhs_constant)) {
+            try {
+                auto value = formula_program::apply(opcode, _program._constants[_program._code[first].lhs], *rhs_constant);
+                truncate(first, first_constant);
+                emit_constant(source, value, dst);
+                return;
+            } catch (...) {
+                // Leave the error to be reported when the formula is evaluated.
+            }
+        }
+    }
+
+    emit(source, opcode, dst, dst, tmp);
+}
+
+void formula_compiler::compile_member(formula_node const &source, formula_node const &lhs, datum const &key, size_t dst)
+{
+    ttlet first = _program._code.size();
+    ttlet first_constant = _program._constants.size();
+
+    lhs.compile(*this, dst);
+
+    if (ttlet lhs_constant = constant_since(first)) {
+        try {
+            auto value = formula_program::apply_member(*lhs_constant, key);
+            truncate(first, first_constant);
+            emit_constant(source, value, dst);
+            return;
+        } catch (...) {
+            // Leave the error to be reported when the formula is evaluated.
+        }
+    }
+
+    ttlet key_index = _program._constants.size();
+    _program._constants.push_back(key);
+    emit(source, formula_opcode::member, dst, dst, key_index);
+}
+
+void formula_compiler::compile_index(formula_node const &source, formula_node const &lhs, formula_node const &rhs, size_t dst)
+{
+    ttlet first = _program._code.size();
+    ttlet first_constant = _program._constants.size();
+
+    lhs.compile(*this, dst);
+    ttlet lhs_is_constant = constant_since(first) != nullptr;
+
+    ttlet rhs_first = _program._code.size();
+    ttlet tmp = allocate_register();
+    rhs.compile(*this, tmp);
+    release_register();
+
+    if (lhs_is_constant) {
+        if (ttlet rhs_constant = constant_since(rhs_first)) {
+            try {
+                auto value = formula_program::apply_index(_program._constants[_program._code[first].lhs], *rhs_constant);
+                truncate(first, first_constant);
+                emit_constant(source, value, dst);
+                return;
+            } catch (...) {
+                // Leave the error to be reported when the formula is evaluated.
+            }
+        }
+    }
+
+    emit(source, formula_opcode::index, dst, dst, tmp);
+}
+
+void formula_compiler::compile_logical(bool is_and, formula_node const &source, formula_node const &lhs, formula_node const &rhs, size_t dst)
+{
+    ttlet first = _program._code.size();
+    ttlet first_constant = _program._constants.size();
+
+    lhs.compile(*this, dst);
+
+    if (ttlet lhs_constant = constant_since(first)) {
+        if (static_cast<bool>(*lhs_constant) == is_and) {
+            // The result is the right hand side.
+            truncate(first, first_constant);
+            rhs.compile(*this, dst);
+        }
+        return;
+    }
+
+    ttlet jump = emit(source, is_and ? formula_opcode::jump_if_false : formula_opcode::jump_if_true, dst, dst, 0);
+    rhs.compile(*this, dst);
+    patch_jump(jump);
+}
+
+void formula_compiler::compile_ternary(
+    formula_node const &source,
+    formula_node const &condition,
+    formula_node const &rhs_true,
+    formula_node const &rhs_false,
+    size_t dst)
+{
+    ttlet first = _program._code.size();
+    ttlet first_constant = _program._constants.size();
+
+    condition.compile(*this, dst);
+
+    if (ttlet condition_constant = constant_since(first)) {
+        ttlet condition_value = static_cast<bool>(*condition_constant);
+        truncate(first, first_constant);
+        if (condition_value) {
+            rhs_true.compile(*this, dst);
+        } else {
+            rhs_false.compile(*this, dst);
+        }
+        return;
+    }
+
+    ttlet jump_to_false = emit(source, formula_opcode::jump_if_false, dst, dst, 0);
+    rhs_true.compile(*this, dst);
+    ttlet jump_to_end = emit(source, formula_opcode::jump, dst, 0, 0);
+    patch_jump(jump_to_false);
+    rhs_false.compile(*this, dst);
+    patch_jump(jump_to_end);
+}
+
+} // namespace tt
@@ -0,0 +1,116 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "formula_program.hpp"
+#include "../required.hpp"
+#include "../assert.hpp"
+#include "../datum.hpp"
+#include <string>
+#include <unordered_map>
+
+namespace tt {
+
+struct formula_node;
+
+/** Compiles a post-processed formula to a `formula_program`.
+ *
+ * Each node emits its own instructions through `formula_node::compile()`, which puts
+ * the result of the node in the given register. Subtrees of literals are folded into a
+ * single constant. Nodes that do not override `formula_node::compile()` are evaluated
+ * by the tree-walker at run time.
+ */
+class formula_compiler {
+public:
+    /** Compile a formula.
+     *
+     * @param node The formula after `formula_node::post_process()`.
+     * @return The program, which refers to the nodes of the formula.
+     * @throw operation_error When the formula is too large for the instruction operands.
+     */
+    [[nodiscard]] static formula_program compile(formula_node const &node);
+
+    /** Allocate a temporary register.
+     * Registers are allocated as a stack, the register must be released before the
+     * register allocated before it.
+     */
+    [[nodiscard]] size_t allocate_register();
+
+    void release_register() noexcept
+    {
+        tt_axiom(_nr_registers_in_use > 0);
+        --_nr_registers_in_use;
+    }
+
+    /** Emit an instruction that evaluates the node with the tree-walker.
+     */
+    void emit_evaluate(formula_node const &source, size_t dst);
+
+    void emit_constant(formula_node const &source, datum const &value, size_t dst);
+
+    /** Emit the lookup of a variable.
+     * Each distinct name is given an entry in the name table of the program.
+     *
+     * @param source The name node.
+     * @param name The name of the variable.
+     * @param slot The storage of the variable resolved during post processing.
+     * @param dst The register to load the variable in.
+     */
+    void emit_name(formula_node const &source, std::string const &name, formula_variable_slot const &slot, size_t dst);
+
+    /** Compile an unary operation, folding it when the operand is a constant.
+     */
+    void compile_unary(formula_opcode opcode, formula_node const &source, formula_node const &rhs, size_t dst);
+
+    /** Compile a binary operation, folding it when both operands are constants.
+     */
+    void compile_binary(formula_opcode opcode, formula_node const &source, formula_node const &lhs, formula_node const &rhs, size_t dst);
+
+    void compile_member(formula_node const &source, formula_node const &lhs, datum const &key, size_t dst);
+
+    void compile_index(formula_node const &source, formula_node const &lhs, formula_node const &rhs, size_t dst);
+
+    /** Compile a short-circuiting `&&` or `||`.
+     *
+     * @param is_and True for `&&`, false for `||`.
+     */
+    void compile_logical(bool is_and, formula_node const &source, formula_node const &lhs, formula_node const &rhs, size_t dst);
+
+    void compile_ternary(
+        formula_node const &source,
+        formula_node const &condition,
+        formula_node const &rhs_true,
+        formula_node const &rhs_false,
+        size_t dst);
+
+private:
+    formula_program _program;
+    std::unordered_map<std::string, size_t> _name_slots;
+    size_t _nr_registers_in_use = 0;
+
+    formula_compiler() noexcept = default;
+
+    /** Emit an instruction.
+     * @return The index of the instruction.
+     */
+    size_t emit(formula_node const &source, formula_opcode opcode, size_t dst, size_t lhs, size_t rhs);
+
+    /** Point a jump instruction to the next instruction that will be emitted.
+     */
+    void patch_jump(size_t index);
+
+    /** Get the constant when the code since an instruction is a single load of a constant.
+     *
+     * @param first The index of the first instruction of an operand.
+     * @return A pointer to the constant, or nullptr.
+     */
+    [[nodiscard]] datum const *constant_since(size_t first) const noexcept;
+
+    /** Remove the instructions and constants of folded operands.
+     */
+    void truncate(size_t nr_instructions, size_t nr_constants) noexcept;
+};
+
+} // namespace tt
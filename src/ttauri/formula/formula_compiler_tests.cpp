@@ -0,0 +1,185 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "formula.hpp"
+#include "formula_compiled_node.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+using namespace std;
+using namespace std::literals;
+using namespace tt;
+
+namespace {
+
+void initialize_context(formula_evaluation_context &context)
+{
+    context.set_global("a", 42);
+    context.set_global("b", 5);
+    context.set_global("zero", 0);
+    context.set_global("foo", datum::vector{1, 2, 42, 3});
+    context.set_global("data", datum::map{{"level", 3}, {"name", "hello"}});
+}
+
+/** Evaluate a formula with the tree-walker and the bytecode virtual machine and compare the results.
+ */
+void differential(std::string_view text)
+{
+    SCOPED_TRACE(text);
+
+    auto tree = parse_formula(text);
+    auto compiled = compile_formula(parse_formula(text));
+    ASSERT_EQ(compiled->string(), tree->string());
+
+    formula_evaluation_context tree_context;
+    formula_evaluation_context compiled_context;
+    initialize_context(tree_context);
+    initialize_context(compiled_context);
+
+    datum tree_result;
+    datum compiled_result;
+    bool tree_threw = false;
+    bool compiled_threw = false;
+
+    try {
+        tree_result = tree->evaluate(tree_context);
+    } catch (std::exception const &) {
+        tree_threw = true;
+    }
+
+    try {
+        compiled_result = compiled->evaluate(compiled_context);
+    } catch (std::exception const &) {
+        compiled_threw = true;
+    }
+
+    ASSERT_EQ(compiled_threw, tree_threw);
+    ASSERT_EQ(compiled_result, tree_result);
+    ASSERT_EQ(compiled_context.globals, tree_context.globals);
+}
+
+[[nodiscard]] formula_program const &program_of(std::unique_ptr<formula_node> const &node)
+{
+    auto compiled = dynamic_cast<formula_compiled_node const *>(node.get());
+    tt_assert(compiled != nullptr);
+    return compiled->program;
+}
+
+} // namespace
+
+TEST(FormulaCompiler, Differential)
+{
+    differential("4 - 2 - 1");
+    differential("1 + 2 * 3");
+    differential("(1 + 2) * 3");
+    differential("42 ** 6");
+    differential("42 / 6");
+    differential("42 % 6");
+    differential("42 & 6");
+    differential("42 | 6");
+    differential("42 ^ 6");
+    differential("42 << 6");
+    differential("42 >> 6");
+    differential("42 == 6");
+    differential("42 != 6");
+    differential("42 < 6");
+    differential("42 > 6");
+    differential("42 <= 6");
+    differential("42 >= 6");
+    differential("42 && 0");
+    differential("42 || 0");
+    differential("~ 1 + 2");
+    differential("! 42");
+    differential("- 42");
+    differential("+ 42");
+    differential("a - data.level - 1");
+    differential("a * b + a / b - a % b");
+    differential("a > b ? a : b");
+    differential("zero ? a : b");
+    differential("zero && a");
+    differential("zero || a");
+    differential("b && a");
+    differential("foo[2] + foo[b - 4]");
+    differential("!foo[2]");
+    differential("data.name + \"!\"");
+    differential("\"hello\" + \" \" + \"world\"");
+    differential("[1, a, 3][1]");
+    differential("{\"x\": a}.x");
+    differential("float(a) / b");
+    differential("a = a + 1");
+    differential("(a += 2) * b");
+    differential("foo.append(4) + 1");
+}
+
+TEST(FormulaCompiler, DifferentialErrors)
+{
+    differential("\"hello\" - a");
+    differential("unknown + 1");
+    differential("data.unknown");
+    differential("foo[10]");
+    differential("zero ? a : unknown");
+    differential("1 ? a : unknown");
+    differential("data + 1");
+}
+
+TEST(FormulaCompiler, ConstantFolding)
+{
+    auto e = compile_formula(parse_formula("(1 + 2) * 3 - 4"));
+    ttlet &program = program_of(e);
+    ASSERT_EQ(program.size(), 1);
+    ASSERT_EQ(program[0].opcode, formula_opcode::load_constant);
+    ASSERT_EQ(program.constants().size(), 1);
+    ASSERT_EQ(program.constants()[0], 5);
+
+    // Only the literal subtree is folded.
+    e = compile_formula(parse_formula("a + 2 * 3"));
+    ttlet &program2 = program_of(e);
+    ASSERT_EQ(program2.size(), 3);
+    ASSERT_EQ(program2[2].opcode, formula_opcode::add);
+
+    // A constant condition selects the branch at compile time.
+    e = compile_formula(parse_formula("1 > 2 ? a : b"));
+    ttlet &program3 = program_of(e);
+    ASSERT_EQ(program3.size(), 1);
+    ASSERT_EQ(program3[0].opcode, formula_opcode::load_name);
+    ASSERT_EQ(program3.names()[0], "b");
+
+    // Errors are reported at evaluation time.
+    e = compile_formula(parse_formula("\"hello\" - 1"));
+    formula_evaluation_context context;
+    initialize_context(context);
+    ASSERT_THROW((void)e->evaluate(context), operation_error);
+}
+
+TEST(FormulaCompiler, NameSlots)
+{
+    auto e = compile_formula(parse_formula("a * a + b * a - b"));
+    ttlet &program = program_of(e);
+    ASSERT_EQ(program.names().size(), 2);
+    ASSERT_EQ(program.names()[0], "a");
+    ASSERT_EQ(program.names()[1], "b");
+}
+
+TEST(FormulaCompiler, OpcodeNames)
+{
+    ASSERT_EQ(to_string(formula_opcode::load_constant), "load-constant");
+    ASSERT_EQ(to_string(formula_opcode::load_name), "load-name");
+    ASSERT_EQ(to_string(formula_opcode::evaluate), "evaluate");
+}
+
+TEST(FormulaCompiler, Fallback)
+{
+    // Nothing can be compiled, the original formula is returned.
+    auto e = compile_formula(parse_formula("a = 2"));
+    ASSERT_EQ(dynamic_cast<formula_compiled_node *>(e.get()), nullptr);
+
+    // An assignable compiled formula forwards the assignment to the original formula.
+    e = compile_formula(parse_formula("data.level"));
+    ASSERT_NE(dynamic_cast<formula_compiled_node *>(e.get()), nullptr);
+    formula_evaluation_context context;
+    initialize_context(context);
+    e->assign(context, 7);
+    ASSERT_EQ(e->evaluate(context), 7);
+}
@@ -22,6 +22,10 @@ struct formula_div_node final : formula_binary_operator_node {
         }
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_binary(formula_opcode::div, *this, *lhs, *rhs, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("({} / {})", *lhs, *rhs);
     }
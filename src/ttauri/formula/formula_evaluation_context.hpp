@@ -7,19 +7,136 @@
 #include "../required.hpp"
 #include "../datum.hpp"
 #include "../exception.hpp"
+#include "../assert.hpp"
+#include "formula_output_sink.hpp"
 #include <unordered_map>
 #include <vector>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <cstdint>
 
 namespace tt {
 
+/** The storage of a variable, resolved by `formula_post_process_context::resolve_variable()`.
+ */
+struct formula_variable_slot {
+    enum class scope_type : uint8_t {
+        /** The variable is looked up by name during evaluation. */
+        dynamic,
+
+        /** A local variable of a function, when not assigned the global variable with the same name is used. */
+        local,
+
+        /** A global variable. */
+        global,
+
+        /** A loop variable, such as `$i` or `$$first`. */
+        loop
+    };
+
+    enum class loop_field : uint8_t { count, first, size, last };
+
+    scope_type scope = scope_type::dynamic;
+
+    /** For a loop variable, the number of loops outward from the inner most loop.
+     */
+    uint16_t depth = 0;
+
+    /** The index of a local variable in its frame, or the `loop_field` of a loop variable.
+     */
+    uint32_t index = 0;
+
+    /** The index of a global variable in `formula_evaluation_context::global_cache`.
+     */
+    uint32_t global_index = 0;
+};
+
 struct formula_evaluation_context {
     using scope = std::unordered_map<std::string, datum>;
-    using stack = std::vector<scope>;
+
+    /** The local variables of a function call.
+     */
+    struct frame {
+        /** The names of the local variables that were resolved to a slot during post processing.
+         */
+        std::vector<std::string> const *slot_names;
+
+        /** The values of the resolved local variables, empty until assigned.
+         */
+        std::vector<std::optional<datum>> slots;
+
+        /** Local variables that were not resolved during post processing.
+         */
+        scope dynamic;
+
+        frame(std::vector<std::string> const *slot_names) :
+            slot_names(slot_names), slots(slot_names != nullptr ? slot_names->size() : 0_uz), dynamic()
+        {
+        }
+
+        [[nodiscard]] datum const *find(std::string const &name) const noexcept
+        {
+            if (slot_names != nullptr) {
+                for (auto i = 0_uz; i != slot_names->size(); ++i) {
+                    if ((*slot_names)[i] == name) {
+                        return slots[i] ? &*slots[i] : nullptr;
+                    }
+                }
+            }
+
+            ttlet i = dynamic.find(name);
+            return i != dynamic.end() ? &i->second : nullptr;
+        }
+
+        [[nodiscard]] datum *find(std::string const &name) noexcept
+        {
+            return const_cast<datum *>(std::as_const(*this).find(name));
+        }
+
+        datum &set(std::string const &name, datum const &value)
+        {
+            if (slot_names != nullptr) {
+                for (auto i = 0_uz; i != slot_names->size(); ++i) {
+                    if ((*slot_names)[i] == name) {
+                        return slots[i].emplace(value);
+                    }
+                }
+            }
+
+            return dynamic[name] = value;
+        }
+    };
+
+    using stack = std::vector<frame>;
+
+    /** How the large objects of the datums created during evaluation are allocated.
+     * With `datum_allocation::arena` each evaluation of a template opens a `datum_arena_scope`
+     * for its duration; the datums that outlive the evaluation keep that arena alive.
+     */
+    datum_allocation allocation = datum_allocation::heap;
+
+    /** The size of the buffered output at which it is written to the `output_sink`.
+     */
+    static constexpr size_t output_chunk_size = 65536;
 
     ssize_t output_disable_count = 0;
+
+    /** The output that has not yet been written to the `output_sink`.
+     * When there is no sink this is the complete output.
+     */
     std::string output;
 
+    /** The destination of the output, or nullptr to keep the complete output in `output`.
+     */
+    formula_output_sink *output_sink = nullptr;
+
+    /** The number of sections of the output which may still be discarded.
+     * The output is not written to the sink while there are such sections.
+     */
+    ssize_t output_mark_count = 0;
+
     stack local_stack;
 
     struct loop_info {
@@ -42,32 +159,100 @@ struct formula_evaluation_context {
         }
     };
     std::vector<loop_info> loop_stack;
+
+    /** The global variables.
+     * Items must not be erased while formulas are evaluated, as they are cached in `global_cache`.
+     */
     scope globals;
 
-    formula_evaluation_context() {};
+    /** Pointers to items in `globals`, indexed by `formula_variable_slot::global_index`.
+     * Filled in on first use, so that a global variable is only hashed once per evaluation context.
+     */
+    mutable std::vector<datum *> global_cache;
+
+    /** Create a context for evaluating formulas.
+     *
+     * @param allocation With `datum_allocation::arena` the datums created during the evaluation
+     *                   of a template are allocated from an arena, which is only active while
+     *                   the template is evaluated.
+     */
+    formula_evaluation_context(datum_allocation allocation = datum_allocation::heap) : allocation(allocation) {};
 
     /** Write data to the output.
+    * @throw io_error When writing to the sink failed.
     */
-    void write(std::string_view text) noexcept {
+    void write(std::string_view text) {
         if (output_disable_count == 0) {
             output += text;
+            if (output.size() >= output_chunk_size and output_mark_count == 0) {
+                flush_output();
+            }
+        }
+    }
+
+    /** Write the buffered output to the sink.
+    * @throw io_error When writing to the sink failed.
+    */
+    void flush_output() {
+        if (output_sink != nullptr) {
+            tt_axiom(output_mark_count == 0);
+            output_sink->write(output);
+            output.clear();
         }
     }
 
-    /** Get the size of the output.
-    * Used if you need to reset the output to a previous position.
+    /** Writes the output of the context to a sink during its lifetime.
+    * The previous sink and the number of output marks are restored on destruction,
+    * also when the evaluation was interrupted by an exception.
     */
-    ssize_t output_size() const noexcept {
+    class output_sink_scope {
+    public:
+        output_sink_scope(formula_evaluation_context &context, formula_output_sink &sink) noexcept :
+            _context(context),
+            _previous_sink(std::exchange(context.output_sink, &sink)),
+            _previous_mark_count(context.output_mark_count)
+        {
+        }
+
+        ~output_sink_scope()
+        {
+            _context.output_sink = _previous_sink;
+            _context.output_mark_count = _previous_mark_count;
+        }
+
+        output_sink_scope(output_sink_scope const &) = delete;
+        output_sink_scope(output_sink_scope &&) = delete;
+        output_sink_scope &operator=(output_sink_scope const &) = delete;
+        output_sink_scope &operator=(output_sink_scope &&) = delete;
+
+    private:
+        formula_evaluation_context &_context;
+        formula_output_sink *_previous_sink;
+        ssize_t _previous_mark_count;
+    };
+
+    /** Start a section of the output which may be discarded.
+    * Used by functions with a #return statement, which discard the text they have written.
+    *
+    * @return The position in the output to rewind to.
+    */
+    [[nodiscard]] ssize_t output_mark() noexcept {
+        ++output_mark_count;
         return std::ssize(output);
     }
 
-    /** Set the size of the output.
-    * Used if you need to reset the output to a previous position.
+    /** End a section of the output started with `output_mark()`.
+    *
+    * @param mark The position returned by `output_mark()`.
+    * @param discard Discard the text written since the mark.
     */
-    void set_output_size(ssize_t new_size) noexcept {
-        tt_assert(new_size > 0);
-        tt_assert(new_size <= output_size());
-        output.resize(new_size);
+    void output_release(ssize_t mark, bool discard) noexcept {
+        tt_axiom(output_mark_count > 0);
+        tt_axiom(mark <= std::ssize(output));
+        --output_mark_count;
+        if (discard) {
+            output.resize(mark);
+        }
     }
 
     void enable_output() noexcept {
@@ -88,8 +273,12 @@ struct formula_evaluation_context {
         loop_stack.pop_back();
     }
 
-    void push() {
-        local_stack.emplace_back();
+    /** Push the local variables of a function call.
+     *
+     * @param slot_names The names of the local variables resolved during post processing of the function.
+     */
+    void push(std::vector<std::string> const *slot_names = nullptr) {
+        local_stack.emplace_back(slot_names);
         loop_push();
     }
 
@@ -103,48 +292,89 @@ struct formula_evaluation_context {
         return local_stack.size() > 0;
     }
 
-    scope const& locals() const {
+    frame const& locals() const {
         tt_axiom(has_locals());
         return local_stack.back();
     }
 
-    scope& locals() {
+    frame& locals() {
         tt_axiom(has_locals());
         return local_stack.back();
     }
 
-    [[nodiscard]] datum const &loop_get(std::string_view name) const {
-        tt_axiom(name.size() > 0);
-        if (name.back() == '$') {
-            throw operation_error("Invalid loop variable '{}'", name);
+    /** Parse the name of a loop variable.
+     *
+     * @param name The name of a loop variable, starting with a '$'.
+     * @return The slot of the loop variable, or empty when the name is invalid.
+     */
+    [[nodiscard]] static std::optional<formula_variable_slot> parse_loop_variable(std::string_view name) noexcept {
+        tt_axiom(name.size() > 0 and name.front() == '$');
+
+        auto r = formula_variable_slot{};
+        r.scope = formula_variable_slot::scope_type::loop;
+
+        auto short_name = name.substr(1);
+        while (short_name.size() > 0 and short_name.front() == '$') {
+            short_name = short_name.substr(1);
+            ++r.depth;
         }
 
-        std::string_view short_name = name.substr(1);
-        auto i = loop_stack.crbegin();
+        if (short_name == "i" || short_name == "count") {
+            r.index = static_cast<uint32_t>(formula_variable_slot::loop_field::count);
+        } else if (short_name == "first") {
+            r.index = static_cast<uint32_t>(formula_variable_slot::loop_field::first);
+        } else if (short_name == "size" || short_name == "length") {
+            r.index = static_cast<uint32_t>(formula_variable_slot::loop_field::size);
+        } else if (short_name == "last") {
+            r.index = static_cast<uint32_t>(formula_variable_slot::loop_field::last);
+        } else {
+            return {};
+        }
+        return r;
+    }
 
-        while (short_name[0] == '$') {
+    [[nodiscard]] datum const &loop_get(formula_variable_slot const &slot, std::string_view name) const {
+        tt_axiom(slot.scope == formula_variable_slot::scope_type::loop);
+
+        auto i = loop_stack.crbegin();
+        for (auto depth = 0; depth != slot.depth; ++depth) {
             if (i == loop_stack.crend() || i->count.is_undefined()) {
                 throw operation_error("Accessing loop variable {} while not in loop", name);
             }
-
-            short_name = short_name.substr(1);
             i++;
         }
 
-        if (short_name == "i" || short_name == "count") {
+        if (i == loop_stack.crend()) {
+            throw operation_error("Accessing loop variable {} while not in loop", name);
+        }
+
+        switch (static_cast<formula_variable_slot::loop_field>(slot.index)) {
+        case formula_variable_slot::loop_field::count:
             return i->count;
-        } else if (short_name == "first") {
+        case formula_variable_slot::loop_field::first:
             return i->first;
-        } else if (short_name == "size" || short_name == "length") {
+        case formula_variable_slot::loop_field::size:
             if (i->size.is_undefined()) {
                 throw operation_error("Accessing loop variable {} only available in #for loops", name);
             }
             return i->size;
-        } else if (short_name == "last") {
+        case formula_variable_slot::loop_field::last:
             if (i->last.is_undefined()) {
                 throw operation_error("Accessing loop variable {} only available in #for loops", name);
             }
             return i->last;
+        }
+        tt_no_default();
+    }
+
+    [[nodiscard]] datum const &loop_get(std::string_view name) const {
+        tt_axiom(name.size() > 0);
+        if (name.back() == '$') {
+            throw operation_error("Invalid loop variable '{}'", name);
+        }
+
+        if (ttlet slot = parse_loop_variable(name)) {
+            return loop_get(*slot, name);
         } else {
             throw operation_error("Unknown loop variable {}", name);
         }
@@ -158,9 +388,8 @@ struct formula_evaluation_context {
         }
 
         if (has_locals()) {
-            ttlet i = locals().find(name);
-            if (i != locals().end()) {
-                return i->second;
+            if (ttlet value = locals().find(name)) {
+                return *value;
             }
         }
 
@@ -176,9 +405,8 @@ struct formula_evaluation_context {
         tt_assert(name.size() > 0);
 
         if (has_locals()) {
-            ttlet i = locals().find(name);
-            if (i != locals().end()) {
-                return i->second;
+            if (ttlet value = locals().find(name)) {
+                return *value;
             }
         }
 
@@ -190,9 +418,81 @@ struct formula_evaluation_context {
         throw operation_error("Could not find {} in local or global scope.", name);
     }
 
+    /** Get a variable through its slot.
+     *
+     * @param slot The slot resolved during post processing.
+     * @param name The name of the variable, used when the slot is dynamic or not yet cached.
+     */
+    [[nodiscard]] datum const &get(formula_variable_slot const &slot, std::string const &name) const {
+        switch (slot.scope) {
+        case formula_variable_slot::scope_type::local:
+            tt_axiom(has_locals() and slot.index < locals().slots.size());
+            if (ttlet &value = locals().slots[slot.index]) {
+                return *value;
+            }
+            return get_global(slot.global_index, name);
+
+        case formula_variable_slot::scope_type::global:
+            if (has_locals()) [[unlikely]] {
+                // A formula resolved outside of a function, evaluated inside a function.
+                return get(name);
+            }
+            return get_global(slot.global_index, name);
+
+        case formula_variable_slot::scope_type::loop:
+            return loop_get(slot, name);
+
+        default:
+            return get(name);
+        }
+    }
+
+    [[nodiscard]] datum &get(formula_variable_slot const &slot, std::string const &name) {
+        switch (slot.scope) {
+        case formula_variable_slot::scope_type::local:
+            tt_axiom(has_locals() and slot.index < locals().slots.size());
+            if (auto &value = locals().slots[slot.index]) {
+                return *value;
+            }
+            return get_global(slot.global_index, name);
+
+        case formula_variable_slot::scope_type::global:
+            if (has_locals()) [[unlikely]] {
+                return get(name);
+            }
+            return get_global(slot.global_index, name);
+
+        default:
+            return get(name);
+        }
+    }
+
+    /** Assign to a variable through its slot.
+     *
+     * @param slot The slot resolved during post processing.
+     * @param name The name of the variable, used when the slot is dynamic or not yet cached.
+     * @param value The value to assign.
+     */
+    datum &set(formula_variable_slot const &slot, std::string const &name, datum const &value) {
+        switch (slot.scope) {
+        case formula_variable_slot::scope_type::local:
+            tt_axiom(has_locals() and slot.index < locals().slots.size());
+            return locals().slots[slot.index].emplace(value);
+
+        case formula_variable_slot::scope_type::global:
+            if (has_locals()) [[unlikely]] {
+                return set(name, value);
+            }
+            return global_cache_entry(slot.global_index, name, true) = value;
+
+        default:
+            return set(name, value);
+        }
+    }
+
     template<typename T>
     void set_local(std::string const &name, T &&value) {
-        locals()[name] = std::forward<T>(value);
+        locals().set(name, std::forward<T>(value));
     }
 
     template<typename T>
@@ -202,11 +502,44 @@ struct formula_evaluation_context {
 
     datum &set(std::string const &name, datum const &value) {
         if (has_locals()) {
-            return locals()[name] = value;
+            return locals().set(name, value);
         } else {
             return globals[name] = value;
         }
     }
+
+private:
+    /** Get the cached item of a global variable.
+     *
+     * @param index The global index of the variable.
+     * @param name The name of the variable.
+     * @param create Create the variable when it does not exist.
+     * @return The value of the global variable.
+     * @throw operation_error When the variable does not exist and create is false.
+     */
+    [[nodiscard]] datum &global_cache_entry(uint32_t index, std::string const &name, bool create) const {
+        if (index >= global_cache.size()) {
+            global_cache.resize(index + 1, nullptr);
+        }
+
+        auto &ptr = global_cache[index];
+        if (ptr == nullptr) [[unlikely]] {
+            // The cache is an index into the globals, which is logically part of this context.
+            auto &globals_ = const_cast<scope &>(globals);
+            if (create) {
+                ptr = &globals_[name];
+            } else if (auto i = globals_.find(name); i != globals_.end()) {
+                ptr = &i->second;
+            } else {
+                throw operation_error("Could not find {} in local or global scope.", name);
+            }
+        }
+        return *ptr;
+    }
+
+    [[nodiscard]] datum &get_global(uint32_t index, std::string const &name) const {
+        return global_cache_entry(index, name, false);
+    }
 };
 
 }
\ No newline at end of file
@@ -37,6 +37,10 @@ struct formula_index_node final : formula_binary_operator_node {
         }
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_index(*this, *lhs, *rhs, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("({}[{}])", *lhs, *rhs);
     }
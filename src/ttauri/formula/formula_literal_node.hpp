@@ -18,6 +18,10 @@ struct formula_literal_node final : formula_node {
         return value;
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.emit_constant(*this, value, dst);
+    }
+
     std::string string() const noexcept override {
         return value.repr();
     }
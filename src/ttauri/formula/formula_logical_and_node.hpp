@@ -21,6 +21,10 @@ struct formula_logical_and_node final : formula_binary_operator_node {
         }
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_logical(true, *this, *lhs, *rhs, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("({} && {})", *lhs, *rhs);
     }
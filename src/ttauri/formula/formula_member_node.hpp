@@ -12,6 +12,10 @@ struct formula_member_node final : formula_binary_operator_node {
     mutable formula_post_process_context::method_type method;
     formula_name_node* rhs_name;
 
+    /** The name of the member as an interned key, so that it is not allocated and hashed on each lookup.
+     */
+    datum rhs_key;
+
     formula_member_node(parse_location location, std::unique_ptr<formula_node> lhs, std::unique_ptr<formula_node> rhs) :
         formula_binary_operator_node(std::move(location), std::move(lhs), std::move(rhs))
     {
@@ -19,9 +23,17 @@ struct formula_member_node final : formula_binary_operator_node {
         if (rhs_name == nullptr) {
             throw parse_error("{}: Expecting a name token on the right hand side of a member accessor. got {}.", location, *rhs);
         }
+        rhs_key = datum::intern(rhs_name->name);
+    }
+
+    void post_process(formula_post_process_context& context) override {
+        // The right hand side is the name of a member, not a variable.
+        lhs->post_process(context);
     }
 
     void resolve_function_pointer(formula_post_process_context& context) override {
+        lhs->post_process(context);
+
         method = context.get_method(rhs_name->name);
         if (!method) {
             throw parse_error("{}: Could not find method .{}().", location, rhs_name->name);
@@ -32,11 +44,11 @@ struct formula_member_node final : formula_binary_operator_node {
         if (lhs->has_evaluate_xvalue()) {
             ttlet &lhs_ = lhs->evaluate_xvalue(context);
 
-            if (!lhs_.contains(rhs_name->name)) {
+            if (!lhs_.contains(rhs_key)) {
                 throw operation_error("{}: Unknown attribute .{}", location, rhs_name->name);
             }
             try {
-                return lhs_[rhs_name->name];
+                return lhs_[rhs_key];
             } catch (std::exception const &e) {
                 throw operation_error("{}: Can not evaluate member selection.\n{}", location, e.what());
             }
@@ -44,11 +56,11 @@ struct formula_member_node final : formula_binary_operator_node {
         } else {
             ttlet lhs_ = lhs->evaluate(context);
 
-            if (!lhs_.contains(rhs_name->name)) {
+            if (!lhs_.contains(rhs_key)) {
                 throw operation_error("{}: Unknown attribute .{}", location, rhs_name->name);
             }
             try {
-                return lhs_[rhs_name->name];
+                return lhs_[rhs_key];
             } catch (std::exception const &e) {
                 throw operation_error("{}: Can not evaluate member selection.\n{}", location, e.what());
             }
@@ -58,7 +70,7 @@ struct formula_member_node final : formula_binary_operator_node {
     datum &evaluate_lvalue(formula_evaluation_context& context) const override {
         auto &lhs_ = lhs->evaluate_lvalue(context);
         try {
-            return lhs_[rhs_name->name];
+            return lhs_[rhs_key];
         } catch (std::exception const &e) {
             throw operation_error("{}: Can not evaluate member-selection.\n{}", location, e.what());
         }
@@ -73,6 +85,10 @@ struct formula_member_node final : formula_binary_operator_node {
         }
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_member(*this, *lhs, rhs_key, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("({} . {})", *lhs, *rhs);
     }
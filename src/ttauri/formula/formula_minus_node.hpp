@@ -21,6 +21,10 @@ struct formula_minus_node final : formula_unary_operator_node {
         }
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_unary(formula_opcode::minus, *this, *rhs, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("(- {})", *rhs);
     }
@@ -16,6 +16,10 @@ struct formula_ne_node final : formula_binary_operator_node {
         return lhs->evaluate(context) != rhs->evaluate(context);
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_binary(formula_opcode::ne, *this, *lhs, *rhs, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("({} != {})", *lhs, *rhs);
     }
@@ -6,6 +6,7 @@
 
 #include "formula_post_process_context.hpp"
 #include "formula_evaluation_context.hpp"
+#include "formula_compiler.hpp"
 #include "../required.hpp"
 #include "../parse_location.hpp"
 #include "../datum.hpp"
@@ -35,6 +36,17 @@ struct formula_node {
      */
     virtual void resolve_function_pointer(formula_post_process_context &context) {}
 
+    /** Compile the formula to bytecode.
+     * The default implementation evaluates this node with the tree-walker.
+     *
+     * @param compiler The compiler to emit the instructions to.
+     * @param dst The register where the result of the formula is stored.
+     */
+    virtual void compile(formula_compiler &compiler, size_t dst) const
+    {
+        compiler.emit_evaluate(*this, dst);
+    }
+
     /** Evaluate an rvalue.
      */
     virtual datum evaluate(formula_evaluation_context &context) const = 0;
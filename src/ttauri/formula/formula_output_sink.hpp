@@ -0,0 +1,66 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "../required.hpp"
+#include "../file.hpp"
+#include <string>
+#include <string_view>
+
+namespace tt {
+
+/** The destination of the text generated while evaluating a skeleton.
+ *
+ * The `formula_evaluation_context` buffers the text and writes it to the sink
+ * in chunks, so that the complete document does not need to be held in memory.
+ */
+class formula_output_sink {
+public:
+    formula_output_sink() noexcept = default;
+    virtual ~formula_output_sink() = default;
+    formula_output_sink(formula_output_sink const &) = delete;
+    formula_output_sink(formula_output_sink &&) = delete;
+    formula_output_sink &operator=(formula_output_sink const &) = delete;
+    formula_output_sink &operator=(formula_output_sink &&) = delete;
+
+    /** Write text to the destination.
+     *
+     * @param text A chunk of the generated text.
+     */
+    virtual void write(std::string_view text) = 0;
+};
+
+/** Appends the generated text to a string.
+ */
+class formula_string_sink final : public formula_output_sink {
+public:
+    formula_string_sink(std::string &str) noexcept : _str(str) {}
+
+    void write(std::string_view text) override
+    {
+        _str += text;
+    }
+
+private:
+    std::string &_str;
+};
+
+/** Writes the generated text to a file.
+ */
+class formula_file_sink final : public formula_output_sink {
+public:
+    formula_file_sink(file &file) noexcept : _file(file) {}
+
+    /** @throw io_error */
+    void write(std::string_view text) override
+    {
+        _file.write(text);
+    }
+
+private:
+    file &_file;
+};
+
+} // namespace tt
@@ -6,35 +6,36 @@
 
 #include "../required.hpp"
 #include "../tokenizer.hpp"
-#include <vector>
 #include <string_view>
 
 namespace tt {
 
 struct formula_parse_context {
-    using const_iterator = typename std::vector<token_t>::const_iterator;
-
     std::string_view::const_iterator first;
     std::string_view::const_iterator last;
 
-    std::vector<token_t> tokens;
-    const_iterator token_it;
+    /** The tokens are read one at a time while parsing.
+     */
+    token_reader reader;
+    token_t token;
 
     formula_parse_context(std::string_view::const_iterator first, std::string_view::const_iterator last) :
-        first(first), last(last), tokens(parseTokens(first, last)), token_it(tokens.begin()) {}
+        first(first), last(last), reader(first, last), token()
+    {
+        read_token();
+    }
 
     [[nodiscard]] token_t const& operator*() const noexcept {
-        return *token_it;
+        return token;
     }
 
     [[nodiscard]] token_t const *operator->() const noexcept {
-        return &(*token_it);
+        return &token;
     }
 
     formula_parse_context& operator++() noexcept {
-        tt_axiom(token_it != tokens.end());
-        tt_axiom(*token_it != tokenizer_name_t::End);
-        ++token_it;
+        tt_axiom(token != tokenizer_name_t::End);
+        read_token();
         return *this;
     }
 
@@ -43,6 +44,15 @@ struct formula_parse_context {
         ++(*this);
         return tmp;
     }
+
+private:
+    void read_token() noexcept
+    {
+        ttlet view = reader.next();
+        token.name = view.name;
+        token.value = view.value();
+        token.location = view.location;
+    }
 };
 
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 
 #include "formula_post_process_context.hpp"
 #include "../url_parser.hpp"
+#include "../unfair_mutex.hpp"
+#include "../cast.hpp"
+#include <mutex>
+#include <algorithm>
 
 namespace tt {
 
@@ -256,4 +260,53 @@ formula_post_process_context::filter_table formula_post_process_context::global_
     {"url"s, url_encode}
 };
 
+[[nodiscard]] std::optional<uint32_t> formula_post_process_context::global_index(std::string const &name)
+{
+    static unfair_mutex mutex;
+    static std::unordered_map<std::string, uint32_t> indices;
+
+    ttlet lock = std::scoped_lock(mutex);
+    if (ttlet i = indices.find(name); i != indices.end()) {
+        return i->second;
+    } else if (indices.size() < global_index_capacity) {
+        return indices.emplace(name, narrow_cast<uint32_t>(indices.size())).first->second;
+    } else {
+        return {};
+    }
+}
+
+[[nodiscard]] formula_variable_slot formula_post_process_context::resolve_variable(std::string const &name)
+{
+    tt_axiom(name.size() > 0);
+
+    if (name.front() == '$') {
+        if (name.back() != '$') {
+            if (ttlet slot = formula_evaluation_context::parse_loop_variable(name)) {
+                return *slot;
+            }
+        }
+        return {};
+    }
+
+    ttlet index = global_index(name);
+    if (not index) {
+        return {};
+    }
+
+    auto r = formula_variable_slot{};
+    r.global_index = *index;
+
+    if (local_scopes.size() > 0) {
+        auto &names = *local_scopes.back();
+        r.scope = formula_variable_slot::scope_type::local;
+        r.index = narrow_cast<uint32_t>(std::distance(names.begin(), std::find(names.begin(), names.end(), name)));
+        if (r.index == names.size()) {
+            names.push_back(name);
+        }
+    } else {
+        r.scope = formula_variable_slot::scope_type::global;
+    }
+    return r;
+}
+
 }
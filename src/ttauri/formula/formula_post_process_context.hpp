@@ -7,12 +7,15 @@
 #include "formula_evaluation_context.hpp"
 #include "../required.hpp"
 #include "../datum.hpp"
+#include "../assert.hpp"
 #include "../strings.hpp"
 #include <functional>
 #include <unordered_map>
 #include <vector>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <cstdint>
 
 namespace tt {
 
@@ -27,6 +30,16 @@ struct formula_post_process_context {
 
     function_table functions;
     function_stack super_stack;
+
+    /** The names of the local variables of the functions being post processed.
+     */
+    std::vector<std::vector<std::string> *> local_scopes;
+
+    /** The number of #return statements that have been post processed.
+     * Used by skeleton functions to find out if they may need to discard their output.
+     */
+    size_t return_count = 0;
+
     static function_table global_functions;
     static method_table global_methods;
     static filter_table global_filters;
@@ -68,6 +81,44 @@ struct formula_post_process_context {
         super_stack.pop_back();
     }
 
+    /** Start resolving variables to the local variables of a function.
+     *
+     * @param names The names of the local variables, arguments should already be added.
+     *              Names of variables used inside the function are appended during post processing.
+     */
+    void push_local_scope(std::vector<std::string> &names) noexcept {
+        local_scopes.push_back(&names);
+    }
+
+    void pop_local_scope() noexcept {
+        tt_axiom(local_scopes.size() > 0);
+        local_scopes.pop_back();
+    }
+
+    /** Resolve the storage of a variable.
+     *
+     * Inside a function a variable is given a slot in the local variables of the function,
+     * outside a function a variable is given an index in the cache of global variables.
+     * Invalid loop variables are left dynamic, so that the error is reported during evaluation.
+     * Variables are also left dynamic when the table of global indices is full.
+     *
+     * @param name The name of the variable.
+     * @return The slot of the variable.
+     */
+    [[nodiscard]] formula_variable_slot resolve_variable(std::string const &name);
+
+    /** The maximum number of names that are given an index in the cache of global variables.
+     * This bounds the size of the process-wide table of names, and of the cache in each evaluation context.
+     */
+    static constexpr size_t global_index_capacity = 4096;
+
+    /** Get the index of a global variable in `formula_evaluation_context::global_cache`.
+     * The index is unique for each name in the process.
+     *
+     * @return The index, or empty when `global_index_capacity` names already have an index.
+     */
+    [[nodiscard]] static std::optional<uint32_t> global_index(std::string const &name);
+
     [[nodiscard]] filter_type get_filter(std::string const &name) const noexcept {
         ttlet i = global_filters.find(name);
         if (i != global_filters.end()) {
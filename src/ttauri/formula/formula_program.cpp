@@ -0,0 +1,166 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "formula_program.hpp"
+#include "formula_node.hpp"
+#include "../exception.hpp"
+#include <array>
+#include <utility>
+
+namespace tt {
+
+[[nodiscard]] std::string_view to_string(formula_opcode opcode) noexcept
+{
+    switch (opcode) {
+    case formula_opcode::load_constant: return "load-constant";
+    case formula_opcode::load_name: return "load-name";
+    case formula_opcode::evaluate: return "evaluate";
+    case formula_opcode::member: return "member selection";
+    case formula_opcode::index: return "indexing operation";
+    case formula_opcode::jump: return "jump";
+    case formula_opcode::jump_if_false: return "jump-if-false";
+    case formula_opcode::jump_if_true: return "jump-if-true";
+    case formula_opcode::minus: return "unary-minus";
+    case formula_opcode::plus: return "unary-plus";
+    case formula_opcode::invert: return "binary-not";
+    case formula_opcode::logical_not: return "logical not";
+    case formula_opcode::add: return "add";
+    case formula_opcode::sub: return "subtract";
+    case formula_opcode::mul: return "multiply";
+    case formula_opcode::div: return "division";
+    case formula_opcode::mod: return "modulo";
+    case formula_opcode::pow: return "power-operator";
+    case formula_opcode::shl: return "shift-left";
+    case formula_opcode::shr: return "shift-right";
+    case formula_opcode::lt: return "less-than";
+    case formula_opcode::gt: return "greater-than";
+    case formula_opcode::le: return "less-or-equal";
+    case formula_opcode::ge: return "greater-or-equal";
+    case formula_opcode::eq: return "equal";
+    case formula_opcode::ne: return "not-equal";
+    case formula_opcode::bit_and: return "binary-and";
+    case formula_opcode::bit_or: return "binary-or";
+    case formula_opcode::bit_xor: return "binary-xor";
+    }
+    tt_no_default();
+}
+
+[[nodiscard]] datum formula_program::apply(formula_opcode opcode, datum const &rhs)
+{
+    switch (opcode) {
+    case formula_opcode::minus: return -rhs;
+    case formula_opcode::plus: return +rhs;
+    case formula_opcode::invert: return ~rhs;
+    case formula_opcode::logical_not: return !rhs;
+    default: tt_no_default();
+    }
+}
+
+[[nodiscard]] datum formula_program::apply(formula_opcode opcode, datum const &lhs, datum const &rhs)
+{
+    switch (opcode) {
+    case formula_opcode::add: return lhs + rhs;
+    case formula_opcode::sub: return lhs - rhs;
+    case formula_opcode::mul: return lhs * rhs;
+    case formula_opcode::div: return lhs / rhs;
+    case formula_opcode::mod: return lhs % rhs;
+    case formula_opcode::pow: return pow(lhs, rhs);
+    case formula_opcode::shl: return lhs << rhs;
+    case formula_opcode::shr: return lhs >> rhs;
+    case formula_opcode::lt: return lhs < rhs;
+    case formula_opcode::gt: return lhs > rhs;
+    case formula_opcode::le: return lhs <= rhs;
+    case formula_opcode::ge: return lhs >= rhs;
+    case formula_opcode::eq: return lhs == rhs;
+    case formula_opcode::ne: return lhs != rhs;
+    case formula_opcode::bit_and: return lhs & rhs;
+    case formula_opcode::bit_or: return lhs | rhs;
+    case formula_opcode::bit_xor: return lhs ^ rhs;
+    default: tt_no_default();
+    }
+}
+
+[[nodiscard]] datum formula_program::apply_member(datum const &lhs, datum const &key)
+{
+    if (!lhs.contains(key)) {
+        throw operation_error("Unknown attribute .{}", key);
+    }
+    return lhs[key];
+}
+
+[[nodiscard]] datum formula_program::apply_index(datum const &lhs, datum const &key)
+{
+    if (!lhs.contains(key)) {
+        throw operation_error("Unknown key '{}'.", key);
+    }
+    return lhs[key];
+}
+
+[[nodiscard]] datum formula_program::evaluate(formula_evaluation_context &context) const
+{
+    if (_nr_registers <= nr_inline_registers) {
+        auto registers = std::array<datum, nr_inline_registers>{};
+        return run(context, registers.data());
+    } else {
+        auto registers = std::vector<datum>(_nr_registers);
+        return run(context, registers.data());
+    }
+}
+
+[[nodiscard]] datum formula_program::run(formula_evaluation_context &context, datum *registers) const
+{
+    ttlet &const_context = context;
+
+    auto pc = 0_uz;
+    while (pc != _code.size()) {
+        ttlet &instruction = _code[pc];
+
+        if (instruction.opcode == formula_opcode::evaluate) {
+            // The tree-walker reports its own errors.
+            registers[instruction.dst] = _sources[pc]->evaluate(context);
+            ++pc;
+            continue;
+        }
+
+        try {
+            switch (instruction.opcode) {
+            case formula_opcode::load_constant: registers[instruction.dst] = _constants[instruction.lhs]; break;
+            case formula_opcode::load_name: registers[instruction.dst] = const_context.get(_slots[instruction.lhs], _names[instruction.lhs]); break;
+            case formula_opcode::member:
+                registers[instruction.dst] = apply_member(registers[instruction.lhs], _constants[instruction.rhs]);
+                break;
+            case formula_opcode::index:
+                registers[instruction.dst] = apply_index(registers[instruction.lhs], registers[instruction.rhs]);
+                break;
+            case formula_opcode::jump: pc = instruction.rhs; continue;
+            case formula_opcode::jump_if_false:
+                if (not static_cast<bool>(registers[instruction.lhs])) {
+                    pc = instruction.rhs;
+                    continue;
+                }
+                break;
+            case formula_opcode::jump_if_true:
+                if (static_cast<bool>(registers[instruction.lhs])) {
+                    pc = instruction.rhs;
+                    continue;
+                }
+                break;
+            case formula_opcode::minus:
+            case formula_opcode::plus:
+            case formula_opcode::invert:
+            case formula_opcode::logical_not:
+                registers[instruction.dst] = apply(instruction.opcode, registers[instruction.lhs]);
+                break;
+            default: registers[instruction.dst] = apply(instruction.opcode, registers[instruction.lhs], registers[instruction.rhs]);
+            }
+        } catch (std::exception const &e) {
+            throw operation_error("{}: Can not evaluate {}.\n{}", _sources[pc]->location, to_string(instruction.opcode), e.what());
+        }
+        ++pc;
+    }
+
+    return std::move(registers[0]);
+}
+
+} // namespace tt
@@ -0,0 +1,189 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "formula_evaluation_context.hpp"
+#include "../required.hpp"
+#include "../assert.hpp"
+#include "../datum.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace tt {
+
+struct formula_node;
+
+/** The operations of the formula virtual machine.
+ */
+enum class formula_opcode : uint8_t {
+    /** dst = constants[lhs] */
+    load_constant,
+    /** dst = context.get(slots[lhs], names[lhs]) */
+    load_name,
+    /** dst = source->evaluate(context), using the tree-walker for nodes that are not compiled. */
+    evaluate,
+    /** dst = registers[lhs] . constants[rhs] */
+    member,
+    /** dst = registers[lhs][registers[rhs]] */
+    index,
+    /** pc = rhs */
+    jump,
+    /** if (not registers[lhs]) pc = rhs */
+    jump_if_false,
+    /** if (registers[lhs]) pc = rhs */
+    jump_if_true,
+
+    // dst = op registers[lhs]
+    minus,
+    plus,
+    invert,
+    logical_not,
+
+    // dst = registers[lhs] op registers[rhs]
+    add,
+    sub,
+    mul,
+    div,
+    mod,
+    pow,
+    shl,
+    shr,
+    lt,
+    gt,
+    le,
+    ge,
+    eq,
+    ne,
+    bit_and,
+    bit_or,
+    bit_xor
+};
+
+[[nodiscard]] constexpr bool is_unary(formula_opcode opcode) noexcept
+{
+    return opcode >= formula_opcode::minus and opcode <= formula_opcode::logical_not;
+}
+
+[[nodiscard]] constexpr bool is_binary(formula_opcode opcode) noexcept
+{
+    return opcode >= formula_opcode::add;
+}
+
+/** A name of the operation used in error messages, the same as used by the tree-walker.
+ */
+[[nodiscard]] std::string_view to_string(formula_opcode opcode) noexcept;
+
+/** A single instruction of the formula virtual machine.
+ * Operands are register numbers, or indices into the constant or name table
+ * of the program, depending on the opcode.
+ */
+struct formula_instruction {
+    formula_opcode opcode;
+    uint16_t dst;
+    uint16_t lhs;
+    uint16_t rhs;
+};
+
+/** A formula compiled to bytecode for a register based virtual machine.
+ *
+ * The registers of the virtual machine are datums, the result of the formula is
+ * left in register 0. Nodes that can not be compiled are evaluated through
+ * the tree-walker, therefor a program may not outlive the formula it was compiled from.
+ */
+class formula_program {
+public:
+    /** The number of registers that are allocated on the stack during evaluation.
+     */
+    static constexpr size_t nr_inline_registers = 16;
+
+    formula_program() noexcept = default;
+    formula_program(formula_program const &) = default;
+    formula_program(formula_program &&) noexcept = default;
+    formula_program &operator=(formula_program const &) = default;
+    formula_program &operator=(formula_program &&) noexcept = default;
+
+    /** Evaluate the program.
+     *
+     * @param context The context with the variables used by the formula.
+     * @return The result of the formula.
+     */
+    [[nodiscard]] datum evaluate(formula_evaluation_context &context) const;
+
+    /** The number of instructions of the program.
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _code.size();
+    }
+
+    [[nodiscard]] formula_instruction const &operator[](size_t index) const noexcept
+    {
+        tt_axiom(index < _code.size());
+        return _code[index];
+    }
+
+    /** The number of registers needed to evaluate the program.
+     */
+    [[nodiscard]] size_t nr_registers() const noexcept
+    {
+        return _nr_registers;
+    }
+
+    /** The names of the variables used by the program.
+     * Each name is resolved to a slot in this table once, during compilation.
+     */
+    [[nodiscard]] std::vector<std::string> const &names() const noexcept
+    {
+        return _names;
+    }
+
+    [[nodiscard]] std::vector<datum> const &constants() const noexcept
+    {
+        return _constants;
+    }
+
+    /** Apply an unary operation.
+     * This is used by the virtual machine and by the compiler for constant folding.
+     */
+    [[nodiscard]] static datum apply(formula_opcode opcode, datum const &rhs);
+
+    /** Apply a binary operation.
+     * This is used by the virtual machine and by the compiler for constant folding.
+     */
+    [[nodiscard]] static datum apply(formula_opcode opcode, datum const &lhs, datum const &rhs);
+
+    /** Select the member of an object.
+     * This is used by the virtual machine and by the compiler for constant folding.
+     */
+    [[nodiscard]] static datum apply_member(datum const &lhs, datum const &key);
+
+    /** Index an object.
+     * This is used by the virtual machine and by the compiler for constant folding.
+     */
+    [[nodiscard]] static datum apply_index(datum const &lhs, datum const &key);
+
+private:
+    std::vector<formula_instruction> _code;
+
+    /** The node each instruction was compiled from, for error messages and for calling the tree-walker.
+     */
+    std::vector<formula_node const *> _sources;
+
+    std::vector<datum> _constants;
+    std::vector<std::string> _names;
+
+    /** The storage of each variable in the name table.
+     */
+    std::vector<formula_variable_slot> _slots;
+    size_t _nr_registers = 0;
+
+    [[nodiscard]] datum run(formula_evaluation_context &context, datum *registers) const;
+
+    friend class formula_compiler;
+};
+
+} // namespace tt
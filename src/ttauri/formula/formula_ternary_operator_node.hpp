@@ -40,6 +40,10 @@ struct formula_ternary_operator_node final : formula_node {
         }
     }
 
+    void compile(formula_compiler &compiler, size_t dst) const override {
+        compiler.compile_ternary(*this, *lhs, *rhs_true, *rhs_false, dst);
+    }
+
     std::string string() const noexcept override {
         return std::format("({} ? {} : {})", *lhs, *rhs_true, *rhs_false);
     }
@@ -367,6 +367,68 @@ TEST(Formula, Binding) {
     ASSERT_EQ(context.get("foo"), expected);
 }
 
+TEST(Formula, VariableSlots) {
+    using scope_type = formula_variable_slot::scope_type;
+
+    auto post_process_context = formula_post_process_context();
+
+    ttlet foo = post_process_context.resolve_variable("foo");
+    ASSERT_EQ(foo.scope, scope_type::global);
+    ASSERT_EQ(post_process_context.resolve_variable("foo").global_index, foo.global_index);
+    ASSERT_NE(post_process_context.resolve_variable("bar").global_index, foo.global_index);
+
+    auto local_names = std::vector<std::string>{"bar"};
+    post_process_context.push_local_scope(local_names);
+    ttlet local_foo = post_process_context.resolve_variable("foo");
+    ASSERT_EQ(local_foo.scope, scope_type::local);
+    ASSERT_EQ(local_foo.index, 1);
+    ASSERT_EQ(local_foo.global_index, foo.global_index);
+    ASSERT_EQ(post_process_context.resolve_variable("bar").index, 0);
+    ASSERT_EQ(local_names.size(), 2);
+    post_process_context.pop_local_scope();
+
+    ttlet outer_first = post_process_context.resolve_variable("$$first");
+    ASSERT_EQ(outer_first.scope, scope_type::loop);
+    ASSERT_EQ(outer_first.depth, 1);
+    ASSERT_EQ(outer_first.index, static_cast<uint32_t>(formula_variable_slot::loop_field::first));
+    ASSERT_EQ(post_process_context.resolve_variable("$foo").scope, scope_type::dynamic);
+
+    formula_evaluation_context context;
+    context.set_global("foo", 42);
+    ASSERT_EQ(std::as_const(context).get(foo, "foo"), 42);
+    context.set(foo, "foo", 5);
+    ASSERT_EQ(context.get("foo"), 5);
+
+    // A local variable falls back to the global variable until it is assigned.
+    context.push(&local_names);
+    ASSERT_EQ(std::as_const(context).get(local_foo, "foo"), 5);
+    context.set(local_foo, "foo", 7);
+    ASSERT_EQ(std::as_const(context).get(local_foo, "foo"), 7);
+    ASSERT_EQ(context.get("foo"), 7);
+    context.pop();
+    ASSERT_EQ(std::as_const(context).get(foo, "foo"), 5);
+}
+
+TEST(Formula, VariableSlotsCapacity) {
+    using scope_type = formula_variable_slot::scope_type;
+
+    auto post_process_context = formula_post_process_context();
+    ttlet foo = post_process_context.resolve_variable("foo");
+
+    // Fill the table of global indices, names that do not fit are looked up by name.
+    for (auto i = 0_uz; i != formula_post_process_context::global_index_capacity; ++i) {
+        (void)post_process_context.resolve_variable("capacity" + std::to_string(i));
+    }
+    ttlet overflow = post_process_context.resolve_variable("overflow");
+    ASSERT_EQ(overflow.scope, scope_type::dynamic);
+    ASSERT_EQ(post_process_context.resolve_variable("foo").global_index, foo.global_index);
+
+    formula_evaluation_context context;
+    context.set(overflow, "overflow", 3);
+    ASSERT_EQ(std::as_const(context).get(overflow, "overflow"), 3);
+    ASSERT_EQ(context.get("overflow"), 3);
+}
+
 TEST(Formula, FunctionCall) {
     std::unique_ptr<formula_node> e;
     datum r;
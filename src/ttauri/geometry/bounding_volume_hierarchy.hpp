@@ -0,0 +1,200 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "axis_aligned_rectangle.hpp"
+#include "point.hpp"
+#include "../assert.hpp"
+#include "../cast.hpp"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+namespace tt {
+
+/** A bounding volume hierarchy of axis aligned rectangles.
+ *
+ * The hierarchy is build in one go from a list of rectangles with their values,
+ * after which it can be queried for all rectangles that contain a point in
+ * logarithmic time.
+ *
+ * Nodes are split at the median of the centers of the rectangles along the
+ * longest axis, which keeps the tree balanced for the grids and rows of
+ * rectangles that are common in a user interface.
+ *
+ * @tparam T The type of value associated with each rectangle.
+ */
+template<typename T>
+class bounding_volume_hierarchy {
+public:
+    using value_type = T;
+
+    struct item_type {
+        aarectangle rectangle;
+        value_type value;
+    };
+
+    /** The maximum number of items in a leaf node.
+     */
+    static constexpr size_t leaf_size = 4;
+
+    bounding_volume_hierarchy() noexcept = default;
+    bounding_volume_hierarchy(bounding_volume_hierarchy const &) noexcept = default;
+    bounding_volume_hierarchy(bounding_volume_hierarchy &&) noexcept = default;
+    bounding_volume_hierarchy &operator=(bounding_volume_hierarchy const &) noexcept = default;
+    bounding_volume_hierarchy &operator=(bounding_volume_hierarchy &&) noexcept = default;
+
+    /** Build the hierarchy.
+     *
+     * @param items The rectangles and their values; any previous items are replaced.
+     */
+    bounding_volume_hierarchy(std::vector<item_type> items) noexcept
+    {
+        build(std::move(items));
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _items.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _items.empty();
+    }
+
+    /** The rectangle enclosing all the items.
+     */
+    [[nodiscard]] aarectangle bounding_rectangle() const noexcept
+    {
+        return _nodes.empty() ? aarectangle{} : _nodes.front().rectangle;
+    }
+
+    void clear() noexcept
+    {
+        _items.clear();
+        _nodes.clear();
+    }
+
+    /** Build the hierarchy.
+     *
+     * @param items The rectangles and their values; any previous items are replaced.
+     */
+    void build(std::vector<item_type> items) noexcept
+    {
+        _items = std::move(items);
+        _nodes.clear();
+        if (not _items.empty()) {
+            _nodes.reserve((_items.size() / leaf_size + 1) * 2);
+            build_node(0, _items.size());
+        }
+    }
+
+    /** Find all items that contain a point.
+     *
+     * Items are found in no particular order. As with `aarectangle::contains()` the
+     * left and bottom edges of a rectangle are inclusive, the right and top edges exclusive.
+     *
+     * @param position The point to test.
+     * @param function The function `void(value_type const &)` called for each item containing the point.
+     */
+    template<typename Function>
+    void find(point2 position, Function &&function) const noexcept
+    {
+        if (_nodes.empty()) {
+            return;
+        }
+
+        // The tree is balanced, so its depth is at most the logarithm of the number of items.
+        std::array<uint32_t, 64> stack;
+        size_t stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size != 0) {
+            ttlet node_index = stack[--stack_size];
+            ttlet &node = _nodes[node_index];
+
+            if (not node.rectangle.contains(position)) {
+                continue;
+            }
+
+            if (node.count != 0) {
+                for (auto i = node.first; i != node.first + node.count; ++i) {
+                    ttlet &item = _items[i];
+                    if (item.rectangle.contains(position)) {
+                        function(item.value);
+                    }
+                }
+
+            } else {
+                tt_axiom(stack_size + 2 <= stack.size());
+                // The left child directly follows its parent, node.first is the index of the right child.
+                stack[stack_size++] = node.first;
+                stack[stack_size++] = node_index + 1;
+            }
+        }
+    }
+
+private:
+    struct node_type {
+        aarectangle rectangle;
+
+        /** Index of the first item of a leaf node, or the index of the right child node.
+         */
+        uint32_t first;
+
+        /** Number of items in a leaf node, zero for a branch node.
+         */
+        uint32_t count;
+    };
+
+    std::vector<item_type> _items;
+    std::vector<node_type> _nodes;
+
+    [[nodiscard]] static point2 center(aarectangle const &rectangle) noexcept
+    {
+        return point2{(rectangle.left() + rectangle.right()) * 0.5f, (rectangle.bottom() + rectangle.top()) * 0.5f};
+    }
+
+    uint32_t build_node(size_t first, size_t last) noexcept
+    {
+        ttlet node_index = narrow_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+
+        auto rectangle = aarectangle{};
+        auto center_min = center(_items[first].rectangle);
+        auto center_max = center_min;
+        for (auto i = first; i != last; ++i) {
+            ttlet item_center = center(_items[i].rectangle);
+            rectangle |= _items[i].rectangle;
+            center_min = min(center_min, item_center);
+            center_max = max(center_max, item_center);
+        }
+
+        if (last - first <= leaf_size) {
+            _nodes[node_index] = node_type{rectangle, narrow_cast<uint32_t>(first), narrow_cast<uint32_t>(last - first)};
+            return node_index;
+        }
+
+        ttlet center_extent = center_max - center_min;
+        ttlet split_on_x = center_extent.x() >= center_extent.y();
+        ttlet middle = first + (last - first) / 2;
+        std::nth_element(
+            _items.begin() + first, _items.begin() + middle, _items.begin() + last, [split_on_x](ttlet &lhs, ttlet &rhs) {
+                ttlet lhs_center = center(lhs.rectangle);
+                ttlet rhs_center = center(rhs.rectangle);
+                return split_on_x ? lhs_center.x() < rhs_center.x() : lhs_center.y() < rhs_center.y();
+            });
+
+        build_node(first, middle);
+        ttlet right_index = build_node(middle, last);
+
+        _nodes[node_index] = node_type{rectangle, right_index, 0};
+        return node_index;
+    }
+};
+
+} // namespace tt
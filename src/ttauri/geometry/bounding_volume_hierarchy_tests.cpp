@@ -0,0 +1,75 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/geometry/bounding_volume_hierarchy.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+using namespace tt;
+
+namespace {
+
+[[nodiscard]] std::vector<int> find_all(bounding_volume_hierarchy<int> const &bvh, point2 position)
+{
+    auto r = std::vector<int>{};
+    bvh.find(position, [&r](int value) {
+        r.push_back(value);
+    });
+    std::sort(r.begin(), r.end());
+    return r;
+}
+
+} // namespace
+
+TEST(bounding_volume_hierarchy, empty)
+{
+    auto bvh = bounding_volume_hierarchy<int>{};
+    ASSERT_TRUE(bvh.empty());
+    ASSERT_EQ(find_all(bvh, point2{0.0f, 0.0f}), std::vector<int>{});
+}
+
+TEST(bounding_volume_hierarchy, grid)
+{
+    // A grid of 100 x 100 cells of 10 x 10 pixels.
+    auto items = std::vector<bounding_volume_hierarchy<int>::item_type>{};
+    for (int y = 0; y != 100; ++y) {
+        for (int x = 0; x != 100; ++x) {
+            items.push_back({aarectangle{x * 10.0f, y * 10.0f, 10.0f, 10.0f}, y * 100 + x});
+        }
+    }
+    auto bvh = bounding_volume_hierarchy<int>{std::move(items)};
+    ASSERT_EQ(bvh.size(), 10000);
+    ASSERT_EQ(bvh.bounding_rectangle(), (aarectangle{0.0f, 0.0f, 1000.0f, 1000.0f}));
+
+    ASSERT_EQ(find_all(bvh, point2{5.0f, 5.0f}), std::vector<int>{0});
+    ASSERT_EQ(find_all(bvh, point2{995.0f, 5.0f}), std::vector<int>{99});
+    ASSERT_EQ(find_all(bvh, point2{455.0f, 725.0f}), std::vector<int>{7245});
+
+    // Left and bottom edges are inclusive, right and top edges exclusive.
+    ASSERT_EQ(find_all(bvh, point2{10.0f, 10.0f}), std::vector<int>{101});
+    ASSERT_EQ(find_all(bvh, point2{1000.0f, 5.0f}), std::vector<int>{});
+    ASSERT_EQ(find_all(bvh, point2{-1.0f, 5.0f}), std::vector<int>{});
+}
+
+TEST(bounding_volume_hierarchy, overlapping)
+{
+    auto items = std::vector<bounding_volume_hierarchy<int>::item_type>{};
+    for (int i = 0; i != 20; ++i) {
+        items.push_back({aarectangle{i * 5.0f, 0.0f, 10.0f, 10.0f}, i});
+    }
+    // A large rectangle, for example an overlay, on top of the rest.
+    items.push_back({aarectangle{0.0f, 0.0f, 200.0f, 200.0f}, 100});
+    // Empty rectangles are never found.
+    items.push_back({aarectangle{}, 200});
+
+    auto bvh = bounding_volume_hierarchy<int>{std::move(items)};
+
+    ASSERT_EQ(find_all(bvh, point2{0.0f, 0.0f}), (std::vector<int>{0, 100}));
+    ASSERT_EQ(find_all(bvh, point2{12.0f, 5.0f}), (std::vector<int>{1, 2, 100}));
+    ASSERT_EQ(find_all(bvh, point2{150.0f, 150.0f}), (std::vector<int>{100}));
+
+    bvh.clear();
+    ASSERT_EQ(find_all(bvh, point2{12.0f, 5.0f}), std::vector<int>{});
+}
@@ -0,0 +1,57 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "l10n.hpp"
+#include "unfair_mutex.hpp"
+#include <unordered_map>
+#include <mutex>
+
+namespace tt {
+
+/** The number of messages in the cache after which the cache is cleared.
+ * This limits the memory used by messages with arguments that change often, such as counters.
+ */
+constexpr size_t l10n_cache_capacity = 4096;
+
+static unfair_mutex l10n_cache_mutex;
+static std::unordered_map<l10n, std::shared_ptr<std::string const>> l10n_cache;
+static size_t l10n_cache_generation = 0;
+
+[[nodiscard]] std::shared_ptr<std::string const> l10n::shared() const noexcept
+{
+    // Read the generation before translating, so that a change of the translations
+    // during translation will invalidate the result on the next call.
+    ttlet generation = language::generation();
+
+    {
+        ttlet lock = std::scoped_lock(l10n_cache_mutex);
+        if (l10n_cache_generation < generation) {
+            l10n_cache.clear();
+            l10n_cache_generation = generation;
+
+        } else if (l10n_cache_generation == generation) {
+            if (ttlet i = l10n_cache.find(*this); i != l10n_cache.end()) {
+                return i->second;
+            }
+        }
+    }
+
+    // Translate and format without holding the lock.
+    auto r = std::make_shared<std::string const>((*this)());
+
+    ttlet lock = std::scoped_lock(l10n_cache_mutex);
+    if (l10n_cache_generation != generation) {
+        return r;
+    }
+
+    if (l10n_cache.size() >= l10n_cache_capacity) {
+        l10n_cache.clear();
+    }
+
+    // Another thread may have added the same message in the mean time, share its string.
+    ttlet [i, inserted] = l10n_cache.try_emplace(*this, std::move(r));
+    return i->second;
+}
+
+} // namespace tt
@@ -8,6 +8,7 @@
 #include "text/translation.hpp"
 #include "forward_value.hpp"
 #include "cast.hpp"
+#include "hash.hpp"
 #include <memory>
 #include <string>
 #include <string_view>
@@ -41,6 +42,11 @@ public:
 
     [[nodiscard]] virtual bool equal_to(l10n_args_base const &rhs) const noexcept = 0;
 
+    /** The hash of the arguments.
+     * Arguments that can not be hashed are skipped, they are still compared by `equal_to()`.
+     */
+    [[nodiscard]] virtual size_t hash() const noexcept = 0;
+
     [[nodiscard]] bool friend operator==(l10n_args_base const &lhs, l10n_args_base const &rhs) noexcept
     {
         return lhs.equal_to(rhs);
@@ -119,6 +125,26 @@ public:
         return n_recurse<0>();
     }
 
+    template<size_t I>
+    [[nodiscard]] size_t hash_recurse() const noexcept
+    {
+        if constexpr (I < sizeof...(Values)) {
+            using value_type = std::tuple_element_t<I, std::tuple<Values...>>;
+            if constexpr (std::is_default_constructible_v<std::hash<value_type>>) {
+                return hash_mix_two(std::hash<value_type>{}(std::get<I>(_values)), hash_recurse<I + 1>());
+            } else {
+                return hash_recurse<I + 1>();
+            }
+        } else {
+            return 0;
+        }
+    }
+
+    [[nodiscard]] size_t hash() const noexcept override
+    {
+        return hash_recurse<0>();
+    }
+
 private:
     std::tuple<Values...> _values;
 
@@ -225,6 +251,23 @@ public:
         }
     }
 
+    /** Translate and format the message using the preferred languages.
+     *
+     * The result is memoized, so that the message is translated and formatted only once
+     * for each generation of the translations, see `language::generation()`. Widgets that
+     * display the same message share the same string, which may be compared by pointer
+     * to check if the text has changed.
+     *
+     * @return The translated and formatted message.
+     */
+    [[nodiscard]] std::shared_ptr<std::string const> shared() const noexcept;
+
+    [[nodiscard]] size_t hash() const noexcept
+    {
+        ttlet msg_id_hash = std::hash<std::string>{}(_msg_id);
+        return _args ? hash_mix_two(msg_id_hash, _args->hash()) : msg_id_hash;
+    }
+
     /** Compare two localizable messages.
      *
      * @param lhs A localizable message.
@@ -248,3 +291,16 @@ private:
 };
 
 } // namespace tt
+
+namespace std {
+
+template<>
+class hash<tt::l10n> {
+public:
+    [[nodiscard]] size_t operator()(tt::l10n const &rhs) const noexcept
+    {
+        return rhs.hash();
+    }
+};
+
+} // namespace std
@@ -0,0 +1,100 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/l10n.hpp"
+#include "ttauri/text/language.hpp"
+#include "ttauri/text/translation.hpp"
+#include <gtest/gtest.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace tt;
+
+namespace {
+
+/** Use a language for the duration of a test, and restore the preferred languages afterwards.
+ */
+struct preferred_language_guard {
+    std::vector<language_tag> previous_tags;
+
+    preferred_language_guard(language_tag const &tag) noexcept
+    {
+        for (ttlet language : language::preferred_languages()) {
+            previous_tags.push_back(language->tag);
+        }
+        language::set_preferred_languages({tag});
+    }
+
+    ~preferred_language_guard()
+    {
+        language::set_preferred_languages(previous_tags);
+    }
+};
+
+} // namespace
+
+TEST(l10n, equality_and_hash)
+{
+    ttlet hello = l10n("hello");
+    ttlet count1 = l10n("count {}", 1);
+
+    ASSERT_EQ(hello, l10n("hello"));
+    ASSERT_EQ(hello.hash(), l10n("hello").hash());
+    ASSERT_EQ(std::hash<l10n>{}(hello), hello.hash());
+    ASSERT_NE(hello, l10n("goodbye"));
+
+    ASSERT_EQ(count1, l10n("count {}", 1));
+    ASSERT_EQ(count1.hash(), l10n("count {}", 1).hash());
+    ASSERT_NE(count1, l10n("count {}", 2));
+    ASSERT_NE(count1, l10n("total {}", 1));
+
+    // Arguments of a different type, or a different number of arguments, are not equal.
+    ASSERT_NE(count1, l10n("count {}", 1.0));
+    ASSERT_NE(count1, l10n("count {}"));
+    ASSERT_NE(l10n("count {}"), count1);
+
+    // A copy has its own arguments, which compare equal.
+    ttlet copy = count1;
+    ASSERT_EQ(copy, count1);
+    ASSERT_EQ(copy.hash(), count1.hash());
+}
+
+TEST(l10n, shared)
+{
+    ttlet tag = language_tag("x-l10n-shared-test");
+    auto &language = language::find_or_create(tag);
+    ttlet guard = preferred_language_guard(tag);
+
+    ttlet message = l10n("shared message {}", 5);
+
+    // The same message is translated and formatted once, and shared by its users.
+    ttlet first = message.shared();
+    ASSERT_EQ(*first, "shared message 5");
+    ASSERT_EQ(message.shared(), first);
+    ASSERT_EQ(l10n("shared message {}", 5).shared(), first);
+    ASSERT_NE(l10n("shared message {}", 6).shared(), first);
+
+    // Adding a translation changes the generation, which recomputes the message.
+    add_translation("shared message {}", language, {"gedeeld bericht {}"});
+    ttlet translated = message.shared();
+    ASSERT_NE(translated, first);
+    ASSERT_EQ(*translated, "gedeeld bericht 5");
+    ASSERT_EQ(message.shared(), translated);
+
+    // Invalidating the generation recomputes the message even when the text is the same.
+    language::increment_generation();
+    ttlet recomputed = message.shared();
+    ASSERT_NE(recomputed, translated);
+    ASSERT_EQ(*recomputed, *translated);
+
+    // A change of the preferred languages recomputes the message.
+    {
+        ttlet other_guard = preferred_language_guard(language_tag("x-l10n-other-test"));
+        ttlet untranslated = message.shared();
+        ASSERT_NE(untranslated, recomputed);
+        ASSERT_EQ(*untranslated, "shared message 5");
+    }
+    ASSERT_EQ(*message.shared(), "gedeeld bericht 5");
+}
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "../required.hpp"
+#include "../architecture.hpp"
 #include <array>
 #include <smmintrin.h>
 #include <xmmintrin.h>
@@ -12,6 +14,21 @@
 
 namespace tt {
 
+/** Transpose the 4x4 matrices in the low and high 128 bit lanes of four AVX registers.
+ * Both lanes are transposed independently, no data crosses between the lanes.
+ */
+tt_target("avx2") inline void f32x8_x64v25_transpose_lanes(__m256 &r0, __m256 &r1, __m256 &r2, __m256 &r3) noexcept
+{
+    ttlet t0 = _mm256_unpacklo_ps(r0, r1);
+    ttlet t1 = _mm256_unpackhi_ps(r0, r1);
+    ttlet t2 = _mm256_unpacklo_ps(r2, r3);
+    ttlet t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t2, 0b01'00'01'00);
+    r1 = _mm256_shuffle_ps(t0, t2, 0b11'10'11'10);
+    r2 = _mm256_shuffle_ps(t1, t3, 0b01'00'01'00);
+    r3 = _mm256_shuffle_ps(t1, t3, 0b11'10'11'10);
+}
+
 //inline float hadd(__m256 x)
 //{
 //    return _mm256_cvtss_f32(_mm256_hadd_ps(sum_v));
@@ -468,6 +468,15 @@ public:
      */
     [[nodiscard]] static constexpr numeric_array load(T const *ptr) noexcept
     {
+        if (!std::is_constant_evaluated()) {
+            // Load directly into a register; a std::memcpy() may be split into smaller loads through the stack.
+            if constexpr (x86_64_v2_5 and is_f32x8) {
+                return numeric_array{_mm256_loadu_ps(ptr)};
+            } else if constexpr (x86_64_v2 and is_f32x4) {
+                return numeric_array{_mm_loadu_ps(ptr)};
+            }
+        }
+
         auto r = numeric_array{};
         std::memcpy(&r, ptr, sizeof(r));
         return r;
@@ -6,6 +6,7 @@
 
 #include "skeleton_node.hpp"
 #include "skeleton_parse_context.hpp"
+#include "skeleton_cache.hpp"
 #include "../resource_view.hpp"
 
 namespace tt {
@@ -31,4 +32,12 @@ namespace tt {
     return parse_skeleton(std::move(url), sv.cbegin(), sv.cend());
 }
 
+/** Parse a template through the process-wide `skeleton_cache`.
+ * @see skeleton_cache::get()
+ */
+[[nodiscard]] inline std::shared_ptr<skeleton_node> parse_skeleton_cached(URL const &url)
+{
+    return skeleton_cache::global().get(url);
+}
+
 }
@@ -12,6 +12,10 @@ struct skeleton_block_node final: skeleton_node {
     std::string name;
     statement_vector children;
 
+    /** The names of the local variables.
+     */
+    std::vector<std::string> local_names;
+
     formula_post_process_context::function_type function;
     formula_post_process_context::function_type super_function;
 
@@ -42,10 +46,14 @@ struct skeleton_block_node final: skeleton_node {
         function = context.get_function(name);
         tt_assert(function);
 
+        local_names.clear();
+
         context.push_super(super_function);
+        context.push_local_scope(local_names);
         for (ttlet &child: children) {
             child->post_process(context);
         }
+        context.pop_local_scope();
         context.pop_super();
     }
 
@@ -73,7 +81,7 @@ struct skeleton_block_node final: skeleton_node {
     }
 
     datum evaluate_call(formula_evaluation_context &context, datum::vector const &arguments) {
-        context.push();
+        context.push(&local_names);
         auto tmp = evaluate_children(context, children);
         context.pop();
 
@@ -0,0 +1,61 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "skeleton_cache.hpp"
+#include "skeleton.hpp"
+#include <mutex>
+#include <algorithm>
+
+namespace tt {
+
+skeleton_cache::~skeleton_cache() = default;
+
+[[nodiscard]] std::shared_ptr<skeleton_node> skeleton_cache::get(URL const &url)
+{
+    auto entry = std::shared_ptr<entry_type const>{};
+    {
+        ttlet lock = std::scoped_lock(_mutex);
+        if (ttlet i = _entries.find(url); i != _entries.end()) {
+            entry = i->second;
+        }
+    }
+
+    // Files are checked and parsed without holding the lock, so that other templates
+    // can be retrieved in the mean time.
+    if (entry and std::all_of(entry->files.begin(), entry->files.end(), [](ttlet &file) {
+            return file.is_current();
+        })) {
+        return entry->node;
+    }
+
+    // The identity of each file is taken from the same text that is parsed, and the modification
+    // time from before it was read, so that a file modified during parsing is detected on the next call.
+    ttlet modification_time = skeleton_file_identity::get_modification_time(url);
+    ttlet view = url.loadView();
+    ttlet text = view->string_view();
+    auto context = skeleton_parse_context(url, text.cbegin(), text.cend());
+    context.files.emplace_back(url, text, modification_time);
+
+    auto new_entry = std::make_shared<entry_type>();
+    new_entry->node = parse_skeleton(context);
+    new_entry->files = std::move(context.files);
+
+    ttlet lock = std::scoped_lock(_mutex);
+    _entries[url] = new_entry;
+    return new_entry->node;
+}
+
+void skeleton_cache::invalidate(URL const &url) noexcept
+{
+    ttlet lock = std::scoped_lock(_mutex);
+    _entries.erase(url);
+}
+
+void skeleton_cache::clear() noexcept
+{
+    ttlet lock = std::scoped_lock(_mutex);
+    _entries.clear();
+}
+
+} // namespace tt
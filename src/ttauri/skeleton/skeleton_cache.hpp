@@ -0,0 +1,71 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "../URL.hpp"
+#include "../unfair_mutex.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace tt {
+
+struct skeleton_node;
+struct skeleton_file_identity;
+
+/** A cache of parsed templates.
+ *
+ * A template is parsed again when the content of its file, or the content of
+ * one of the files it includes, has changed.
+ *
+ * A parsed template is shared and not modified during evaluation. It may be
+ * evaluated from multiple threads at the same time, as long as each thread
+ * uses its own `formula_evaluation_context`.
+ */
+class skeleton_cache {
+public:
+    skeleton_cache() noexcept = default;
+    ~skeleton_cache();
+    skeleton_cache(skeleton_cache const &) = delete;
+    skeleton_cache(skeleton_cache &&) = delete;
+    skeleton_cache &operator=(skeleton_cache const &) = delete;
+    skeleton_cache &operator=(skeleton_cache &&) = delete;
+
+    /** Get a parsed template.
+     *
+     * @param url The location of the template.
+     * @return The parsed template, shared with other users of the cache.
+     * @throw io_error, url_error, parse_error
+     */
+    [[nodiscard]] std::shared_ptr<skeleton_node> get(URL const &url);
+
+    /** Remove a template from the cache.
+     * Users that already got the template keep their copy.
+     */
+    void invalidate(URL const &url) noexcept;
+
+    /** Remove all templates from the cache.
+     */
+    void clear() noexcept;
+
+    /** The process-wide cache used by `parse_skeleton_cached()`.
+     */
+    [[nodiscard]] static skeleton_cache &global() noexcept
+    {
+        static auto r = skeleton_cache{};
+        return r;
+    }
+
+private:
+    struct entry_type {
+        std::shared_ptr<skeleton_node> node;
+        std::vector<skeleton_file_identity> files;
+    };
+
+    mutable unfair_mutex _mutex;
+    std::unordered_map<URL, std::shared_ptr<entry_type const>> _entries;
+};
+
+} // namespace tt
@@ -43,7 +43,7 @@ struct skeleton_do_node final: skeleton_node {
             children.back()->left_align();
         }
 
-        post_process_expression(context, *expression, location);
+        post_process_expression(context, expression, location);
 
         for (ttlet &child: children) {
             child->post_process(context);
@@ -51,8 +51,6 @@ struct skeleton_do_node final: skeleton_node {
     }
 
     datum evaluate(formula_evaluation_context &context) override {
-        ttlet output_size = context.output_size();
-
         ssize_t loop_count = 0;
         do {
             context.loop_push(loop_count++);
@@ -64,7 +62,6 @@ struct skeleton_do_node final: skeleton_node {
             } else if (tmp.is_continue()) {
                 continue;
             } else if (!tmp.is_undefined()) {
-                context.set_output_size(output_size);
                 return tmp;
             }
 
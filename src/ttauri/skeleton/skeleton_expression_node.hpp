@@ -15,7 +15,7 @@ struct skeleton_expression_node final: skeleton_node {
         skeleton_node(std::move(location)), expression(std::move(expression)) {}
 
     void post_process(formula_post_process_context &context) override {
-        post_process_expression(context, *expression, location);
+        post_process_expression(context, expression, location);
     }
 
     std::string string() const noexcept override {
@@ -46,8 +46,8 @@ struct skeleton_for_node final: skeleton_node {
             else_children.back()->left_align();
         }
 
-        post_process_expression(context, *name_expression, location);
-        post_process_expression(context, *list_expression, location);
+        post_process_expression(context, name_expression, location);
+        post_process_expression(context, list_expression, location);
 
         for (ttlet &child: children) {
             child->post_process(context);
@@ -64,7 +64,6 @@ struct skeleton_for_node final: skeleton_node {
             throw operation_error("{}: Expecting expression returns a vector, got {}", location, list_data);
         }
 
-        ttlet output_size = context.output_size();
         if (list_data.size() > 0) {
             ttlet loop_size = std::ssize(list_data);
             ssize_t loop_count = 0;
@@ -86,7 +85,6 @@ struct skeleton_for_node final: skeleton_node {
                 } else if (tmp.is_continue()) {
                     continue;
                 } else if (!tmp.is_undefined()) {
-                    context.set_output_size(output_size);
                     return tmp;
                 }
             }
@@ -96,7 +94,6 @@ struct skeleton_for_node final: skeleton_node {
             if (tmp.is_break() || tmp.is_continue()) {
                 return tmp;
             } else if (!tmp.is_undefined()) {
-                context.set_output_size(output_size);
                 return tmp;
             }
         }
@@ -13,6 +13,14 @@ struct skeleton_function_node final: skeleton_node {
     std::vector<std::string> argument_names;
     statement_vector children;
 
+    /** The names of the local variables, starting with the arguments.
+     */
+    std::vector<std::string> local_names;
+
+    /** The function contains a #return statement.
+     */
+    bool has_return = false;
+
     formula_post_process_context::function_type super_function;
 
     skeleton_function_node(parse_location location, formula_post_process_context &context, std::unique_ptr<formula_node> function_declaration_expression) noexcept :
@@ -49,11 +57,18 @@ struct skeleton_function_node final: skeleton_node {
             children.back()->left_align();
         }
 
+        local_names = argument_names;
+        ttlet return_count = context.return_count;
+
         context.push_super(super_function);
+        context.push_local_scope(local_names);
         for (ttlet &child: children) {
             child->post_process(context);
         }
+        context.pop_local_scope();
         context.pop_super();
+
+        has_return = context.return_count != return_count;
     }
 
     datum evaluate(formula_evaluation_context &context) override {
@@ -61,19 +76,25 @@ struct skeleton_function_node final: skeleton_node {
     }
 
     datum evaluate_call(formula_evaluation_context &context, datum::vector const &arguments) {
-        context.push();
         if (std::ssize(argument_names) != std::ssize(arguments)) {
             throw operation_error("{}: Invalid number of arguments to function {}() expecting {} got {}.", location, name, argument_names.size(), arguments.size());
         }
 
+        context.push(&local_names);
         for (ssize_t i = 0; i != std::ssize(argument_names); ++i) {
-            context.set(argument_names[i], arguments[i]);
+            context.set_local(argument_names[i], arguments[i]);
         }
 
-        ttlet output_size = context.output_size();
+        // Only a function that can return needs to be able to discard its output.
+        ttlet output_mark = has_return ? context.output_mark() : 0;
         auto tmp = evaluate_children(context, children);
         context.pop();
 
+        if (has_return) {
+            // When a function returns, it should not have written data to the output.
+            context.output_release(output_mark, not tmp.is_undefined());
+        }
+
         if (tmp.is_break()) {
             throw operation_error("{}: Found #break not inside a loop statement.", location);
 
@@ -84,8 +105,6 @@ struct skeleton_function_node final: skeleton_node {
             return {};
 
         } else {
-            // When a function returns, it should not have written data to the output.
-            context.set_output_size(output_size);
             return tmp;
         }
     }
@@ -51,7 +51,7 @@ struct skeleton_if_node final: skeleton_node {
     void post_process(formula_post_process_context &context) override {
         tt_assert(std::ssize(expressions) == std::ssize(formula_locations));
         for (ssize_t i = 0; i != std::ssize(expressions); ++i) {
-            post_process_expression(context, *expressions[i], formula_locations[i]);
+            post_process_expression(context, expressions[i], formula_locations[i]);
         }
 
         for (ttlet &children: children_groups) {
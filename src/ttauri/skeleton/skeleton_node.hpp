@@ -54,19 +54,21 @@ struct skeleton_node {
     }
 
     [[nodiscard]] std::string evaluate_output(formula_evaluation_context &context) {
-        auto tmp = evaluate(context);
-        if (tmp.is_break()) {
-            throw operation_error("{}: Found #break not inside a loop statement.", location);
-
-        } else if (tmp.is_continue()) {
-            throw operation_error("{}: Found #continue not inside a loop statement.", location);
-
-        } else if (tmp.is_undefined()) {
-            return std::move(context.output);
+        evaluate_top(context);
+        return std::move(context.output);
+    }
 
-        } else {
-            throw operation_error("{}: Found #return not inside a function.", location);
-        }
+    /** Evaluate the template and write the text to a sink.
+    * The text is written to the sink in chunks of `formula_evaluation_context::output_chunk_size`,
+    * except for the text written by a function which may still be discarded by a \#return statement.
+    *
+    * @param context Data used by expressions inside the template statements.
+    * @param sink The destination of the text.
+    */
+    void evaluate_output(formula_evaluation_context &context, formula_output_sink &sink) {
+        ttlet sink_scope = formula_evaluation_context::output_sink_scope(context, sink);
+        evaluate_top(context);
+        context.flush_output();
     }
 
     [[nodiscard]] std::string evaluate_output() {
@@ -111,9 +113,12 @@ struct skeleton_node {
         }
     }
 
-    static void post_process_expression(formula_post_process_context &context, formula_node &expression, parse_location const &location) {
+    /** Post process an expression and compile it to bytecode.
+    */
+    static void post_process_expression(formula_post_process_context &context, std::unique_ptr<formula_node> &expression, parse_location const &location) {
         try {
-            return expression.post_process(context);
+            expression->post_process(context);
+            expression = compile_formula(std::move(expression));
 
         } catch (std::exception const &e) {
             throw operation_error("{}: Could not post-process expression.\n{}", location, e.what());
@@ -129,6 +134,22 @@ struct skeleton_node {
         }
         return {};
     }
+
+private:
+    void evaluate_top(formula_evaluation_context &context) {
+        ttlet arena_scope = datum_arena_scope{context.allocation};
+
+        auto tmp = evaluate(context);
+        if (tmp.is_break()) {
+            throw operation_error("{}: Found #break not inside a loop statement.", location);
+
+        } else if (tmp.is_continue()) {
+            throw operation_error("{}: Found #continue not inside a loop statement.", location);
+
+        } else if (!tmp.is_undefined()) {
+            throw operation_error("{}: Found #return not inside a function.", location);
+        }
+    }
 };
 
 }
@@ -8,9 +8,58 @@
 #include "skeleton_do_node.hpp"
 #include "skeleton_string_node.hpp"
 #include "skeleton.hpp"
+#include "../codec/SHA2.hpp"
+#include <chrono>
+#include <system_error>
 
 namespace tt {
 
+/** The largest resolution of the modification time of common file systems; FAT has two seconds.
+ * A file that is modified within this time of the previous modification may keep its time stamp.
+ */
+constexpr auto skeleton_modification_time_resolution = std::chrono::seconds(2);
+
+skeleton_file_identity::skeleton_file_identity(URL url, std::string_view text, std::optional<time_type> modification_time) :
+    url(std::move(url)), size(text.size()), modification_time(modification_time), digest(SHA256{}.add(text).get_bytes())
+{
+    if (modification_time and *modification_time + skeleton_modification_time_resolution > time_type::clock::now()) {
+        this->modification_time = {};
+    }
+}
+
+[[nodiscard]] bool skeleton_file_identity::is_current() const noexcept
+{
+    try {
+        if (modification_time) {
+            if (ttlet current_time = get_modification_time(url); current_time == modification_time) {
+                return std::filesystem::file_size(url.nativeWPath()) == size;
+            }
+        }
+
+        ttlet view = url.loadView();
+        ttlet text = view->string_view();
+        return text.size() == size and SHA256{}.add(text).get_bytes() == digest;
+
+    } catch (...) {
+        return false;
+    }
+}
+
+[[nodiscard]] std::optional<skeleton_file_identity::time_type>
+skeleton_file_identity::get_modification_time(URL const &url) noexcept
+{
+    if (not url.isFileScheme()) {
+        return {};
+    }
+
+    auto error = std::error_code{};
+    ttlet r = std::filesystem::last_write_time(url.nativeWPath(), error);
+    if (error) {
+        return {};
+    }
+    return r;
+}
+
 [[nodiscard]] bool skeleton_parse_context::append(std::unique_ptr<skeleton_node> x) noexcept
 {
     return statement_stack.back()->append(std::move(x));
@@ -126,8 +175,19 @@ void skeleton_parse_context::include(parse_location _location, std::unique_ptr<f
 
     ttlet new_skeleton_path = current_skeleton_directory.urlByAppendingPath(static_cast<std::string>(argument));
 
+    ttlet modification_time = skeleton_file_identity::get_modification_time(new_skeleton_path);
+    ttlet view = new_skeleton_path.loadView();
+    ttlet text = view->string_view();
+    auto include_context = skeleton_parse_context(new_skeleton_path, text.cbegin(), text.cend());
+    include_context.files.emplace_back(new_skeleton_path, text, modification_time);
+    auto include_node = parse_skeleton(include_context);
+
+    for (auto &file: include_context.files) {
+        files.push_back(std::move(file));
+    }
+
     if (std::ssize(statement_stack) > 0) {
-        if (!statement_stack.back()->append(parse_skeleton(new_skeleton_path))) {
+        if (!statement_stack.back()->append(std::move(include_node))) {
             throw parse_error("{}: Unexpected #include statement.", location);
         }
     } else {
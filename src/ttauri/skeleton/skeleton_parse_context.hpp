@@ -7,14 +7,59 @@
 #include "../formula/formula.hpp"
 #include "../strings.hpp"
 #include "../algorithm.hpp"
+#include "../URL.hpp"
+#include "../byte_string.hpp"
 #include <memory>
 #include <string_view>
 #include <optional>
+#include <vector>
+#include <filesystem>
 
 namespace tt {
 
 struct skeleton_node;
 
+/** The identity of a file that was read while parsing a template.
+ * Used to detect if a parsed template is out of date.
+ */
+struct skeleton_file_identity {
+    using time_type = std::filesystem::file_time_type;
+
+    URL url;
+    size_t size;
+
+    /** The modification time of the file, taken before it was read.
+     * Empty when the file has no modification time, or when it was modified so recently
+     * that a modification within the resolution of the file system's time stamps could
+     * be missed. In both cases the content of the file is always compared.
+     */
+    std::optional<time_type> modification_time;
+
+    /** The SHA-256 of the content of the file.
+     */
+    bstring digest;
+
+    /** Create the identity of a file.
+     *
+     * @param url The location of the file.
+     * @param text The content of the file as it was parsed.
+     * @param modification_time The result of `get_modification_time(url)` from before the file was read.
+     */
+    skeleton_file_identity(URL url, std::string_view text, std::optional<time_type> modification_time);
+
+    /** Check if the file still has the same content.
+     * When the size and modification time are unchanged the file is not read;
+     * otherwise the content is compared. A file which can no longer be read is not current.
+     */
+    [[nodiscard]] bool is_current() const noexcept;
+
+    /** Get the modification time of a file.
+     *
+     * @return The modification time, or empty when the url is not a file or the file can not be found.
+     */
+    [[nodiscard]] static std::optional<time_type> get_modification_time(URL const &url) noexcept;
+};
+
 struct skeleton_parse_context {
     using statement_stack_type = std::vector<std::unique_ptr<skeleton_node>>;
     using const_iterator = typename std::string_view::const_iterator;
@@ -32,6 +77,10 @@ struct skeleton_parse_context {
     */
     formula_post_process_context post_process_context;
 
+    /** The files that were read while parsing, including the template itself when it was loaded from a file.
+     */
+    std::vector<skeleton_file_identity> files;
+
     skeleton_parse_context() = delete;
     skeleton_parse_context(skeleton_parse_context const &other) = delete;
     skeleton_parse_context &operator=(skeleton_parse_context const &other) = delete;
@@ -25,6 +25,7 @@ struct skeleton_placeholder_node final : skeleton_node {
     {
         try {
             expression->post_process(context);
+            expression = compile_formula(std::move(expression));
 
         } catch (std::exception const &e) {
             throw operation_error("{}: Could not post process placeholder.\n{}", location, e.what());
@@ -38,9 +39,13 @@ struct skeleton_placeholder_node final : skeleton_node {
 
     datum evaluate(formula_evaluation_context &context) override
     {
-        ttlet output_size = context.output_size();
-
+        ttlet output_mark = context.output_mark();
         ttlet tmp = evaluate_expression(context, *expression, location);
+
+        // Functions called by the expression should not have written data to the output
+        // when the value of the expression is written.
+        context.output_release(output_mark, not tmp.is_undefined());
+
         if (tmp.is_break()) {
             throw operation_error("{}: Found #break not inside a loop statement.", location);
 
@@ -51,8 +56,6 @@ struct skeleton_placeholder_node final : skeleton_node {
             return {};
 
         } else {
-            // When a function returns, it should not have written data to the output.
-            context.set_output_size(output_size);
             context.write(static_cast<std::string>(tmp));
             return {};
         }
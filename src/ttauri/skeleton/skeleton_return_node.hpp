@@ -15,7 +15,8 @@ struct skeleton_return_node final: skeleton_node {
         skeleton_node(std::move(location)), expression(std::move(expression)) {}
 
     void post_process(formula_post_process_context &context) override {
-        post_process_expression(context, *expression, location);
+        ++context.return_count;
+        post_process_expression(context, expression, location);
     }
 
     datum evaluate(formula_evaluation_context &context) override {
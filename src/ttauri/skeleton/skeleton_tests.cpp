@@ -3,9 +3,16 @@
 // (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include "ttauri/skeleton/skeleton.hpp"
+#include "ttauri/file.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <array>
+#include <type_traits>
+#include <filesystem>
+#include <chrono>
+#include <system_error>
 
 using namespace std;
 using namespace tt;
@@ -412,6 +419,120 @@ TEST(skeleton, FunctionReturn) {
     );
 }
 
+TEST(skeleton, FunctionLocalVariables) {
+    std::unique_ptr<skeleton_node> t;
+    std::string result;
+
+    ASSERT_NO_THROW(t = parse_skeleton(URL("none:"),
+        "#total = 100\n"
+        "#offset = 1\n"
+        "#function sum(list)\n"
+        "#total = 0\n"
+        "#for x: list\n"
+        "#total = total + x\n"
+        "#end\n"
+        "#return total + offset\n"
+        "#end\n"
+        "${sum([1, 2, 3])} ${total}\n"
+        "#for x: [4, 5]\n"
+        "${$i}/${$size} ${sum([x])}\n"
+        "#end\n"
+    ));
+
+    ASSERT_NO_THROW(result = t->evaluate_output());
+    ASSERT_EQ(result,
+        "7 100\n"
+        "0/2 5\n"
+        "1/2 6\n"
+    );
+}
+
+TEST(skeleton, OutputSink) {
+    struct chunk_sink final : formula_output_sink {
+        std::string text;
+        size_t nr_chunks = 0;
+        size_t max_chunk_size = 0;
+
+        void write(std::string_view chunk) override {
+            text += chunk;
+            ++nr_chunks;
+            max_chunk_size = std::max(max_chunk_size, chunk.size());
+        }
+    };
+
+    std::unique_ptr<skeleton_node> t;
+    ASSERT_NO_THROW(t = parse_skeleton(URL("none:"),
+        "#function twice(x)\n"
+        "ignored\n"
+        "#return x * 2\n"
+        "#end\n"
+        "#for x: items\n"
+        "line ${x} is ${twice(x)}\n"
+        "#end\n"
+    ));
+
+    datum::vector items;
+    for (auto i = 0; i != 100'000; ++i) {
+        items.emplace_back(i);
+    }
+
+    // A large document is written in bounded chunks.
+    chunk_sink sink;
+    formula_evaluation_context context;
+    context.set_global("items", items);
+    ASSERT_NO_THROW(t->evaluate_output(context, sink));
+    ASSERT_GT(sink.text.size(), 1'000'000);
+    ASSERT_GT(sink.nr_chunks, 1);
+    ASSERT_LT(sink.max_chunk_size, formula_evaluation_context::output_chunk_size + 64);
+    ASSERT_EQ(context.output.size(), 0);
+
+    formula_evaluation_context string_context;
+    string_context.set_global("items", items);
+    std::string result;
+    ASSERT_NO_THROW(result = t->evaluate_output(string_context));
+    ASSERT_EQ(sink.text, result);
+    ASSERT_EQ(result.substr(0, 24), "line 0 is 0\nline 1 is 2\n");
+
+    // An exception inside a function restores the sink and releases the output marks.
+    ASSERT_NO_THROW(t = parse_skeleton(URL("none:"),
+        "#function fail(x)\n"
+        "#return x + missing\n"
+        "#end\n"
+        "${fail(1)}\n"
+    ));
+
+    formula_evaluation_context failing_context;
+    ASSERT_THROW(t->evaluate_output(failing_context, sink), operation_error);
+    ASSERT_EQ(failing_context.output_sink, nullptr);
+    ASSERT_EQ(failing_context.output_mark_count, 0);
+}
+
+TEST(skeleton, Arena) {
+    std::unique_ptr<skeleton_node> t;
+    ASSERT_NO_THROW(t = parse_skeleton(URL("none:"),
+        "#for x: [1, 2, 3]\n"
+        "item ${x}\n"
+        "#end\n"
+    ));
+
+    // The context does not own an arena, so it can be moved and used on another thread.
+    static_assert(std::is_move_constructible_v<formula_evaluation_context>);
+    auto context = formula_evaluation_context{datum_allocation::arena};
+    auto moved_context = std::move(context);
+
+    std::string result;
+    auto thread = std::thread([&] {
+        result = t->evaluate_output(moved_context);
+    });
+    thread.join();
+    ASSERT_EQ(result, "item 1\nitem 2\nitem 3\n");
+
+    // The arena is only active during the evaluation.
+    ASSERT_EQ(datum_arena::current(), nullptr);
+    ASSERT_EQ(t->evaluate_output(moved_context), "item 1\nitem 2\nitem 3\n");
+    ASSERT_EQ(datum_arena::current(), nullptr);
+}
+
 TEST(skeleton, Block) {
     std::unique_ptr<skeleton_node> t;
 
@@ -447,3 +568,77 @@ TEST(skeleton, Include) {
         ">"
     );
 }
+
+TEST(skeleton, Cache) {
+    ttlet path = std::filesystem::temp_directory_path() / "skeleton_cache_test.ttt";
+    ttlet url = URL::urlFromWPath(path.wstring());
+    ttlet write_file = [&url](std::string_view text) {
+        auto f = file(url, access_mode::truncate_or_create_for_write);
+        f.write(text);
+        f.close();
+    };
+
+    struct remove_file_guard {
+        std::filesystem::path path;
+        ~remove_file_guard()
+        {
+            auto error = std::error_code{};
+            std::filesystem::remove(path, error);
+        }
+    };
+    ttlet remove_file = remove_file_guard{path};
+
+    skeleton_cache cache;
+
+    write_file("value ${a}\n");
+    ttlet t1 = cache.get(url);
+    ASSERT_EQ(cache.get(url), t1);
+
+    // A shared template can be evaluated concurrently with separate contexts.
+    std::array<std::string, 4> results;
+    std::vector<std::thread> threads;
+    for (auto i = 0; i != std::ssize(results); ++i) {
+        threads.emplace_back([&t1, &results, i]() {
+            formula_evaluation_context context;
+            context.set_global("a", i);
+            results[i] = t1->evaluate_output(context);
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (auto i = 0; i != std::ssize(results); ++i) {
+        ASSERT_EQ(results[i], std::format("value {}\n", i));
+    }
+
+    // Changes to the file are detected, also when the size stays the same.
+    write_file("other value ${a}\n");
+    ttlet t2 = cache.get(url);
+    ASSERT_NE(t2, t1);
+    write_file("OTHER VALUE ${a}\n");
+    ttlet t3 = cache.get(url);
+    ASSERT_NE(t3, t2);
+    ASSERT_EQ(cache.get(url), t3);
+
+    formula_evaluation_context context;
+    context.set_global("a", 42);
+    ASSERT_EQ(t3->evaluate_output(context), "OTHER VALUE 42\n");
+
+    cache.invalidate(url);
+    ttlet t4 = cache.get(url);
+    ASSERT_NE(t4, t3);
+
+    // A file with an old modification time is not read when its size and modification time are unchanged.
+    ttlet old_time = std::filesystem::last_write_time(path) - std::chrono::hours(1);
+    std::filesystem::last_write_time(path, old_time);
+    cache.invalidate(url);
+    ttlet t5 = cache.get(url);
+    write_file("other value ${b}\n");
+    std::filesystem::last_write_time(path, old_time);
+    ASSERT_EQ(cache.get(url), t5);
+
+    // A change in size is detected without comparing the content.
+    write_file("other value ${b} \n");
+    std::filesystem::last_write_time(path, old_time);
+    ASSERT_NE(cache.get(url), t5);
+}
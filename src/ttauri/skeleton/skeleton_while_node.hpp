@@ -27,15 +27,13 @@ struct skeleton_while_node final: skeleton_node {
             children.back()->left_align();
         }
 
-        post_process_expression(context, *expression, location);
+        post_process_expression(context, expression, location);
         for (ttlet &child: children) {
             child->post_process(context);
         }
     }
 
     datum evaluate(formula_evaluation_context &context) override {
-        ttlet output_size = context.output_size();
-
         ssize_t loop_count = 0;
         while (evaluate_formula_without_output(context, *expression, location)) {
             context.loop_push(loop_count++);
@@ -46,7 +44,6 @@ struct skeleton_while_node final: skeleton_node {
             } else if (tmp.is_continue()) {
                 continue;
             } else if (!tmp.is_undefined()) {
-                context.set_output_size(output_size);
                 return tmp;
             }
         }
@@ -13,6 +13,8 @@ attributed_glyph::attributed_glyph(attributed_grapheme const &attr_grapheme, att
     logicalIndex(attr_grapheme.logicalIndex),
     graphemeCount(1),
     general_category(attr_grapheme.general_category),
+    line_break(attr_grapheme.line_break),
+    word_break(attr_grapheme.word_break),
     style(attr_grapheme.style)
 {
     // Get the font_id that matches the requested style.
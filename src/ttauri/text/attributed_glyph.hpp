@@ -33,6 +33,14 @@ struct attributed_glyph {
 
     unicode_general_category general_category;
 
+    /** The line-break opportunity after the last grapheme of this glyph.
+     */
+    unicode_break_opportunity line_break;
+
+    /** The word-break opportunity after the last grapheme of this glyph.
+     */
+    unicode_break_opportunity word_break;
+
     /** Copied from the original attributed-grapheme. */
     text_style style;
 
@@ -62,8 +62,8 @@ struct attributed_glyph_line {
                 // Found position where to wrap.
                 break;
 
-            } else if (i->isWhiteSpace()) {
-                // Include the whitespace in the word, as it should belong at the end of the line.
+            } else if (i->line_break != unicode_break_opportunity::no) {
+                // Trailing whitespace is included in the word, as it should belong at the end of the line.
                 word_end = i + 1;
             }
         }
@@ -79,6 +79,24 @@ struct attributed_glyph_line {
         return reset_of_line;
     }
 
+    /** Join wrapped lines back onto this line.
+     * The glyphs are moved from the lines, the metrics are calculated once.
+     *
+     * @param first The first line that was wrapped from this line.
+     * @param last One beyond the last line that was wrapped from this line.
+     */
+    template<typename It>
+    void join(It first, It last) noexcept {
+        if (first == last) {
+            return;
+        }
+
+        for (auto i = first; i != last; ++i) {
+            std::move(i->line.begin(), i->line.end(), std::back_inserter(line));
+        }
+        calculateLineMetrics();
+    }
+
     [[nodiscard]] aarectangle boundingBox() const noexcept {
         tt_axiom(std::ssize(line) >= 1);
 
@@ -8,6 +8,7 @@
 #include "text_style.hpp"
 #include "unicode_bidi_class.hpp"
 #include "unicode_general_category.hpp"
+#include "unicode_text_segmentation.hpp"
 
 namespace tt {
 
@@ -32,10 +33,20 @@ struct attributed_grapheme {
 
     unicode_general_category general_category;
 
+    /** The line-break opportunity after this grapheme.
+     */
+    unicode_break_opportunity line_break;
+
+    /** The word-break opportunity after this grapheme.
+     */
+    unicode_break_opportunity word_break;
+
     attributed_grapheme(tt::grapheme grapheme, text_style style, ssize_t logicalIndex=0) :
         grapheme(std::move(grapheme)), style(std::move(style)), logicalIndex(logicalIndex),
         bidi_class(unicode_bidi_class::unknown),
-        general_category(unicode_general_category::unknown)
+        general_category(unicode_general_category::unknown),
+        line_break(unicode_break_opportunity::no),
+        word_break(unicode_break_opportunity::no)
     {
     }
 };
@@ -4,34 +4,84 @@
 
 #include "grapheme.hpp"
 #include "unicode_normalization.hpp"
+#include "../unfair_mutex.hpp"
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
 
 namespace tt {
 
+static unfair_mutex long_grapheme_mutex;
+
+/** The maximum number of entries in the intern table.
+ * This bounds the memory used by text from untrusted sources to a few megabytes.
+ */
+constexpr size_t long_grapheme_table_capacity = 65536;
+
+/** The table of interned long graphemes.
+ *
+ * Entries are immutable and never freed, so that graphemes share them without reference counting;
+ * an application only uses a small number of distinct long graphemes.
+ * The table is constructed on first use, so that graphemes may be created during static initialization.
+ */
+[[nodiscard]] static std::unordered_map<std::u32string_view, long_grapheme const *> &long_grapheme_table() noexcept
+{
+    static auto table = std::unordered_map<std::u32string_view, long_grapheme const *>{};
+    return table;
+}
+
+[[nodiscard]] uint64_t grapheme::intern(char32_t const *data, size_t size) noexcept
+{
+    tt_assert(size <= std::tuple_size_v<long_grapheme>);
+
+    ttlet lock = std::scoped_lock(long_grapheme_mutex);
+    auto &table = long_grapheme_table();
+
+    auto it = table.find(std::u32string_view{data, size});
+    if (it == table.end()) {
+        if (table.size() >= long_grapheme_table_capacity) {
+            return (0x00'fffdULL << 1) | 1; // Replacement character.
+        }
+
+        auto ptr = new long_grapheme{};
+        std::copy_n(data, size, ptr->data());
+        it = table.emplace(std::u32string_view{ptr->data(), size}, ptr).first;
+    }
+
+    auto iptr = reinterpret_cast<ptrdiff_t>(it->second);
+    auto uptr = static_cast<uint64_t>(iptr << 16) >> 16;
+    return (static_cast<uint64_t>(size) << 48) | uptr;
+}
+
 grapheme::grapheme(std::u32string_view codePoints) noexcept :
-    value(0)
+    grapheme(from_NFC(unicode_NFC(codePoints))) {}
+
+[[nodiscard]] grapheme grapheme::from_NFC(std::u32string_view codePoints) noexcept
 {
-    ttlet codePoints_ = unicode_NFC(codePoints);
+    auto r = grapheme{};
+    r.value = 0;
 
-    switch (codePoints_.size()) {
+    switch (codePoints.size()) {
     case 3:
-        value |= (static_cast<uint64_t>(codePoints_[2] & 0x1f'ffff) << 43);
+        r.value |= (static_cast<uint64_t>(codePoints[2] & 0x1f'ffff) << 43);
         [[fallthrough]];
     case 2:
-        value |= (static_cast<uint64_t>(codePoints_[1] & 0x1f'ffff) << 22);
+        r.value |= (static_cast<uint64_t>(codePoints[1] & 0x1f'ffff) << 22);
         [[fallthrough]];
     case 1:
-        value |= (static_cast<uint64_t>(codePoints_[0] & 0x1f'ffff) << 1);
+        r.value |= (static_cast<uint64_t>(codePoints[0] & 0x1f'ffff) << 1);
         [[fallthrough]];
     case 0:
-        value |= 1;
+        r.value |= 1;
         break;
     default:
-        if (codePoints_.size() <= std::tuple_size_v<long_grapheme>) {
-            value = create_pointer(codePoints_.data(), codePoints_.size());
+        if (codePoints.size() <= std::tuple_size_v<long_grapheme>) {
+            r.value = intern(codePoints.data(), codePoints.size());
         } else {
-            value = (0x00'fffdULL << 1) | 1; // Replacement character.
+            r.value = (0x00'fffdULL << 1) | 1; // Replacement character.
         }
     }
+    return r;
 }
 
 grapheme& grapheme::operator+=(char32_t codePoint) noexcept
@@ -53,11 +103,13 @@ grapheme& grapheme::operator+=(char32_t codePoint) noexcept
         tmp[1] = (*this)[1];
         tmp[2] = (*this)[2];
         tmp[3] = codePoint;
-        value = create_pointer(tmp.data(), 3);
+        value = intern(tmp.data(), tmp.size());
         } break;
     default:
+        ttlet old_size = size();
         auto tmp = *get_pointer();
-        tmp[size()] = codePoint;
+        tmp[old_size] = codePoint;
+        value = intern(tmp.data(), old_size + 1);
     }
     return *this;
 }
@@ -8,6 +8,7 @@
 #include "../cast.hpp"
 #include "../hash.hpp"
 #include <array>
+#include <utility>
 
 namespace tt {
 
@@ -17,10 +18,15 @@ using long_grapheme = std::array<char32_t, 18>;
 
 /*! A grapheme, what a user thinks a character is.
  * This will exclude ligatures, because a user would see those as separate characters.
+ *
+ * Graphemes of more than 3 code-points are interned in a process-wide table
+ * of immutable entries, so that copying a grapheme never allocates.
+ * The table is bounded; once it is full new long graphemes are replaced by
+ * the replacement character.
  */
 class grapheme {
     /*! This value contains up to 3 code-points, or a pointer+length to an array
-     * of code-points located on the heap.
+     * of code-points in the intern table.
      *
      * The code-points inside the grapheme are in NFC.
      *
@@ -32,38 +38,16 @@ class grapheme {
      *
      * if bit 0 is '0' the value contains a length+pointer as follows:
      *    - 63:48   Length
-     *    - 47:0    Pointer to long_grapheme on the heap;
+     *    - 47:0    Pointer to an interned long_grapheme;
      *              bottom two bits are zero, due to alignment.
      */
     uint64_t value;
 
 public:
     grapheme() noexcept : value(1) {}
-
-    ~grapheme()
-    {
-        delete_pointer();
-    }
-
-    grapheme(const grapheme &other) noexcept
-    {
-        tt_axiom(&other != this);
-        value = other.value;
-        if (other.has_pointer()) {
-            value = create_pointer(other.get_pointer()->data(), other.size());
-        }
-    }
-
-    grapheme &operator=(const grapheme &other) noexcept
-    {
-        tt_return_on_self_assignment(other);
-        delete_pointer();
-        value = other.value;
-        if (other.has_pointer()) {
-            value = create_pointer(other.get_pointer()->data(), other.size());
-        }
-        return *this;
-    }
+    ~grapheme() = default;
+    grapheme(const grapheme &other) noexcept = default;
+    grapheme &operator=(const grapheme &other) noexcept = default;
 
     grapheme(grapheme &&other) noexcept
     {
@@ -75,9 +59,7 @@ public:
     grapheme &operator=(grapheme &&other) noexcept
     {
         // Self-assignment is allowed.
-        delete_pointer();
-        value = other.value;
-        other.value = 1;
+        value = std::exchange(other.value, 1);
         return *this;
     }
 
@@ -85,13 +67,33 @@ public:
 
     explicit grapheme(char32_t codePoint) noexcept : grapheme(std::u32string_view{&codePoint, 1}) {}
 
+    /** Construct a grapheme from code-points that are already in NFC.
+     * This skips the normalization done by the other constructors.
+     *
+     * @param codePoints The code-points of a single grapheme in NFC.
+     */
+    [[nodiscard]] static grapheme from_NFC(std::u32string_view codePoints) noexcept;
+
+    /** Construct a grapheme from a range of code-points.
+     * The code-points are collected in a local buffer and normalized, so that
+     * a long grapheme is interned once instead of once for every prefix.
+     *
+     * @param ptr An iterator to the first code-point of a single grapheme.
+     * @param last An iterator one beyond the last code-point.
+     */
     template<typename It>
-    explicit grapheme(It ptr, It last) noexcept : grapheme(*ptr)
-    {
-        ++ptr;
-        while (ptr != last) {
-            *this += *(ptr++);
+    explicit grapheme(It ptr, It last) noexcept : value(1)
+    {
+        auto buffer = long_grapheme{};
+        auto size = 0_uz;
+        for (; ptr != last; ++ptr) {
+            if (size == buffer.size()) {
+                value = (0x00'fffdULL << 1) | 1; // Replacement character.
+                return;
+            }
+            buffer[size++] = *ptr;
         }
+        *this = grapheme(std::u32string_view{buffer.data(), size});
     }
 
     grapheme &operator=(std::u32string_view codePoints) noexcept
@@ -106,6 +108,10 @@ public:
         return *this;
     }
 
+    /** Append a code-point.
+     * When the result is longer than 3 code-points it is added to the intern table;
+     * use the constructors to create a long grapheme at once.
+     */
     grapheme &operator+=(char32_t codePoint) noexcept;
 
     explicit operator std::u32string() const noexcept
@@ -228,30 +234,20 @@ private:
         return (value & 1) == 0;
     }
 
-    [[nodiscard]] static uint64_t create_pointer(char32_t const *data, size_t size) noexcept
-    {
-        tt_assert(size <= std::tuple_size<long_grapheme>::value);
-
-        auto ptr = new long_grapheme();
-        memcpy(ptr->data(), data, size);
-
-        auto iptr = reinterpret_cast<ptrdiff_t>(ptr);
-        auto uptr = static_cast<uint64_t>(iptr << 16) >> 16;
-        return (size << 48) | uptr;
-    }
+    /** Find or add the code-points in the intern table.
+     *
+     * @param data The code-points of a grapheme in NFC.
+     * @param size The number of code-points, at most the size of a long_grapheme.
+     * @return The value of a grapheme pointing to the interned code-points, or
+     *         the replacement character when the table is full.
+     */
+    [[nodiscard]] static uint64_t intern(char32_t const *data, size_t size) noexcept;
 
-    [[nodiscard]] long_grapheme *get_pointer() const noexcept
+    [[nodiscard]] long_grapheme const *get_pointer() const noexcept
     {
         auto uptr = (value << 16);
         auto iptr = static_cast<ptrdiff_t>(uptr) >> 16;
-        return std::launder(reinterpret_cast<long_grapheme *>(iptr));
-    }
-
-    void delete_pointer() noexcept
-    {
-        if (has_pointer()) {
-            delete get_pointer();
-        }
+        return std::launder(reinterpret_cast<long_grapheme const *>(iptr));
     }
 
     [[nodiscard]] friend bool operator<(grapheme const &a, grapheme const &b) noexcept
@@ -272,6 +268,11 @@ private:
             return true;
         }
 
+        if (a.has_pointer() && b.has_pointer()) {
+            // Equal long graphemes share the same interned entry.
+            return false;
+        }
+
         if (std::ssize(a) != std::ssize(b)) {
             return false;
         }
@@ -0,0 +1,64 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/text/grapheme.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace tt;
+
+// Family: man, woman, girl, boy.
+constexpr auto family = std::u32string_view{U"\U0001f468\u200d\U0001f469\u200d\U0001f467\u200d\U0001f466"};
+
+TEST(grapheme, short_grapheme)
+{
+    ttlet g = grapheme(U"e\u0301\u0323");
+    ASSERT_EQ(g.size(), 2);
+    ASSERT_EQ(g.NFC(), U"\u1eb9\u0301");
+}
+
+TEST(grapheme, long_grapheme)
+{
+    ttlet g = grapheme::from_NFC(family);
+    ASSERT_EQ(g.size(), family.size());
+    ASSERT_EQ(g.NFC(), family);
+
+    // Copies share the interned code-points.
+    ttlet copy = g;
+    ASSERT_EQ(copy, g);
+    ASSERT_EQ(copy.NFC(), family);
+
+    auto other = grapheme::from_NFC(family);
+    ASSERT_EQ(other, g);
+    ASSERT_EQ(other.hash(), g.hash());
+
+    other = grapheme::from_NFC(family.substr(0, 5));
+    ASSERT_NE(other, g);
+    ASSERT_EQ(other.NFC(), family.substr(0, 5));
+}
+
+TEST(grapheme, append)
+{
+    auto g = grapheme{};
+    for (auto i = 0_uz; i != family.size(); ++i) {
+        g += family[i];
+        ASSERT_EQ(g.size(), i + 1);
+        ASSERT_EQ(g, grapheme::from_NFC(family.substr(0, i + 1)));
+    }
+}
+
+TEST(grapheme, from_range)
+{
+    ttlet g = grapheme(family.begin(), family.end());
+    ASSERT_EQ(g, grapheme::from_NFC(family));
+    ASSERT_EQ(g.NFC(), family);
+
+    // The code-points are normalized.
+    ttlet decomposed = std::u32string_view{U"e\u0301"};
+    ASSERT_EQ(grapheme(decomposed.begin(), decomposed.end()), grapheme(U'\u00e9'));
+
+    // A grapheme longer than a long_grapheme is replaced.
+    ttlet too_long = std::u32string(std::tuple_size_v<long_grapheme> + 1, U'\u0301');
+    ASSERT_EQ(grapheme(too_long.begin(), too_long.end()), grapheme(U'\ufffd'));
+}
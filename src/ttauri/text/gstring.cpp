@@ -6,32 +6,132 @@
 #include "unicode_text_segmentation.hpp"
 #include "unicode_normalization.hpp"
 #include "../strings.hpp"
+#include "../architecture.hpp"
+#include <bit>
+#if TT_PROCESSOR == TT_CPU_X64
+#include <emmintrin.h>
+#endif
 
 namespace tt {
 
+/** Append the graphemes of text that is already in NFC.
+ */
+static void append_NFC(gstring &r, std::u32string_view text) noexcept
+{
+    auto breakState = tt::grapheme_break_state{};
+
+    auto cluster_first = 0_uz;
+    for (auto i = 0_uz; i != text.size(); ++i) {
+        if (breaks_grapheme(text[i], breakState) && i != cluster_first) {
+            r += grapheme::from_NFC(text.substr(cluster_first, i - cluster_first));
+            cluster_first = i;
+        }
+    }
+    if (cluster_first != text.size()) {
+        r += grapheme::from_NFC(text.substr(cluster_first));
+    }
+}
+
 [[nodiscard]] gstring to_gstring(std::u32string_view rhs) noexcept
 {
-    ttlet normalizedString = unicode_NFC(rhs, true, true, true);
+    auto r = tt::gstring{};
+    append_NFC(r, unicode_NFC(rhs, true, true, true));
+    return r;
+}
+
+[[nodiscard]] static bool is_ascii(char c) noexcept
+{
+    return static_cast<uint8_t>(c) < 0x80;
+}
+
+/** Find the first non-ASCII code-unit.
+ */
+[[nodiscard]] static size_t find_non_ascii(std::string_view text, size_t first) noexcept
+{
+    auto i = first;
 
+#if TT_PROCESSOR == TT_CPU_X64
+    for (; i + 16 <= text.size(); i += 16) {
+        ttlet chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(text.data() + i));
+        if (ttlet mask = static_cast<unsigned int>(_mm_movemask_epi8(chunk))) {
+            return i + std::countr_zero(mask);
+        }
+    }
+#endif
+
+    for (; i != text.size(); ++i) {
+        if (!is_ascii(text[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+/** Find the end of a segment of text which contains non-ASCII characters.
+ * The segment ends between two ASCII characters, where there is always a grapheme break
+ * and which normalization can not cross, except for a CR-LF pair.
+ */
+[[nodiscard]] static size_t find_segment_end(std::string_view text, size_t first) noexcept
+{
+    for (auto i = first + 1; i < text.size(); ++i) {
+        ttlet prev = text[i - 1];
+        ttlet c = text[i];
+        if (is_ascii(prev) && is_ascii(c) && !(prev == '\r' && c == '\n')) {
+            return i;
+        }
+    }
+    return text.size();
+}
+
+[[nodiscard]] gstring to_gstring(std::string_view rhs) noexcept
+{
     auto r = tt::gstring{};
-    auto breakState = tt::grapheme_break_state{};
-    auto cluster = std::u32string{};
+    r.graphemes.reserve(rhs.size());
 
-    for (ttlet codePoint : normalizedString) {
-        if (breaks_grapheme(codePoint, breakState)) {
-            if (cluster.size() > 0) {
-                r += tt::grapheme{cluster};
+    auto i = 0_uz;
+    while (i != rhs.size()) {
+        // A run of ASCII characters is already in NFC and every character is a grapheme, except
+        // for the last character of the run which may combine with the following non-ASCII characters.
+        ttlet run_last = find_non_ascii(rhs, i);
+        ttlet fast_last = (run_last == rhs.size() || run_last == i) ? run_last : run_last - 1;
+
+        while (i < fast_last) {
+            ttlet c = rhs[i];
+            if (c == '\r' && i + 1 != rhs.size() && rhs[i + 1] == '\n') {
+                if (i + 1 == fast_last) {
+                    // The line-feed is part of the next segment.
+                    break;
+                }
+                r += grapheme::PS();
+                i += 2;
+
+            } else if (c == '\n') {
+                r += grapheme::PS();
+                ++i;
+
+            } else {
+                ttlet code_point = static_cast<char32_t>(c);
+                r += grapheme::from_NFC(std::u32string_view{&code_point, 1});
+                ++i;
             }
-            cluster.clear();
         }
 
-        cluster += codePoint;
-    }
-    if (std::ssize(cluster) != 0) {
-        r += tt::grapheme{cluster};
+        if (i == rhs.size()) {
+            break;
+        }
+
+        // Normalize the segment with the non-ASCII characters, skipping normalization
+        // when the segment passes the quick-check.
+        ttlet segment_last = find_segment_end(rhs, i);
+        ttlet segment = to_u32string(rhs.substr(i, segment_last - i));
+        if (unicode_NFC_quick_check(segment, true, true, true)) {
+            append_NFC(r, segment);
+        } else {
+            append_NFC(r, unicode_NFC(segment, true, true, true));
+        }
+        i = segment_last;
     }
     return r;
 }
 
-
-}
\ No newline at end of file
+}
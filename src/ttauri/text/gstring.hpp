@@ -73,13 +73,17 @@ struct gstring {
 
 [[nodiscard]] gstring to_gstring(std::u32string_view rhs) noexcept;
 
-[[nodiscard]] inline gstring to_gstring(std::u8string_view rhs) noexcept {
-    return to_gstring(tt::to_u32string(rhs));
-}
+/** Convert a UTF-8 encoded string to a gstring.
+ * The text is normalized to NFC in a single pass; runs of ASCII characters and text
+ * that passes the NFC quick-check are converted directly into graphemes.
+ *
+ * @param rhs A UTF-8 encoded string, which may contain invalid code-units.
+ * @return The graphemes of the string in NFC.
+ */
+[[nodiscard]] gstring to_gstring(std::string_view rhs) noexcept;
 
-[[nodiscard]] inline gstring to_gstring(std::string_view rhs) noexcept
-{
-    return to_gstring(tt::to_u32string(rhs));
+[[nodiscard]] inline gstring to_gstring(std::u8string_view rhs) noexcept {
+    return to_gstring(std::string_view{reinterpret_cast<char const *>(rhs.data()), rhs.size()});
 }
 
 
@@ -0,0 +1,62 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/text/gstring.hpp"
+#include "ttauri/codec/UTF.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace tt;
+
+namespace {
+
+[[nodiscard]] std::vector<std::u32string> to_vector(gstring const &text)
+{
+    auto r = std::vector<std::u32string>{};
+    for (ttlet &g : text) {
+        r.push_back(g.NFC());
+    }
+    return r;
+}
+
+} // namespace
+
+TEST(gstring, ascii)
+{
+    ASSERT_EQ(to_vector(to_gstring(std::string_view{"ab c"})), (std::vector<std::u32string>{U"a", U"b", U" ", U"c"}));
+
+    // Line-feeds are converted to paragraph separators, CR-LF is composed.
+    ASSERT_EQ(
+        to_vector(to_gstring(std::string_view{"a\nb\r\nc\rd"})),
+        (std::vector<std::u32string>{U"a", U"\u2029", U"b", U"\u2029", U"c", U"\r", U"d"}));
+}
+
+TEST(gstring, combining)
+{
+    // The last ASCII character of a run is composed with the combining mark that follows it.
+    ASSERT_EQ(
+        to_vector(to_gstring(std::string_view{"abe\xcc\x81" "cd"})),
+        (std::vector<std::u32string>{U"a", U"b", U"\u00e9", U"c", U"d"}));
+
+    ASSERT_EQ(to_vector(to_gstring(std::string_view{"\r\xcc\x81"})), (std::vector<std::u32string>{U"\r", U"\u0301"}));
+    ASSERT_EQ(to_vector(to_gstring(std::string_view{"a\r\n\xcc\x81"})), (std::vector<std::u32string>{U"a", U"\u2029", U"\u0301"}));
+}
+
+TEST(gstring, same_as_utf32)
+{
+    ttlet tests = std::vector<std::u32string>{
+        U"The quick brown fox",
+        U"Café crème brûlée",
+        U"Ω क़ ﬁx",
+        U"각 각 각",
+        U"中文。",
+        U"\U0001f468‍\U0001f469‍\U0001f467 \U0001f1f3\U0001f1f1 \U0001f44d\U0001f3fd",
+        U"؀a ক্ষ ো",
+        U"x\r\n\r\ny\n z"};
+
+    for (ttlet &test : tests) {
+        ASSERT_EQ(to_vector(to_gstring(to_string(test))), to_vector(to_gstring(std::u32string_view{test})));
+    }
+}
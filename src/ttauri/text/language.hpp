@@ -15,9 +15,11 @@
 #include <vector>
 #include <functional>
 #include <mutex>
+#include <atomic>
 
 namespace tt {
 
+class translation_catalog;
 
 class language {
 public:
@@ -26,6 +28,13 @@ public:
     language_tag tag;
     std::function<int(int)> plurality_func;
 
+    /** The translations of this language.
+     * The catalog is replaced as a whole by `add_translation()`, so that it can be read without a lock.
+     * A replaced catalog is owned by the translation module until the application exits, so a
+     * pointer loaded from here stays valid.
+     */
+    mutable std::atomic<translation_catalog const *> catalog = nullptr;
+
     language(language_tag tag) noexcept;
 
     language(language const &) = delete;
@@ -128,9 +137,26 @@ public:
                 language_order_string += to_string(language->tag);
             }
             tt_log_info("Setting preferred language in order: ", language_order_string);
+            increment_generation();
         }
     }
 
+    /** The generation of the translations.
+     * The generation is incremented each time the preferred languages or the
+     * translations are changed, so that translated text can be cached.
+     */
+    [[nodiscard]] static size_t generation() noexcept
+    {
+        return _generation.load(std::memory_order::acquire);
+    }
+
+    /** Invalidate all cached translated text.
+     */
+    static void increment_generation() noexcept
+    {
+        _generation.fetch_add(1, std::memory_order::acq_rel);
+    }
+
     /** Get the preferred language tags from the operating system.
      * Language tags are based on IETF BCP-47/RFC-5646
      */
@@ -154,6 +180,7 @@ public:
 
 private:
     inline static std::atomic<bool> _is_running;
+    inline static std::atomic<size_t> _generation = 0;
     inline static std::unordered_map<language_tag, std::unique_ptr<language>> _languages;
     inline static std::vector<language_tag> _preferred_language_tags;
     inline static std::vector<language *> _preferred_languages;
@@ -4,6 +4,7 @@
 
 #include "shaped_text.hpp"
 #include "unicode_description.hpp"
+#include "unicode_text_segmentation.hpp"
 #include "../small_map.hpp"
 
 namespace tt {
@@ -76,6 +77,30 @@ static void wrap_lines(std::vector<attributed_glyph_line> &lines, float width) n
     }
 }
 
+/** Join the lines that were wrapped back into paragraphs.
+ * Each paragraph ends in a paragraph separator; the first line of a paragraph keeps
+ * the capacity of the whole paragraph, so joining does not allocate.
+ */
+static void unwrap_lines(std::vector<attributed_glyph_line> &lines) noexcept
+{
+    auto paragraph = lines.begin();
+    for (auto first = lines.begin(); first != lines.end(); ++paragraph) {
+        auto last = std::find_if(first, lines.end(), [](ttlet &line) {
+            return line.line.back().isParagraphSeparator();
+        });
+        if (last != lines.end()) {
+            ++last;
+        }
+
+        if (paragraph != first) {
+            *paragraph = std::move(*first);
+        }
+        paragraph->join(first + 1, last);
+        first = last;
+    }
+    lines.erase(paragraph, lines.end());
+}
+
 /** Calculate the size of the text.
  * @return The extent of the text and the base line position of the middle line.
  */
@@ -222,12 +247,6 @@ static void position_glyphs(std::vector<attributed_glyph_line> &lines, alignment
     }
 }
 
-struct shape_text_result {
-    extent2 preferred_extent;
-    aarectangle boundingBox;
-    std::vector<attributed_glyph_line> lines;
-};
-
 /** Shape the text.
 * The given text is in logical-order; the order in which humans write text.
 * The resulting glyphs are in left-to-right display order.
@@ -237,23 +256,15 @@ struct shape_text_result {
 *  - Convert attributed-graphemes into attributes-glyphs using font_book's find_glyph algorithm.
 *  - Morph attributed-glyphs using the font's morph algorithm.
 *  - Calculate advance for each attributed-glyph using the font's advance and kern algorithms.
-*  - Add line-breaks to the text to fit within the maximum-width.
-*  - Calculate actual size of the text
-*  - Align the text within the given extent size.
+*  - Split the text into paragraphs.
+*
+* Line-breaks and alignment do not need access to the fonts and are done by `shaped_text::layout()`.
 *
 * @param text The text to be shaped.
-* @param alignment How the text should be horizontally-aligned inside the maximum_width.
-* @param max_width Maximum width that the text should flow into.
-* @return preferred size of the text, size of the resulting text, shaped text.
+* @return The paragraphs of shaped text, not yet wrapped or positioned.
 */
-[[nodiscard]] static shape_text_result shape_text(
-    std::vector<attributed_grapheme> text,
-    float width,
-    alignment alignment,
-    float wrap) noexcept
+[[nodiscard]] static std::vector<attributed_glyph_line> shape_text(std::vector<attributed_grapheme> text) noexcept
 {
-    std::vector<attributed_glyph> attributed_glyphs;
-
     // Put graphemes in left-to-right display order using the unicode_data::global's bidi_algorithm.
     //bidi_algorithm(text);
     ssize_t logicalIndex = 0;
@@ -265,48 +276,40 @@ struct shape_text_result {
     }
     tt_axiom(text.back().general_category == unicode_general_category::Zp);
 
+    // Find the break opportunities once, they are used for line-wrapping and cursor movement.
+    ttlet get_code_point = [](ttlet &c) {
+        return c.grapheme[0];
+    };
+    ttlet line_breaks = unicode_line_break(text.cbegin(), text.cend(), get_code_point);
+    ttlet word_breaks = unicode_word_break(text.cbegin(), text.cend(), get_code_point);
+    for (auto i = 0_uz; i != text.size(); ++i) {
+        text[i].line_break = line_breaks[i + 1];
+        text[i].word_break = word_breaks[i + 1];
+    }
+
     // Convert attributed-graphemes into attributes-glyphs using font_book's find_glyph algorithm.
     auto glyphs = graphemes_to_glyphs(text);
 
-    // Split the text up in lines, based on line-feeds and line-wrapping.
-    auto lines = make_lines(std::move(glyphs));
-
-    // Calculate actual size of the box, no smaller than the minimum_size.
-    ttlet preferred_extent = ceil(calculate_text_size(lines));
-
-    if (wrap) {
-        wrap_lines(lines, width);
-    }
-
     // Morph attributed-glyphs using the font's morph algorithm.
     //morph_glyphs(glyphs);
 
-    // Align the text within the actual box size.
-    position_glyphs(lines, alignment, width);
-
-    ttlet bounding_box = calculate_bounding_box(lines, width);
-
-    return {
-        preferred_extent,
-        bounding_box,
-        lines
-    };
+    // Split the text up in paragraphs, based on line-feeds.
+    return make_lines(std::move(glyphs));
 }
 
-
 shaped_text::shaped_text(
     std::vector<attributed_grapheme> const &text,
     float width,
     tt::alignment alignment,
     bool wrap
 ) noexcept :
-    alignment(alignment),
-    width(width)
+    lines(shape_text(text)),
+    _wrap(wrap)
 {
-    auto result = shape_text(text, width, alignment, wrap);
-    _preferred_extent = result.preferred_extent;
-    boundingBox = result.boundingBox;
-    lines = std::move(result.lines);
+    // Calculate actual size of the box, no smaller than the minimum_size.
+    _preferred_extent = ceil(calculate_text_size(lines));
+
+    layout(width, alignment);
 }
 
 shaped_text::shaped_text(
@@ -328,6 +331,23 @@ shaped_text::shaped_text(
     shaped_text(to_gstring(text), style, width, alignment, wrap) {}
 
 
+void shaped_text::layout(float width, tt::alignment alignment) noexcept
+{
+    this->width = width;
+    this->alignment = alignment;
+
+    // Start from the unwrapped paragraphs, the glyphs and their metrics are reused.
+    if (_wrap) {
+        unwrap_lines(lines);
+        wrap_lines(lines, width);
+    }
+
+    // Align the text within the actual box size.
+    position_glyphs(lines, alignment, width);
+
+    boundingBox = calculate_bounding_box(lines, width);
+}
+
 [[nodiscard]] shaped_text::const_iterator shaped_text::find(ssize_t index) const noexcept
 {
     return std::find_if(cbegin(), cend(), [=](ttlet &x) {
@@ -511,13 +531,17 @@ shaped_text::shaped_text(
         }
     }
 
-    // Expand the word to left and right.
-    auto [s, e] = bifind_cluster(cbegin(), cend(), i, [](ttlet &x) {
-        return x.selectionWordClusterID();
-    });
+    // Expand the word to left and right, up to the word-breaks found while shaping.
+    auto s = i;
+    while (s != cbegin() && (s - 1)->word_break == unicode_break_opportunity::no) {
+        --s;
+    }
+
+    auto e = i;
+    while (e->word_break == unicode_break_opportunity::no && (e + 1) != cend()) {
+        ++e;
+    }
 
-    tt_axiom(e != i);
-    --e;
     return {s->logicalIndex, e->logicalIndex + e->graphemeCount};
 }
 
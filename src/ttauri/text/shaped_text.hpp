@@ -31,12 +31,16 @@ public:
     float width;
 
 private:
+    /** The lines after wrapping and positioning the shaped paragraphs.
+     * On relayout the wrapped lines are joined back into paragraphs in place.
+     */
     std::vector<attributed_glyph_line> lines;
     extent2 _preferred_extent;
+    bool _wrap;
 
 public:
     shaped_text() noexcept :
-        alignment(alignment::middle_center), boundingBox(), width(0.0f), _preferred_extent(), lines() {}
+        alignment(alignment::middle_center), boundingBox(), width(0.0f), lines(), _preferred_extent(), _wrap(true) {}
     shaped_text(shaped_text const &other) = default;
     shaped_text(shaped_text &&other) noexcept = default;
     shaped_text &operator=(shaped_text const &other) = default;
@@ -105,6 +109,15 @@ public:
         bool wrap=true
     ) noexcept;
 
+    /** Wrap and position the shaped text for a new width.
+     * This reuses the glyphs and metrics of the shaped text, and does not access the fonts.
+     * The glyphs are moved between the lines, so the paragraphs are not copied.
+     *
+     * @param width The width into which the text is horizontally aligned.
+     * @param alignment The alignment of the text within the extent.
+     */
+    void layout(float width, tt::alignment alignment) noexcept;
+
     [[nodiscard]] size_t size() const noexcept {
         ssize_t count = 0;
         for (ttlet &line: lines) {
@@ -5,63 +5,109 @@
 
 #include "translation.hpp"
 #include "po_parser.hpp"
+#include "../unfair_mutex.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace tt {
 
-struct translation_key {
-    std::string msgid;
-    language const *language;
-
-    translation_key(std::string_view msgid, tt::language const *language=nullptr) noexcept :
-        msgid(msgid), language(language) {}
+static unfair_mutex translation_mutex;
+
+/** All catalogs that were ever published to a language.
+ * A replaced catalog is kept until the application exits, because a lookup on another thread
+ * may still be reading it, and `get_translation()` returns views into it.
+ * translation_mutex must be locked.
+ */
+static std::vector<std::unique_ptr<translation_catalog const>> translation_catalogs;
+
+/** Messages added one at a time which are not yet in the catalog of their language.
+ * They are built into the catalogs on the next lookup, so that adding many messages
+ * builds each catalog only once.
+ * translation_mutex must be locked.
+ */
+static std::unordered_map<language const *, translation_catalog::message_map> translation_pending;
+static std::atomic<bool> translation_has_pending = false;
+
+/** Replace the catalog of a language.
+ * translation_mutex must be locked.
+ */
+static void set_translation_catalog(language const &language, std::unique_ptr<translation_catalog const> catalog)
+{
+    translation_catalogs.push_back(std::move(catalog));
+    language.catalog.store(translation_catalogs.back().get(), std::memory_order::release);
+    language::increment_generation();
+}
 
-    [[nodiscard]] size_t hash() const noexcept {
-        return hash_mix(language, msgid);
+/** Add messages to the catalog of a language.
+ * translation_mutex must be locked.
+ */
+static void add_translation(translation_catalog::message_map messages, language const &language) noexcept
+{
+    if (ttlet catalog = language.catalog.load(std::memory_order::acquire)) {
+        // Messages that are already in the catalog are replaced by the new messages.
+        messages.merge(catalog->messages());
     }
 
-    [[nodiscard]] friend bool operator==(translation_key const &lhs, translation_key const &rhs) noexcept {
-        return lhs.language == rhs.language && lhs.msgid == rhs.msgid;
+    try {
+        set_translation_catalog(language, std::make_unique<translation_catalog>(messages));
+    } catch (std::exception const &e) {
+        tt_log_error("Could not build translation catalog for {}: {}", to_string(language.tag), e.what());
     }
-};
-
 }
 
-namespace std {
-
-template<>
-struct hash<tt::translation_key> {
-    [[nodiscard]] size_t operator()(tt::translation_key const &rhs) const noexcept {
-        return rhs.hash();
+/** Build the catalogs of the languages that have pending messages.
+ * translation_mutex must be locked.
+ */
+static void flush_pending_translations() noexcept
+{
+    for (auto &[language, messages] : translation_pending) {
+        add_translation(std::move(messages), *language);
     }
-};
-
+    translation_pending.clear();
+    translation_has_pending.store(false, std::memory_order::release);
 }
 
-namespace tt {
-
-std::unordered_map<translation_key,std::vector<std::string>> translations;
+tt_no_inline static void flush_pending_translations_for_lookup() noexcept
+{
+    ttlet lock = std::scoped_lock(translation_mutex);
+    flush_pending_translations();
+}
 
 [[nodiscard]] std::string_view get_translation(
     std::string_view msgid,
     long long n,
     std::vector<language*> const &languages
 ) noexcept {
-
-    auto key = translation_key{msgid};
+    if (translation_has_pending.load(std::memory_order::acquire)) {
+        [[unlikely]] flush_pending_translations_for_lookup();
+    }
 
     for (ttlet *language : languages) {
-        key.language = language;
-
-        ttlet i = translations.find(key);
-        if (i != translations.cend()) {
-            ttlet plurality = language->plurality(n, std::ssize(i->second));
-            ttlet &translation = i->second[plurality];
-            if (translation.size() != 0) {
-                return translation;
-            }
+        ttlet catalog = language->catalog.load(std::memory_order::acquire);
+        if (catalog == nullptr) {
+            continue;
+        }
+
+        ttlet index = catalog->find(msgid);
+        if (index < 0) {
+            continue;
+        }
+
+        ttlet nr_plural_forms = catalog->nr_plural_forms(narrow_cast<size_t>(index));
+        if (nr_plural_forms == 0) {
+            continue;
+        }
+
+        ttlet plurality = language->plurality(n, narrow_cast<ssize_t>(nr_plural_forms));
+        ttlet translation = catalog->plural_form(narrow_cast<size_t>(index), narrow_cast<size_t>(plurality));
+        if (translation.size() != 0) {
+            return translation;
         }
     }
-    tt_log_info("No translation found for '{}'", msgid);
     return msgid;
 }
 
@@ -70,8 +116,12 @@ void add_translation(
     language const &language,
     std::vector<std::string> const &plural_forms
 ) noexcept {
-    auto key = translation_key{msgid, &language};
-    translations[key] = plural_forms;
+    ttlet lock = std::scoped_lock(translation_mutex);
+
+    auto &messages = translation_pending[&language];
+    messages.insert_or_assign(std::string{msgid}, plural_forms);
+    translation_has_pending.store(true, std::memory_order::release);
+    language::increment_generation();
 }
 
 void add_translation(
@@ -85,13 +135,27 @@ void add_translation(
 
 void add_translation(po_translations const &po_translations, language const &language) noexcept
 {
+    ttlet lock = std::scoped_lock(translation_mutex);
+    flush_pending_translations();
+
+    auto messages = translation_catalog::message_map{};
     for (ttlet &translation : po_translations.translations) {
         auto msgid = std::ssize(translation.msgctxt) == 0 ? translation.msgid : translation.msgctxt + '|' + translation.msgid;
-        add_translation(
-            msgid,
-            language,
-            translation.msgstr
-        );
+        messages[std::move(msgid)] = translation.msgstr;
+    }
+    add_translation(std::move(messages), language);
+}
+
+void add_translation(std::unique_ptr<translation_catalog const> catalog, language const &language) noexcept
+{
+    tt_axiom(catalog);
+    ttlet lock = std::scoped_lock(translation_mutex);
+    flush_pending_translations();
+
+    try {
+        set_translation_catalog(language, std::move(catalog));
+    } catch (std::exception const &e) {
+        tt_log_error("Could not add translation catalog for {}: {}", to_string(language.tag), e.what());
     }
 }
 
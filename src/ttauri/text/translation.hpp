@@ -5,6 +5,7 @@
 #pragma once
 
 #include "language.hpp"
+#include "translation_catalog.hpp"
 #include "../formula/formula.hpp"
 #include "../hash.hpp"
 #include <string>
@@ -14,12 +15,32 @@
 
 namespace tt {
 
+/** Find the translation of a message.
+ *
+ * The lookup does not allocate and does not take a lock, except when messages added by
+ * `add_translation()` of a single message are still pending. Then this call builds the new
+ * catalogs of those languages under a lock, which costs a full copy of each catalog.
+ *
+ * @param msgid The message to translate.
+ * @param n The number used to select the plural form.
+ * @param languages The languages to search, in order of preference.
+ * @return The translation, or the msgid when no translation was found. A translation
+ *         points into a catalog, which stays valid until the application exits.
+ *         Replaced catalogs are never freed before then.
+ */
 [[nodiscard]] std::string_view get_translation(
     std::string_view msgid,
     long long n=0,
     std::vector<language*> const &languages=language::preferred_languages()
 ) noexcept;
 
+/** Add the translation of a single message.
+ * The messages added this way are built into the catalog of the language on the next
+ * call to `get_translation()`, so that adding many messages rebuilds the catalog once.
+ * That rebuild copies the whole catalog and is paid by the first lookup after the messages
+ * were added. Each rebuild also keeps the replaced catalog in memory until the application
+ * exits; prefer adding a whole catalog when loading many translations.
+ */
 void add_translation(
     std::string_view msgid,
     language const &language,
@@ -35,4 +56,9 @@ void add_translation(
 struct po_translations;
 void add_translation(po_translations const &translations, language const &language) noexcept;
 
+/** Replace the translations of a language with a compiled catalog.
+ * For example a catalog that was memory-mapped from disk.
+ */
+void add_translation(std::unique_ptr<translation_catalog const> catalog, language const &language) noexcept;
+
 }
@@ -0,0 +1,301 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "translation_catalog.hpp"
+#include "../endian.hpp"
+#include "../placement.hpp"
+#include "../check.hpp"
+#include "../cast.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace tt {
+
+struct translation_catalog::header_type {
+    little_uint32_buf_t magic;
+    little_uint32_buf_t nr_messages;
+    little_uint32_buf_t nr_buckets;
+    little_uint32_buf_t nr_forms;
+    little_uint32_buf_t strings_size;
+};
+
+struct translation_catalog::seed_type {
+    little_uint32_buf_t seed;
+};
+
+struct translation_catalog::message_type {
+    little_uint32_buf_t msgid_offset;
+    little_uint32_buf_t msgid_size;
+    little_uint32_buf_t first_form;
+    little_uint32_buf_t nr_forms;
+};
+
+struct translation_catalog::form_type {
+    little_uint32_buf_t offset;
+    little_uint32_buf_t size;
+};
+
+/** "ttc1" */
+constexpr uint32_t translation_catalog_magic = 0x31'63'74'74;
+
+/** The average number of messages in a bucket of the perfect hash.
+ */
+constexpr size_t translation_catalog_bucket_size = 4;
+
+/** Hash a msgid.
+ * The catalog may be stored on disk, so the hash must not depend on the platform.
+ */
+[[nodiscard]] static uint64_t translation_catalog_hash(std::string_view msgid) noexcept
+{
+    // FNV-1a
+    uint64_t h = 0xcbf2'9ce4'8422'2325;
+    for (ttlet c : msgid) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100'0000'01b3;
+    }
+    return h;
+}
+
+/** Select a slot based on the hash of a msgid and a seed.
+ * Seed 0 is used to select the bucket, the seed of the bucket selects the message.
+ */
+[[nodiscard]] static size_t translation_catalog_slot(uint64_t hash, uint32_t seed, size_t nr_slots) noexcept
+{
+    tt_axiom(nr_slots > 0);
+
+    // Mix the seed into the hash using the finalizer of splitmix64.
+    auto x = hash ^ (uint64_t{seed} * 0x9e37'79b9'7f4a'7c15);
+    x ^= x >> 30;
+    x *= 0xbf58'476d'1ce4'e5b9;
+    x ^= x >> 27;
+    x *= 0x94d0'49bb'1331'11eb;
+    x ^= x >> 31;
+    return static_cast<size_t>(x % nr_slots);
+}
+
+static void append(bstring &bytes, uint32_t value) noexcept
+{
+    little_uint32_buf_t buf;
+    buf = value;
+    bytes.append(buf._value, sizeof(buf._value));
+}
+
+translation_catalog::translation_catalog(message_map const &messages)
+{
+    ttlet nr_messages = messages.size();
+    ttlet nr_buckets = (nr_messages + translation_catalog_bucket_size - 1) / translation_catalog_bucket_size;
+
+    auto msgids = std::vector<std::string const *>{};
+    auto plural_forms = std::vector<std::vector<std::string> const *>{};
+    auto hashes = std::vector<uint64_t>{};
+    msgids.reserve(nr_messages);
+    plural_forms.reserve(nr_messages);
+    hashes.reserve(nr_messages);
+    for (ttlet &[msgid, forms] : messages) {
+        msgids.push_back(&msgid);
+        plural_forms.push_back(&forms);
+        hashes.push_back(translation_catalog_hash(msgid));
+    }
+
+    // Distribute the messages over the buckets.
+    auto buckets = std::vector<std::vector<size_t>>(nr_buckets);
+    for (auto i = 0_uz; i != nr_messages; ++i) {
+        buckets[translation_catalog_slot(hashes[i], 0, nr_buckets)].push_back(i);
+    }
+
+    // Find a seed for each bucket that puts its messages in free slots, largest buckets first.
+    auto bucket_order = std::vector<size_t>(nr_buckets);
+    std::iota(bucket_order.begin(), bucket_order.end(), 0_uz);
+    std::stable_sort(bucket_order.begin(), bucket_order.end(), [&buckets](ttlet lhs, ttlet rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    auto seeds = std::vector<uint32_t>(nr_buckets, 0);
+    auto slot_to_message = std::vector<size_t>(nr_messages, nr_messages);
+    auto bucket_slots = std::vector<size_t>{};
+    for (ttlet bucket_index : bucket_order) {
+        ttlet &bucket = buckets[bucket_index];
+        if (bucket.empty()) {
+            break;
+        }
+
+        for (uint32_t seed = 1;; ++seed) {
+            tt_assert(seed != 0);
+
+            bucket_slots.clear();
+            auto found = true;
+            for (ttlet message_index : bucket) {
+                ttlet slot = translation_catalog_slot(hashes[message_index], seed, nr_messages);
+                if (slot_to_message[slot] != nr_messages ||
+                    std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+                    found = false;
+                    break;
+                }
+                bucket_slots.push_back(slot);
+            }
+
+            if (found) {
+                for (auto i = 0_uz; i != bucket.size(); ++i) {
+                    slot_to_message[bucket_slots[i]] = bucket[i];
+                }
+                seeds[bucket_index] = seed;
+                break;
+            }
+        }
+    }
+
+    // Lay out the strings and the plural forms in the order of the slots.
+    auto strings = std::string{};
+    auto forms = std::vector<std::pair<uint32_t, uint32_t>>{};
+    auto records = std::vector<std::array<uint32_t, 4>>{};
+    records.reserve(nr_messages);
+    for (ttlet message_index : slot_to_message) {
+        ttlet &msgid = *msgids[message_index];
+        ttlet &message_forms = *plural_forms[message_index];
+
+        records.push_back(
+            {narrow_cast<uint32_t>(strings.size()),
+             narrow_cast<uint32_t>(msgid.size()),
+             narrow_cast<uint32_t>(forms.size()),
+             narrow_cast<uint32_t>(message_forms.size())});
+        strings += msgid;
+
+        for (ttlet &form : message_forms) {
+            forms.emplace_back(narrow_cast<uint32_t>(strings.size()), narrow_cast<uint32_t>(form.size()));
+            strings += form;
+        }
+    }
+
+    _bytes.reserve(
+        sizeof(header_type) + nr_buckets * sizeof(seed_type) + nr_messages * sizeof(message_type) +
+        forms.size() * sizeof(form_type) + strings.size());
+
+    append(_bytes, translation_catalog_magic);
+    append(_bytes, narrow_cast<uint32_t>(nr_messages));
+    append(_bytes, narrow_cast<uint32_t>(nr_buckets));
+    append(_bytes, narrow_cast<uint32_t>(forms.size()));
+    append(_bytes, narrow_cast<uint32_t>(strings.size()));
+    for (ttlet seed : seeds) {
+        append(_bytes, seed);
+    }
+    for (ttlet &record : records) {
+        for (ttlet value : record) {
+            append(_bytes, value);
+        }
+    }
+    for (ttlet [offset, size] : forms) {
+        append(_bytes, offset);
+        append(_bytes, size);
+    }
+    _bytes.append(reinterpret_cast<std::byte const *>(strings.data()), strings.size());
+
+    attach();
+}
+
+translation_catalog::translation_catalog(bstring bytes) : _bytes(std::move(bytes))
+{
+    attach();
+}
+
+translation_catalog::translation_catalog(std::unique_ptr<resource_view> view) : _view(std::move(view))
+{
+    tt_assert(_view);
+    attach();
+}
+
+void translation_catalog::attach()
+{
+    ttlet bytes = this->bytes();
+
+    ssize_t offset = 0;
+    ttlet header = make_placement_ptr<header_type>(bytes, offset);
+    tt_parse_check(header->magic.value() == translation_catalog_magic, "Not a translation catalog.");
+
+    _nr_messages = header->nr_messages.value();
+    _nr_buckets = header->nr_buckets.value();
+    ttlet nr_forms = header->nr_forms.value();
+    ttlet strings_size = header->strings_size.value();
+    tt_parse_check((_nr_messages == 0) == (_nr_buckets == 0), "Translation catalog without buckets.");
+
+    ttlet seeds = make_placement_array<seed_type>(bytes, offset, narrow_cast<ssize_t>(_nr_buckets));
+    ttlet messages = make_placement_array<message_type>(bytes, offset, narrow_cast<ssize_t>(_nr_messages));
+    ttlet forms = make_placement_array<form_type>(bytes, offset, narrow_cast<ssize_t>(nr_forms));
+    ttlet strings = make_placement_array<char>(bytes, offset, narrow_cast<ssize_t>(strings_size));
+
+    // Check all offsets once, so that lookups do not need to.
+    for (ttlet &message : messages) {
+        tt_parse_check(
+            uint64_t{message.msgid_offset.value()} + message.msgid_size.value() <= strings_size,
+            "Translation catalog msgid beyond string storage.");
+        tt_parse_check(
+            uint64_t{message.first_form.value()} + message.nr_forms.value() <= nr_forms,
+            "Translation catalog plural forms beyond table.");
+    }
+    for (ttlet &form : forms) {
+        tt_parse_check(
+            uint64_t{form.offset.value()} + form.size.value() <= strings_size,
+            "Translation catalog plural form beyond string storage.");
+    }
+
+    _seeds = seeds.begin();
+    _messages = messages.begin();
+    _forms = forms.begin();
+    _strings = strings.begin();
+}
+
+[[nodiscard]] ssize_t translation_catalog::find(std::string_view msgid) const noexcept
+{
+    if (_nr_messages == 0) {
+        return -1;
+    }
+
+    ttlet hash = translation_catalog_hash(msgid);
+    ttlet seed = _seeds[translation_catalog_slot(hash, 0, _nr_buckets)].seed.value();
+    ttlet slot = translation_catalog_slot(hash, seed, _nr_messages);
+
+    // A msgid that is not in the catalog is also mapped to a slot.
+    if (this->msgid(slot) == msgid) {
+        return narrow_cast<ssize_t>(slot);
+    } else {
+        return -1;
+    }
+}
+
+[[nodiscard]] std::string_view translation_catalog::msgid(size_t index) const noexcept
+{
+    tt_axiom(index < _nr_messages);
+    ttlet &message = _messages[index];
+    return {_strings + message.msgid_offset.value(), message.msgid_size.value()};
+}
+
+[[nodiscard]] size_t translation_catalog::nr_plural_forms(size_t index) const noexcept
+{
+    tt_axiom(index < _nr_messages);
+    return _messages[index].nr_forms.value();
+}
+
+[[nodiscard]] std::string_view translation_catalog::plural_form(size_t index, size_t plurality) const noexcept
+{
+    tt_axiom(index < _nr_messages);
+    ttlet &message = _messages[index];
+    tt_axiom(plurality < message.nr_forms.value());
+
+    ttlet &form = _forms[message.first_form.value() + plurality];
+    return {_strings + form.offset.value(), form.size.value()};
+}
+
+[[nodiscard]] translation_catalog::message_map translation_catalog::messages() const noexcept
+{
+    auto r = message_map{};
+    for (auto index = 0_uz; index != _nr_messages; ++index) {
+        auto &forms = r[std::string{msgid(index)}];
+        for (auto plurality = 0_uz; plurality != nr_plural_forms(index); ++plurality) {
+            forms.emplace_back(plural_form(index, plurality));
+        }
+    }
+    return r;
+}
+
+} // namespace tt
@@ -0,0 +1,136 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include "../required.hpp"
+#include "../byte_string.hpp"
+#include "../resource_view.hpp"
+#include "../URL.hpp"
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tt {
+
+/** An immutable catalog of the translations of a single language.
+ *
+ * The catalog is stored in a single little-endian buffer, which can be written to disk
+ * and later memory-mapped:
+ *  - A header with the number of messages, buckets, plural forms and the size of the string storage.
+ *  - A seed for each bucket of a minimal perfect hash (hash and displace) over the msgids.
+ *  - A record for each message, at the slot given by the perfect hash, with the
+ *    offset of the msgid and the range of its plural forms.
+ *  - The offset and size of each plural form.
+ *  - The contiguous storage of the msgids and plural forms.
+ *
+ * Lookups do not allocate and do not take locks; a catalog can be shared between threads.
+ * Publishing a catalog to a language is described in `language::catalog`.
+ */
+class translation_catalog {
+public:
+    using message_map = std::map<std::string, std::vector<std::string>, std::less<>>;
+
+    translation_catalog(translation_catalog const &) = delete;
+    translation_catalog(translation_catalog &&) = delete;
+    translation_catalog &operator=(translation_catalog const &) = delete;
+    translation_catalog &operator=(translation_catalog &&) = delete;
+
+    /** Build a catalog.
+     *
+     * @param messages The plural forms of each msgid.
+     */
+    explicit translation_catalog(message_map const &messages);
+
+    /** Load a compiled catalog.
+     *
+     * @param bytes The buffer returned by `bytes()` of a catalog.
+     * @throw parse_error When the buffer is not a valid catalog.
+     */
+    explicit translation_catalog(bstring bytes);
+
+    /** Load a compiled catalog from a memory mapping.
+     *
+     * @param view The view of a file containing the buffer returned by `bytes()` of a catalog.
+     * @throw parse_error When the file is not a valid catalog.
+     */
+    explicit translation_catalog(std::unique_ptr<resource_view> view);
+
+    /** Load a compiled catalog from a file.
+     *
+     * @throw io_error, parse_error
+     */
+    explicit translation_catalog(URL const &url) : translation_catalog(url.loadView()) {}
+
+    /** The compiled catalog, to be written to disk.
+     */
+    [[nodiscard]] std::span<std::byte const> bytes() const noexcept
+    {
+        return _view ? _view->bytes() : std::span<std::byte const>{_bytes.data(), _bytes.size()};
+    }
+
+    /** The number of messages in the catalog.
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _nr_messages;
+    }
+
+    /** Find a message.
+     *
+     * @param msgid The message to find.
+     * @return The index of the message, or -1 when the message is not in the catalog.
+     */
+    [[nodiscard]] ssize_t find(std::string_view msgid) const noexcept;
+
+    /** The msgid of a message.
+     *
+     * @param index The index of a message, between 0 and `size()`.
+     */
+    [[nodiscard]] std::string_view msgid(size_t index) const noexcept;
+
+    /** The number of plural forms of a message.
+     *
+     * @param index The index of a message, between 0 and `size()`.
+     */
+    [[nodiscard]] size_t nr_plural_forms(size_t index) const noexcept;
+
+    /** A plural form of a message.
+     *
+     * @param index The index of a message, between 0 and `size()`.
+     * @param plurality The plural form, between 0 and `nr_plural_forms(index)`.
+     */
+    [[nodiscard]] std::string_view plural_form(size_t index, size_t plurality) const noexcept;
+
+    /** Get all the messages, used to build a new catalog with more translations.
+     */
+    [[nodiscard]] message_map messages() const noexcept;
+
+private:
+    struct header_type;
+    struct seed_type;
+    struct message_type;
+    struct form_type;
+
+    bstring _bytes;
+    std::unique_ptr<resource_view> _view;
+
+    size_t _nr_messages = 0;
+    size_t _nr_buckets = 0;
+    seed_type const *_seeds = nullptr;
+    message_type const *_messages = nullptr;
+    form_type const *_forms = nullptr;
+    char const *_strings = nullptr;
+
+    /** Validate the buffer and set the pointers to its tables.
+     *
+     * @throw parse_error
+     */
+    void attach();
+};
+
+} // namespace tt
@@ -0,0 +1,101 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include "ttauri/text/translation_catalog.hpp"
+#include "ttauri/text/translation.hpp"
+#include "ttauri/text/language.hpp"
+#include "ttauri/exception.hpp"
+#include "ttauri/cast.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace tt;
+
+namespace {
+
+[[nodiscard]] translation_catalog::message_map make_messages(size_t nr_messages)
+{
+    auto r = translation_catalog::message_map{};
+    for (auto i = 0_uz; i != nr_messages; ++i) {
+        auto &forms = r["message " + std::to_string(i)];
+        for (auto j = 0_uz; j != i % 4; ++j) {
+            forms.push_back("form " + std::to_string(i) + "." + std::to_string(j));
+        }
+    }
+    return r;
+}
+
+void check_catalog(translation_catalog const &catalog, translation_catalog::message_map const &messages)
+{
+    ASSERT_EQ(catalog.size(), messages.size());
+
+    for (ttlet &[msgid, forms] : messages) {
+        ASSERT_GE(catalog.find(msgid), 0);
+        ttlet index = narrow_cast<size_t>(catalog.find(msgid));
+        ASSERT_EQ(catalog.msgid(index), msgid);
+        ASSERT_EQ(catalog.nr_plural_forms(index), forms.size());
+        for (auto i = 0_uz; i != forms.size(); ++i) {
+            ASSERT_EQ(catalog.plural_form(index, i), forms[i]);
+        }
+    }
+
+    for (auto i = 0_uz; i != messages.size() + 10; ++i) {
+        ASSERT_EQ(catalog.find("unknown " + std::to_string(i)), -1);
+    }
+}
+
+} // namespace
+
+TEST(translation_catalog, lookup)
+{
+    for (ttlet nr_messages : {0_uz, 1_uz, 2_uz, 5_uz, 17_uz, 1000_uz}) {
+        ttlet messages = make_messages(nr_messages);
+        ttlet catalog = translation_catalog(messages);
+        check_catalog(catalog, messages);
+        ASSERT_EQ(catalog.messages(), messages);
+    }
+}
+
+TEST(translation_catalog, load)
+{
+    ttlet messages = make_messages(100);
+    ttlet catalog = translation_catalog(messages);
+    ttlet bytes = catalog.bytes();
+
+    ttlet loaded = translation_catalog(bstring{bytes.data(), bytes.size()});
+    check_catalog(loaded, messages);
+
+    // A truncated catalog is rejected when loaded.
+    ASSERT_THROW(translation_catalog(bstring{bytes.data(), bytes.size() - 1}), parse_error);
+    ASSERT_THROW(translation_catalog(bstring{bytes.data(), 10}), parse_error);
+}
+
+TEST(translation_catalog, add_translation)
+{
+    auto &language = language::find_or_create(language_tag("x-translation-test"));
+    ttlet languages = std::vector<tt::language *>{&language};
+
+    // Messages added one at a time are built into a single catalog on the next lookup.
+    ttlet generation = language::generation();
+    for (auto i = 0; i != 100; ++i) {
+        add_translation("message " + std::to_string(i), language, {"translation " + std::to_string(i)});
+    }
+    ASSERT_GT(language::generation(), generation);
+    ASSERT_EQ(get_translation("message 42", 0, languages), "translation 42");
+
+    ttlet catalog = language.catalog.load();
+    ASSERT_NE(catalog, nullptr);
+    ASSERT_EQ(catalog->size(), 100);
+
+    // A message that is added again replaces the previous translation, the previous
+    // catalog stays valid for a thread that still holds a pointer to it.
+    add_translation("message 42", language, {"replaced"});
+    ASSERT_EQ(get_translation("message 42", 0, languages), "replaced");
+    ASSERT_NE(language.catalog.load(), catalog);
+    ASSERT_EQ(language.catalog.load()->size(), 100);
+    ASSERT_EQ(catalog->plural_form(narrow_cast<size_t>(catalog->find("message 42")), 0), "translation 42");
+
+    ASSERT_EQ(get_translation("untranslated", 0, languages), "untranslated");
+}
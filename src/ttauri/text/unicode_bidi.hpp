@@ -7,6 +7,11 @@
 
 #include "unicode_bidi_class.hpp"
 #include "unicode_description.hpp"
+#include "../algorithm.hpp"
+#include "../cast.hpp"
+#include <array>
+#include <algorithm>
+#include <vector>
 
 namespace tt {
 namespace detail {
@@ -96,8 +101,118 @@ struct unicode_bidi_test_parameters {
     unicode_bidi_class force_paragraph_direction = unicode_bidi_class::unknown;
     bool enable_mirrored_brackets = true;
     bool enable_line_separator = true;
+    bool enable_fast_path = true;
 };
 
+/** The bidi class of each ASCII code-point.
+ * So that classifying a paragraph does not need to search the unicode database for the common characters.
+ */
+constexpr auto unicode_bidi_ascii_classes = []() {
+    using enum unicode_bidi_class;
+
+    auto r = std::array<unicode_bidi_class, 128>{};
+    for (auto c = 0_uz; c != r.size(); ++c) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            r[c] = L;
+        } else if (c >= '0' && c <= '9') {
+            r[c] = EN;
+        } else if (c == '#' || c == '$' || c == '%') {
+            r[c] = ET;
+        } else if (c == '+' || c == '-') {
+            r[c] = ES;
+        } else if (c == ',' || c == '.' || c == '/' || c == ':') {
+            r[c] = CS;
+        } else if (c == '\t' || c == 0x0b || c == 0x1f) {
+            r[c] = S;
+        } else if (c == '\n' || c == '\r' || (c >= 0x1c && c <= 0x1e)) {
+            r[c] = B;
+        } else if (c == ' ' || c == '\f') {
+            r[c] = WS;
+        } else if (c < 0x20 || c == 0x7f) {
+            r[c] = BN;
+        } else {
+            r[c] = ON;
+        }
+    }
+    return r;
+}();
+
+[[nodiscard]] inline unicode_bidi_class unicode_bidi_class_of(char32_t code_point) noexcept
+{
+    if (code_point < unicode_bidi_ascii_classes.size()) {
+        return unicode_bidi_ascii_classes[code_point];
+    } else {
+        return unicode_description_find(code_point).bidi_class();
+    }
+}
+
+/** The result of classifying a paragraph for the fast paths of the bidirectional algorithm.
+ */
+enum class unicode_bidi_fast_path {
+    /** The text needs the complete bidirectional algorithm. */
+    none,
+
+    /** All characters are resolved to embedding level 0; the text is left as-is. */
+    left_to_right,
+
+    /** All characters are resolved to embedding level 1; the text is reversed as a whole. */
+    right_to_left
+};
+
+/** Classify text to see if the bidirectional algorithm can be skipped.
+ *
+ * The bidi class of each character is or-ed into a mask, the text is trivial when the mask only
+ * contains classes which can not change the embedding level:
+ *  - left-to-right: strong left-to-right characters, european numbers and neutrals,
+ *    such text resolves to the paragraph level 0.
+ *  - right-to-left: strong right-to-left characters and neutrals, such text resolves
+ *    to the paragraph level 1 and is a single line.
+ *
+ * Boundary neutrals and explicit formatting characters are never trivial, since rule X9 removes them.
+ * Right-to-left text is not trivial when `enable_mirrored_brackets` is false, since the fast path
+ * mirrors the brackets.
+ */
+template<typename It, typename GetCodePoint>
+[[nodiscard]] unicode_bidi_fast_path
+unicode_bidi_classify(It first, It last, GetCodePoint get_code_point, unicode_bidi_test_parameters test_parameters) noexcept
+{
+    using enum unicode_bidi_class;
+
+    constexpr auto bit = [](unicode_bidi_class bidi_class) {
+        return uint32_t{1} << static_cast<int>(bidi_class);
+    };
+    constexpr auto neutral_mask = bit(ES) | bit(ET) | bit(CS) | bit(NSM) | bit(WS) | bit(ON);
+    constexpr auto left_to_right_mask = neutral_mask | bit(L) | bit(EN) | bit(B) | bit(S);
+    constexpr auto right_to_left_mask = neutral_mask | bit(R) | bit(AL);
+
+    if (not test_parameters.enable_fast_path or test_parameters.force_paragraph_direction != unknown) {
+        return unicode_bidi_fast_path::none;
+    }
+
+    auto classes = uint32_t{0};
+    for (auto it = first; it != last; ++it) {
+        ttlet code_point = get_code_point(*it);
+        classes |= bit(unicode_bidi_class_of(code_point));
+        if (code_point == U'\u2028') {
+            // A line separator splits right-to-left text in lines that are reversed separately.
+            classes |= bit(B);
+        }
+
+        if ((classes & left_to_right_mask) != classes && (classes & right_to_left_mask) != classes) {
+            return unicode_bidi_fast_path::none;
+        }
+    }
+
+    // Text without strong characters gets the left-to-right paragraph direction.
+    if ((classes & left_to_right_mask) == classes) {
+        return unicode_bidi_fast_path::left_to_right;
+    } else if (test_parameters.enable_mirrored_brackets) {
+        return unicode_bidi_fast_path::right_to_left;
+    } else {
+        return unicode_bidi_fast_path::none;
+    }
+}
+
 [[nodiscard]] unicode_bidi_char_info_iterator unicode_bidi_P1(
     unicode_bidi_char_info_iterator first,
     unicode_bidi_char_info_iterator last,
@@ -105,6 +220,22 @@ struct unicode_bidi_test_parameters {
 
 } // namespace detail
 
+/** A run of characters with the same embedding level.
+ */
+struct unicode_bidi_run {
+    /** The index of the first character of the run in the original text.
+     */
+    size_t first;
+
+    /** The index one beyond the last character of the run in the original text.
+     */
+    size_t last;
+
+    /** The embedding level of the run, the characters are displayed right-to-left when the level is odd.
+     */
+    int8_t embedding_level;
+};
+
 /** Reorder a given range of characters based on the unicode_bidi algorithm.
  * This algorithm will:
  *  - Reorder the list of items
@@ -136,6 +267,22 @@ It unicode_bidi(
     SetCodePoint set_code_point,
     detail::unicode_bidi_test_parameters test_parameters = {})
 {
+    switch (detail::unicode_bidi_classify(first, last, get_code_point, test_parameters)) {
+    case detail::unicode_bidi_fast_path::left_to_right: return last;
+
+    case detail::unicode_bidi_fast_path::right_to_left:
+        std::reverse(first, last);
+        for (auto it = first; it != last; ++it) {
+            ttlet &description = unicode_description_find(get_code_point(*it));
+            if (description.bidi_bracket_type() != unicode_bidi_bracket_type::n) {
+                set_code_point(*it, description.bidi_mirrored_glyph());
+            }
+        }
+        return last;
+
+    default:;
+    }
+
     auto proxy = detail::unicode_bidi_char_info_vector{};
     proxy.reserve(std::distance(first, last));
 
@@ -153,4 +300,70 @@ It unicode_bidi(
     return last;
 }
 
+/** Find the runs of characters with the same embedding level.
+ *
+ * The text is not reordered, so that each run can be shaped separately. Runs are
+ * reordered for display after shaping, when the text has been broken into lines.
+ * Characters that are removed by the bidirectional algorithm, such as explicit formatting
+ * characters, are given the embedding level of the preceding character.
+ *
+ * @param first The first iterator
+ * @param last The last iterator
+ * @param get_code_point A function to get the character from an item.
+ * @return The runs in the original order of the text.
+ */
+template<typename It, typename GetCodePoint>
+[[nodiscard]] std::vector<unicode_bidi_run> unicode_bidi_runs(
+    It first,
+    It last,
+    GetCodePoint get_code_point,
+    detail::unicode_bidi_test_parameters test_parameters = {})
+{
+    ttlet size = narrow_cast<size_t>(std::distance(first, last));
+
+    auto r = std::vector<unicode_bidi_run>{};
+    if (size == 0) {
+        return r;
+    }
+
+    switch (detail::unicode_bidi_classify(first, last, get_code_point, test_parameters)) {
+    case detail::unicode_bidi_fast_path::left_to_right: r.push_back({0, size, 0}); return r;
+    case detail::unicode_bidi_fast_path::right_to_left: r.push_back({0, size, 1}); return r;
+    default:;
+    }
+
+    auto proxy = detail::unicode_bidi_char_info_vector{};
+    proxy.reserve(size);
+
+    size_t index = 0;
+    for (auto it = first; it != last; ++it) {
+        proxy.emplace_back(index++, get_code_point(*it));
+    }
+
+    ttlet proxy_last = detail::unicode_bidi_P1(std::begin(proxy), std::end(proxy), test_parameters);
+
+    // The reordered characters still know their original index.
+    auto levels = std::vector<int8_t>(size, int8_t{-1});
+    for (auto it = std::begin(proxy); it != proxy_last; ++it) {
+        levels[it->index] = it->embedding_level;
+    }
+
+    ttlet first_level = std::find_if(std::begin(levels), std::end(levels), [](ttlet level) {
+        return level >= 0;
+    });
+    auto level = first_level != std::end(levels) ? *first_level : int8_t{0};
+    for (auto i = 0_uz; i != size; ++i) {
+        if (levels[i] >= 0) {
+            level = levels[i];
+        }
+
+        if (r.empty() || r.back().embedding_level != level) {
+            r.push_back({i, i + 1, level});
+        } else {
+            r.back().last = i + 1;
+        }
+    }
+    return r;
+}
+
 } // namespace tt
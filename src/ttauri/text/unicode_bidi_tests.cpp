@@ -13,6 +13,7 @@
 #include <string_view>
 #include <span>
 #include <format>
+#include <random>
 
 using namespace tt;
 using namespace tt::detail;
@@ -319,3 +320,115 @@ TEST(unicode_bidi, bidi_character_test)
         }
     }
 }
+
+TEST(unicode_bidi, ascii_classes)
+{
+    for (char32_t c = 0; c != 128; ++c) {
+        ASSERT_EQ(unicode_bidi_ascii_classes[c], unicode_description_find(c).bidi_class());
+    }
+}
+
+TEST(unicode_bidi, fast_path)
+{
+    // Latin, Hebrew and Arabic letters, European and Arabic digits, brackets, separators and formatting characters.
+    constexpr auto characters = std::u32string_view{U"ab1 ,.-+#()[]\t\u05d0\u05d1\u0627\u0661\u0300\u00ad\u200f\u2028\u2067\u2069"};
+
+    auto rng = std::mt19937{42};
+    for (auto i = 0; i != 10'000; ++i) {
+        // Mostly use a few of the characters, so that many strings are left-to-right or right-to-left only.
+        ttlet nr_characters = 1 + rng() % characters.size();
+        ttlet offset = rng() % (characters.size() - nr_characters + 1);
+
+        auto text = std::u32string{};
+        ttlet length = rng() % 20;
+        for (auto j = 0_uz; j != length; ++j) {
+            text += characters[offset + rng() % nr_characters];
+        }
+
+        auto fast = text;
+        auto fast_last = unicode_bidi(
+            std::begin(fast),
+            std::end(fast),
+            [](ttlet &c) {
+                return c;
+            },
+            [](auto &c, ttlet code_point) {
+                c = code_point;
+            });
+
+        auto slow = text;
+        auto slow_last = unicode_bidi(
+            std::begin(slow),
+            std::end(slow),
+            [](ttlet &c) {
+                return c;
+            },
+            [](auto &c, ttlet code_point) {
+                c = code_point;
+            },
+            {.enable_fast_path = false});
+
+        ASSERT_EQ(std::distance(std::begin(fast), fast_last), std::distance(std::begin(slow), slow_last));
+        ASSERT_TRUE(std::equal(std::begin(fast), fast_last, std::begin(slow)));
+    }
+}
+
+TEST(unicode_bidi, fast_path_parameters)
+{
+    auto get_code_point = [](ttlet &c) {
+        return c;
+    };
+
+    constexpr auto left_to_right = std::u32string_view{U"a (b) 1"};
+    constexpr auto right_to_left = std::u32string_view{U"\u05d0 (\u05d1)"};
+
+    ASSERT_EQ(
+        unicode_bidi_classify(left_to_right.begin(), left_to_right.end(), get_code_point, {}),
+        unicode_bidi_fast_path::left_to_right);
+    ASSERT_EQ(
+        unicode_bidi_classify(right_to_left.begin(), right_to_left.end(), get_code_point, {}),
+        unicode_bidi_fast_path::right_to_left);
+
+    // The right-to-left fast path mirrors brackets, so it is not used when mirroring is disabled.
+    ASSERT_EQ(
+        unicode_bidi_classify(left_to_right.begin(), left_to_right.end(), get_code_point, {.enable_mirrored_brackets = false}),
+        unicode_bidi_fast_path::left_to_right);
+    ASSERT_EQ(
+        unicode_bidi_classify(right_to_left.begin(), right_to_left.end(), get_code_point, {.enable_mirrored_brackets = false}),
+        unicode_bidi_fast_path::none);
+
+    ASSERT_EQ(
+        unicode_bidi_classify(left_to_right.begin(), left_to_right.end(), get_code_point, {.enable_fast_path = false}),
+        unicode_bidi_fast_path::none);
+}
+
+TEST(unicode_bidi, runs)
+{
+    auto get_code_point = [](ttlet &c) {
+        return c;
+    };
+
+    ttlet ltr = std::u32string{U"abc (def)"};
+    ttlet ltr_runs = unicode_bidi_runs(std::begin(ltr), std::end(ltr), get_code_point);
+    ASSERT_EQ(ltr_runs.size(), 1);
+    ASSERT_EQ(ltr_runs[0].last, ltr.size());
+    ASSERT_EQ(ltr_runs[0].embedding_level, 0);
+
+    ttlet rtl = std::u32string{U"\u05d0\u05d1 (\u05d2)"};
+    ttlet rtl_runs = unicode_bidi_runs(std::begin(rtl), std::end(rtl), get_code_point);
+    ASSERT_EQ(rtl_runs.size(), 1);
+    ASSERT_EQ(rtl_runs[0].embedding_level, 1);
+
+    ttlet mixed = std::u32string{U"abc \u05d0\u05d1 def"};
+    ttlet mixed_runs = unicode_bidi_runs(std::begin(mixed), std::end(mixed), get_code_point);
+    ASSERT_EQ(mixed_runs.size(), 3);
+    ASSERT_EQ(mixed_runs[0].first, 0);
+    ASSERT_EQ(mixed_runs[0].last, 4);
+    ASSERT_EQ(mixed_runs[0].embedding_level, 0);
+    ASSERT_EQ(mixed_runs[1].first, 4);
+    ASSERT_EQ(mixed_runs[1].last, 6);
+    ASSERT_EQ(mixed_runs[1].embedding_level, 1);
+    ASSERT_EQ(mixed_runs[2].first, 6);
+    ASSERT_EQ(mixed_runs[2].last, mixed.size());
+    ASSERT_EQ(mixed_runs[2].embedding_level, 0);
+}
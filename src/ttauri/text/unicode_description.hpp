@@ -8,6 +8,8 @@
 #include "unicode_bidi_class.hpp"
 #include "unicode_bidi_bracket_type.hpp"
 #include "unicode_grapheme_cluster_break.hpp"
+#include "unicode_line_break_class.hpp"
+#include "unicode_word_break_property.hpp"
 #include "../required.hpp"
 #include "../assert.hpp"
 
@@ -66,6 +68,8 @@ public:
         char32_t code_point,
         unicode_general_category general_category,
         unicode_grapheme_cluster_break grapheme_cluster_break,
+        unicode_line_break_class line_break_class,
+        unicode_word_break_property word_break_property,
         unicode_bidi_class bidi_class,
         unicode_bidi_bracket_type bidi_bracket_type,
         char32_t bidi_mirrored_glyph,
@@ -83,11 +87,15 @@ public:
         _composition_canonical(static_cast<uint32_t>(composition_canonical)),
         _combining_class(static_cast<uint32_t>(combining_class)),
         _decomposition_index(static_cast<uint32_t>(decomposition_index)),
-        _decomposition_length(static_cast<uint32_t>(decomposition_length))
+        _decomposition_length(static_cast<uint32_t>(decomposition_length)),
+        _line_break_class(static_cast<uint32_t>(line_break_class)),
+        _word_break_property(static_cast<uint32_t>(word_break_property))
     {
         tt_axiom(code_point <= 0x10ffff);
         tt_axiom(static_cast<uint32_t>(general_category) <= 0x1f);
         tt_axiom(static_cast<uint32_t>(grapheme_cluster_break) <= 0x0f);
+        tt_axiom(static_cast<uint32_t>(line_break_class) <= 0x3f);
+        tt_axiom(static_cast<uint32_t>(word_break_property) <= 0x1f);
         tt_axiom(static_cast<uint32_t>(bidi_class) <= 0x1f);
         tt_axiom(static_cast<uint32_t>(bidi_bracket_type) <= 0x03);
         tt_axiom(static_cast<uint32_t>(bidi_mirrored_glyph) <= 0x10ffff);
@@ -115,6 +123,26 @@ public:
         return static_cast<unicode_grapheme_cluster_break>((_general_info >> 1) & 0xf);
     }
 
+    /** The line break class of this code-point.
+     * This function is used to determine where a line of text may be broken.
+     *
+     * @return The line break class of this code-point, after resolving the classes of rule LB1.
+     */
+    [[nodiscard]] constexpr unicode_line_break_class line_break_class() const noexcept
+    {
+        return static_cast<unicode_line_break_class>(_line_break_class);
+    }
+
+    /** The word break property of this code-point.
+     * This function is used to determine where to break a string of code-points into words.
+     *
+     * @return The word break property of this code-point.
+     */
+    [[nodiscard]] constexpr unicode_word_break_property word_break_property() const noexcept
+    {
+        return static_cast<unicode_word_break_property>(_word_break_property);
+    }
+
     /** The general category of this code-point.
      * This function is used to determine what kind of code-point this,
      * this allows you to determine if the code-point is a letter, number, punctuation, white-space, etc.
@@ -257,7 +285,9 @@ private:
 
     // 4th dword
     uint32_t _decomposition_length : 5;
-    uint32_t _decomposition_reserved2 : 27 = 0;
+    uint32_t _line_break_class : 6;
+    uint32_t _word_break_property : 5;
+    uint32_t _segmentation_reserved : 16 = 0;
 
 
     template<typename It>
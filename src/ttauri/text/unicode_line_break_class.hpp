@@ -0,0 +1,60 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace tt {
+
+/** Line breaking class.
+ * Unicode Standard Annex #14: https://unicode.org/reports/tr14/
+ *
+ * Only the classes that remain after resolving AI, SG, XX, SA and CJ (rule LB1) are listed.
+ */
+enum class unicode_line_break_class : uint8_t {
+    AL, ///< Alphabetic
+    BK, ///< Mandatory Break
+    CR, ///< Carriage Return
+    LF, ///< Line Feed
+    NL, ///< Next Line
+    CM, ///< Combining Mark
+    ZWJ, ///< Zero Width Joiner
+    SP, ///< Space
+    ZW, ///< Zero Width Space
+    WJ, ///< Word Joiner
+    GL, ///< Non-breaking ("Glue")
+    B2, ///< Break Opportunity Before and After
+    BA, ///< Break After
+    BB, ///< Break Before
+    HY, ///< Hyphen
+    CB, ///< Contingent Break Opportunity
+    CL, ///< Close Punctuation
+    CP, ///< Close Parenthesis
+    EX, ///< Exclamation/Interrogation
+    IN, ///< Inseparable
+    NS, ///< Nonstarter
+    OP, ///< Open Punctuation
+    QU, ///< Quotation
+    IS, ///< Infix Numeric Separator
+    NU, ///< Numeric
+    PO, ///< Postfix Numeric
+    PR, ///< Prefix Numeric
+    SY, ///< Symbols Allowing Break After
+    HL, ///< Hebrew Letter
+    ID, ///< Ideographic
+    JL, ///< Hangul L Jamo
+    JV, ///< Hangul V Jamo
+    JT, ///< Hangul T Jamo
+    H2, ///< Hangul LV Syllable
+    H3, ///< Hangul LVT Syllable
+    RI, ///< Regional Indicator
+    EB, ///< Emoji Base
+    EM ///< Emoji Modifier
+};
+
+constexpr size_t unicode_line_break_class_count = static_cast<size_t>(unicode_line_break_class::EM) + 1;
+
+}
@@ -8,6 +8,8 @@
 #include "ttauri/text/unicode_db.hpp"
 #include "../assert.hpp"
 #include "../required.hpp"
+#include <vector>
+#include <algorithm>
 
 namespace tt {
 
@@ -222,6 +224,55 @@ unicode_NFC(std::u32string_view text, bool ligatures, bool paragraph, bool compo
     return r;
 }
 
+/** Check if a starter may compose with the code-point before it.
+ */
+[[nodiscard]] static bool is_composing_starter(char32_t code_point) noexcept
+{
+    static ttlet starters = [] {
+        auto r = std::vector<char32_t>{};
+        for (ttlet &composition : detail::unicode_db_composition_table) {
+            if (unicode_description_find(composition.second()).combining_class() == 0) {
+                r.push_back(composition.second());
+            }
+        }
+        std::sort(r.begin(), r.end());
+        r.erase(std::unique(r.begin(), r.end()), r.end());
+        return r;
+    }();
+
+    return is_hangul_V_part(code_point) || is_hangul_T_part(code_point) ||
+        std::binary_search(starters.begin(), starters.end(), code_point);
+}
+
+[[nodiscard]] bool unicode_NFC_quick_check(std::u32string_view text, bool ligatures, bool paragraph, bool composeCRLF) noexcept
+{
+    for (ttlet code_point : text) {
+        if ((paragraph && code_point == U'\n') || (composeCRLF && code_point == U'\r')) {
+            return false;
+        }
+
+        ttlet &description = unicode_description_find(code_point);
+        if (description.combining_class() != 0) {
+            // Non-starters may need to be reordered or composed.
+            return false;
+        }
+
+        if (description.decomposition_length() != 0) {
+            if (description.decomposition_canonical() && !description.composition_canonical()) {
+                // Singletons and composition exclusions are replaced by their decomposition.
+                return false;
+            } else if (ligatures && is_typographical_ligature(code_point)) {
+                return false;
+            }
+        }
+
+        if (is_composing_starter(code_point)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::u32string unicode_NFKD(std::u32string_view text, bool paragraph) noexcept
 {
     auto r = std::u32string{};
@@ -241,4 +292,73 @@ std::u32string unicode_NFKC(std::u32string_view text, bool paragraph, bool compo
     return r;
 }
 
+unicode_normalizer::unicode_normalizer(
+    unicode_normalization_form form,
+    bool ligatures,
+    bool paragraph,
+    bool composeCRLF) noexcept :
+    _compatible(form == unicode_normalization_form::NFKD || form == unicode_normalization_form::NFKC),
+    _compose(form == unicode_normalization_form::NFC || form == unicode_normalization_form::NFKC),
+    _ligatures(ligatures),
+    _paragraph(paragraph),
+    _composeCRLF(composeCRLF && _compose)
+{
+}
+
+void unicode_normalizer::reset() noexcept
+{
+    _decomposed.clear();
+    _nr_non_starters = 0;
+    _normalized.clear();
+}
+
+[[nodiscard]] std::u32string_view unicode_normalizer::normalize(std::u32string_view text, bool last) noexcept
+{
+    // The start of the last combining sequence, the code-points before it can be normalized
+    // without knowing the rest of the text.
+    auto boundary = 0_uz;
+
+    for (ttlet code_point : text) {
+        auto i = _decomposed.size();
+        unicode_decompose(code_point, _compatible, _ligatures, _paragraph, _decomposed);
+
+        for (; i != _decomposed.size(); ++i) {
+            ttlet code_unit = _decomposed[i];
+
+            if ((code_unit >> 24) != 0) {
+                if (++_nr_non_starters > max_non_starters) {
+                    // Stream-Safe Text Process: break up the sequence of non-starters with a
+                    // combining-grapheme-joiner, which is a starter that does not compose.
+                    _decomposed.insert(i, 1, U'\u034f');
+                    boundary = i++;
+                    _nr_non_starters = 1;
+                }
+
+            } else {
+                _nr_non_starters = 0;
+
+                ttlet after_CR = _composeCRLF && i != 0 && (_decomposed[i - 1] & 0x1f'ffff) == U'\r';
+                if (i != 0 && !after_CR && !(_compose && is_composing_starter(code_unit))) {
+                    boundary = i;
+                }
+            }
+        }
+    }
+
+    if (last) {
+        boundary = _decomposed.size();
+        _nr_non_starters = 0;
+    }
+
+    _normalized.assign(_decomposed, 0, boundary);
+    _decomposed.erase(0, boundary);
+
+    unicode_reorder(_normalized);
+    if (_compose) {
+        unicode_compose(_paragraph, _composeCRLF, _normalized);
+    }
+    unicode_clean(_normalized);
+    return _normalized;
+}
+
 }
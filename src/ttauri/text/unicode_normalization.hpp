@@ -7,6 +7,8 @@
 #include "../algorithm.hpp"
 #include <string>
 #include <string_view>
+#include <algorithm>
+#include <cstdint>
 
 
 namespace tt {
@@ -34,6 +36,21 @@ std::u32string unicode_NFD(std::u32string_view text, bool ligatures = false, boo
 unicode_NFC(std::u32string_view text, bool ligatures = false, bool paragraph = false, bool composeCRLF = false)
     noexcept;
 
+/** Check if text is already in Unicode-NFC normal form.
+ *
+ * This is a quick check based on the properties of each code-point, and may
+ * return false for text that is in NFC.
+ *
+ * @param text to check.
+ * @param ligatures typographical-ligatures such as "fi" are decomposed.
+ * @param paragraph line-feed characters are converted to paragraph separators.
+ * @param composeCRLF Compose CR-LF combinations to LF.
+ * @return true when `unicode_NFC()` with the same arguments would return the text unmodified.
+ */
+[[nodiscard]] bool
+unicode_NFC_quick_check(std::u32string_view text, bool ligatures = false, bool paragraph = false, bool composeCRLF = false)
+    noexcept;
+
 /** Convert text to Unicode-NFKD normal form.
  * Code point 0x00'ffff is used internally, do not pass in text.
  *
@@ -51,4 +68,102 @@ std::u32string unicode_NFKD(std::u32string_view text, bool paragraph = false) no
  */
 std::u32string unicode_NFKC(std::u32string_view text, bool paragraph = false, bool composeCRLF = false) noexcept;
 
+enum class unicode_normalization_form : uint8_t {
+    NFD,
+    NFC,
+    NFKD,
+    NFKC
+};
+
+/** An incremental unicode normalizer.
+ *
+ * Text is passed to the normalizer in chunks of code-points, the normalized text is written
+ * to an output iterator. Only the last combining sequence of a chunk is buffered, as it may
+ * be extended by the next chunk.
+ *
+ * The output is in the stream-safe text format of UAX #15: a combining-grapheme-joiner U+034F
+ * is inserted in a sequence of more than 30 non-starters. This bounds the size of the buffer.
+ */
+class unicode_normalizer {
+public:
+    /** The maximum number of non-starters in a row, before a U+034F is inserted.
+     */
+    static constexpr size_t max_non_starters = 30;
+
+    /** Construct a normalizer.
+     *
+     * @param form The normalization form.
+     * @param ligatures typographical-ligatures such as "fi" are decomposed, for NFD and NFC.
+     * @param paragraph line-feed characters are converted to paragraph separators.
+     * @param composeCRLF Compose CR-LF combinations to LF, for NFC and NFKC.
+     */
+    unicode_normalizer(
+        unicode_normalization_form form,
+        bool ligatures = false,
+        bool paragraph = false,
+        bool composeCRLF = false) noexcept;
+
+    unicode_normalizer(unicode_normalizer const &) = default;
+    unicode_normalizer(unicode_normalizer &&) noexcept = default;
+    unicode_normalizer &operator=(unicode_normalizer const &) = default;
+    unicode_normalizer &operator=(unicode_normalizer &&) noexcept = default;
+
+    /** Normalize the next chunk of text.
+     *
+     * @param text The next chunk of the text to normalize.
+     * @param out The output iterator where the normalized code-points are written.
+     * @return The output iterator after the last written code-point.
+     */
+    template<typename OutputIt>
+    OutputIt write(std::u32string_view text, OutputIt out) noexcept
+    {
+        ttlet normalized = normalize(text, false);
+        return std::copy(normalized.begin(), normalized.end(), out);
+    }
+
+    /** Normalize the code-points that are still buffered at the end of the text.
+     * After flushing the normalizer can be used for a new text.
+     *
+     * @param out The output iterator where the normalized code-points are written.
+     * @return The output iterator after the last written code-point.
+     */
+    template<typename OutputIt>
+    OutputIt flush(OutputIt out) noexcept
+    {
+        ttlet normalized = normalize({}, true);
+        return std::copy(normalized.begin(), normalized.end(), out);
+    }
+
+    /** Discard the buffered code-points, to start a new text.
+     */
+    void reset() noexcept;
+
+private:
+    bool _compatible;
+    bool _compose;
+    bool _ligatures;
+    bool _paragraph;
+    bool _composeCRLF;
+
+    /** Decomposed code-points, with the combining class in the upper bits, which are not yet normalized.
+     */
+    std::u32string _decomposed;
+
+    /** The number of non-starters at the end of `_decomposed`.
+     */
+    size_t _nr_non_starters = 0;
+
+    /** The normalized text of the last chunk.
+     */
+    std::u32string _normalized;
+
+    /** Normalize a chunk of text.
+     *
+     * @param text The next chunk of the text to normalize.
+     * @param last The end of the text is reached, all buffered code-points are normalized.
+     * @return The normalized code-points, valid until the next call.
+     */
+    [[nodiscard]] std::u32string_view normalize(std::u32string_view text, bool last) noexcept;
+};
+
 }
@@ -317,3 +317,59 @@ TEST_F(unicode_normalization, Invariant)
     }
 }
 #endif
+
+/** Normalize text in chunks of the given size.
+ */
+static std::u32string normalize_in_chunks(unicode_normalizer &normalizer, std::u32string_view text, size_t chunk_size)
+{
+    auto r = std::u32string{};
+    for (size_t i = 0; i < text.size(); i += chunk_size) {
+        normalizer.write(text.substr(i, chunk_size), std::back_inserter(r));
+    }
+    normalizer.flush(std::back_inserter(r));
+    return r;
+}
+
+TEST_F(unicode_normalization, normalizer)
+{
+    auto NFD = unicode_normalizer(unicode_normalization_form::NFD);
+    auto NFC = unicode_normalizer(unicode_normalization_form::NFC);
+    auto NFKD = unicode_normalizer(unicode_normalization_form::NFKD);
+    auto NFKC = unicode_normalizer(unicode_normalization_form::NFKC);
+
+    auto text = std::u32string{};
+    for (ttlet &test : normalizationTests) {
+        ASSERT_TRUE(normalize_in_chunks(NFD, test.c1, 1) == test.c3) << test.comment;
+        ASSERT_TRUE(normalize_in_chunks(NFC, test.c1, 1) == test.c2) << test.comment;
+        ASSERT_TRUE(normalize_in_chunks(NFKD, test.c1, 1) == test.c5) << test.comment;
+        ASSERT_TRUE(normalize_in_chunks(NFKC, test.c1, 1) == test.c4) << test.comment;
+        text += test.c1;
+    }
+
+    // The whole file in chunks which do not line up with the combining sequences.
+    ASSERT_TRUE(normalize_in_chunks(NFC, text, 4093) == unicode_NFC(text));
+    ASSERT_TRUE(normalize_in_chunks(NFKD, text, 4093) == unicode_NFKD(text));
+}
+
+TEST_F(unicode_normalization, normalizer_CRLF)
+{
+    auto normalizer = unicode_normalizer(unicode_normalization_form::NFC, false, true, true);
+    ASSERT_TRUE(normalize_in_chunks(normalizer, U"a\r\nb\nc\r", 2) == U"a\u2029b\u2029c\r");
+}
+
+TEST_F(unicode_normalization, normalizer_stream_safe)
+{
+    auto normalizer = unicode_normalizer(unicode_normalization_form::NFD);
+
+    // A combining grapheme joiner is inserted after 30 non-starters.
+    auto text = std::u32string{U"a"};
+    auto expected = std::u32string{U"a"};
+    for (auto i = 0; i != 40; ++i) {
+        text += U'\u0301';
+        if (i == 30) {
+            expected += U'\u034f';
+        }
+        expected += U'\u0301';
+    }
+    ASSERT_TRUE(normalize_in_chunks(normalizer, text, 7) == expected);
+}
@@ -5,97 +5,523 @@
 #include "unicode_text_segmentation.hpp"
 #include "unicode_description.hpp"
 #include "../required.hpp"
+#include <array>
 
 namespace tt {
 
-[[nodiscard]] static bool
-breaks_grapheme(unicode_grapheme_cluster_break cluster_break, grapheme_break_state &state) noexcept
+using grapheme_break_dfa_state = detail::grapheme_break_dfa_state;
+
+constexpr size_t grapheme_break_dfa_state_count = static_cast<size_t>(grapheme_break_dfa_state::start) + 1;
+constexpr size_t grapheme_cluster_break_count = static_cast<size_t>(unicode_grapheme_cluster_break::Extended_Pictographic) + 1;
+
+/** The grapheme cluster break property of the code-point that caused a state.
+ */
+[[nodiscard]] constexpr unicode_grapheme_cluster_break grapheme_break_dfa_property(grapheme_break_dfa_state state) noexcept
 {
     using enum unicode_grapheme_cluster_break;
 
-    ttlet lhs = state.previous;
-    ttlet rhs = cluster_break;
+    switch (state) {
+    case grapheme_break_dfa_state::pictographic_extend: return Extend;
+    case grapheme_break_dfa_state::pictographic_ZWJ: return ZWJ;
+    case grapheme_break_dfa_state::RI_pair: return Regional_Indicator;
+    default: return static_cast<unicode_grapheme_cluster_break>(state);
+    }
+}
 
-    enum class break_state {
-        unknown,
-        do_break,
-        dont_break,
-    };
+/** Apply the rules of UAX #29 to find a grapheme break between the previous code-point and the next.
+ *
+ * @param state The state after the previous code-point.
+ * @param rhs The grapheme cluster break property of the next code-point.
+ * @return true when there is a grapheme break before the next code-point.
+ */
+[[nodiscard]] constexpr bool grapheme_break_rule(grapheme_break_dfa_state state, unicode_grapheme_cluster_break rhs) noexcept
+{
+    using enum unicode_grapheme_cluster_break;
+
+    if (state == grapheme_break_dfa_state::start) {
+        // GB1
+        return true;
+    }
 
-    break_state break_state = break_state::unknown;
+    ttlet lhs = grapheme_break_dfa_property(state);
 
-    bool GB1 = state.first_character;
-    if ((break_state == break_state::unknown) & GB1) {
-        break_state = break_state::do_break;
+    if (lhs == CR && rhs == LF) {
+        // GB3
+        return false;
+    } else if (lhs == Control || lhs == CR || lhs == LF || rhs == Control || rhs == CR || rhs == LF) {
+        // GB4, GB5
+        return true;
+    } else if (lhs == L && (rhs == L || rhs == V || rhs == LV || rhs == LVT)) {
+        // GB6
+        return false;
+    } else if ((lhs == LV || lhs == V) && (rhs == V || rhs == T)) {
+        // GB7
+        return false;
+    } else if ((lhs == LVT || lhs == T) && rhs == T) {
+        // GB8
+        return false;
+    } else if (rhs == Extend || rhs == ZWJ || rhs == SpacingMark || lhs == Prepend) {
+        // GB9, GB9a, GB9b
+        return false;
+    } else if (state == grapheme_break_dfa_state::pictographic_ZWJ && rhs == Extended_Pictographic) {
+        // GB11
+        return false;
+    } else if (state == static_cast<grapheme_break_dfa_state>(Regional_Indicator) && rhs == Regional_Indicator) {
+        // GB12, GB13
+        return false;
+    } else {
+        // GB999
+        return true;
     }
+}
 
-    state.first_character = false;
+/** The state after the next code-point.
+ */
+[[nodiscard]] constexpr grapheme_break_dfa_state
+grapheme_break_next_state(grapheme_break_dfa_state state, unicode_grapheme_cluster_break rhs) noexcept
+{
+    using enum unicode_grapheme_cluster_break;
 
-    ttlet GB3 = (lhs == CR) && (rhs == LF);
-    ttlet GB4 = (lhs == Control) || (lhs == CR) || (lhs == LF);
-    ttlet GB5 = (rhs == Control) || (rhs == CR) || (rhs == LF);
-    if (break_state == break_state::unknown) {
-        if (GB3) {
-            break_state = break_state::dont_break;
-        } else if (GB4 || GB5) {
-            break_state = break_state::do_break;
-        }
+    ttlet in_pictographic = state == static_cast<grapheme_break_dfa_state>(Extended_Pictographic) ||
+        state == grapheme_break_dfa_state::pictographic_extend;
+
+    if (in_pictographic && rhs == Extend) {
+        return grapheme_break_dfa_state::pictographic_extend;
+    } else if (in_pictographic && rhs == ZWJ) {
+        return grapheme_break_dfa_state::pictographic_ZWJ;
+    } else if (state == static_cast<grapheme_break_dfa_state>(Regional_Indicator) && rhs == Regional_Indicator) {
+        return grapheme_break_dfa_state::RI_pair;
+    } else {
+        return static_cast<grapheme_break_dfa_state>(rhs);
     }
+}
 
-    ttlet GB6 = (lhs == L) &&
-        ((rhs == L) || (rhs == V) ||
-         (rhs == LV) | (rhs == LVT));
-    ttlet GB7 = ((lhs == LV) || (lhs == V)) &&
-        ((rhs == V) || (rhs == T));
-    ttlet GB8 = ((lhs == LVT) || (lhs == T)) && (rhs == T);
-    if ((break_state == break_state::unknown) && (GB6 || GB7 || GB8)) {
-        break_state = break_state::dont_break;
+/** The transition table of the grapheme-break state machine.
+ * Each entry contains the next state in bits [6:0] and bit 7 is set when there is a break
+ * before the code-point.
+ */
+constexpr auto grapheme_break_dfa_table = [] {
+    auto r = std::array<std::array<uint8_t, grapheme_cluster_break_count>, grapheme_break_dfa_state_count>{};
+
+    for (size_t i = 0; i != grapheme_break_dfa_state_count; ++i) {
+        ttlet state = static_cast<grapheme_break_dfa_state>(i);
+        for (size_t j = 0; j != grapheme_cluster_break_count; ++j) {
+            ttlet rhs = static_cast<unicode_grapheme_cluster_break>(j);
+            r[i][j] = static_cast<uint8_t>(
+                static_cast<uint8_t>(grapheme_break_next_state(state, rhs)) | (grapheme_break_rule(state, rhs) ? 0x80 : 0x00));
+        }
     }
+    return r;
+}();
+
+[[nodiscard]] static bool
+breaks_grapheme(unicode_grapheme_cluster_break cluster_break, grapheme_break_state &state) noexcept
+{
+    tt_axiom(static_cast<size_t>(state.state) < grapheme_break_dfa_state_count);
+    tt_axiom(static_cast<size_t>(cluster_break) < grapheme_cluster_break_count);
 
-    ttlet GB9 = ((rhs == Extend) || (rhs == ZWJ));
-    ttlet GB9a = (rhs == SpacingMark);
-    ttlet GB9b = (lhs == Prepend);
-    if ((break_state == break_state::unknown) & (GB9 || GB9a || GB9b)) {
-        break_state = break_state::dont_break;
+    ttlet transition = grapheme_break_dfa_table[static_cast<size_t>(state.state)][static_cast<size_t>(cluster_break)];
+    state.state = static_cast<grapheme_break_dfa_state>(transition & 0x7f);
+    return (transition & 0x80) != 0;
+}
+
+[[nodiscard]] bool breaks_grapheme(char32_t code_point, grapheme_break_state &state) noexcept
+{
+    return breaks_grapheme(unicode_description_find(code_point).grapheme_cluster_break(), state);
+}
+
+[[nodiscard]] unicode_break_vector unicode_grapheme_break(std::u32string_view text) noexcept
+{
+    auto r = unicode_break_vector(text.size() + 1, unicode_break_opportunity::no);
+
+    auto state = grapheme_break_state{};
+    for (auto i = 0_uz; i != text.size(); ++i) {
+        if (breaks_grapheme(text[i], state)) {
+            r[i] = unicode_break_opportunity::yes;
+        }
     }
 
-    ttlet GB11 =
-        state.in_extended_pictograph && (lhs == ZWJ) && (rhs == Extended_Pictographic);
-    if ((break_state == break_state::unknown) && GB11) {
-        break_state = break_state::dont_break;
+    // GB2
+    if (!text.empty()) {
+        r.back() = unicode_break_opportunity::yes;
     }
+    return r;
+}
 
-    if (rhs == Extended_Pictographic) {
-        state.in_extended_pictograph = true;
-    } else if (!((rhs == Extend) || (rhs == ZWJ))) {
-        state.in_extended_pictograph = false;
+[[nodiscard]] unicode_line_break_class unicode_line_break_class_of(char32_t code_point) noexcept
+{
+    return unicode_description_find(code_point).line_break_class();
+}
+
+[[nodiscard]] unicode_word_break_property unicode_word_break_property_of(char32_t code_point) noexcept
+{
+    return unicode_description_find(code_point).word_break_property();
+}
+
+[[nodiscard]] unicode_break_vector unicode_word_break(std::u32string_view text) noexcept
+{
+    using enum unicode_word_break_property;
+
+    auto r = unicode_break_vector(text.size() + 1, unicode_break_opportunity::no);
+    if (text.empty()) {
+        return r;
     }
 
-    ttlet GB12_13 = (lhs == Regional_Indicator) && (rhs == Regional_Indicator) &&
-        ((state.RI_count % 2) == 1);
-    if ((break_state == break_state::unknown) && (GB12_13)) {
-        break_state = break_state::dont_break;
+    auto properties = std::vector<unicode_word_break_property>{};
+    properties.reserve(text.size());
+    for (ttlet code_point : text) {
+        properties.push_back(unicode_word_break_property_of(code_point));
     }
 
-    if (rhs == Regional_Indicator) {
-        state.RI_count++;
-    } else {
-        state.RI_count = 0;
+    ttlet is_newline = [](ttlet p) {
+        return p == CR || p == LF || p == Newline;
+    };
+    ttlet is_ignored = [](ttlet p) {
+        return p == Extend || p == Format || p == ZWJ;
+    };
+    ttlet is_AHLetter = [](ttlet p) {
+        return p == ALetter || p == Hebrew_Letter;
+    };
+    ttlet is_MidNumLetQ = [](ttlet p) {
+        return p == MidNumLet || p == Single_Quote;
+    };
+
+    // The property of the first character after i, skipping characters ignored by WB4.
+    ttlet lookahead = [&](size_t i) {
+        while (i < properties.size() && is_ignored(properties[i])) {
+            ++i;
+        }
+        return i < properties.size() ? properties[i] : Other;
+    };
+
+    // The properties of the two characters before the break, skipping characters ignored by WB4.
+    auto lhs = properties.front();
+    auto lhs2 = Other;
+    auto RI_count = lhs == Regional_Indicator ? 1 : 0;
+
+    // WB1
+    r.front() = unicode_break_opportunity::yes;
+
+    for (auto i = 1_uz; i != properties.size(); ++i) {
+        ttlet prev = properties[i - 1];
+        ttlet rhs = properties[i];
+
+        auto do_break = true;
+        if (prev == CR && rhs == LF) {
+            // WB3
+            do_break = false;
+        } else if (is_newline(prev) || is_newline(rhs)) {
+            // WB3a, WB3b
+            do_break = true;
+        } else if (
+            prev == ZWJ &&
+            unicode_description_find(text[i]).grapheme_cluster_break() == unicode_grapheme_cluster_break::Extended_Pictographic) {
+            // WB3c
+            do_break = false;
+        } else if (prev == WSegSpace && rhs == WSegSpace) {
+            // WB3d
+            do_break = false;
+        } else if (is_ignored(rhs)) {
+            // WB4
+            do_break = false;
+        } else if (is_AHLetter(lhs) && is_AHLetter(rhs)) {
+            // WB5
+            do_break = false;
+        } else if (is_AHLetter(lhs) && (rhs == MidLetter || is_MidNumLetQ(rhs)) && is_AHLetter(lookahead(i + 1))) {
+            // WB6
+            do_break = false;
+        } else if (is_AHLetter(lhs2) && (lhs == MidLetter || is_MidNumLetQ(lhs)) && is_AHLetter(rhs)) {
+            // WB7
+            do_break = false;
+        } else if (lhs == Hebrew_Letter && rhs == Single_Quote) {
+            // WB7a
+            do_break = false;
+        } else if (lhs == Hebrew_Letter && rhs == Double_Quote && lookahead(i + 1) == Hebrew_Letter) {
+            // WB7b
+            do_break = false;
+        } else if (lhs2 == Hebrew_Letter && lhs == Double_Quote && rhs == Hebrew_Letter) {
+            // WB7c
+            do_break = false;
+        } else if ((lhs == Numeric || is_AHLetter(lhs)) && rhs == Numeric) {
+            // WB8, WB9
+            do_break = false;
+        } else if (lhs == Numeric && is_AHLetter(rhs)) {
+            // WB10
+            do_break = false;
+        } else if (lhs2 == Numeric && (lhs == MidNum || is_MidNumLetQ(lhs)) && rhs == Numeric) {
+            // WB11
+            do_break = false;
+        } else if (lhs == Numeric && (rhs == MidNum || is_MidNumLetQ(rhs)) && lookahead(i + 1) == Numeric) {
+            // WB12
+            do_break = false;
+        } else if (lhs == Katakana && rhs == Katakana) {
+            // WB13
+            do_break = false;
+        } else if ((is_AHLetter(lhs) || lhs == Numeric || lhs == Katakana || lhs == ExtendNumLet) && rhs == ExtendNumLet) {
+            // WB13a
+            do_break = false;
+        } else if (lhs == ExtendNumLet && (is_AHLetter(rhs) || rhs == Numeric || rhs == Katakana)) {
+            // WB13b
+            do_break = false;
+        } else if (lhs == Regional_Indicator && rhs == Regional_Indicator && (RI_count % 2) == 1) {
+            // WB15, WB16
+            do_break = false;
+        }
+
+        if (do_break) {
+            r[i] = unicode_break_opportunity::yes;
+        }
+
+        // Characters ignored by WB4 are treated as the character before them, except at the start of a line.
+        if (!is_ignored(rhs) || is_newline(prev)) {
+            RI_count = rhs != Regional_Indicator ? 0 : lhs == Regional_Indicator ? RI_count + 1 : 1;
+            lhs2 = lhs;
+            lhs = rhs;
+        }
     }
 
-    // GB999
-    if (break_state == break_state::unknown) {
-        break_state = break_state::do_break;
+    // WB2
+    r.back() = unicode_break_opportunity::yes;
+    return r;
+}
+
+/** How the line breaking rules apply to a pair of characters.
+ */
+enum class line_break_action : uint8_t {
+    /** A break is allowed between the pair. */
+    direct,
+    /** A break is only allowed when there are spaces between the pair. */
+    indirect,
+    /** No break is allowed, even when there are spaces between the pair. */
+    prohibited
+};
+
+/** Apply the pair rules of UAX #14 to two characters which may be separated by spaces.
+ * Rules LB4 - LB10, LB21a, LB30a and the East Asian Width exclusion of LB30 depend on more context
+ * and are handled by `unicode_line_break()`.
+ */
+[[nodiscard]] constexpr line_break_action line_break_pair_rule(unicode_line_break_class lhs, unicode_line_break_class rhs) noexcept
+{
+    using enum unicode_line_break_class;
+
+    ttlet lhs_AL_HL = lhs == AL || lhs == HL;
+    ttlet rhs_AL_HL = rhs == AL || rhs == HL;
+    ttlet lhs_korean = lhs == JL || lhs == JV || lhs == JT || lhs == H2 || lhs == H3;
+    ttlet rhs_korean = rhs == JL || rhs == JV || rhs == JT || rhs == H2 || rhs == H3;
+
+    if (rhs == WJ || rhs == CL || rhs == CP || rhs == EX || rhs == IS || rhs == SY) {
+        // LB11, LB13
+        return line_break_action::prohibited;
+    } else if (lhs == OP) {
+        // LB14
+        return line_break_action::prohibited;
+    } else if (lhs == QU && rhs == OP) {
+        // LB15
+        return line_break_action::prohibited;
+    } else if ((lhs == CL || lhs == CP) && rhs == NS) {
+        // LB16
+        return line_break_action::prohibited;
+    } else if (lhs == B2 && rhs == B2) {
+        // LB17
+        return line_break_action::prohibited;
+    } else if (lhs == WJ || lhs == GL) {
+        // LB11, LB12
+        return line_break_action::indirect;
+    } else if (rhs == GL && lhs != BA && lhs != HY) {
+        // LB12a
+        return line_break_action::indirect;
+    } else if (lhs == QU || rhs == QU) {
+        // LB19
+        return line_break_action::indirect;
+    } else if (lhs == CB || rhs == CB) {
+        // LB20
+        return line_break_action::direct;
+    } else if (rhs == BA || rhs == HY || rhs == NS || lhs == BB) {
+        // LB21
+        return line_break_action::indirect;
+    } else if (lhs == SY && rhs == HL) {
+        // LB21b
+        return line_break_action::indirect;
+    } else if (rhs == IN) {
+        // LB22
+        return line_break_action::indirect;
+    } else if ((lhs_AL_HL && rhs == NU) || (lhs == NU && rhs_AL_HL)) {
+        // LB23
+        return line_break_action::indirect;
+    } else if (
+        (lhs == PR && (rhs == ID || rhs == EB || rhs == EM)) || ((lhs == ID || lhs == EB || lhs == EM) && rhs == PO)) {
+        // LB23a
+        return line_break_action::indirect;
+    } else if (((lhs == PR || lhs == PO) && rhs_AL_HL) || (lhs_AL_HL && (rhs == PR || rhs == PO))) {
+        // LB24
+        return line_break_action::indirect;
+    } else if (
+        ((lhs == CL || lhs == CP || lhs == NU) && (rhs == PO || rhs == PR)) ||
+        ((lhs == PO || lhs == PR) && (rhs == OP || rhs == NU)) ||
+        ((lhs == HY || lhs == IS || lhs == NU || lhs == SY) && rhs == NU)) {
+        // LB25
+        return line_break_action::indirect;
+    } else if (
+        (lhs == JL && (rhs == JL || rhs == JV || rhs == H2 || rhs == H3)) ||
+        ((lhs == JV || lhs == H2) && (rhs == JV || rhs == JT)) || ((lhs == JT || lhs == H3) && rhs == JT)) {
+        // LB26
+        return line_break_action::indirect;
+    } else if ((lhs_korean && rhs == PO) || (lhs == PR && rhs_korean)) {
+        // LB27
+        return line_break_action::indirect;
+    } else if (lhs_AL_HL && rhs_AL_HL) {
+        // LB28
+        return line_break_action::indirect;
+    } else if (lhs == IS && rhs_AL_HL) {
+        // LB29
+        return line_break_action::indirect;
+    } else if (((lhs_AL_HL || lhs == NU) && rhs == OP) || (lhs == CP && (rhs_AL_HL || rhs == NU))) {
+        // LB30
+        return line_break_action::indirect;
+    } else if (lhs == EB && rhs == EM) {
+        // LB30b
+        return line_break_action::indirect;
+    } else {
+        // LB31
+        return line_break_action::direct;
     }
+}
 
-    state.previous = rhs;
-    return break_state == break_state::do_break;
+/** Check if opening or closing punctuation has the East Asian Width F, W or H, which LB30 excludes.
+ * In Unicode 12.1 these are U+2329, U+232A and the OP and CP characters in the CJK Symbols and Punctuation,
+ * Vertical Forms, CJK Compatibility Forms, Small Form Variants and Halfwidth and Fullwidth Forms blocks.
+ */
+[[nodiscard]] constexpr bool is_east_asian_wide_punctuation(char32_t code_point) noexcept
+{
+    return code_point == U'\u2329' || code_point == U'\u232a' || (code_point >= U'\u3000' && code_point <= U'\u303f') ||
+        (code_point >= U'\ufe10' && code_point <= U'\ufe1f') || (code_point >= U'\ufe30' && code_point <= U'\ufe6f') ||
+        (code_point >= U'\uff00' && code_point <= U'\uffef');
 }
 
+constexpr auto line_break_pair_table = [] {
+    auto r = std::array<std::array<line_break_action, unicode_line_break_class_count>, unicode_line_break_class_count>{};
 
-[[nodiscard]] bool breaks_grapheme(char32_t code_point, grapheme_break_state &state) noexcept
+    for (size_t i = 0; i != unicode_line_break_class_count; ++i) {
+        for (size_t j = 0; j != unicode_line_break_class_count; ++j) {
+            r[i][j] =
+                line_break_pair_rule(static_cast<unicode_line_break_class>(i), static_cast<unicode_line_break_class>(j));
+        }
+    }
+    return r;
+}();
+
+[[nodiscard]] unicode_break_vector unicode_line_break(std::u32string_view text) noexcept
 {
-    return breaks_grapheme(unicode_description_find(code_point).grapheme_cluster_break(), state);
+    using enum unicode_line_break_class;
+
+    auto r = unicode_break_vector(text.size() + 1, unicode_break_opportunity::no);
+    if (text.empty()) {
+        return r;
+    }
+
+    auto classes = std::vector<unicode_line_break_class>{};
+    classes.reserve(text.size());
+    for (ttlet code_point : text) {
+        classes.push_back(unicode_line_break_class_of(code_point));
+    }
+
+    // The class of a character at the start of a line.
+    // Spaces are kept with the start of the line and combining marks without a base are treated as AL (LB10).
+    ttlet start_class = [](ttlet c) {
+        return c == SP ? WJ : (c == CM || c == ZWJ) ? AL : c;
+    };
+
+    // The class of the character before the break, skipping spaces and combining marks (LB9).
+    auto lhs = start_class(classes.front());
+    auto lhs_code_point = text.front();
+    auto has_spaces = false;
+    auto RI_count = lhs == RI ? 1 : 0;
+    auto after_HL_hyphen = false;
+
+    for (auto i = 1_uz; i != classes.size(); ++i) {
+        ttlet prev = classes[i - 1];
+        auto rhs = classes[i];
+
+        if (prev == BK || prev == LF || prev == NL || (prev == CR && rhs != LF)) {
+            // LB4, LB5
+            r[i] = unicode_break_opportunity::mandatory;
+            lhs = start_class(rhs);
+            lhs_code_point = text[i];
+            has_spaces = false;
+            RI_count = lhs == RI ? 1 : 0;
+            after_HL_hyphen = false;
+            continue;
+
+        } else if (rhs == BK || rhs == CR || rhs == LF || rhs == NL) {
+            // LB6
+            lhs = rhs;
+            lhs_code_point = text[i];
+            continue;
+
+        } else if (rhs == SP) {
+            // LB7
+            has_spaces = true;
+            continue;
+
+        } else if (rhs == ZW) {
+            // LB7
+            lhs = ZW;
+            lhs_code_point = text[i];
+            has_spaces = false;
+            continue;
+
+        } else if (lhs == ZW) {
+            // LB8
+            r[i] = unicode_break_opportunity::yes;
+            lhs = start_class(rhs);
+            lhs_code_point = text[i];
+            has_spaces = false;
+            RI_count = lhs == RI ? 1 : 0;
+            after_HL_hyphen = false;
+            continue;
+
+        } else if ((rhs == CM || rhs == ZWJ) && !has_spaces) {
+            // LB8a, LB9
+            continue;
+
+        } else if (rhs == CM || rhs == ZWJ) {
+            // LB10
+            rhs = AL;
+        }
+
+        ttlet action = line_break_pair_table[static_cast<size_t>(lhs)][static_cast<size_t>(rhs)];
+        auto do_break = action == line_break_action::direct || (action == line_break_action::indirect && has_spaces);
+
+        if (prev == ZWJ) {
+            // LB8a
+            do_break = false;
+        } else if (after_HL_hyphen && !has_spaces) {
+            // LB21a
+            do_break = false;
+        } else if (lhs == RI && rhs == RI && !has_spaces && (RI_count % 2) == 1) {
+            // LB30a
+            do_break = false;
+        } else if (
+            ((lhs == AL || lhs == HL || lhs == NU) && rhs == OP && is_east_asian_wide_punctuation(text[i])) ||
+            (lhs == CP && (rhs == AL || rhs == HL || rhs == NU) && is_east_asian_wide_punctuation(lhs_code_point))) {
+            // LB30 does not apply to wide punctuation, LB31
+            do_break = true;
+        }
+
+        if (do_break) {
+            r[i] = unicode_break_opportunity::yes;
+        }
+
+        after_HL_hyphen = lhs == HL && (rhs == HY || rhs == BA) && !has_spaces;
+        RI_count = rhs != RI ? 0 : (lhs == RI && !has_spaces) ? RI_count + 1 : 1;
+        lhs = rhs;
+        lhs_code_point = text[i];
+        has_spaces = false;
+    }
+
+    // LB3
+    r.back() = unicode_break_opportunity::mandatory;
+    return r;
 }
 
 }
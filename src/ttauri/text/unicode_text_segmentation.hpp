@@ -5,22 +5,42 @@
 #pragma once
 
 #include "unicode_grapheme_cluster_break.hpp"
+#include "unicode_line_break_class.hpp"
+#include "unicode_word_break_property.hpp"
 #include "unicode_description.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
 
 namespace tt {
 
+namespace detail {
+
+/** The states of the grapheme-break state machine.
+ * The first states are the grapheme cluster break property of the previous code-point,
+ * the extra states carry the context needed by rules GB1, GB11 and GB12/GB13.
+ */
+enum class grapheme_break_dfa_state : uint8_t {
+    // 0 - 14 are the unicode_grapheme_cluster_break values.
+    /** Extended_Pictographic Extend* */
+    pictographic_extend = 15,
+    /** Extended_Pictographic Extend* ZWJ */
+    pictographic_ZWJ = 16,
+    /** A Regional_Indicator that completes a pair. */
+    RI_pair = 17,
+    /** Start of text. */
+    start = 18
+};
+
+}
+
 struct grapheme_break_state {
-    unicode_grapheme_cluster_break previous = unicode_grapheme_cluster_break::Other;
-    int RI_count = 0;
-    bool first_character = true;
-    bool in_extended_pictograph = false;
+    detail::grapheme_break_dfa_state state = detail::grapheme_break_dfa_state::start;
 
     void reset() noexcept
     {
-        previous = unicode_grapheme_cluster_break::Other;
-        RI_count = 0;
-        first_character = true;
-        in_extended_pictograph = false;
+        state = detail::grapheme_break_dfa_state::start;
     }
 };
 
@@ -33,6 +53,85 @@ struct grapheme_break_state {
  */
 [[nodiscard]] bool breaks_grapheme(char32_t code_point, grapheme_break_state &state) noexcept;
 
+enum class unicode_break_opportunity : uint8_t {
+    no,
+    yes,
+    mandatory,
+};
+
+/** The break opportunities of a text.
+ * There is an entry before each code-point and one at the end of the text.
+ */
+using unicode_break_vector = std::vector<unicode_break_opportunity>;
+
+/** Get the line breaking class of a code-point.
+ * The class is looked up in the unicode database, with rule LB1 already applied.
+ */
+[[nodiscard]] unicode_line_break_class unicode_line_break_class_of(char32_t code_point) noexcept;
+
+/** Get the word break property of a code-point.
+ * The property is looked up in the unicode database.
+ */
+[[nodiscard]] unicode_word_break_property unicode_word_break_property_of(char32_t code_point) noexcept;
+
+/** Find all grapheme cluster breaks in a text.
+ *
+ * @param text The text in code-points.
+ * @return The break opportunities of the text.
+ */
+[[nodiscard]] unicode_break_vector unicode_grapheme_break(std::u32string_view text) noexcept;
+
+/** Find all word breaks in a text.
+ * This implements the word boundary rules of UAX #29.
+ *
+ * @param text The text in code-points.
+ * @return The break opportunities of the text.
+ */
+[[nodiscard]] unicode_break_vector unicode_word_break(std::u32string_view text) noexcept;
+
+/** Find all line break opportunities in a text.
+ * This implements the pair-table based algorithm of UAX #14.
+ *
+ * @param text The text in code-points.
+ * @return The break opportunities of the text, with `mandatory` after hard line breaks
+ *         and at the end of the text.
+ */
+[[nodiscard]] unicode_break_vector unicode_line_break(std::u32string_view text) noexcept;
+
+namespace detail {
+
+/** Gather the code-points of a range of items.
+ *
+ * @param first The first iterator of a text.
+ * @param last The one beyond the last iterator of a text.
+ * @param get_code_point A function returning the code-point of an item pointed by the iterator.
+ *                       `char32_t get_code_point(auto const &item)`
+ */
+[[nodiscard]] std::u32string gather_code_points(auto first, auto last, auto const &get_code_point) noexcept
+{
+    auto r = std::u32string{};
+    r.reserve(std::distance(first, last));
+    for (auto it = first; it != last; ++it) {
+        r += get_code_point(*it);
+    }
+    return r;
+}
+
+}
+
+/** Find all word breaks in a text, for example graphemes using the first code-point of each.
+ */
+[[nodiscard]] unicode_break_vector unicode_word_break(auto first, auto last, auto const &get_code_point) noexcept
+{
+    return unicode_word_break(detail::gather_code_points(first, last, get_code_point));
+}
+
+/** Find all line break opportunities in a text, for example graphemes using the first code-point of each.
+ */
+[[nodiscard]] unicode_break_vector unicode_line_break(auto first, auto last, auto const &get_code_point) noexcept
+{
+    return unicode_line_break(detail::gather_code_points(first, last, get_code_point));
+}
 
 /** Wrap lines in text that are too wide.
  * This algorithm may modify white-space in text and change them into line seperators.
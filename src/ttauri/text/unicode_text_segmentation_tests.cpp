@@ -13,20 +13,21 @@
 #include <string_view>
 #include <span>
 #include <format>
+#include <filesystem>
 
 using namespace std;
 using namespace tt;
 
-struct graphemeBreakTest {
+struct breakTest {
     std::u32string code_points;
     std::vector<bool> break_opportunities;
     std::string comment;
     int lineNr;
 };
 
-std::optional<graphemeBreakTest> parsegraphemeBreakTests_line(std::string_view line, int lineNr)
+std::optional<breakTest> parseBreakTests_line(std::string_view line, int lineNr)
 {
-    graphemeBreakTest r;
+    breakTest r;
 
     ttlet split_line = split(line, "\t#");
     if (split_line.size() < 2) {
@@ -56,15 +57,18 @@ std::optional<graphemeBreakTest> parsegraphemeBreakTests_line(std::string_view l
     return r;
 }
 
-std::vector<graphemeBreakTest> parsegraphemeBreakTests()
+/** Parse one of the break test files of the unicode character database.
+ * The GraphemeBreakTest.txt, WordBreakTest.txt and LineBreakTest.txt files all have the same format.
+ */
+std::vector<breakTest> parseBreakTests(URL const &url)
 {
-    ttlet view = file_view(URL("file:graphemeBreakTest.txt"));
+    ttlet view = file_view(url);
     ttlet test_data = view.string_view();
 
-    std::vector<graphemeBreakTest> r;
+    std::vector<breakTest> r;
     int lineNr = 1;
     for (ttlet line : split(test_data, '\n')) {
-        if (ttlet optionalTest = parsegraphemeBreakTests_line(line, lineNr)) {
+        if (ttlet optionalTest = parseBreakTests_line(line, lineNr)) {
             r.push_back(*optionalTest);
         }
         lineNr++;
@@ -74,7 +78,7 @@ std::vector<graphemeBreakTest> parsegraphemeBreakTests()
 
 TEST(unicode_text_segmentation, breaks_grapheme)
 {
-    auto tests = parsegraphemeBreakTests();
+    auto tests = parseBreakTests(URL("file:graphemeBreakTest.txt"));
 
     for (ttlet &test : tests) {
         ASSERT_EQ(test.code_points.size() + 1, test.break_opportunities.size());
@@ -89,3 +93,147 @@ TEST(unicode_text_segmentation, breaks_grapheme)
         }
     }
 }
+
+TEST(unicode_text_segmentation, unicode_grapheme_break)
+{
+    auto tests = parseBreakTests(URL("file:graphemeBreakTest.txt"));
+
+    for (ttlet &test : tests) {
+        ttlet breaks = unicode_grapheme_break(test.code_points);
+        ASSERT_EQ(breaks.size(), test.break_opportunities.size());
+
+        for (size_t i = 0; i != breaks.size(); ++i) {
+            ASSERT_EQ(breaks[i] != unicode_break_opportunity::no, test.break_opportunities[i]) << test.comment;
+        }
+    }
+}
+
+/** Show the break opportunities of a text with '|' for a break and '!' for a mandatory break.
+ */
+static std::u32string show_breaks(std::u32string_view text, unicode_break_vector const &breaks)
+{
+    auto r = std::u32string{};
+    for (size_t i = 0; i != breaks.size(); ++i) {
+        if (breaks[i] == unicode_break_opportunity::yes) {
+            r += U'|';
+        } else if (breaks[i] == unicode_break_opportunity::mandatory) {
+            r += U'!';
+        }
+        if (i != text.size()) {
+            r += text[i];
+        }
+    }
+    return r;
+}
+
+TEST(unicode_text_segmentation, unicode_line_break_class_of)
+{
+    ASSERT_EQ(unicode_line_break_class_of(U'a'), unicode_line_break_class::AL);
+    ASSERT_EQ(unicode_line_break_class_of(U'\u00a0'), unicode_line_break_class::GL);
+    ASSERT_EQ(unicode_line_break_class_of(U'\u05d0'), unicode_line_break_class::HL);
+    ASSERT_EQ(unicode_line_break_class_of(U'\u4e01'), unicode_line_break_class::ID);
+    ASSERT_EQ(unicode_line_break_class_of(U'\uac01'), unicode_line_break_class::H3);
+    ASSERT_EQ(unicode_line_break_class_of(U'\U0001f3fb'), unicode_line_break_class::EM);
+
+    // LB1: SA is resolved to CM for combining marks and to AL otherwise, CJ is resolved to NS.
+    ASSERT_EQ(unicode_line_break_class_of(U'\u0e01'), unicode_line_break_class::AL);
+    ASSERT_EQ(unicode_line_break_class_of(U'\u0e31'), unicode_line_break_class::CM);
+    ASSERT_EQ(unicode_line_break_class_of(U'\u3041'), unicode_line_break_class::NS);
+}
+
+TEST(unicode_text_segmentation, unicode_word_break_property_of)
+{
+    ASSERT_EQ(unicode_word_break_property_of(U'a'), unicode_word_break_property::ALetter);
+    ASSERT_EQ(unicode_word_break_property_of(U' '), unicode_word_break_property::WSegSpace);
+    ASSERT_EQ(unicode_word_break_property_of(U'\u00a0'), unicode_word_break_property::Other);
+    ASSERT_EQ(unicode_word_break_property_of(U'\u202f'), unicode_word_break_property::ExtendNumLet);
+    ASSERT_EQ(unicode_word_break_property_of(U'\u2139'), unicode_word_break_property::ALetter);
+    ASSERT_EQ(unicode_word_break_property_of(U'\u30a2'), unicode_word_break_property::Katakana);
+    ASSERT_EQ(unicode_word_break_property_of(U'\u4e01'), unicode_word_break_property::Other);
+}
+
+TEST(unicode_text_segmentation, unicode_word_break_conformance)
+{
+    if (not std::filesystem::exists("WordBreakTest.txt")) {
+        FAIL() << "Copy WordBreakTest.txt from https://www.unicode.org/Public/12.1.0/ucd/auxiliary/ into tests/data";
+    }
+    auto tests = parseBreakTests(URL("file:WordBreakTest.txt"));
+
+    for (ttlet &test : tests) {
+        ttlet breaks = unicode_word_break(test.code_points);
+        ASSERT_EQ(breaks.size(), test.break_opportunities.size());
+
+        for (size_t i = 0; i != breaks.size(); ++i) {
+            ASSERT_EQ(breaks[i] != unicode_break_opportunity::no, test.break_opportunities[i]) << test.comment;
+        }
+    }
+}
+
+TEST(unicode_text_segmentation, unicode_line_break_conformance)
+{
+    if (not std::filesystem::exists("LineBreakTest.txt")) {
+        FAIL() << "Copy LineBreakTest.txt from https://www.unicode.org/Public/12.1.0/ucd/auxiliary/ into tests/data";
+    }
+    auto tests = parseBreakTests(URL("file:LineBreakTest.txt"));
+
+    for (ttlet &test : tests) {
+        ttlet breaks = unicode_line_break(test.code_points);
+        ASSERT_EQ(breaks.size(), test.break_opportunities.size());
+
+        for (size_t i = 0; i != breaks.size(); ++i) {
+            ASSERT_EQ(breaks[i] != unicode_break_opportunity::no, test.break_opportunities[i]) << test.comment;
+        }
+    }
+}
+
+TEST(unicode_text_segmentation, unicode_word_break)
+{
+    ttlet text = std::u32string{U"can't stop 3.14, $100 well-known"};
+    ASSERT_EQ(show_breaks(text, unicode_word_break(text)), U"|can't| |stop| |3.14|,| |$|100| |well|-|known|");
+
+    ttlet text2 = std::u32string{U"e\u0301t\u00e9 \u65e5\u672c\r\nx"};
+    ASSERT_EQ(show_breaks(text2, unicode_word_break(text2)), U"|e\u0301t\u00e9| |\u65e5|\u672c|\r\n|x|");
+}
+
+TEST(unicode_text_segmentation, unicode_line_break)
+{
+    ttlet text = std::u32string{U"Hello, world! (test) well-known 3.14%"};
+    ASSERT_EQ(show_breaks(text, unicode_line_break(text)), U"Hello, |world! |(test) |well-|known |3.14%!");
+
+    ttlet text2 = std::u32string{U"a\r\nb\u00a0c  d\u65e5\u672c\u3002\u3067"};
+    ASSERT_EQ(show_breaks(text2, unicode_line_break(text2)), U"a\r\n!b\u00a0c  |d|\u65e5|\u672c\u3002|\u3067!");
+
+    // Regional indicators pair up into flags.
+    ttlet text3 = std::u32string{U"\U0001f1fa\U0001f1f8\U0001f1eb\U0001f1f7"};
+    ASSERT_EQ(show_breaks(text3, unicode_line_break(text3)), U"\U0001f1fa\U0001f1f8|\U0001f1eb\U0001f1f7!");
+}
+
+TEST(unicode_text_segmentation, unicode_line_break_rules)
+{
+    auto check = [](std::u32string_view text, std::u32string_view expected) {
+        ASSERT_EQ(show_breaks(text, unicode_line_break(text)), expected);
+    };
+
+    // LB8: break after a zero width space.
+    check(U"a\u200bb", U"a\u200b|b!");
+
+    // LB13, LB14, LB30: no break around parenthesis next to letters.
+    check(U"a(b) c", U"a(b) |c!");
+
+    // LB30: fullwidth and wide opening punctuation is excluded.
+    check(U"a\uff08b\uff09c", U"a|\uff08b\uff09|c!");
+    check(U"1\u3008", U"1|\u3008!");
+
+    // LB19: no break around quotation marks.
+    check(U"a\"b\" c", U"a\"b\" |c!");
+
+    // LB21, LB21a: a hyphen after a Hebrew letter does not break.
+    check(U"a-b", U"a-|b!");
+    check(U"\u05d0-\u05d1", U"\u05d0-\u05d1!");
+
+    // LB25: numbers with prefix, infix and postfix.
+    check(U"$1.50% x", U"$1.50% |x!");
+
+    // LB30b: an emoji modifier stays with its base.
+    check(U"\U0001f466\U0001f3fb\U0001f466", U"\U0001f466\U0001f3fb|\U0001f466!");
+}
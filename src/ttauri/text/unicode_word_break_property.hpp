@@ -0,0 +1,36 @@
+// Copyright Take Vos 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace tt {
+
+/** Word break property.
+ * Unicode Standard Annex #29: https://unicode.org/reports/tr29/
+ */
+enum class unicode_word_break_property : uint8_t {
+    Other,
+    CR,
+    LF,
+    Newline,
+    Extend,
+    ZWJ,
+    Regional_Indicator,
+    Format,
+    Katakana,
+    Hebrew_Letter,
+    ALetter,
+    Single_Quote,
+    Double_Quote,
+    MidNumLet,
+    MidLetter,
+    MidNum,
+    Numeric,
+    ExtendNumLet,
+    WSegSpace
+};
+
+}
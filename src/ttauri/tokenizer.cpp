@@ -800,7 +800,7 @@ constexpr std::array<tokenizer_transition_t,256> calculateTransitionTable_Operat
         default:
             // If we don't recognize the operator, it means this character is invalid.
             transition.next = tokenizer_state_t::Initial;
-            transition.action = tokenizer_action_t::Read | tokenizer_action_t::Capture;
+            transition.action = tokenizer_action_t::Found | tokenizer_action_t::Read | tokenizer_action_t::Capture;
             transition.name = tokenizer_name_t::ErrorInvalidCharacter;
         }
 
@@ -955,88 +955,143 @@ constexpr transitionTable_t buildTransitionTable()
 constexpr transitionTable_t transitionTable = buildTransitionTable();
 
 
-struct tokenizer {
-    using iterator = typename std::string_view::const_iterator;
-
-    tokenizer_state_t state;
-    iterator index;
-    iterator end;
-    parse_location location;
-    parse_location captureLocation;
+[[nodiscard]] static bool is_operator_after_integer(tokenizer_state_t state) noexcept
+{
+    // The '-' or ':' that starts this operator was read by the integer before it.
+    return state == tokenizer_state_t::DashAfterInteger || state == tokenizer_state_t::ColonAfterInteger;
+}
 
-    tokenizer(iterator begin, iterator end) :
-        state(tokenizer_state_t::Initial), index(begin), end(end) {}
+[[nodiscard]] token_view token_reader::next() noexcept
+{
+    auto token = token_view{};
+    token._state = _state;
+    token._first = _index;
+    auto text_first = _index;
+    auto started = false;
+
+    auto state = static_cast<tokenizer_state_t>(_state);
+    auto transition = tokenizer_transition_t{};
+    while (_index != _end) {
+        transition = transitionTable[get_offset(state, *_index)];
+
+        auto action = transition.action;
+        if (action >= tokenizer_action_t::Start || (action >= tokenizer_action_t::Capture && !started)) {
+            // Operators start at their first captured character.
+            started = true;
+            token._state = static_cast<uint8_t>(state);
+            token._first = _index;
+            token.location = _location;
+            text_first = is_operator_after_integer(state) ? _index - 1 : _index;
+        }
+        state = transition.next;
+        if (state == tokenizer_state_t::Initial && !(action >= tokenizer_action_t::Found)) {
+            // Skipped white space or a comment.
+            started = false;
+        }
 
-    /*! Parse a token.
-    */
-    [[nodiscard]] token_t getNextToken() {
-        auto token = token_t{};
+        if (action >= tokenizer_action_t::Read) {
+            if (action >= tokenizer_action_t::LineFeed) {
+                _location.increment_line();
+            } else if (action >= tokenizer_action_t::Tab) {
+                _location.tab_column();
+            } else {
+                _location.increment_column();
+            }
+            ++_index;
+        }
 
-        auto transition = tokenizer_transition_t{};
-        while (index != end) {
-            transition = transitionTable[get_offset(state, *index)];
-            state = transition.next;
+        if (action >= tokenizer_action_t::Found) {
+            _state = static_cast<uint8_t>(state);
+            token.name = transition.name;
+            token._found = true;
+            token._last = _index;
+            ttlet text_last = is_operator_after_integer(state) ? _index - 1 : _index;
+            token.text = std::string_view{text_first, static_cast<size_t>(text_last - text_first)};
+            return token;
+        }
+    }
 
-            auto action = transition.action;
-            if (action >= tokenizer_action_t::Start) {
-                token.location = location;
-                token.value.clear();
-            }
+    // Complete the token at the current state. Or an end-token at the initial state.
+    if (state == tokenizer_state_t::Initial) {
+        // Mark the current offset as the position of the end-token.
+        token.location = _location;
+        token._first = _index;
+        text_first = _index;
+    }
 
-            if (action >= tokenizer_action_t::Capture) {
-                token.value += transition.c;
-            }
+    transition = transitionTable[get_offset(state)];
+    _state = static_cast<uint8_t>(transition.next);
 
-            if (action >= tokenizer_action_t::Read) {
-                if (action >= tokenizer_action_t::LineFeed) {
-                    location.increment_line();
-                } else if (action >= tokenizer_action_t::Tab) {
-                    location.tab_column();
-                } else {
-                    location.increment_column();
-                }
-                ++index;
-            }
+    token.name = transition.name;
+    token._last = _index;
+    ttlet text_last = is_operator_after_integer(transition.next) ? _index - 1 : _index;
+    token.text = std::string_view{text_first, static_cast<size_t>(text_last - text_first)};
+    return token;
+}
 
-            if (action >= tokenizer_action_t::Found) {
-                token.name = transition.name;
-                return token;
-            }
+[[nodiscard]] std::string token_view::value() const noexcept
+{
+    switch (name) {
+    case tokenizer_name_t::Name:
+    case tokenizer_name_t::Operator:
+        // All characters of these tokens are captured unmodified.
+        return std::string{text};
+    case tokenizer_name_t::IntegerLiteral:
+    case tokenizer_name_t::FloatLiteral:
+        if (text.find_first_of("_'") == std::string_view::npos) {
+            return std::string{text};
         }
-
-        // Complete the token at the current state. Or an end-token at the initial state.
-        if (state == tokenizer_state_t::Initial) {
-            // Mark the current offset as the position of the end-token.
-            token.location = location;
-            token.value.clear();
+        break;
+    case tokenizer_name_t::StringLiteral:
+        if (!text.starts_with("\"\"\"") && text.find('\\') == std::string_view::npos) {
+            return std::string{text.substr(1, text.size() - 2)};
         }
+        break;
+    default:;
+    }
 
-        transition = transitionTable[get_offset(state)];
-        state = transition.next;
+    auto r = std::string{};
 
-        token.name = transition.name;
-        return token;
-    }
+    // Replay the characters of the token from the state where the token was started,
+    // this time capturing the characters.
+    auto state = static_cast<tokenizer_state_t>(_state);
+    auto index = _first;
+    while (index != _last || _found) {
+        ttlet transition = transitionTable[get_offset(state, *index)];
+        state = transition.next;
 
-    /*! Parse all tokens.
-    */
-    [[nodiscard]] std::vector<token_t> getTokens() noexcept {
-        std::vector<token_t> r;
+        auto action = transition.action;
+        if (action >= tokenizer_action_t::Capture) {
+            r += transition.c;
+        }
 
-        tokenizer_name_t token_name;
-        do {
-            ttlet token = getNextToken();
-            token_name = token.name;
-            r.push_back(std::move(token));
-        } while (token_name != tokenizer_name_t::End);
+        if (action >= tokenizer_action_t::Read) {
+            ++index;
+        }
 
-        return r;
+        if (action >= tokenizer_action_t::Found) {
+            break;
+        }
     }
-};
+
+    return r;
+}
 
 [[nodiscard]] std::vector<token_t> parseTokens(std::string_view::const_iterator first, std::string_view::const_iterator last) noexcept
 {
-    return tokenizer(first, last).getTokens();
+    std::vector<token_t> r;
+
+    auto reader = token_reader(first, last);
+    while (true) {
+        ttlet token = reader.next();
+
+        auto &tmp = r.emplace_back(token.name, token.value());
+        tmp.location = token.location;
+
+        if (token.name == tokenizer_name_t::End) {
+            return r;
+        }
+    }
 }
 
 [[nodiscard]] std::vector<token_t> parseTokens(std::string_view text) noexcept
@@ -240,6 +240,91 @@ struct token_t {
     }
 };
 
+/** A token which refers to the text it was parsed from.
+ *
+ * A token_view is returned by `token_reader` without allocating memory. The value
+ * of the token is only decoded when `value()` is called.
+ */
+struct token_view {
+    tokenizer_name_t name = tokenizer_name_t::NotAssigned;
+
+    /** The characters of the token in the text.
+     * This includes the quotes and escape sequences of a string literal and the
+     * digit separators of a number.
+     */
+    std::string_view text;
+
+    /** The location where the token starts, without a file.
+     */
+    parse_location location;
+
+    /** Decode the value of the token.
+     * The value is the same as the `token_t::value` returned by `parseTokens()`.
+     */
+    [[nodiscard]] std::string value() const noexcept;
+
+    operator bool() const noexcept
+    {
+        return name != tokenizer_name_t::NotAssigned;
+    }
+
+    [[nodiscard]] friend bool operator==(token_view const &lhs, tokenizer_name_t const &rhs) noexcept
+    {
+        return lhs.name == rhs;
+    }
+
+    /** Compare the text of the token.
+     * For names and operators the text is the same as the value.
+     */
+    [[nodiscard]] friend bool operator==(token_view const &lhs, std::string_view rhs) noexcept
+    {
+        return lhs.text == rhs;
+    }
+
+private:
+    /** The state of the tokenizer before the token was started.
+     */
+    uint8_t _state = 0;
+
+    /** True when the token was completed before the end of the text.
+     */
+    bool _found = false;
+
+    /** The characters which are replayed through the transition table to decode the value.
+     * These may differ from `text` by the '-' or ':' operator which follows an integer.
+     */
+    char const *_first = nullptr;
+    char const *_last = nullptr;
+
+    friend class token_reader;
+};
+
+/** A tokenizer which reads one token at a time.
+ *
+ * The tokens refer to the text, which must outlive the tokens.
+ * This uses the same transition table and produces the same tokens as `parseTokens()`.
+ */
+class token_reader {
+public:
+    token_reader(std::string_view text) noexcept : _index(text.data()), _end(text.data() + text.size()), _location() {}
+
+    token_reader(std::string_view::const_iterator first, std::string_view::const_iterator last) noexcept :
+        token_reader(std::string_view{first, last})
+    {
+    }
+
+    /** Read the next token.
+     * After the end of the text, each call returns an End token.
+     */
+    [[nodiscard]] token_view next() noexcept;
+
+private:
+    uint8_t _state = 0;
+    char const *_index;
+    char const *_end;
+    parse_location _location;
+};
+
 using token_vector = std::vector<tt::token_t>;
 using token_iterator = typename token_vector::iterator;
 
@@ -382,3 +382,53 @@ TEST(Tokenizer, ParseFQName) {
     ASSERT_TOKEN_EQ(tokens[3], End, "");
 }
 
+
+TEST(Tokenizer, ParseInvalidCharacter) {
+    auto str = "a ` b";
+    auto v = std::string_view(str);
+    auto tokens = parseTokens(v);
+    ASSERT_TOKEN_EQ(tokens[0], Name, "a");
+    ASSERT_TOKEN_EQ(tokens[1], ErrorInvalidCharacter, "`");
+    ASSERT_TOKEN_EQ(tokens[2], Name, "b");
+    ASSERT_TOKEN_EQ(tokens[3], End, "");
+}
+
+TEST(Tokenizer, ReaderText) {
+    auto str = "foo \"a\\tb\" 1'000-x\n  \"x\"";
+    auto reader = token_reader(std::string_view(str));
+
+    auto token = reader.next();
+    ASSERT_EQ(token.name, tokenizer_name_t::Name);
+    ASSERT_EQ(token.text, "foo");
+    ASSERT_EQ(token.value(), "foo");
+    ASSERT_EQ(token.location.line_and_column(), std::pair(1, 1));
+
+    token = reader.next();
+    ASSERT_EQ(token.name, tokenizer_name_t::StringLiteral);
+    ASSERT_EQ(token.text, "\"a\\tb\"");
+    ASSERT_EQ(token.value(), "a\tb");
+    ASSERT_EQ(token.location.line_and_column(), std::pair(1, 5));
+
+    token = reader.next();
+    ASSERT_EQ(token.name, tokenizer_name_t::IntegerLiteral);
+    ASSERT_EQ(token.text, "1'000");
+    ASSERT_EQ(token.value(), "1000");
+
+    token = reader.next();
+    ASSERT_EQ(token.name, tokenizer_name_t::Operator);
+    ASSERT_EQ(token.text, "-");
+    ASSERT_EQ(token.value(), "-");
+
+    token = reader.next();
+    ASSERT_EQ(token.name, tokenizer_name_t::Name);
+    ASSERT_EQ(token.text, "x");
+
+    token = reader.next();
+    ASSERT_EQ(token.name, tokenizer_name_t::StringLiteral);
+    ASSERT_EQ(token.text, "\"x\"");
+    ASSERT_EQ(token.value(), "x");
+    ASSERT_EQ(token.location.line_and_column(), std::pair(2, 3));
+
+    ASSERT_EQ(reader.next().name, tokenizer_name_t::End);
+    ASSERT_EQ(reader.next().name, tokenizer_name_t::End);
+}
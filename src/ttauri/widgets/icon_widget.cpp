@@ -3,8 +3,9 @@
 // (See accompanying file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include "icon_widget.hpp"
-#include "../GFX/gfx_surface_vulkan.hpp"
-#include "../GFX/gfx_device_vulkan.hpp"
+#include "../GFX/gfx_surface.hpp"
+#include "../GFX/gfx_device.hpp"
+#include "../GFX/pipeline_image_image.hpp"
 #include "../GUI/gui_window.hpp"
 #include "../GUI/theme.hpp"
 #include "../cast.hpp"
@@ -16,7 +17,7 @@ icon_widget::icon_widget(gui_window &window, widget *parent) noexcept : super(wi
 void icon_widget::init() noexcept
 {
     _icon_callback = icon.subscribe([this]() {
-        _request_constrain = true;
+        request_reconstrain();
     });
 }
 
@@ -45,9 +46,9 @@ void icon_widget::init() noexcept
 
             ttlet &pixmap = get<pixel_map<sfloat_rgba16>>(icon_);
 
-            gfx_device_vulkan *device = nullptr;
+            gfx_device *device = nullptr;
             if (window.surface) {
-                device = narrow_cast<gfx_device_vulkan *>(window.surface->device());
+                device = window.surface->device();
             }
 
             if (device == nullptr) {
@@ -56,15 +57,21 @@ void icon_widget::init() noexcept
                 _pixmap_hash = 0;
                 _pixmap_backing = {};
                 _icon_bounding_box = {};
-                _request_constrain = true;
+                request_reconstrain();
 
             } else if (pixmap.hash() != _pixmap_hash) {
                 _pixmap_hash = pixmap.hash();
-                _pixmap_backing = device->imagePipeline->makeImage(pixmap.width(), pixmap.height());
-
-                _pixmap_backing.upload(pixmap);
-                _icon_bounding_box = aarectangle{
-                    extent2{narrow_cast<float>(_pixmap_backing.width_in_px), narrow_cast<float>(_pixmap_backing.height_in_px)}};
+                _pixmap_backing = device->make_image(pixmap.width(), pixmap.height());
+
+                if (_pixmap_backing.parent == nullptr) {
+                    // The device can not draw images, such as the headless device.
+                    _icon_type = icon_type::no;
+                    _icon_bounding_box = {};
+                } else {
+                    _pixmap_backing.upload(pixmap);
+                    _icon_bounding_box = aarectangle{extent2{
+                        narrow_cast<float>(_pixmap_backing.width_in_px), narrow_cast<float>(_pixmap_backing.height_in_px)}};
+                }
             }
 
         } else if (holds_alternative<font_glyph_ids>(icon_)) {
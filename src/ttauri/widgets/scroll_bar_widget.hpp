@@ -36,13 +36,13 @@ public:
         offset(std::forward<Offset>(offset))
     {
         _content_callback = this->content.subscribe([this](auto...) {
-            this->window.requestLayout = true;
+            this->parent->request_relayout();
         });
         _aperture_callback = this->aperture.subscribe([this](auto...) {
-            this->window.requestLayout = true;
+            this->parent->request_relayout();
         });
         _offset_callback = this->offset.subscribe([this](auto...) {
-            this->window.requestLayout = true;
+            this->parent->request_relayout();
         });
     }
 
@@ -248,7 +248,7 @@ public:
             handled = true;
             _scroll_offset_x += event.wheelDelta.x();
             _scroll_offset_y += event.wheelDelta.y();
-            _request_layout = true;
+            request_relayout();
             return true;
         }
         return handled;
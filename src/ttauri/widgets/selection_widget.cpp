@@ -34,14 +34,14 @@ void selection_widget::init() noexcept
     _column_widget = &_scroll_widget->make_widget<column_widget>();
 
     _unknown_label_callback = this->unknown_label.subscribe([this] {
-        _request_constrain = true;
+        request_reconstrain();
     });
 
     if (auto delegate = _delegate.lock()) {
         _delegate_callback = delegate->subscribe(*this, [this] {
             run_on_gui_thread([this] {
                 repopulate_options();
-                _request_constrain = true;
+                request_reconstrain();
             });
         });
 
@@ -174,7 +174,7 @@ bool selection_widget::handle_event(mouse_event const &event) noexcept
 bool selection_widget::handle_event(command command) noexcept
 {
     tt_axiom(is_gui_thread());
-    _request_layout = true;
+    request_relayout();
 
     if (enabled and _has_options) {
         switch (command) {
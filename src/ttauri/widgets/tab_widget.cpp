@@ -20,7 +20,7 @@ tab_widget::tab_widget(gui_window &window, widget *parent, weak_or_unique_ptr<de
 
     if (auto d = _delegate.lock()) {
         _delegate_callback = d->subscribe(*this, [this](auto...) {
-            this->_request_constrain = true;
+            this->request_reconstrain();
         });
     }
 
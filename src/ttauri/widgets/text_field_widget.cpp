@@ -13,7 +13,7 @@ text_field_widget::text_field_widget(gui_window &window, widget *parent, weak_or
 {
     if (auto d = _delegate.lock()) {
         _delegate_callback = d->subscribe(*this, [this] {
-            _request_layout = true;
+            request_relayout();
         });
     }
 }
@@ -66,8 +66,12 @@ void text_field_widget::layout(hires_utc_clock::time_point display_time_point, b
 {
     tt_axiom(is_gui_thread());
 
-    if (_focus && display_time_point >= _next_redraw_time_point) {
-        request_redraw();
+    if (_focus) {
+        if (display_time_point >= _next_redraw_time_point) {
+            request_redraw();
+        }
+        // Keep being called on each frame to blink the cursor.
+        request_layout_pass();
     }
 
     need_layout |= _request_layout.exchange(false);
@@ -139,7 +143,7 @@ void text_field_widget::draw(draw_context context, hires_utc_clock::time_point d
 bool text_field_widget::handle_event(command command) noexcept
 {
     tt_axiom(is_gui_thread());
-    _request_layout = true;
+    request_relayout();
 
     if (enabled) {
         switch (command) {
@@ -278,7 +282,7 @@ bool text_field_widget::handle_event(keyboard_event const &event) noexcept
         }
     }
 
-    _request_layout = true;
+    request_relayout();
     return handled;
 }
 
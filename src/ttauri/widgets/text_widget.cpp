@@ -12,7 +12,7 @@ text_widget::text_widget(gui_window &window, widget *parent) noexcept : super(wi
 void text_widget::init() noexcept
 {
     _text_callback = text.subscribe([this] {
-        _request_constrain = true;
+        request_reconstrain();
     });
 }
 
@@ -21,7 +21,7 @@ void text_widget::init() noexcept
     tt_axiom(is_gui_thread());
 
     if (super::constrain(display_time_point, need_reconstrain)) {
-        _shaped_text = shaped_text{(*text)(), theme::global(*text_style), 0.0f, *alignment};
+        update_shaped_text();
         _minimum_size = ceil(_shaped_text.minimum_size());
         _preferred_size = ceil(_shaped_text.preferred_size());
         _maximum_size = ceil(_shaped_text.maximum_size());
@@ -53,12 +53,26 @@ void text_widget::init() noexcept
 
     need_layout |= _request_layout.exchange(false);
     if (need_layout) {
-        _shaped_text = shaped_text{(*text)(), theme::global(*text_style), width(), *alignment};
+        update_shaped_text();
+        if (_shaped_text.width != width() || _shaped_text.alignment != *alignment) {
+            // Only wrap and position the already shaped glyphs for the new size.
+            _shaped_text.layout(width(), *alignment);
+        }
         _shaped_text_transform = _shaped_text.translate_base_line(point2{0.0f, base_line()});
     }
     super::layout(displayTimePoint, need_layout);
 }
 
+void text_widget::update_shaped_text() noexcept
+{
+    auto key = shaped_text_key{text->shared(), theme::global(*text_style)};
+    if (key != _shaped_text_key) {
+        // The sizes of the text do not depend on the width, shape with a width of zero.
+        _shaped_text = shaped_text{*key.text, key.style, 0.0f, *alignment};
+        _shaped_text_key = std::move(key);
+    }
+}
+
 void text_widget::draw(draw_context context, hires_utc_clock::time_point display_time_point) noexcept
 {
     tt_axiom(is_gui_thread());
@@ -67,12 +67,27 @@ public:
     void draw(draw_context context, hires_utc_clock::time_point display_time_point) noexcept override;
     /// @endprivatesection
 private:
+    /** The parameters used for shaping the text.
+     * The text is only shaped again when one of the parameters changed.
+     */
+    struct shaped_text_key {
+        std::shared_ptr<std::string const> text;
+        tt::text_style style;
+
+        [[nodiscard]] friend bool operator==(shaped_text_key const &, shaped_text_key const &) noexcept = default;
+    };
+
     decltype(text)::callback_ptr_type _text_callback;
 
+    shaped_text_key _shaped_text_key;
     shaped_text _shaped_text;
     matrix2 _shaped_text_transform;
 
     text_widget(gui_window &window, widget *parent) noexcept;
+
+    /** Shape the text when the text or its style has changed.
+     */
+    void update_shaped_text() noexcept;
 };
 
 } // namespace tt
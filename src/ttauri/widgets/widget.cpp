@@ -5,7 +5,9 @@
 #include "widget.hpp"
 #include "../GUI/theme.hpp"
 #include "../GUI/gui_window.hpp"
+#include "../counters.hpp"
 #include <ranges>
+#include <utility>
 
 namespace tt {
 
@@ -25,14 +27,16 @@ widget::widget(gui_window &_window, widget *parent) noexcept :
     });
 
     _relayout_callback = std::make_shared<std::function<void()>>([this] {
-        _request_layout = true;
+        request_relayout();
     });
     _reconstrain_callback = std::make_shared<std::function<void()>>([this] {
-        _request_constrain = true;
+        request_reconstrain();
     });
 
     enabled.subscribe(_redraw_callback);
     visible.subscribe(_redraw_callback);
+    // Invisible widgets are skipped during layout, when becoming visible the layout needs to be updated.
+    visible.subscribe(_relayout_callback);
 
     _minimum_size = extent2::nan();
     _preferred_size = extent2::nan();
@@ -280,39 +284,130 @@ void widget::set_layout_parameters_from_parent(aarectangle child_rectangle) noex
     return _clipping_rectangle;
 }
 
+[[nodiscard]] aarectangle widget::bounding_rectangle() const noexcept
+{
+    tt_axiom(is_gui_thread());
+    return _bounding_rectangle;
+}
+
 [[nodiscard]] bool widget::constrain(hires_utc_clock::time_point display_time_point, bool need_reconstrain) noexcept
 {
     tt_axiom(is_gui_thread());
 
-    need_reconstrain |= _request_constrain.exchange(false);
+    increment_counter<"widget_constrain">();
+
+    auto has_changed = need_reconstrain;
+    has_changed |= _request_constrain.exchange(false);
 
     for (auto &&child : _children) {
         tt_axiom(child);
         tt_axiom(child->parent == this);
-        need_reconstrain |= child->constrain(display_time_point, need_reconstrain);
+
+        // Clear the path before visiting, so that requests made during the pass are kept for the next frame.
+        ttlet child_on_path = child->_request_constrain_path.exchange(false);
+        if (not need_reconstrain and not child_on_path) {
+            continue;
+        }
+
+        ttlet old_minimum_size = child->minimum_size();
+        ttlet old_preferred_size = child->preferred_size();
+        ttlet old_maximum_size = child->maximum_size();
+
+        if (child->constrain(display_time_point, need_reconstrain)) {
+            // The child will need to layout with its new constraints, and so will its
+            // own children; its siblings only when this widget moves them during layout.
+            child->request_relayout();
+
+            // Only when the child's size has changed does this widget need to recalculate its constraints.
+            // Sizes are initialized with NaN, which always compare unequal.
+            has_changed |= child->minimum_size() != old_minimum_size or child->preferred_size() != old_preferred_size or
+                child->maximum_size() != old_maximum_size;
+        }
+    }
+
+    return has_changed;
+}
+
+void widget::request_reconstrain() noexcept
+{
+    _request_constrain = true;
+    for (auto w = this; w != nullptr; w = w->parent) {
+        w->_request_constrain_path = true;
     }
+}
 
-    return need_reconstrain;
+void widget::request_relayout() noexcept
+{
+    _request_layout = true;
+    request_layout_pass();
+}
+
+void widget::request_layout_pass() noexcept
+{
+    for (auto w = this; w != nullptr; w = w->parent) {
+        w->_request_layout_path = true;
+    }
 }
 
 void widget::layout(hires_utc_clock::time_point display_time_point, bool need_layout) noexcept
 {
     tt_axiom(is_gui_thread());
 
+    increment_counter<"widget_layout">();
+
     need_layout |= _request_layout.exchange(false);
     for (auto &&child : _children) {
         tt_axiom(child);
         tt_axiom(child->parent == this);
         if (child->visible) {
-            child->layout(display_time_point, need_layout);
+            ttlet child_on_path = child->_request_layout_path.exchange(false);
+            if (need_layout or child_on_path) {
+                child->layout(display_time_point, need_layout);
+            }
         }
     }
 
+    update_bounding_rectangle();
+
     if (need_layout) {
         request_redraw();
     }
 }
 
+void widget::update_bounding_rectangle() noexcept
+{
+    tt_axiom(is_gui_thread());
+
+    auto bounding_rectangle = _clipping_rectangle;
+    auto children_modified = false;
+    for (ttlet &child : _children) {
+        if (child->visible) {
+            bounding_rectangle |= child->_bounding_rectangle;
+        }
+        children_modified |= std::exchange(child->_bounding_rectangle_modified, false);
+    }
+
+    if (_children.size() < children_index_threshold) {
+        _children_index.clear();
+
+    } else if (children_modified or _children_index.size() != _children.size()) {
+        // Invisible children are indexed as well, so that changing the visibility of a child
+        // does not require rebuilding the index; hitbox_test() will skip them.
+        auto items = std::vector<decltype(_children_index)::item_type>{};
+        items.reserve(_children.size());
+        for (size_t i = 0; i != _children.size(); ++i) {
+            items.push_back({_children[i]->_bounding_rectangle, i});
+        }
+        _children_index.build(std::move(items));
+    }
+
+    ttlet parent_bounding_rectangle = aarectangle{_local_to_parent * bounding_rectangle};
+    if (parent_bounding_rectangle != _bounding_rectangle) {
+        _bounding_rectangle = parent_bounding_rectangle;
+        _bounding_rectangle_modified = true;
+    }
+}
+
 void widget::draw(draw_context context, hires_utc_clock::time_point display_time_point) noexcept
 {
     tt_axiom(is_gui_thread());
@@ -350,6 +445,26 @@ void widget::request_redraw() const noexcept
     tt_axiom(is_gui_thread());
 
     auto r = hitbox{};
+
+    if (_children_index.size() == _children.size() and not _children_index.empty()) {
+        // The index returns the children in arbitrary order; when hitboxes compare equal
+        // the first child wins, the same as the linear search below.
+        auto r_index = std::numeric_limits<size_t>::max();
+        _children_index.find(position, [&](size_t i) {
+            ttlet &child = _children[i];
+            tt_axiom(child);
+            tt_axiom(child->parent == this);
+            if (child->visible) {
+                ttlet child_hitbox = child->hitbox_test(point2{child->parent_to_local() * position});
+                if (r < child_hitbox or (not(child_hitbox < r) and i < r_index)) {
+                    r = child_hitbox;
+                    r_index = i;
+                }
+            }
+        });
+        return r;
+    }
+
     for (ttlet &child : _children) {
         tt_axiom(child);
         tt_axiom(child->parent == this);
@@ -551,7 +666,8 @@ void widget::clear() noexcept
 {
     tt_axiom(is_gui_thread());
     _children.clear();
-    _request_constrain = true;
+    _children_index.clear();
+    request_reconstrain();
 }
 
 /** Add a widget directly to this widget.
@@ -564,7 +680,9 @@ widget &widget::add_widget(std::unique_ptr<widget> widget) noexcept
 
     auto widget_ptr = &(*widget);
     _children.push_back(std::move(widget));
-    _request_constrain = true;
+    // The index is no longer valid, hitbox_test() will use a linear search until the next layout().
+    _children_index.clear();
+    request_reconstrain();
     window.requestLayout = true;
     return *widget_ptr;
 }
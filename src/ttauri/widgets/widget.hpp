@@ -14,6 +14,7 @@
 //#include "../alignment.hpp"
 #include "../geometry/extent.hpp"
 #include "../geometry/axis_aligned_rectangle.hpp"
+#include "../geometry/bounding_volume_hierarchy.hpp"
 #include "../geometry/transform.hpp"
 #include "../hires_utc_clock.hpp"
 #include "../observable.hpp"
@@ -201,10 +202,22 @@ public:
 
     [[nodiscard]] aarectangle clipping_rectangle() const noexcept;
 
+    /** Get the rectangle enclosing this widget and all its visible descendants.
+     * This is the union of the clipping rectangles of the widget and its visible descendants,
+     * which encloses every position where `hitbox_test()` may find a widget.
+     *
+     * @pre `mutex` must be locked by current thread.
+     * @return The bounding rectangle in the parent's coordinate system, updated by `layout()`.
+     */
+    [[nodiscard]] aarectangle bounding_rectangle() const noexcept;
+
     /** Find the widget that is under the mouse cursor.
      * This function will recursively test with visual child widgets, when
      * widgets overlap on the screen the hitbox object with the highest elevation is returned.
      *
+     * When a widget has many children, only the children whose `bounding_rectangle()`
+     * contains the position are tested, using an index that is updated by `layout()`.
+     *
      * @param position The coordinate of the mouse local to the widget.
      * @return A hit_box object with the cursor-type and a reference to the widget.
      */
@@ -230,6 +243,10 @@ public:
      * Subclasses should call `constrain()` on its base-class to check if its or any of
      * its children's constraints where changed, before doing specific constraining
      *
+     * Only the children that requested to be re-constrained, or have a descendant that
+     * requested to be re-constrained, are visited; unless `need_reconstrain` is true.
+     * A child whose constraints have been recalculated will also get a new layout.
+     *
      * If the container, due to a change in constraints, wants the window to resize to the minimum size
      * it should set `window::request_resize` to `true`.
      *
@@ -237,10 +254,28 @@ public:
      *       and `widget::maximum_size()`.
      * @param display_time_point The time point when the widget will be shown on the screen.
      * @param need_reconstrain Force the widget to re-constrain.
-     * @return True if its or any children's constraints has changed.
+     * @return True if it was requested to re-constrain, or the size of any of its children has changed.
      */
     [[nodiscard]] virtual bool constrain(hires_utc_clock::time_point display_time_point, bool need_reconstrain) noexcept;
 
+    /** Request the constraints of this widget to be recalculated.
+     * This sets the flag for this widget, and marks the path from the window-widget
+     * to this widget, so that the next `constrain()` pass only needs to visit the
+     * widgets on the path.
+     *
+     * Thread safety: may be called from any thread.
+     */
+    void request_reconstrain() noexcept;
+
+    /** Request the layout of this widget to be recalculated.
+     * This sets the flag for this widget, and marks the path from the window-widget
+     * to this widget, so that the next `layout()` pass only needs to visit the
+     * widgets on the path.
+     *
+     * Thread safety: may be called from any thread.
+     */
+    void request_relayout() noexcept;
+
     /** Update the internal layout of the widget.
      * This function is called on each vertical sync, even if no drawing is to be done.
      *
@@ -252,6 +287,9 @@ public:
      * relative to this widget. At the end of the function the subclass should call `layout()`
      * on its base-class to recursively update the layout of the children.
      *
+     * Only the visible children that requested a new layout, or have a descendant that
+     * requested a new layout, are visited; unless `need_layout` is true.
+     *
      * @pre `widget::set_layout_parameters()` should be called.
      * @post This function will change what is returned by `widget::size()` and the transformation
      *       matrices.
@@ -424,14 +462,48 @@ protected:
      */
     aarectangle _visible_rectangle;
 
+    /** The rectangle in parent coordinates, enclosing this widget and its visible descendants.
+     */
+    aarectangle _bounding_rectangle;
+
+    /** Set when `_bounding_rectangle` was changed by `layout()`.
+     * The parent will update its `_children_index` when this flag is set on any of its children.
+     */
+    bool _bounding_rectangle_modified = true;
+
+    /** The number of children that are needed to maintain the `_children_index`.
+     * With fewer children a linear search is faster than maintaining the index.
+     */
+    static constexpr size_t children_index_threshold = 16;
+
+    /** An index of the bounding rectangles of the children.
+     * The value of each item is the index of the child in `_children`.
+     *
+     * The index is only valid when its size is equal to the number of children, otherwise
+     * `hitbox_test()` will test each child.
+     */
+    bounding_volume_hierarchy<size_t> _children_index;
+
     /** When set to true the widget will recalculate the constraints on the next call to `updateConstraints()`
+     * Use `request_reconstrain()` to set this flag, so that the `constrain()` pass will visit this widget.
      */
     std::atomic<bool> _request_constrain = true;
 
     /** When set to true the widget will recalculate the layout on the next call to `updateLayout()`
+     * Use `request_relayout()` to set this flag, so that the `layout()` pass will visit this widget.
      */
     std::atomic<bool> _request_layout = true;
 
+    /** Set when this widget or one of its descendants has requested to be re-constrained.
+     * The parent's `constrain()` will skip this widget and its descendants when this flag is not set.
+     */
+    std::atomic<bool> _request_constrain_path = true;
+
+    /** Set when this widget or one of its descendants has requested a new layout.
+     * The parent's `layout()` will skip this widget and its descendants when this flag is not set.
+     */
+    std::atomic<bool> _request_layout_path = true;
+
     extent2 _minimum_size;
     extent2 _preferred_size;
     extent2 _maximum_size;
@@ -451,6 +523,13 @@ protected:
         return static_cast<T &>(add_widget(std::move(tmp)));
     }
 
+    /** Request `layout()` to be called on the next frame, without requesting a new layout.
+     * This is used by widgets that need to check the time on each frame, for example for animation.
+     *
+     * Thread safety: may be called from any thread.
+     */
+    void request_layout_pass() noexcept;
+
     /** Make an overlay rectangle.
      *
      * This function tries to create a rectangle for an overlay-widget that
@@ -461,6 +540,12 @@ protected:
      * @return A rectangle that fits the window's constraints in the local coordinate system.
      */
     [[nodiscard]] aarectangle make_overlay_rectangle(aarectangle requested_rectangle) const noexcept;
+
+private:
+    /** Update the bounding rectangle of this widget and the index of its children.
+     * Called from `layout()` after the children have been laid out.
+     */
+    void update_bounding_rectangle() noexcept;
 };
 
 } // namespace tt
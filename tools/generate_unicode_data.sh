@@ -12,6 +12,8 @@ python tools/unicode_data_generator.py \
     --emoji-data=data/emoji-data.txt \
     --composition-exclusions=data/CompositionExclusions.txt \
     --grapheme-break-property=data/GraphemeBreakProperty.txt \
+    --line-break=data/LineBreak.txt \
+    --word-break-property=data/WordBreakProperty.txt \
     --bidi-brackets=data/BidiBrackets.txt \
     --bidi-mirroring=data/BidiMirroring.txt
 
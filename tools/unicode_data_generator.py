@@ -11,6 +11,8 @@ parser.add_argument("--unicode-data", dest="unicode_data_path", action="store",
 parser.add_argument("--emoji-data", dest="emoji_data_path", action="store", required=True)
 parser.add_argument("--composition-exclusions", dest="composition_exclusions_path", action="store", required=True)
 parser.add_argument("--grapheme-break-property", dest="grapheme_break_property_path", action="store", required=True)
+parser.add_argument("--line-break", dest="line_break_path", action="store", required=True)
+parser.add_argument("--word-break-property", dest="word_break_property_path", action="store", required=True)
 parser.add_argument("--bidi-brackets", dest="bidi_brackets_path", action="store", required=True)
 parser.add_argument("--bidi-mirroring", dest="bidi_mirroring_path", action="store", required=True)
 options = parser.parse_args()
@@ -59,6 +61,8 @@ class UnicodeDescription (object):
         self.codePoint = codePoint;
         self.generalCategory = generalCategory
         self.graphemeClusterBreak = "Other"
+        self.lineBreakClass = "XX"
+        self.wordBreakProperty = "Other"
         self.bidiClass = bidiClass
         self.bidiMirrored = bidiMirrored
         self.bidiBracketType = "n"
@@ -69,6 +73,18 @@ class UnicodeDescription (object):
         self.decompositionOrder = decompositionOrder
         self.decompositionIndex = None
 
+    def resolvedLineBreakClass(self):
+        """Resolve the line break classes which are not used by the algorithm, see rule LB1 of UAX #14.
+        """
+        if self.lineBreakClass in ("AI", "SG", "XX"):
+            return "AL"
+        elif self.lineBreakClass == "SA":
+            return "CM" if self.generalCategory in ("Mn", "Mc") else "AL"
+        elif self.lineBreakClass == "CJ":
+            return "NS"
+        else:
+            return self.lineBreakClass
+
     def serialize(self):
         s = "TTXD{"
 
@@ -81,6 +97,8 @@ class UnicodeDescription (object):
         s += format_char32(self.codePoint)
         s += ", TTXGC::{}".format(self.generalCategory)
         s += ", TTXGU::{}".format(self.graphemeClusterBreak)
+        s += ", TTXLB::{}".format(self.resolvedLineBreakClass())
+        s += ", TTXWB::{}".format(self.wordBreakProperty)
 
         # Bidirection algorithm
         s += ", TTXBC::{}".format(self.bidiClass)
@@ -124,6 +142,40 @@ def parseGraphemeBreakProperty(filename, descriptions):
             if codePoint in descriptions:
                 descriptions[codePoint].graphemeClusterBreak = columns[1]
 
+def parseLineBreak(filename, descriptions):
+    for line in open(filename, encoding="utf-8"):
+        line = line.rstrip()
+        line = line.split("#", 1)[0]
+        if line == "":
+            continue
+
+        columns = [x.strip() for x in line.split(";")]
+
+        codePoints = [int(x, 16) for x in columns[0].split("..")]
+        if len(codePoints) == 1:
+            codePoints.append(codePoints[0])
+
+        for codePoint in range(codePoints[0], codePoints[1] + 1):
+            if codePoint in descriptions:
+                descriptions[codePoint].lineBreakClass = columns[1]
+
+def parseWordBreakProperty(filename, descriptions):
+    for line in open(filename, encoding="utf-8"):
+        line = line.rstrip()
+        line = line.split("#", 1)[0]
+        if line == "":
+            continue
+
+        columns = [x.strip() for x in line.split(";")]
+
+        codePoints = [int(x, 16) for x in columns[0].split("..")]
+        if len(codePoints) == 1:
+            codePoints.append(codePoints[0])
+
+        for codePoint in range(codePoints[0], codePoints[1] + 1):
+            if codePoint in descriptions:
+                descriptions[codePoint].wordBreakProperty = columns[1]
+
 def parseEmojiData(filename, descriptions):
     for line in open(filename, encoding="utf-8"):
         line = line.rstrip()
@@ -269,6 +321,8 @@ def writeUnicodeData(filename, descriptions, compositions, decompositions):
     fd.write('#include "ttauri/text/unicode_bidi_bracket_type.hpp"\n')
     fd.write('#include "ttauri/text/unicode_bidi_class.hpp"\n')
     fd.write('#include "ttauri/text/unicode_grapheme_cluster_break.hpp"\n')
+    fd.write('#include "ttauri/text/unicode_line_break_class.hpp"\n')
+    fd.write('#include "ttauri/text/unicode_word_break_property.hpp"\n')
     fd.write('#include "ttauri/text/unicode_composition.hpp"\n')
     fd.write('#include "ttauri/text/unicode_description.hpp"\n')
     fd.write('#include <array>\n\n')
@@ -280,6 +334,8 @@ def writeUnicodeData(filename, descriptions, compositions, decompositions):
     fd.write('#define TTXBC unicode_bidi_class\n')
     fd.write('#define TTXBB unicode_bidi_bracket_type\n')
     fd.write('#define TTXGU unicode_grapheme_cluster_break\n')
+    fd.write('#define TTXLB unicode_line_break_class\n')
+    fd.write('#define TTXWB unicode_word_break_property\n')
     fd.write('constexpr auto unicode_db_description_table = std::array{')
     for i, description in enumerate(descriptions):
         if i != 0:
@@ -292,6 +348,8 @@ def writeUnicodeData(filename, descriptions, compositions, decompositions):
     fd.write('#undef TTXBC\n')
     fd.write('#undef TTXBB\n')
     fd.write('#undef TTXGU\n')
+    fd.write('#undef TTXLB\n')
+    fd.write('#undef TTXWB\n')
 
     fd.write('#define TTXC unicode_composition\n')
     fd.write('constexpr auto unicode_db_composition_table = std::array{')
@@ -335,6 +393,8 @@ def main():
     composition_exclusions = parseCompositionExclusions(options.composition_exclusions_path)
     parseGraphemeBreakProperty(options.grapheme_break_property_path, descriptions)
     parseEmojiData(options.emoji_data_path, descriptions)
+    parseLineBreak(options.line_break_path, descriptions)
+    parseWordBreakProperty(options.word_break_property_path, descriptions)
     parseBidiBrackets(options.bidi_brackets_path, descriptions)
     parseBidiMirroring(options.bidi_mirroring_path, descriptions)
 